@@ -0,0 +1,109 @@
+#include "flow_control_tuner.h"
+
+uint8_t FlowControlTuner::sep_time_ms(uint8_t sep_time) {
+  // 0xF1 - 0xF9 (100us - 900us) считаем как 0 мс
+  return (sep_time <= 0x7F) ? sep_time : 0;
+}
+
+const FlowControlTuner::Entry* FlowControlTuner::find(uint32_t rx_id) const {
+  for (const Entry& entry : _entries) {
+    if (entry.used && entry.rx_id == rx_id) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+FlowControlTuner::Entry* FlowControlTuner::find(uint32_t rx_id) {
+  return const_cast<Entry*>(static_cast<const FlowControlTuner*>(this)->find(rx_id));
+}
+
+FlowControlTuner::Entry* FlowControlTuner::find_or_add(uint32_t rx_id) {
+  Entry* free_entry = nullptr;
+  for (Entry& entry : _entries) {
+    if (entry.used && entry.rx_id == rx_id) {
+      return &entry;
+    }
+    if (!entry.used && free_entry == nullptr) {
+      free_entry = &entry;
+    }
+  }
+  if (free_entry != nullptr) {
+    *free_entry       = Entry();
+    free_entry->used  = true;
+    free_entry->rx_id = rx_id;
+  }
+  return free_entry;
+}
+
+bool FlowControlTuner::configure(uint32_t rx_id, const FlowControlParams& base, bool adaptive) {
+  Entry* entry = find_or_add(rx_id);
+  if (entry == nullptr) {
+    return false;
+  }
+  entry->base     = base;
+  entry->current  = base;
+  entry->adaptive = adaptive;
+  entry->clean    = 0;
+  return true;
+}
+
+FlowControlParams FlowControlTuner::params(uint32_t rx_id) const {
+  const Entry* entry = find(rx_id);
+  return (entry != nullptr) ? entry->current : FlowControlParams();
+}
+
+void FlowControlTuner::on_success(uint32_t rx_id) {
+  Entry* entry = find(rx_id);
+  if (entry == nullptr || !entry->adaptive) {
+    return;
+  }
+
+  FlowControlParams& current    = entry->current;
+  const FlowControlParams& base = entry->base;
+  if (current.blocksize == base.blocksize && current.min_sep_time == base.min_sep_time) {
+    return;
+  }
+  if (++entry->clean < CLEAN_TRANSFERS_TO_RELAX) {
+    return;
+  }
+  entry->clean = 0;
+
+  // Ослабляем в обратном порядке: сначала STmin, затем BS
+  if (sep_time_ms(current.min_sep_time) > sep_time_ms(base.min_sep_time)) {
+    const uint8_t relaxed = sep_time_ms(current.min_sep_time) / 2;
+    current.min_sep_time  = (relaxed > sep_time_ms(base.min_sep_time)) ? relaxed : base.min_sep_time;
+    return;
+  }
+  current.min_sep_time = base.min_sep_time;
+
+  const uint16_t relaxed = static_cast<uint16_t>(current.blocksize) * 2;
+  if (base.blocksize != 0 && relaxed >= base.blocksize) {
+    current.blocksize = base.blocksize;
+  } else if (base.blocksize == 0 && relaxed > SAFE_BLOCKSIZE) {
+    current.blocksize = 0;
+  } else {
+    current.blocksize = static_cast<uint8_t>(relaxed);
+  }
+}
+
+void FlowControlTuner::on_error(uint32_t rx_id) {
+  Entry* entry = find_or_add(rx_id);
+  if (entry == nullptr || !entry->adaptive) {
+    return;
+  }
+  entry->clean = 0;
+
+  FlowControlParams& current = entry->current;
+  if (current.blocksize == 0 || current.blocksize > SAFE_BLOCKSIZE) {
+    current.blocksize = SAFE_BLOCKSIZE;
+    return;
+  }
+  if (current.blocksize > 1) {
+    current.blocksize /= 2;
+    return;
+  }
+
+  const uint16_t sep_time = (sep_time_ms(current.min_sep_time) == 0) ? 1 : sep_time_ms(current.min_sep_time) * 2;
+  current.min_sep_time     = (sep_time < MAX_ADAPTIVE_STMIN) ? static_cast<uint8_t>(sep_time) : MAX_ADAPTIVE_STMIN;
+}
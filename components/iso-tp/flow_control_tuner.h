@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Параметры управления потоком приемника ISO-TP
+ */
+struct FlowControlParams {
+  uint8_t blocksize    = 0;   // BS в FC: 0 - без ограничения количества CF
+  uint8_t min_sep_time = 0;   // STmin в FC в формате ISO 15765-2
+  uint8_t wft_max      = 10;  // Допустимое количество FC WAIT от получателя при отправке
+};
+
+/**
+ * @brief Адаптивный подбор BS/STmin для каждого ЭБУ
+ *
+ * После ошибок приема (пропуск CF из-за переполнения очереди, таймаут CF)
+ * параметры ужесточаются: сначала ограничивается BS, затем растет STmin.
+ * После серии успешных передач параметры постепенно возвращаются к базовым,
+ * поэтому каждый ЭБУ работает на максимальной безопасной для него скорости.
+ */
+class FlowControlTuner {
+ public:
+  static const size_t MAX_ECUS = 8;
+
+  static const uint8_t SAFE_BLOCKSIZE           = 8;   // Не больше глубины очереди подписчика
+  static const uint8_t MAX_ADAPTIVE_STMIN       = 32;  // мс
+  static const uint8_t CLEAN_TRANSFERS_TO_RELAX = 8;
+
+  /**
+   * @brief Задание базовых параметров ЭБУ
+   * @param rx_id CAN ID ответов ЭБУ
+   * @param base Базовые (наиболее быстрые) параметры
+   * @param adaptive Разрешить автоматическую подстройку
+   * @return false если таблица ЭБУ заполнена
+   */
+  bool configure(uint32_t rx_id, const FlowControlParams& base, bool adaptive = true);
+
+  /**
+   * @brief Текущие параметры для ЭБУ (базовые по умолчанию для неизвестного ЭБУ)
+   */
+  FlowControlParams params(uint32_t rx_id) const;
+
+  /**
+   * @brief Многокадровый прием от ЭБУ завершился успешно
+   */
+  void on_success(uint32_t rx_id);
+
+  /**
+   * @brief Многокадровый прием от ЭБУ завершился ошибкой потока (SN, таймаут CF)
+   */
+  void on_error(uint32_t rx_id);
+
+ private:
+  struct Entry {
+    bool used      = false;
+    bool adaptive  = true;
+    uint32_t rx_id = 0;
+    uint8_t clean  = 0;  // Успешные передачи подряд с последней подстройки
+    FlowControlParams base;
+    FlowControlParams current;
+  };
+
+  const Entry* find(uint32_t rx_id) const;
+  Entry* find(uint32_t rx_id);
+  Entry* find_or_add(uint32_t rx_id);
+
+  static uint8_t sep_time_ms(uint8_t sep_time);
+
+  Entry _entries[MAX_ECUS];
+};
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cinttypes>
 #include <cstdint>
+#include <cstring>
+#include <iterator>
 
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
@@ -15,30 +17,38 @@ static uint32_t millis() {
 
 static const char* const TAG = "ISO_TP";
 
+// Допустимые длины кадра CAN FD больше 8 байт (DLC 9-15)
+static const uint8_t FD_FRAME_LENGTHS[] = {12, 16, 20, 24, 32, 48, 64};
+
+// Полезная нагрузка кадра: длина кадра без байта адреса и N_PCI
+static constexpr size_t frame_payload(size_t frame_len, size_t pci_offset, size_t pci_len) {
+  return frame_len - pci_offset - pci_len;
+}
+
+// Классический CAN: SF 7/6, FF 6/5, CF 7/6 байт для нормальной/расширенной адресации
+static_assert(frame_payload(8, 0, 1) == 7 && frame_payload(8, 1, 1) == 6, "SF/CF payload");
+static_assert(frame_payload(8, 0, 2) == 6 && frame_payload(8, 1, 2) == 5, "FF payload");
+
 const char* IsoTp::isotp_state_to_string(isotp_states_t state) {
   switch (state) {
     case ISOTP_IDLE:
       return "ISOTP_IDLE";
-    case ISOTP_SEND:
-      return "ISOTP_SEND";
-    case ISOTP_SEND_FF:
-      return "ISOTP_SEND_FF";
     case ISOTP_SEND_CF:
       return "ISOTP_SEND_CF";
     case ISOTP_WAIT_FIRST_FC:
       return "ISOTP_WAIT_FIRST_FC";
     case ISOTP_WAIT_FC:
       return "ISOTP_WAIT_FC";
+    case ISOTP_WAIT_RESPONSE:
+      return "ISOTP_WAIT_RESPONSE";
     case ISOTP_WAIT_DATA:
       return "ISOTP_WAIT_DATA";
-    case ISOTP_FINISHED:
-      return "ISOTP_FINISHED";
     default:
       return "UNKNOWN_STATE";
   }
 }
 
-void IsoTp::fc_delay(uint8_t sep_time) {
+uint8_t IsoTp::fix_sep_time(uint8_t sep_time) {
   /*
    * 0x00 - 0x7F: 0 - 127ms
    * 0x80 - 0xF0: reserved
@@ -46,12 +56,30 @@ void IsoTp::fc_delay(uint8_t sep_time) {
    * 0xFA - 0xFF: reserved
    * default 0x7F, 127ms
    */
-  if (sep_time <= 0x7F)
-    vTaskDelay(pdMS_TO_TICKS(sep_time));
-  else if ((sep_time >= 0xF1) && (sep_time <= 0xF9))
-    esp_rom_delay_us((sep_time - 0xF0) * 100);
-  else
-    vTaskDelay(pdMS_TO_TICKS(0x7F));
+  const bool wrong_sep_time = (sep_time > 0x7F) && ((sep_time < 0xF1) || (sep_time > 0xF9));
+  return wrong_sep_time ? 0x7F : sep_time;
+}
+
+uint32_t IsoTp::sep_time_to_us(uint8_t sep_time) {
+  if (sep_time <= 0x7F) {
+    return sep_time * 1000;
+  }
+  // 0xF1 - 0xF9: 100us - 900us
+  return (sep_time - 0xF0) * 100;
+}
+
+bool IsoTp::is_valid_frame_length(uint8_t len) {
+  if (len == CAN_MAX_DLEN) {
+    return true;
+  }
+  if (len > CAN_FD_MAX_DLEN) {
+    return false;  // Сборка без TWAI_CAN_FD: кадр CAN FD не помещается в TwaiFrame
+  }
+  return std::find(std::begin(FD_FRAME_LENGTHS), std::end(FD_FRAME_LENGTHS), len) != std::end(FD_FRAME_LENGTHS);
+}
+
+bool IsoTp::time_reached(uint32_t now, uint32_t deadline) {
+  return static_cast<int32_t>(now - deadline) >= 0;
 }
 
 void IsoTp::log_print(const char* format, ...) {
@@ -63,7 +91,7 @@ void IsoTp::log_print(const char* format, ...) {
   }
 }
 
-void IsoTp::log_print_buffer(uint32_t id, uint8_t* buffer, uint16_t len) {
+void IsoTp::log_print_buffer(uint32_t id, const uint8_t* buffer, uint16_t len) {
   if (ISO_TP_DEBUG) {
     char log_buffer[128];
     int offset = 0;
@@ -79,8 +107,18 @@ void IsoTp::log_print_buffer(uint32_t id, uint8_t* buffer, uint16_t len) {
   log_print("\n");
 }
 
-IsoTp::IsoTp(IPhyInterface& bus) :
-    _bus(bus) {
+IsoTp::IsoTp(IPhyInterface& bus, TaskHandle_t consumer_task) :
+    IsoTp(bus, LinkConfig(), consumer_task) {}
+
+IsoTp::IsoTp(IPhyInterface& bus, const LinkConfig& link, TaskHandle_t consumer_task) :
+    _bus(bus),
+    _link(link),
+    _subscriber(consumer_task),
+    _pacer(wake_task, &_subscriber) {
+  if (!is_valid_frame_length(_link.tx_dl)) {
+    ESP_LOGW(TAG, "Invalid TX_DL %d, using %d", _link.tx_dl, CAN_MAX_DLEN);
+    _link.tx_dl = CAN_MAX_DLEN;
+  }
   bus.RegisterSubscriber(_subscriber);
 }
 
@@ -88,394 +126,1177 @@ IsoTp::~IsoTp() {
   _bus.UnRegisterSubscriber(_subscriber);
 }
 
-void IsoTp::can_send(uint32_t id, uint8_t len, uint8_t* data) {
-  log_print_buffer(id, data, len);
-  TwaiFrame message;
-  message.id          = id;
-  message.is_extended = false;  // Standard frame
-  message.is_rtr      = false;
-  message.is_fd       = false;
-  message.brs         = false;
-  message.data_length = len;
-  if ((len <= 8) && (data != nullptr)) {  // Проверка на максимальный размер данных для классического CAN
-    memcpy(message.data, data, len);
+uint8_t IsoTp::frame_length(size_t len) const {
+  if (len <= CAN_MAX_DLEN) {
+    return _link.padding ? CAN_MAX_DLEN : static_cast<uint8_t>(len);
+  }
+  // CAN FD: длина кадра только из ряда DLC, остаток заполняется всегда
+  for (uint8_t fd_len : FD_FRAME_LENGTHS) {
+    if (fd_len >= len) {
+      return fd_len;
+    }
   }
-  _bus.Transmit(message, 0);
+  return CAN_FD_MAX_DLEN;
 }
 
-bool IsoTp::can_receive() {
-  if (_subscriber.Receive(rxFrame, 10)) {
-    log_print_buffer(rxFrame.id, rxFrame.data, rxFrame.data_length);
-    return true;
+size_t IsoTp::max_message_len() const {
+  return (_link.tx_dl > CAN_MAX_DLEN) ? MAX_MESSAGE_LEN_ESCAPE : MAX_MESSAGE_LEN;
+}
+
+bool IsoTp::is_29bit_id(const Message& msg) {
+  switch (msg.addressing) {
+    case Addressing::NORMAL:
+      return false;
+    case Addressing::NORMAL_FIXED:
+      return true;
+    default:
+      return (msg.tx_id > 0x7FF) || (msg.rx_id > 0x7FF);
   }
-  return false;
 }
 
-void IsoTp::send_fc(const Message_t& msg) {
-  uint8_t TxBuf[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-  // FC message high nibble = 0x3 , low nibble = FC Status
-  TxBuf[0] = (N_PCI_FC | msg.fc_status);
-  TxBuf[1] = msg.blocksize;
-  /* fix wrong separation time values according spec */
-  const bool wrong_sep_time = (msg.min_sep_time > 0x7F) && ((msg.min_sep_time < 0xF1) || (msg.min_sep_time > 0xF9));
-  TxBuf[2]                  = wrong_sep_time ? 0x7F : msg.min_sep_time;
-  can_send(msg.tx_id, 8, TxBuf);
+uint8_t IsoTp::pci_offset(Addressing addressing) {
+  return (addressing == Addressing::EXTENDED || addressing == Addressing::MIXED) ? 1 : 0;
 }
 
-void IsoTp::send_sf(const Message_t& msg) {
-  uint8_t TxBuf[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-  // SF message high nibble = 0x0 , low nibble = Length
-  TxBuf[0] = (N_PCI_SF | msg.len);
-  if (msg.len > 0 && msg.buffer != nullptr) {
-    memcpy(TxBuf + 1, msg.buffer, msg.len);
+size_t IsoTp::sf_payload(uint8_t pci_offset) const {
+  // В кадре CAN FD длиннее 8 байт SF_DL передается во втором байте (escape)
+  if (_link.tx_dl > CAN_MAX_DLEN) {
+    return frame_payload(_link.tx_dl, pci_offset, N_PCI_SF_ESC_SZ);
   }
-  //  return can_send(msg.tx_id,msg.len+1,TxBuf);// Add PCI length
-  can_send(msg.tx_id, 8, TxBuf);  // Always send full frame
+  return frame_payload(CAN_MAX_DLEN, pci_offset, N_PCI_SF_SZ);
+}
+
+size_t IsoTp::ff_payload(const Session& session) const {
+  // FF_DL > 4095 передается в 32 битах после нулевого 12-битного поля (escape)
+  const size_t pci_len = (session.len > MAX_MESSAGE_LEN) ? N_PCI_FF_ESC_SZ : N_PCI_FF_SZ;
+  return frame_payload(_link.tx_dl, session.pci_offset, pci_len);
 }
 
-void IsoTp::send_ff(const Message_t& msg) {
-  uint8_t TxBuf[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+size_t IsoTp::cf_payload(const Session& session) const {
+  return frame_payload(_link.tx_dl, session.pci_offset, N_PCI_CF_SZ);
+}
+
+void IsoTp::build_frame(
+    const Session& session, size_t len, const uint8_t* pci, TxPriority priority, TwaiFrame& message) const {
+  message.id           = session.tx_id;
+  message.is_extended  = session.is_extended;
+  message.is_rtr       = false;
+  message.is_fd        = _link.tx_dl > CAN_MAX_DLEN;
+  message.brs          = message.is_fd && _link.bit_rate_switch;
+  message.data_length  = frame_length(session.pci_offset + len);
+  message.timestamp_us = 0;
+  message.tx_priority  = priority;
+  message.data[0]      = session.tx_address;  // Перезаписывается N_PCI при нормальной адресации
+  memcpy(message.data + session.pci_offset, pci, len);
+  memset(message.data + session.pci_offset + len,
+         _link.pad_byte,
+         message.data_length - session.pci_offset - len);
+  log_print_buffer(message.id, message.data, message.data_length);
+}
 
-  TxBuf[0] = (N_PCI_FF | ((msg.len & 0x0F00) >> 8));
-  TxBuf[1] = (msg.len & 0x00FF);
-  if (msg.buffer != nullptr) {
-    memcpy(TxBuf + 2, msg.buffer, 6);  // Skip 2 Bytes PCI
+bool IsoTp::can_send(const Session& session, size_t len, const uint8_t* pci, TxPriority priority) {
+  TwaiFrame message;
+  build_frame(session, len, pci, priority, message);
+  if (_bus.Transmit(message, 0) != IPhyInterface::TwaiError::OK) {
+    return false;
   }
-  can_send(msg.tx_id, 8, TxBuf);  // First Frame has full length
+  _tx_queued++;
+  return true;
+}
+
+void IsoTp::send_fc(const Session& session, uint8_t fc_status, uint8_t blocksize, uint8_t min_sep_time) {
+  uint8_t TxBuf[FC_CONTENT_SZ];
+  // FC message high nibble = 0x3 , low nibble = FC Status
+  TxBuf[0] = (N_PCI_FC | fc_status);
+  TxBuf[1] = blocksize;
+  TxBuf[2] = fix_sep_time(min_sep_time);
+  // FC обгоняет CF в очереди драйвера: задержка FC не приводит к N_Bs у отправителя
+  can_send(session, FC_CONTENT_SZ, TxBuf, TxPriority::FLOW_CONTROL);
 }
 
-void IsoTp::send_cf(const Message_t& msg) {
-  uint8_t TxBuf[8] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-  uint16_t len     = (msg.len > 7) ? 7 : msg.len;
+bool IsoTp::send_sf(const Session& session) {
+  uint8_t TxBuf[CAN_FD_MAX_DLEN];
+  size_t pci_len = N_PCI_SF_SZ;
+  if (session.len <= frame_payload(CAN_MAX_DLEN, session.pci_offset, N_PCI_SF_SZ)) {
+    // SF message high nibble = 0x0 , low nibble = Length
+    TxBuf[0] = (N_PCI_SF | session.len);
+  } else {
+    // CAN FD: SF_DL escape, length in the second byte
+    TxBuf[0] = N_PCI_SF;
+    TxBuf[1] = session.len;
+    pci_len  = N_PCI_SF_ESC_SZ;
+  }
+  if (session.len > 0 && session.buffer != nullptr) {
+    memcpy(TxBuf + pci_len, session.buffer, session.len);
+  }
+  return can_send(session, pci_len + session.len, TxBuf);
+}
 
-  TxBuf[0] = (N_PCI_CF | (msg.seq_id & 0x0F));
-  if (len > 0 && msg.buffer != nullptr) {
-    memcpy(TxBuf + 1, msg.buffer, len);  // Skip 1 Byte PCI
+bool IsoTp::send_ff(const Session& session) {
+  uint8_t TxBuf[CAN_FD_MAX_DLEN];
+  size_t pci_len = N_PCI_FF_SZ;
+  if (session.len <= MAX_MESSAGE_LEN) {
+    TxBuf[0] = (N_PCI_FF | ((session.len & 0x0F00) >> 8));
+    TxBuf[1] = (session.len & 0x00FF);
+  } else {
+    // FF_DL escape: zero 12-bit length followed by 32-bit length
+    TxBuf[0] = N_PCI_FF;
+    TxBuf[1] = 0;
+    TxBuf[2] = (session.len >> 24) & 0xFF;
+    TxBuf[3] = (session.len >> 16) & 0xFF;
+    TxBuf[4] = (session.len >> 8) & 0xFF;
+    TxBuf[5] = session.len & 0xFF;
+    pci_len  = N_PCI_FF_ESC_SZ;
   }
-  // return can_send(msg.tx_id,len+1,TxBuf);
-  // // Last frame is probably shorter
-  // than 8 -> Signals last CF Frame
-  can_send(msg.tx_id, 8, TxBuf);  // Last frame is probably shorter
-                                  // than 8, pad with 00
+  const size_t payload = ff_payload(session);
+  memcpy(TxBuf + pci_len, session.buffer, payload);
+  return can_send(session, pci_len + payload, TxBuf);  // First Frame has full length
 }
 
-void IsoTp::rcv_sf(Message_t& msg) {
-  /* get the SF_DL from the N_PCI byte */
-  msg.len = rxFrame.data[0] & 0x0F;
+size_t IsoTp::send_cf(const Session& session, size_t count) {
+  TwaiFrame frames[TX_WINDOW];
+  count = std::min<size_t>(count, TX_WINDOW);
+
+  uint8_t TxBuf[CAN_FD_MAX_DLEN];
+  size_t offset  = session.offset;
+  uint8_t seq_id = session.seq_id;
+  for (size_t i = 0; i < count; i++) {
+    const size_t len = std::min(session.len - offset, cf_payload(session));
+    TxBuf[0]         = (N_PCI_CF | (seq_id & 0x0F));
+    memcpy(TxBuf + N_PCI_CF_SZ, session.buffer + offset, len);
+    build_frame(session, N_PCI_CF_SZ + len, TxBuf, TxPriority::BULK, frames[i]);  // Last frame is probably shorter
+    offset += len;
+    seq_id = (seq_id + 1) & 0x0F;
+  }
+
+  // Пачка CF ставится в очередь драйвера одним вызовом
+  size_t queued = 0;
+  _bus.TransmitBatch(Span<const TwaiFrame>(frames, count), 0, queued);
+  _tx_queued += queued;
+  return queued;
+}
 
-  uint16_t copy_len = msg.len;
-  if (msg.len > msg.max_len) {
-    ESP_LOGW(TAG, "Buffer too small for SF (need %ld, have %ld), truncating", msg.len, msg.max_len);
-    copy_len = msg.max_len;
+void IsoTp::deliver(Session& session, size_t offset, const uint8_t* data, size_t len) {
+  if (session.consumer != nullptr) {
+    session.consumer(offset, Span<const uint8_t>(data, len), session.len, session.consumer_ctx);
+    return;
   }
 
-  /* copy the received data bytes */
-  if (msg.buffer != nullptr && copy_len > 0) {
-    memcpy(msg.buffer, rxFrame.data + 1, copy_len);  // Skip PCI, SF uses len bytes
+  const size_t available_space = (session.max_len > offset) ? session.max_len - offset : 0;
+  const size_t copy_len        = std::min(len, available_space);
+  memcpy(session.buffer + offset, data, copy_len);
+  if (copy_len < len) {
+    ESP_LOGW(TAG,
+             "Truncated frame data (needed %u, had %u space)",
+             static_cast<unsigned>(len),
+             static_cast<unsigned>(available_space));
+    session.truncated = true;
   }
-  msg.tp_state = ISOTP_FINISHED;
 }
 
-void IsoTp::rcv_ff(Message_t& msg) {
-  msg.seq_id = 1;
+void IsoTp::rcv_sf(Session& session, const TwaiFrame& frame) {
+  const uint8_t* const pci = frame.data + session.pci_offset;
+  const size_t frame_len   = frame.data_length - session.pci_offset;
+
+  /* get the SF_DL from the N_PCI byte */
+  size_t len     = pci[0] & 0x0F;
+  size_t pci_len = N_PCI_SF_SZ;
+  if (len == 0 && frame.data_length > CAN_MAX_DLEN) {
+    // CAN FD: SF_DL escape
+    len     = pci[1];
+    pci_len = N_PCI_SF_ESC_SZ;
+  }
+  if (len == 0 || (pci_len == N_PCI_SF_SZ && len > frame_payload(CAN_MAX_DLEN, session.pci_offset, N_PCI_SF_SZ))) {
+    ESP_LOGW(TAG, "Invalid SF_DL %u ignored", static_cast<unsigned>(len));
+    return;
+  }
+  if (pci_len + len > frame_len) {
+    ESP_LOGW(TAG, "SF_DL %u exceeds frame length %d", static_cast<unsigned>(len), frame.data_length);
+    return;
+  }
+  session.len   = len;
+  session.rx_us = frame_time_us(frame);
+  record_latency(session, &TransferStatsEntry::response, session.start_us, session.rx_us);
+
+  deliver(session, 0, pci + pci_len, len);  // Skip PCI, SF uses len bytes
+  complete(session, Result::OK);
+}
+
+void IsoTp::rcv_ff(Session& session, const TwaiFrame& frame) {
+  const uint8_t* const pci = frame.data + session.pci_offset;
+  const size_t frame_len   = frame.data_length - session.pci_offset;
 
   /* get the FF_DL */
-  msg.len = (rxFrame.data[0] & 0x0F) << 8;
-  msg.len += rxFrame.data[1];
-  rest = msg.len;
+  size_t len     = ((pci[0] & 0x0F) << 8) | pci[1];
+  size_t pci_len = N_PCI_FF_SZ;
+  if (len == 0 && frame.data_length > CAN_MAX_DLEN) {
+    // CAN FD: FF_DL escape, 32-bit length только для сообщений длиннее 4095 байт
+    len = (static_cast<uint32_t>(pci[2]) << 24) | (static_cast<uint32_t>(pci[3]) << 16) |
+          (static_cast<uint32_t>(pci[4]) << 8) | pci[5];
+    pci_len = N_PCI_FF_ESC_SZ;
+    if (len <= MAX_MESSAGE_LEN) {
+      ESP_LOGW(TAG, "Escaped FF_DL %u fits 12 bits, ignored", static_cast<unsigned>(len));
+      return;
+    }
+  }
+  const size_t payload = (frame_len > pci_len) ? frame_len - pci_len : 0;
+  if (len <= payload || payload == 0) {
+    ESP_LOGW(TAG, "Invalid FF_DL %u ignored", static_cast<unsigned>(len));
+    return;
+  }
 
-  /* copy the first received data bytes */
-  uint16_t copy_len = (msg.max_len > 6) ? 6 : msg.max_len;
-  if (msg.buffer != nullptr && copy_len > 0) {
-    memcpy(msg.buffer, rxFrame.data + 2, copy_len);  // Skip 2 bytes PCI
+  session.ff_us = frame_time_us(frame);
+  if (session.tp_state == ISOTP_WAIT_DATA) {
+    ESP_LOGW(TAG,
+             "New FF interrupts reception at %u/%u bytes",
+             static_cast<unsigned>(session.offset),
+             static_cast<unsigned>(session.len));
+  } else {
+    record_latency(session, &TransferStatsEntry::response, session.start_us, session.ff_us);
   }
-  rest -= 6;  // Restlength
+  session.rx_us = session.ff_us;
+
+  session.len    = len;
+  session.seq_id = 1;
+  session.offset = payload;
 
-  msg.tp_state = ISOTP_WAIT_DATA;
+  deliver(session, 0, pci + pci_len, payload);  // Skip PCI
 
-  log_print("First frame received with message length: %d\n", rest);
+  session.tp_state = ISOTP_WAIT_DATA;
+  arm_timer(session, TIMEOUT_CF, session.ff_us);
+
+  log_print("First frame received with message length: %u\n", static_cast<unsigned>(session.len));
   log_print("Send flow controll.\n");
-  log_print("ISO-TP state: %s\n", IsoTp::isotp_state_to_string(msg.tp_state));
 
   /* send our first FC frame with Target Address*/
-  Message_t fc;
-  fc.tx_id        = msg.tx_id;
-  fc.fc_status    = ISOTP_FC_CTS;
-  fc.blocksize    = 0;
-  fc.min_sep_time = 0;
-  send_fc(fc);
+  session.bs_count = 0;
+  send_fc(session, ISOTP_FC_CTS, session.fc_params.blocksize, session.fc_params.min_sep_time);
 }
 
-void IsoTp::rcv_cf(Message_t& msg) {
-  // Handle Timeout
-  // If no Frame within 250ms change State to ISOTP_IDLE
-  const uint32_t delta = millis() - wait_cf;
-
-  if ((delta >= TIMEOUT_FC) && msg.seq_id > 1) {
-    ESP_LOGW(TAG, "CF frame timeout during receive wait_cf=%u delta=%u", wait_cf, delta);
-
-    msg.tp_state = ISOTP_IDLE;
+void IsoTp::rcv_cf(Session& session, const TwaiFrame& frame) {
+  if (session.tp_state != ISOTP_WAIT_DATA) {
+    log_print("Unexpected CF in state %s ignored\n", isotp_state_to_string(session.tp_state));
     return;
   }
-  wait_cf = millis();
 
-  log_print("ISO-TP state: %s\n", IsoTp::isotp_state_to_string(msg.tp_state));
-  log_print("CF received with message rest length: %d\n", rest);
+  const uint8_t* const pci = frame.data + session.pci_offset;
+  const size_t frame_len   = frame.data_length - session.pci_offset;
 
-  if (msg.tp_state != ISOTP_WAIT_DATA)
-    return;
-
-  const uint8_t received_seq_id = rxFrame.data[0] & 0x0F;
-  const uint8_t expected_seq_id = msg.seq_id & 0x0F;
+  const uint8_t received_seq_id = pci[0] & 0x0F;
+  const uint8_t expected_seq_id = session.seq_id & 0x0F;
 
   if (received_seq_id != expected_seq_id) {
-    if (received_seq_id < expected_seq_id) {
+    if (received_seq_id == ((expected_seq_id - 1) & 0x0F)) {
       // Дублированный кадр - игнорируем
       ESP_LOGW(TAG, "Duplicate CF ignored: Got sequence ID: %d Expected: %d", received_seq_id, expected_seq_id);
-      return;
-    } else {
-      // Пропущен кадр - ошибка
-      ESP_LOGW(TAG, "Missing CF detected: Got sequence ID: %d Expected: %d", received_seq_id, expected_seq_id);
-      msg.tp_state = ISOTP_IDLE;
-      msg.seq_id   = 1;
+      TransferStatsEntry* const stats = stats_entry(session);
+      if (stats != nullptr) {
+        stats->duplicates++;
+      }
       return;
     }
+    // Пропущен кадр - ошибка
+    ESP_LOGW(TAG, "Missing CF detected: Got sequence ID: %d Expected: %d", received_seq_id, expected_seq_id);
+    complete(session, Result::WRONG_SN);
+    return;
   }
 
-  const ssize_t offset         = 6 + 7 * (msg.seq_id - 1);
-  const ssize_t tmp_space      = msg.max_len - offset;
-  const size_t available_space = std::max(tmp_space, static_cast<ssize_t>(0));
-  if (rest <= 7) {  // Last Frame
-    uint16_t copy_len = (rest > available_space) ? available_space : rest;
-    if (msg.buffer != nullptr && copy_len > 0) {
-      memcpy(msg.buffer + offset, rxFrame.data + 1, copy_len);  // 6 Bytes in FF + 7
-    }
-    if (copy_len < rest) {
-      ESP_LOGW(TAG, "Truncated last CF frame (needed %d, had %ld space)", rest, available_space);
-    }
-    msg.tp_state = ISOTP_FINISHED;  // per CF skip PCI
-    log_print("Last CF received with seq. ID: %d\n", msg.seq_id);
-  } else {
-    uint16_t copy_len = (7 > available_space) ? available_space : 7;
-    if (msg.buffer != nullptr && copy_len > 0) {
-      memcpy(msg.buffer + offset, rxFrame.data + 1, copy_len);
-    }
-    if (copy_len < 7) {
-      ESP_LOGW(TAG, "Truncated CF frame (needed 7, had %ld space)", available_space);
-    }
-    rest -= 7;  // Got another 7 Bytes of Data;
-    log_print("CF received with seq. ID: %d\n", msg.seq_id);
+  // Размер CF задает отправитель (RX_DL), последний кадр может быть короче
+  const size_t rest  = session.len - session.offset;
+  const size_t chunk = std::min<size_t>(rest, (frame_len > N_PCI_CF_SZ) ? frame_len - N_PCI_CF_SZ : 0);
+  deliver(session, session.offset, pci + N_PCI_CF_SZ, chunk);  // per CF skip PCI
+  session.offset += chunk;
+
+  log_print("CF received with seq. ID: %d\n", session.seq_id);
+
+  if (session.offset >= session.len) {
+    complete(session, Result::OK);
+    return;
   }
 
-  msg.seq_id++;
-  return;
+  session.seq_id++;
+  arm_timer(session, TIMEOUT_CF, frame_time_us(frame));
+
+  if (session.fc_params.blocksize > 0 && ++session.bs_count >= session.fc_params.blocksize) {
+    log_print("Block of %d CF received, send FC\n", session.fc_params.blocksize);
+    session.bs_count = 0;
+    send_fc(session, ISOTP_FC_CTS, session.fc_params.blocksize, session.fc_params.min_sep_time);
+  }
 }
 
-bool IsoTp::rcv_fc(Message_t& msg) {
-  /* get communication parameters only from the first FC frame */
-  if (msg.tp_state == ISOTP_WAIT_FIRST_FC) {  //??????????????????????????????????????????????????
-    msg.blocksize    = rxFrame.data[1];
-    msg.min_sep_time = rxFrame.data[2];
+void IsoTp::rcv_fc(Session& session, const TwaiFrame& frame) {
+  if (session.tp_state != ISOTP_WAIT_FIRST_FC && session.tp_state != ISOTP_WAIT_FC) {
+    log_print("Unexpected FC in state %s ignored\n", isotp_state_to_string(session.tp_state));
+    return;
+  }
 
-    /* fix wrong separation time values according spec */
-    if ((msg.min_sep_time > 0x7F) && ((msg.min_sep_time < 0xF1) || (msg.min_sep_time > 0xF9)))
-      msg.min_sep_time = 0x7F;
+  const uint8_t* const pci = frame.data + session.pci_offset;
+
+  /* get communication parameters only from the first FC frame */
+  if (session.tp_state == ISOTP_WAIT_FIRST_FC) {
+    session.blocksize    = pci[1];
+    session.min_sep_time = fix_sep_time(pci[2]);
   }
 
+  const uint32_t rx_us = frame_time_us(frame);
+  record_latency(session, &TransferStatsEntry::fc_wait, session.fc_wait_us, rx_us);
+
   log_print("FC frame: FS %d, Blocksize %d, Min. separation Time %d\n",
-            rxFrame.data[0] & 0x0F,
-            msg.blocksize,
-            msg.min_sep_time);
+            pci[0] & 0x0F,
+            session.blocksize,
+            session.min_sep_time);
 
-  switch (rxFrame.data[0] & 0x0F) {
+  switch (pci[0] & 0x0F) {
     case ISOTP_FC_CTS:
-      msg.tp_state = ISOTP_SEND_CF;
+      session.tp_state       = ISOTP_SEND_CF;
+      session.bs_count       = 0;
+      session.fc_wait_frames = 0;
+      session.timer_active   = false;
+      session.wait_tx_done   = false;
+      session.next_cf_us     = TxPacer::now_us();
       break;
 
     case ISOTP_FC_WT:
-      fc_wait_frames++;
-      if (fc_wait_frames >= MAX_FCWAIT_FRAME) {
-        log_print("FC wait frames exceeded.\n");
-        fc_wait_frames = 0;
+      session.fc_wait_frames++;
+      if (session.fc_wait_frames > session.fc_params.wft_max) {
+        ESP_LOGW(TAG, "FC wait frames exceeded");
+        complete(session, Result::WFT_OVERRUN);
+        return;
       }
       log_print("Start waiting for next FC\n");
+      session.fc_wait_us = rx_us;
+      arm_timer(session, TIMEOUT_FC, rx_us);
       break;
 
     case ISOTP_FC_OVFLW:
       ESP_LOGW(TAG, "Overflow in receiver side");
-      // fall through
+      complete(session, Result::OVERFLOW);
+      break;
+
     default:
-      return false;
+      ESP_LOGW(TAG, "Invalid flow status %d", pci[0] & 0x0F);
+      complete(session, Result::INVALID_FS);
+      break;
   }
-  return true;
 }
 
-bool IsoTp::send(Message& msg) {
-  if ((msg.len > 4095) || ((msg.len > 0) && (msg.data == nullptr))) {
-    return false;
+uint32_t IsoTp::tx_in_flight() {
+  const uint32_t done = _subscriber.GetTxDoneCount();
+  // Завершения кадров других отправителей не должны уводить счетчик в минус
+  if (static_cast<int32_t>(_tx_queued - done) < 0) {
+    _tx_queued = done;
   }
+  return _tx_queued - done;
+}
 
-  Message_t internalMsg;
-  internalMsg.tx_id  = msg.tx_id;
-  internalMsg.rx_id  = msg.rx_id;
-  internalMsg.len    = msg.len;
-  internalMsg.buffer = msg.data;
-
-  // Initialize other fields with default values
-  internalMsg.tp_state     = ISOTP_SEND;
-  internalMsg.fc_status    = ISOTP_FC_CTS;
-  internalMsg.seq_id       = 1;
-  internalMsg.blocksize    = 0;
-  internalMsg.min_sep_time = 0;
-
-  uint32_t wait_fc = 0;
-
-  while (true) {
-    log_print("\tISO-TP State: %s\n", isotp_state_to_string(internalMsg.tp_state));
-
-    switch (internalMsg.tp_state) {
-      case ISOTP_SEND:
-        if (internalMsg.len <= 7) {
-          log_print("Send SF\n");
-          send_sf(internalMsg);
-          return true;
-        }
-
-        log_print("Send FF\n");
-        send_ff(internalMsg);
-        internalMsg.seq_id = 1;
-        internalMsg.buffer += 6;
-        internalMsg.len -= 6;
-        internalMsg.tp_state = ISOTP_WAIT_FIRST_FC;
-        fc_wait_frames       = 0;
-        wait_fc              = millis();
-        break;
-
-      case ISOTP_WAIT_FC:
-      case ISOTP_WAIT_FIRST_FC: {
-        if (can_receive() && (rxFrame.id == internalMsg.rx_id)) {
-          if (!rcv_fc(internalMsg)) {
-            return false;
-          }
-        }
-
-        const uint32_t delta = millis() - wait_fc;
-        if (delta >= TIMEOUT_FC) {
-          ESP_LOGW(TAG, "FC timeout during receive wait_fc=%u delta=%u", wait_fc, delta);
-          return false;
-        }
-      } break;
-
-      case ISOTP_SEND_CF:
-        if (internalMsg.len > 7) {
-          fc_delay(internalMsg.min_sep_time);
-          send_cf(internalMsg);
-          log_print("Send Seq %d\n", internalMsg.seq_id);
-          if (internalMsg.blocksize > 0) {
-            log_print("Blocksize trigger %d\n", internalMsg.seq_id % internalMsg.blocksize);
-            if (!(internalMsg.seq_id % internalMsg.blocksize)) {
-              internalMsg.tp_state = ISOTP_WAIT_FC;
-              wait_fc              = millis();
-            }
-          }
-          internalMsg.seq_id++;
-          if (internalMsg.blocksize < 16) {
-            internalMsg.seq_id %= 16;
-          } else {
-            internalMsg.seq_id %= internalMsg.blocksize;
-          }
-          internalMsg.buffer += 7;
-          internalMsg.len -= 7;
-          log_print("Length      : %d\n", internalMsg.len);
-        } else {
-          fc_delay(internalMsg.min_sep_time);
-          log_print("Send last Seq %d\n", internalMsg.seq_id);
-          send_cf(internalMsg);
-          return true;
-        }
-        break;
-
-      case ISOTP_IDLE:  //??????????????????????????????????????????????????
-      case ISOTP_SEND_FF:
-      case ISOTP_WAIT_DATA:
-      case ISOTP_FINISHED:
-      default:
-        break;
+void IsoTp::sync_bus_off() {
+  const uint32_t bus_off = _subscriber.GetBusOffCount();
+  if (bus_off == _bus_off_seen) {
+    return;
+  }
+  _bus_off_seen = bus_off;
+
+  // Драйвер сбросил очередь передачи: завершений этих кадров не будет
+  _tx_queued = _subscriber.GetTxDoneCount();
+  for (Session& session : _sessions) {
+    if (session.tp_state == ISOTP_SEND_CF) {
+      ESP_LOGW(TAG,
+               "Bus-off tx=%" PRIX32 " at %u/%u bytes",
+               session.tx_id,
+               static_cast<unsigned>(session.offset),
+               static_cast<unsigned>(session.len));
+      complete(session, Result::TIMEOUT_TX);
     }
   }
-  return false;
 }
 
-bool IsoTp::receive(Message& msg, size_t size_buffer) {
+void IsoTp::wait_tx_done(Session& session) {
+  session.wait_tx_done = true;
+  if (!session.timer_active) {
+    arm_timer(session, TIMEOUT_TX);
+  }
+}
+
+void IsoTp::wake_task(void* ctx) {
+  static_cast<TwaiSubscriberIsoTp*>(ctx)->Wake();
+}
+
+void IsoTp::transmit_due_cf(Session& session, uint32_t now_us) {
+  while (session.tp_state == ISOTP_SEND_CF) {
+    // При STmin > 0 в полете не больше одного CF: пауза отсчитывается от его фактической отправки
+    const uint32_t window = (session.min_sep_time == 0) ? TX_WINDOW : 1;
+    if (tx_in_flight() >= window) {
+      _subscriber.RequestTxDoneWakeup();
+      // Передача могла завершиться до запроса пробуждения
+      if (tx_in_flight() >= window) {
+        wait_tx_done(session);
+        return;
+      }
+    }
+
+    if (session.min_sep_time != 0 && session.offset > ff_payload(session)) {
+      const uint32_t after_tx_done = _subscriber.GetLastTxDoneUs() + sep_time_to_us(session.min_sep_time);
+      if (!time_reached(session.next_cf_us, after_tx_done)) {
+        session.next_cf_us = after_tx_done;
+      }
+    }
+    if (!time_reached(now_us, session.next_cf_us)) {
+      _pacer.schedule(session.next_cf_us);
+      return;
+    }
+
+    const size_t sent = send_cf(session, cf_burst(session, window));
+    if (sent == 0) {
+      // Очередь драйвера заполнена: ее освобождение даст событие завершения передачи
+      _subscriber.RequestTxDoneWakeup();
+      wait_tx_done(session);
+      return;
+    }
+    session.wait_tx_done = false;
+    session.timer_active = false;
+
+    for (size_t i = 0; i < sent; i++) {
+      log_print("Send Seq %d\n", session.seq_id);
+      session.offset += std::min(session.len - session.offset, cf_payload(session));
+      session.seq_id = (session.seq_id + 1) & 0x0F;
+
+      if (session.offset >= session.len) {
+        complete(session, Result::OK);
+        return;
+      }
+
+      if (session.blocksize > 0 && ++session.bs_count >= session.blocksize) {
+        log_print("Block of %d CF sent, waiting FC\n", session.blocksize);
+        session.tp_state   = ISOTP_WAIT_FC;
+        session.fc_wait_us = now_us;
+        arm_timer(session, TIMEOUT_FC);
+        return;
+      }
+    }
+
+    session.next_cf_us = now_us + sep_time_to_us(session.min_sep_time);
+  }
+}
+
+size_t IsoTp::cf_burst(const Session& session, uint32_t window) {
+  // При STmin > 0 CF уходят по одному с паузой
+  if (session.min_sep_time != 0) {
+    return 1;
+  }
+  const size_t payload = cf_payload(session);
+  size_t count         = (session.len - session.offset + payload - 1) / payload;
+  if (session.blocksize > 0) {
+    count = std::min<size_t>(count, session.blocksize - session.bs_count);
+  }
+  const uint32_t in_flight = tx_in_flight();
+  return std::min<size_t>(count, (window > in_flight) ? window - in_flight : 1);
+}
+
+size_t IsoTp::session_index(const Session& session) const {
+  return static_cast<size_t>(&session - _sessions);
+}
+
+void IsoTp::arm_assembly(Session& session) {
+  // Потоковый прием идет через очередь: consumer вызывается только из задачи
+  if (session.assembly_armed || session.tp_state != ISOTP_WAIT_DATA || session.consumer != nullptr) {
+    return;
+  }
+
+  TwaiSubscriberIsoTp::RxAssembly assembly;
+  assembly.id            = session.rx_id;
+  assembly.is_extended   = session.is_extended;
+  assembly.pci_offset    = session.pci_offset;
+  assembly.rx_address    = session.rx_address;
+  assembly.buffer        = session.buffer;
+  assembly.len           = session.len;
+  assembly.max_len       = session.max_len;
+  assembly.offset        = session.offset;
+  assembly.seq_id        = session.seq_id;
+  assembly.blocksize     = session.fc_params.blocksize;
+  assembly.bs_count      = session.bs_count;
+  assembly.last_cf_us    = TxPacer::now_us();
+  session.assembly_armed = _subscriber.ArmAssembly(session_index(session), assembly);
+}
+
+void IsoTp::sync_assembly(Session& session) {
+  if (!session.assembly_armed) {
+    return;
+  }
+  session.assembly_armed = false;
+
+  TwaiSubscriberIsoTp::RxAssembly assembly;
+  if (!_subscriber.TakeAssembly(session_index(session), assembly)) {
+    return;
+  }
+
+  // N_Cr отсчитывается от последнего CF, собранного в прерывании
+  if (assembly.offset != session.offset) {
+    arm_timer(session, TIMEOUT_CF, assembly.last_cf_us);
+  }
+  session.offset    = assembly.offset;
+  session.seq_id    = assembly.seq_id;
+  session.bs_count  = assembly.bs_count;
+  session.truncated = session.truncated || assembly.truncated;
+
+  if (assembly.duplicates > 0) {
+    TransferStatsEntry* const stats = stats_entry(session);
+    if (stats != nullptr) {
+      stats->duplicates += assembly.duplicates;
+    }
+  }
+
+  switch (assembly.event) {
+    case TwaiSubscriberIsoTp::AssemblyEvent::COMPLETE:
+      complete(session, Result::OK);
+      break;
+
+    case TwaiSubscriberIsoTp::AssemblyEvent::WRONG_SN:
+      ESP_LOGW(TAG,
+               "Missing CF detected rx=%" PRIX32 " at %u/%u bytes",
+               session.rx_id,
+               static_cast<unsigned>(session.offset),
+               static_cast<unsigned>(session.len));
+      complete(session, Result::WRONG_SN);
+      break;
+
+    case TwaiSubscriberIsoTp::AssemblyEvent::BLOCK_END:
+      log_print("Block of %d CF received, send FC\n", session.fc_params.blocksize);
+      arm_timer(session, TIMEOUT_CF);
+      send_fc(session, ISOTP_FC_CTS, session.fc_params.blocksize, session.fc_params.min_sep_time);
+      break;
+
+    case TwaiSubscriberIsoTp::AssemblyEvent::NONE:
+      break;
+  }
+}
+
+void IsoTp::arm_timer(Session& session, uint32_t timeout_ms) {
+  session.timer_active = true;
+  session.deadline_ms  = millis() + timeout_ms;
+}
+
+void IsoTp::arm_timer(Session& session, uint32_t timeout_ms, uint32_t since_us) {
+  // Кадр мог ждать в очереди подписчика: таймаут отсчитывается от момента приема
+  const int32_t elapsed_us  = static_cast<int32_t>(TxPacer::now_us() - since_us);
+  const uint32_t elapsed_ms = (elapsed_us > 0) ? static_cast<uint32_t>(elapsed_us) / 1000 : 0;
+  arm_timer(session, (elapsed_ms < timeout_ms) ? timeout_ms - elapsed_ms : 0);
+}
+
+uint32_t IsoTp::frame_time_us(const TwaiFrame& frame) {
+  return (frame.timestamp_us != 0) ? frame.timestamp_us : TxPacer::now_us();
+}
+
+void IsoTp::complete(Session& session, Result result) {
+  Completion completion;
+  completion.tx_id   = session.tx_id;
+  completion.rx_id   = session.rx_id;
+  completion.len     = session.len;
+  completion.result  = result;
+  completion.is_send = (session.tp_state == ISOTP_SEND_CF) || (session.tp_state == ISOTP_WAIT_FIRST_FC) ||
+                       (session.tp_state == ISOTP_WAIT_FC) || (session.tp_state == ISOTP_IDLE);
+
+  // Ответ датируется моментом приема первого кадра, а не завершения сборки
+  completion.timestamp_us = session.rx_us;
+
+  record_completion(session, result);
+
+  if (session.assembly_armed) {
+    TwaiSubscriberIsoTp::RxAssembly discarded;
+    _subscriber.TakeAssembly(session_index(session), discarded);
+  }
+
+  // Подстройка FC приемника по результату многокадрового приема
+  if (session.tp_state == ISOTP_WAIT_DATA) {
+    if (result == Result::OK) {
+      _fc_tuner.on_success(session.rx_id);
+    } else if (result == Result::WRONG_SN || result == Result::TIMEOUT_CF) {
+      _fc_tuner.on_error(session.rx_id);
+      ESP_LOGW(TAG,
+               "rx=%" PRIX32 " FC tuned to BS %d, STmin 0x%02X",
+               session.rx_id,
+               _fc_tuner.params(session.rx_id).blocksize,
+               _fc_tuner.params(session.rx_id).min_sep_time);
+    }
+  }
+
+  const CompletionCallback callback = session.callback;
+  void* const ctx                   = session.ctx;
+
+  // Сессия освобождается до вызова обработчика, чтобы он мог запустить следующую транзакцию
+  session          = Session();
+  session.tp_state = ISOTP_IDLE;
+
+  log_print("ISO-TP transaction %" PRIX32 "/%" PRIX32 " finished: %d\n",
+            completion.tx_id,
+            completion.rx_id,
+            static_cast<int>(result));
+
+  if (callback != nullptr) {
+    callback(completion, ctx);
+  }
+}
+
+IsoTp::Session* IsoTp::find_session(uint32_t rx_id, bool is_extended, uint8_t rx_address) {
+  for (Session& session : _sessions) {
+    if (session.tp_state != ISOTP_IDLE && session.rx_id == rx_id && session.is_extended == is_extended &&
+        (session.pci_offset == 0 || session.rx_address == rx_address)) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+const IsoTp::Session* IsoTp::find_session(uint32_t tx_id, uint32_t rx_id) const {
+  for (const Session& session : _sessions) {
+    if (session.tp_state != ISOTP_IDLE && session.tx_id == tx_id && session.rx_id == rx_id) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+IsoTp::Session* IsoTp::allocate_session(const Message& msg) {
+  // Входящие кадры различаются по rx_id и, для расширенной/смешанной адресации, по байту адреса
+  if (find_session(msg.rx_id, is_29bit_id(msg), msg.rx_address) != nullptr) {
+    ESP_LOGW(TAG, "Session for rx=%" PRIX32 " is busy", msg.rx_id);
+    return nullptr;
+  }
+  for (Session& session : _sessions) {
+    if (session.tp_state == ISOTP_IDLE) {
+      session             = Session();
+      session.tx_id       = msg.tx_id;
+      session.rx_id       = msg.rx_id;
+      session.is_extended = is_29bit_id(msg);
+      session.pci_offset  = pci_offset(msg.addressing);
+      session.tx_address  = msg.tx_address;
+      session.rx_address  = msg.rx_address;
+      session.fc_params   = _fc_tuner.params(msg.rx_id);
+      return &session;
+    }
+  }
+  ESP_LOGW(TAG, "No free ISO-TP session (max %u)", static_cast<unsigned>(MAX_SESSIONS));
+  return nullptr;
+}
+
+bool IsoTp::start_send(const Message& msg, CompletionCallback callback, void* ctx) {
+  if ((msg.len > max_message_len()) || ((msg.len > 0) && (msg.data == nullptr))) {
+    return false;
+  }
+
+  Session* const slot = allocate_session(msg);
+  if (slot == nullptr) {
+    return false;
+  }
+
+  Session& session = *slot;
+  session.len      = msg.len;
+  session.buffer   = msg.data;
+  session.callback = callback;
+  session.ctx      = ctx;
+
+  if (session.len <= sf_payload(session.pci_offset)) {
+    log_print("Send SF\n");
+    const bool sent = send_sf(session);
+    complete(session, sent ? Result::OK : Result::TX_FAILED);
+    return sent;
+  }
+
+  log_print("Send FF\n");
+  if (!send_ff(session)) {
+    // Без FF получатель не ответит FC: не ждем TIMEOUT_FC
+    complete(session, Result::TX_FAILED);
+    return false;
+  }
+  session.ff_us          = TxPacer::now_us();
+  session.fc_wait_us     = session.ff_us;
+  session.offset         = ff_payload(session);
+  session.seq_id         = 1;
+  session.fc_wait_frames = 0;
+  session.tp_state       = ISOTP_WAIT_FIRST_FC;
+  arm_timer(session, TIMEOUT_FC);
+  return true;
+}
+
+bool IsoTp::start_receive(const Message& msg, size_t size_buffer, CompletionCallback callback, void* ctx) {
   if (msg.data == nullptr || size_buffer == 0) {
     return false;
   }
 
-  // Create internal Message_t structure
-  Message_t internalMsg;
-  internalMsg.tx_id   = msg.tx_id;
-  internalMsg.rx_id   = msg.rx_id;
-  internalMsg.len     = 0;  // Will be set during reception
-  internalMsg.max_len = size_buffer;
-  internalMsg.buffer  = msg.data;
-  // Initialize other fields with default values
-  internalMsg.tp_state     = ISOTP_IDLE;
-  internalMsg.fc_status    = ISOTP_FC_CTS;
-  internalMsg.seq_id       = 1;
-  internalMsg.blocksize    = 0;
-  internalMsg.min_sep_time = 0;
-
-  uint8_t n_pci_type = 0;
-  uint32_t delta     = 0;
-
-  wait_session = millis();
-  log_print("Start receive...\n");
-
-  while (internalMsg.tp_state != ISOTP_FINISHED) {
-    delta = millis() - wait_session;
-    if (delta >= TIMEOUT_SESSION) {
-      ESP_LOGW(TAG, "ISO-TP Session timeout wait_session=%u delta=%u", wait_session, delta);
-      return false;
+  Session* const slot = allocate_session(msg);
+  if (slot == nullptr) {
+    return false;
+  }
+
+  Session& session = *slot;
+  session.buffer   = msg.data;
+  session.max_len  = size_buffer;
+  session.callback = callback;
+  session.ctx      = ctx;
+  session.tp_state = ISOTP_WAIT_RESPONSE;
+  session.start_us = TxPacer::now_us();
+  arm_timer(session, TIMEOUT_SESSION);
+
+  log_print("Start receive rx=%" PRIX32 "...\n", session.rx_id);
+  return true;
+}
+
+bool IsoTp::start_receive_stream(
+    const Message& msg, StreamConsumer consumer, void* consumer_ctx, CompletionCallback callback, void* ctx) {
+  if (consumer == nullptr) {
+    return false;
+  }
+
+  Session* const slot = allocate_session(msg);
+  if (slot == nullptr) {
+    return false;
+  }
+
+  Session& session     = *slot;
+  session.consumer     = consumer;
+  session.consumer_ctx = consumer_ctx;
+  session.callback     = callback;
+  session.ctx          = ctx;
+  session.tp_state     = ISOTP_WAIT_RESPONSE;
+  session.start_us     = TxPacer::now_us();
+  arm_timer(session, TIMEOUT_SESSION);
+
+  log_print("Start stream receive rx=%" PRIX32 "...\n", session.rx_id);
+  return true;
+}
+
+void IsoTp::on_frame(const TwaiFrame& frame) {
+  log_print_buffer(frame.id, frame.data, frame.data_length);
+
+  if (frame.data_length == 0 || frame.data_length > CAN_FD_MAX_DLEN) {
+    return;
+  }
+  Session* slot = find_session(frame.id, frame.is_extended, frame.data[0]);
+  if (slot != nullptr && slot->assembly_armed) {
+    // CF, собранные прерыванием, приняты раньше этого кадра
+    sync_assembly(*slot);
+    slot = find_session(frame.id, frame.is_extended, frame.data[0]);
+  }
+  if (slot == nullptr) {
+    return;
+  }
+
+  Session& session = *slot;
+  log_print("ISO-TP state: %s\n", isotp_state_to_string(session.tp_state));
+
+  if (frame.data_length <= session.pci_offset) {
+    return;
+  }
+  const uint8_t n_pci  = frame.data[session.pci_offset];
+  const bool receiving = (session.tp_state == ISOTP_WAIT_RESPONSE) || (session.tp_state == ISOTP_WAIT_DATA);
+
+  switch (n_pci & 0xF0) {
+    case N_PCI_FC:
+      rcv_fc(session, frame);
+      break;
+
+    case N_PCI_SF:
+      if (receiving) {
+        rcv_sf(session, frame);
+      }
+      break;
+
+    case N_PCI_FF:
+      if (receiving) {
+        rcv_ff(session, frame);
+      }
+      break;
+
+    case N_PCI_CF:
+      rcv_cf(session, frame);
+      break;
+
+    default:
+      log_print("Unknown N_PCI type 0x%02X ignored\n", n_pci & 0xF0);
+      break;
+  }
+
+  arm_assembly(session);
+}
+
+void IsoTp::poll_session(Session& session, uint32_t now_ms) {
+  const bool timer_expired = session.timer_active && time_reached(now_ms, session.deadline_ms);
+  if (session.assembly_armed && (timer_expired || _subscriber.HasAssemblyEvent(session_index(session)))) {
+    sync_assembly(session);
+    if (session.tp_state == ISOTP_IDLE) {
+      return;
     }
+  }
+
+  transmit_due_cf(session, TxPacer::now_us());
 
-    if (can_receive()) {
-      if (rxFrame.id == internalMsg.rx_id) {
-        log_print("rxId OK!\n");
-        n_pci_type = rxFrame.data[0] & 0xF0;
-
-        switch (n_pci_type) {
-          case N_PCI_FC:
-            log_print("FC\n");  // flow control frame
-            rcv_fc(internalMsg);
-            break;
-
-          case N_PCI_SF:
-            log_print("SF\n");    // single frame
-            rcv_sf(internalMsg);  // internalMsg.tp_state=ISOTP_FINISHED;
-            break;
-
-          case N_PCI_FF:
-            log_print("FF\n");    // first frame
-            rcv_ff(internalMsg);  // internalMsg.tp_state=ISOTP_WAIT_DATA;
-            break;
-
-          case N_PCI_CF:
-            log_print("CF\n");  // consecutive frame
-            rcv_cf(internalMsg);
-            break;
-        }
+  if (!session.timer_active || !time_reached(now_ms, session.deadline_ms)) {
+    return;
+  }
+
+  switch (session.tp_state) {
+    case ISOTP_WAIT_FIRST_FC:
+    case ISOTP_WAIT_FC:
+      ESP_LOGW(TAG, "FC timeout (N_Bs) tx=%" PRIX32 " rx=%" PRIX32, session.tx_id, session.rx_id);
+      complete(session, Result::TIMEOUT_FC);
+      break;
+
+    case ISOTP_WAIT_DATA:
+      ESP_LOGW(TAG,
+               "CF timeout (N_Cr) rx=%" PRIX32 " at %u/%u bytes",
+               session.rx_id,
+               static_cast<unsigned>(session.offset),
+               static_cast<unsigned>(session.len));
+      complete(session, Result::TIMEOUT_CF);
+      break;
+
+    case ISOTP_WAIT_RESPONSE:
+      if (session.functional) {
+        log_print("Functional window closed, no response from rx=%" PRIX32 "\n", session.rx_id);
+      } else {
+        ESP_LOGW(TAG, "ISO-TP Session timeout rx=%" PRIX32, session.rx_id);
       }
+      complete(session, Result::TIMEOUT_SESSION);
+      break;
+
+    case ISOTP_SEND_CF:
+      ESP_LOGW(TAG,
+               "TX timeout (N_As) tx=%" PRIX32 " at %u/%u bytes",
+               session.tx_id,
+               static_cast<unsigned>(session.offset),
+               static_cast<unsigned>(session.len));
+      complete(session, Result::TIMEOUT_TX);
+      break;
+
+    default:
+      session.timer_active = false;
+      break;
+  }
+}
+
+void IsoTp::poll(uint32_t now_ms) {
+  sync_bus_off();
+  for (Session& session : _sessions) {
+    if (session.tp_state != ISOTP_IDLE) {
+      poll_session(session, now_ms);
+      arm_assembly(session);
     }
   }
+}
 
-  // Copy received data back to the external message structure
-  msg.tx_id = internalMsg.tx_id;
-  msg.rx_id = internalMsg.rx_id;
-  msg.len   = internalMsg.len;
-  // Note: msg.data points to the same buffer as internalMsg.buffer, so data is already there
+uint32_t IsoTp::next_timeout(uint32_t now_ms) const {
+  uint32_t timeout      = NO_DEADLINE;
+  const uint32_t now_us = TxPacer::now_us();
+
+  for (const Session& session : _sessions) {
+    // Точно к дедлайну CF задачу будит TxPacer, здесь - страховка с округлением вверх
+    if (session.tp_state == ISOTP_SEND_CF && !session.wait_tx_done) {
+      const uint32_t cf_us = time_reached(now_us, session.next_cf_us) ? 0 : session.next_cf_us - now_us;
+      timeout              = std::min(timeout, (cf_us + 999) / 1000);
+    }
+    if (session.tp_state != ISOTP_IDLE && session.timer_active) {
+      const uint32_t timer = time_reached(now_ms, session.deadline_ms) ? 0 : session.deadline_ms - now_ms;
+      timeout              = std::min(timeout, timer);
+    }
+  }
+  return timeout;
+}
+
+void IsoTp::process(uint32_t max_wait_ms) {
+  const uint32_t wait_ms = std::min(max_wait_ms, next_timeout(millis()));
+
+  TwaiFrame frame;
+  // Округление вверх: нельзя проснуться раньше дедлайна и уйти в холостой цикл
+  const TickType_t wait_ticks =
+      (wait_ms == NO_DEADLINE) ? portMAX_DELAY : (wait_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS;
+  if (_subscriber.Receive(frame, wait_ticks)) {
+    on_frame(frame);
+  }
+  poll(millis());
+}
+
+void IsoTp::abort() {
+  for (Session& session : _sessions) {
+    if (session.tp_state != ISOTP_IDLE) {
+      complete(session, Result::ABORTED);
+    }
+  }
+}
+
+void IsoTp::abort(uint32_t tx_id, uint32_t rx_id) {
+  for (Session& session : _sessions) {
+    if (session.tp_state != ISOTP_IDLE && session.tx_id == tx_id && session.rx_id == rx_id) {
+      complete(session, Result::ABORTED);
+    }
+  }
+}
+
+bool IsoTp::is_busy() const {
+  for (const Session& session : _sessions) {
+    if (session.tp_state != ISOTP_IDLE) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool IsoTp::is_busy(uint32_t tx_id, uint32_t rx_id) const {
+  return find_session(tx_id, rx_id) != nullptr;
+}
+
+bool IsoTp::configure_flow_control(uint32_t rx_id, const FlowControlParams& params, bool adaptive) {
+  return _fc_tuner.configure(rx_id, params, adaptive);
+}
+
+FlowControlParams IsoTp::flow_control(uint32_t rx_id) const {
+  return _fc_tuner.params(rx_id);
+}
+
+const TransferStats& IsoTp::transfer_stats() const {
+  return _stats;
+}
+
+void IsoTp::reset_transfer_stats() {
+  _stats.reset();
+}
+
+bool IsoTp::add_rx_filter(uint32_t id, uint32_t mask, bool is_extended) {
+  if (!_subscriber.AddRxFilter(id, mask, is_extended)) {
+    return false;
+  }
+  // Повторная регистрация перестраивает таблицу маршрутизации драйвера
+  _bus.RegisterSubscriber(_subscriber);
+  return true;
+}
+
+TransferStatsEntry* IsoTp::stats_entry(const Session& session) {
+  return _stats.acquire(session.tx_id, session.rx_id);
+}
+
+void IsoTp::record_latency(const Session& session,
+                           LatencyHistogram TransferStatsEntry::*histogram,
+                           uint32_t since_us,
+                           uint32_t until_us) {
+  TransferStatsEntry* const stats = stats_entry(session);
+  if (stats != nullptr) {
+    (stats->*histogram).add(until_us - since_us);
+  }
+}
+
+void IsoTp::record_completion(const Session& session, Result result) {
+  TransferStatsEntry* const stats = stats_entry(session);
+  if (stats == nullptr) {
+    return;
+  }
+  if (session.truncated) {
+    stats->truncations++;
+  }
+
+  switch (result) {
+    case Result::OK:
+      if (session.tp_state == ISOTP_SEND_CF || session.tp_state == ISOTP_IDLE) {
+        stats->sent_ok++;
+      } else {
+        stats->received_ok++;
+      }
+      // Многокадровая передача: от FF до последнего CF
+      if (session.tp_state == ISOTP_SEND_CF || session.tp_state == ISOTP_WAIT_DATA) {
+        stats->transfer.add(TxPacer::now_us() - session.ff_us);
+      }
+      break;
+    case Result::TIMEOUT_SESSION:
+      // На функциональный запрос отвечают не все ЭБУ: закрытие окна сбора не таймаут
+      if (!session.functional) {
+        stats->timeout_session++;
+      }
+      break;
+    case Result::TIMEOUT_FC:
+      stats->timeout_fc++;
+      break;
+    case Result::TIMEOUT_CF:
+      stats->timeout_cf++;
+      break;
+    case Result::TIMEOUT_TX:
+      stats->timeout_tx++;
+      break;
+    case Result::WRONG_SN:
+      stats->wrong_sn++;
+      break;
+    case Result::OVERFLOW:
+      stats->overflow++;
+      break;
+    case Result::WFT_OVERRUN:
+      stats->wft_overrun++;
+      break;
+    case Result::INVALID_FS:
+      stats->invalid_fs++;
+      break;
+    case Result::ABORTED:
+      stats->aborted++;
+      break;
+    case Result::TX_FAILED:
+      stats->tx_failed++;
+      break;
+  }
+}
+
+bool IsoTp::wait_completion(Session& session, Completion& completion) {
+  struct Waiter {
+    bool done = false;
+    Completion completion;
+  } waiter;
+
+  session.callback = [](const Completion& result, void* ctx) {
+    auto* w       = static_cast<Waiter*>(ctx);
+    w->done       = true;
+    w->completion = result;
+  };
+  session.ctx = &waiter;
+
+  // Остальные сессии продолжают обрабатываться в process()
+  while (!waiter.done) {
+    process(NO_DEADLINE);
+  }
+
+  completion = waiter.completion;
+  return completion.result == Result::OK;
+}
+
+bool IsoTp::send(Message& msg) {
+  if ((msg.len > max_message_len()) || ((msg.len > 0) && (msg.data == nullptr))) {
+    return false;
+  }
+  // SF отправляется сразу, ожидать нечего
+  if (msg.len <= sf_payload(pci_offset(msg.addressing))) {
+    return start_send(msg);
+  }
+  if (!start_send(msg)) {
+    return false;
+  }
+
+  Completion completion;
+  return wait_completion(*find_session(msg.rx_id, is_29bit_id(msg), msg.rx_address), completion);
+}
+
+bool IsoTp::receive(Message& msg, size_t size_buffer) {
+  if (!start_receive(msg, size_buffer)) {
+    return false;
+  }
+
+  Completion completion;
+  if (!wait_completion(*find_session(msg.rx_id, is_29bit_id(msg), msg.rx_address), completion)) {
+    return false;
+  }
+
+  msg.tx_id        = completion.tx_id;
+  msg.rx_id        = completion.rx_id;
+  msg.len          = completion.len;
+  msg.timestamp_us = completion.timestamp_us;
+  // Note: msg.data points to the same buffer as the session, so data is already there
 
   log_print("ISO-TP message received:\n");
-  log_print_buffer(internalMsg.rx_id, internalMsg.buffer, internalMsg.len);
+  log_print_buffer(msg.rx_id, msg.data, std::min(msg.len, size_buffer));
 
   return true;
 }
+
+bool IsoTp::receive_stream(Message& msg, StreamConsumer consumer, void* ctx) {
+  if (!start_receive_stream(msg, consumer, ctx)) {
+    return false;
+  }
+
+  Completion completion;
+  if (!wait_completion(*find_session(msg.rx_id, is_29bit_id(msg), msg.rx_address), completion)) {
+    return false;
+  }
+
+  msg.tx_id        = completion.tx_id;
+  msg.rx_id        = completion.rx_id;
+  msg.len          = completion.len;
+  msg.timestamp_us = completion.timestamp_us;
+  return true;
+}
+
+size_t IsoTp::send_functional(Message& msg, Span<FunctionalResponse> responses, uint32_t window_ms) {
+  // Функциональный запрос передается только одиночным кадром (ISO 15765-2)
+  if ((msg.len == 0) || (msg.data == nullptr) || (msg.len > sf_payload(pci_offset(msg.addressing)))) {
+    return 0;
+  }
+
+  struct Collector {
+    FunctionalResponse* response = nullptr;
+    Session* session             = nullptr;
+    bool done                    = false;
+  } collectors[MAX_SESSIONS];
+
+  const CompletionCallback on_response = [](const Completion& result, void* ctx) {
+    auto* collector                   = static_cast<Collector*>(ctx);
+    collector->done                   = true;
+    collector->response->len          = result.len;
+    collector->response->received     = (result.result == Result::OK);
+    collector->response->timestamp_us = result.timestamp_us;
+  };
+
+  // Сессии приема открываются до отправки, чтобы не потерять быстрый ответ
+  size_t pending = 0;
+  for (FunctionalResponse& response : responses) {
+    response.len          = 0;
+    response.received     = false;
+    response.timestamp_us = 0;
+
+    Message rx_msg = msg;
+    rx_msg.tx_id   = response.tx_id;
+    rx_msg.rx_id   = response.rx_id;
+    rx_msg.data    = response.data;
+
+    Session* slot = nullptr;
+    if ((pending < MAX_SESSIONS) && (response.data != nullptr) && (response.size > 0)) {
+      slot = allocate_session(rx_msg);
+    }
+    if (slot == nullptr) {
+      ESP_LOGW(TAG, "Functional response rx=%" PRIX32 " skipped", response.rx_id);
+      continue;
+    }
+
+    Collector& collector = collectors[pending++];
+    collector.response   = &response;
+    collector.session    = slot;
+
+    Session& session   = *slot;
+    session.buffer     = response.data;
+    session.max_len    = response.size;
+    session.callback   = on_response;
+    session.ctx        = &collector;
+    session.functional = true;
+    session.tp_state   = ISOTP_WAIT_RESPONSE;
+    session.start_us   = TxPacer::now_us();
+    arm_timer(session, window_ms);  // Окно сбора; FF переводит сессию на таймауты CF
+  }
+
+  // Запрос не занимает слот: SF завершается сразу после передачи
+  Session request;
+  request.tx_id       = msg.tx_id;
+  request.is_extended = is_29bit_id(msg);
+  request.pci_offset  = pci_offset(msg.addressing);
+  request.tx_address  = msg.tx_address;
+  request.len         = msg.len;
+  request.buffer      = msg.data;
+  log_print("Send functional SF to %" PRIX32 "\n", request.tx_id);
+  if (!send_sf(request)) {
+    // Запрос не ушел: ответов не будет, окно не ждем
+    for (size_t i = 0; i < pending; i++) {
+      complete(*collectors[i].session, Result::TX_FAILED);
+    }
+    return 0;
+  }
+
+  size_t received = 0;
+  for (size_t i = 0; i < pending; i++) {
+    while (!collectors[i].done) {
+      process(NO_DEADLINE);
+    }
+    if (collectors[i].response->received) {
+      received++;
+    }
+  }
+  return received;
+}
@@ -3,10 +3,41 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "flow_control_tuner.h"
 #include "iso_tp_interface.h"
 #include "phy_interface.h"
+#include "transfer_stats.h"
 #include "twai_subscriber_iso_tp.h"
+#include "tx_pacer.h"
 
+/**
+ * @brief Реализация ISO-TP (ISO 15765-2) в виде реактора
+ *
+ * Движок не блокируется сам по себе: передача продвигается вызовами
+ * on_frame() для каждого принятого кадра и poll() по истечении таймеров.
+ * О завершении транзакции сообщается через CompletionCallback.
+ *
+ * Блокирующие send()/receive() построены поверх движка: они ждут кадр
+ * ровно до ближайшего дедлайна, без периодических пробуждений.
+ *
+ * Одновременно может выполняться до MAX_SESSIONS транзакций с разными
+ * парами адресов (tx_id, rx_id), у каждой свои таймеры и состояние FC.
+ * На этом же построен функциональный запрос: ответы всех ЭБУ принимаются
+ * параллельными сессиями.
+ * Все методы вызываются из одной задачи.
+ *
+ * CF отправляются по микросекундным дедлайнам STmin (TxPacer будит задачу
+ * по esp_timer) и не более TX_WINDOW кадров в очереди драйвера: следующий
+ * CF уходит по событию завершения передачи, а не после задержки. При
+ * STmin = 0 свободная часть окна заполняется одной пачкой (TransmitBatch).
+ * Кадры помечаются классом приоритета передачи: FC - FLOW_CONTROL, CF -
+ * BULK, SF и FF - REQUEST, так что FC приема не ждет CF отправки.
+ *
+ * CF многокадрового приема в буфер собираются в прерывании подписчика
+ * (TwaiSubscriberIsoTp::RxAssembly): задача просыпается на FF, на конец
+ * блока и на завершение сообщения, а не на каждый CF. Потоковый прием
+ * идет по кадрам через очередь: consumer нельзя вызывать из прерывания.
+ */
 class IsoTp : public IIsoTp {
   // Single Frame       = SF
   // First Frame        = FF
@@ -15,38 +46,259 @@ class IsoTp : public IIsoTp {
  public:
   static const bool ISO_TP_DEBUG = false;
 
-  IsoTp(IPhyInterface &bus);
+  /**
+   * @brief Результат завершения транзакции
+   */
+  enum class Result : uint8_t {
+    OK = 0,
+    TIMEOUT_SESSION,  // Не получен SF/FF за TIMEOUT_SESSION
+    TIMEOUT_FC,       // N_Bs: не получен FC после FF или блока CF
+    TIMEOUT_CF,       // N_Cr: не получен очередной CF
+    WRONG_SN,         // Нарушена последовательность CF
+    OVERFLOW,         // Получатель ответил FC OVFLW
+    WFT_OVERRUN,      // Превышен лимит FC WAIT
+    INVALID_FS,       // Некорректный Flow Status
+    ABORTED,          // Транзакция прервана вызывающей стороной
+    TIMEOUT_TX,       // N_As: кадр не покинул контроллер (шина перегружена или bus-off)
+    TX_FAILED         // Драйвер не принял SF/FF (очередь полна, bus-off, listen-only)
+  };
+
+  /**
+   * @brief Информация о завершенной транзакции
+   */
+  struct Completion {
+    uint32_t tx_id        = 0;
+    uint32_t rx_id        = 0;
+    size_t len            = 0;  // Полная длина сообщения (может превышать размер буфера)
+    Result result         = Result::OK;
+    bool is_send          = false;
+    uint32_t timestamp_us = 0;  // Прием: время приема первого кадра (SF/FF), мкс
+  };
+
+  /**
+   * @brief Обработчик завершения транзакции
+   *
+   * Вызывается из контекста on_frame()/poll(). Внутри обработчика
+   * допускается запуск новой транзакции.
+   */
+  using CompletionCallback = void (*)(const Completion& completion, void* ctx);
+
+  /**
+   * @brief Формат кадров канального уровня (ISO 15765-2:2016)
+   *
+   * tx_dl > 8 включает CAN FD: SF до tx_dl - 2 байт (escape SF_DL), CF по
+   * tx_dl - 1 байт, сообщения длиннее 4095 байт (escape FF_DL). Кадры CAN FD
+   * длиннее 8 байт всегда дополняются до ближайшей допустимой длины.
+   * tx_dl > 8 требует сборки с TWAI_CAN_FD, иначе используется 8.
+   */
+  struct LinkConfig {
+    uint8_t tx_dl        = 8;      // Длина кадра: 8 - классический CAN, 12..64 - CAN FD
+    bool padding         = true;   // Дополнять короткие кадры до 8 байт (false - оптимизированный DLC)
+    uint8_t pad_byte     = 0x00;   // Байт заполнения (ISO 15765-2 рекомендует 0xCC, часто 0xAA)
+    bool bit_rate_switch = false;  // BRS для кадров CAN FD
+  };
+
+  /**
+   * @param consumer_task Задача, вызывающая process()/send()/receive(): ее будят
+   *                      принятые кадры (по умолчанию задача, создающая движок)
+   */
+  IsoTp(IPhyInterface &bus, TaskHandle_t consumer_task = xTaskGetCurrentTaskHandle());
+  IsoTp(IPhyInterface &bus, const LinkConfig &link, TaskHandle_t consumer_task = xTaskGetCurrentTaskHandle());
   ~IsoTp();
 
   bool send(Message &msg) override;
   bool receive(Message &msg, size_t size_buffer) override;
+  bool receive_stream(Message &msg, StreamConsumer consumer, void *ctx) override;
+  size_t send_functional(Message &msg, Span<FunctionalResponse> responses, uint32_t window_ms) override;
+
+  /**
+   * @brief Запуск неблокирующей отправки
+   * @param msg Сообщение; буфер должен оставаться валидным до завершения
+   * @param callback Обработчик завершения (может быть nullptr)
+   * @param ctx Пользовательский контекст обработчика
+   * @return false если параметры некорректны, движок занят или драйвер не принял
+   *         SF/FF (в последнем случае callback уже вызван с Result::TX_FAILED)
+   */
+  bool start_send(const Message &msg, CompletionCallback callback = nullptr, void *ctx = nullptr);
+
+  /**
+   * @brief Запуск неблокирующего приема
+   * @param msg Адреса и буфер приема; буфер должен оставаться валидным до завершения
+   * @param size_buffer Размер буфера приема
+   * @param callback Обработчик завершения (может быть nullptr)
+   * @param ctx Пользовательский контекст обработчика
+   * @return false если параметры некорректны или движок занят
+   */
+  bool start_receive(const Message &msg,
+                     size_t size_buffer,
+                     CompletionCallback callback = nullptr,
+                     void *ctx                   = nullptr);
+
+  /**
+   * @brief Запуск неблокирующего потокового приема
+   *
+   * Данные каждого кадра передаются в consumer без копирования, поэтому
+   * длина сообщения ограничена только ISO-TP (4095 байт).
+   *
+   * @param msg Адреса приема (msg.data не используется)
+   * @param consumer Обработчик фрагментов
+   * @param consumer_ctx Контекст обработчика фрагментов
+   * @param callback Обработчик завершения (может быть nullptr)
+   * @param ctx Пользовательский контекст обработчика завершения
+   * @return false если параметры некорректны или движок занят
+   */
+  bool start_receive_stream(const Message &msg,
+                            StreamConsumer consumer,
+                            void *consumer_ctx,
+                            CompletionCallback callback = nullptr,
+                            void *ctx                   = nullptr);
+
+  /**
+   * @brief Обработка принятого CAN кадра
+   */
+  void on_frame(const TwaiFrame &frame);
+
+  /**
+   * @brief Обработка таймеров: таймауты и отправка отложенных CF
+   *
+   * Дедлайны CF сверяются с микросекундными часами TxPacer::now_us().
+   *
+   * @param now_ms Текущее время в миллисекундах
+   */
+  void poll(uint32_t now_ms);
+
+  /**
+   * @brief Время до ближайшего дедлайна движка
+   * @param now_ms Текущее время в миллисекундах
+   * @return Миллисекунды до дедлайна или NO_DEADLINE, если активных таймеров нет
+   */
+  uint32_t next_timeout(uint32_t now_ms) const;
+
+  /**
+   * @brief Один шаг реактора: ожидание кадра не дольше ближайшего дедлайна
+   *
+   * Принимает не более одного кадра из очереди подписчика, передает его
+   * в on_frame() и вызывает poll().
+   *
+   * @param max_wait_ms Верхняя граница ожидания в миллисекундах
+   */
+  void process(uint32_t max_wait_ms);
+
+  /**
+   * @brief Прерывание всех транзакций с результатом ABORTED
+   */
+  void abort();
+
+  /**
+   * @brief Прерывание транзакции по паре адресов с результатом ABORTED
+   */
+  void abort(uint32_t tx_id, uint32_t rx_id);
+
+  bool is_busy() const;
+  bool is_busy(uint32_t tx_id, uint32_t rx_id) const;
+
+  /**
+   * @brief Базовые параметры FC приемника (BS, STmin) и лимит FC WAIT для ЭБУ
+   *
+   * Параметры копируются в сессию при ее запуске. При adaptive = true они
+   * подстраиваются по результатам многокадровых приемов от этого ЭБУ.
+   *
+   * @param rx_id CAN ID ответов ЭБУ
+   * @param params Базовые параметры
+   * @param adaptive Разрешить автоматическую подстройку
+   * @return false если таблица ЭБУ заполнена
+   */
+  bool configure_flow_control(uint32_t rx_id, const FlowControlParams &params, bool adaptive = true);
+
+  /**
+   * @brief Текущие (с учетом подстройки) параметры FC для ЭБУ
+   */
+  FlowControlParams flow_control(uint32_t rx_id) const;
+
+  /**
+   * @brief Статистика передач по парам адресов: счетчики ошибок и гистограммы задержек
+   *
+   * Строку для лога дает TransferStats::format(), все пары - transfer_stats().log().
+   */
+  const TransferStats &transfer_stats() const;
+
+  /**
+   * @brief Сброс статистики передач
+   */
+  void reset_transfer_stats();
+
+  /**
+   * @brief Фильтр принимаемых CAN ID: кадры других ID отбрасываются в прерывании
+   *
+   * Без фильтров в очередь задачи попадает весь трафик шины. Фильтры
+   * настраиваются до начала обмена, например 0x7E8/0x7F8 для ответов 7E8-7EF.
+   *
+   * @param id CAN ID ответов
+   * @param mask Значащие биты ID
+   * @param is_extended 29-битные CAN ID
+   * @return false если таблица фильтров заполнена
+   */
+  bool add_rx_filter(uint32_t id, uint32_t mask, bool is_extended = false);
+
+  static const uint32_t NO_DEADLINE = UINT32_MAX;
+
+  // Максимальное число одновременных сессий: ответы всех ЭБУ 7E8-7EF на запрос 0x7DF
+  static const size_t MAX_SESSIONS = 8;
 
  private:
   typedef enum {
     ISOTP_IDLE = 0,
-    ISOTP_SEND,
-    ISOTP_SEND_FF,
     ISOTP_SEND_CF,
     ISOTP_WAIT_FIRST_FC,
     ISOTP_WAIT_FC,
-    ISOTP_WAIT_DATA,
-    ISOTP_FINISHED
+    ISOTP_WAIT_RESPONSE,
+    ISOTP_WAIT_DATA
   } isotp_states_t;
 
-  struct Message_t {
+  struct Session {
     uint32_t tx_id          = 0;
     uint32_t rx_id          = 0;
-    uint8_t *buffer         = nullptr;
-    size_t len              = 0;
-    size_t max_len          = 0;
-    uint16_t seq_id         = 1;
-    uint8_t fc_status       = ISOTP_FC_CTS;
+    bool is_extended        = false;  // 29-битные CAN ID
+    uint8_t pci_offset      = 0;      // 1 для адресации EXTENDED/MIXED
+    uint8_t tx_address      = 0;
+    uint8_t rx_address      = 0;
+    uint8_t *buffer         = nullptr;  // Текущая позиция данных (отправка) или начало буфера (прием)
+    size_t len              = 0;        // Полная длина сообщения
+    size_t max_len          = 0;        // Размер буфера приема
+    size_t offset           = 0;        // Сколько байт уже передано/принято
+    uint8_t seq_id          = 1;
     uint8_t blocksize       = 0;
     uint8_t min_sep_time    = 0;
+    uint8_t bs_count        = 0;  // CF, отправленные/принятые в текущем блоке
+    uint8_t fc_wait_frames  = 0;
     isotp_states_t tp_state = ISOTP_IDLE;
+
+    bool timer_active    = false;
+    uint32_t deadline_ms = 0;      // Таймаут текущей фазы
+    uint32_t next_cf_us  = 0;      // Время отправки следующего CF в микросекундах
+    bool wait_tx_done    = false;  // Окно передачи занято, CF ждет завершения передачи
+
+    // Отметки времени для статистики, мкс
+    uint32_t start_us   = 0;      // Начало ожидания ответа
+    uint32_t ff_us      = 0;      // FF принят или отправлен
+    uint32_t fc_wait_us = 0;      // Начало ожидания FC
+    uint32_t rx_us      = 0;      // Прием первого кадра ответа (SF/FF)
+    bool truncated      = false;  // Ответ не поместился в буфер
+
+    bool assembly_armed = false;  // CF собирает прерывание подписчика
+    bool functional     = false;  // Сбор ответа на функциональный запрос: молчание ЭБУ - не ошибка
+
+    FlowControlParams fc_params;  // Параметры FC приемника и лимит FC WAIT
+
+    StreamConsumer consumer = nullptr;  // Потоковый прием вместо копирования в buffer
+    void *consumer_ctx      = nullptr;
+
+    CompletionCallback callback = nullptr;
+    void *ctx                   = nullptr;
   };
 
-  static const uint8_t CAN_MAX_DLEN = 8;  // Not extended CAN
+  static const uint8_t CAN_MAX_DLEN    = 8;                          // Classic CAN
+  static const uint8_t CAN_FD_MAX_DLEN = TwaiFrame::kMaxDataLength;  // CAN FD
 
   // Flow Status given in FC frame
   static const uint8_t ISOTP_FC_CTS   = 0;  // clear to send
@@ -57,7 +309,14 @@ class IsoTp : public IIsoTp {
   static const uint32_t TIMEOUT_SESSION = 2000;  // Timeout between successfull send and receive
   static const uint32_t TIMEOUT_FC      = 500;   // Timeout between FF and FC or Block CF and FC
   static const uint32_t TIMEOUT_CF      = 500;   // Timeout between CFs
-  static const uint8_t MAX_FCWAIT_FRAME = 10;
+  static const uint32_t TIMEOUT_TX      = 1000;  // N_As: frame did not leave the controller
+
+  // CF в очереди драйвера при STmin = 0: один передается, следующие ждут своей
+  // очереди, остальные места остаются для FC других сессий
+  static const uint32_t TX_WINDOW = 3;
+
+  static const size_t MAX_MESSAGE_LEN        = 4095;        // 12-bit FF_DL
+  static const size_t MAX_MESSAGE_LEN_ESCAPE = UINT32_MAX;  // 32-bit FF_DL (CAN FD)
 
   // N_PCI type values in bits 7-4 of N_PCI bytes
   static const uint8_t N_PCI_SF = 0x00;  // single frame
@@ -65,32 +324,85 @@ class IsoTp : public IIsoTp {
   static const uint8_t N_PCI_CF = 0x20;  // consecutive frame
   static const uint8_t N_PCI_FC = 0x30;  // flow control
 
+  // N_PCI size in bytes
+  static const uint8_t N_PCI_SF_SZ     = 1;
+  static const uint8_t N_PCI_SF_ESC_SZ = 2;  // CAN FD SF_DL escape
+  static const uint8_t N_PCI_FF_SZ     = 2;
+  static const uint8_t N_PCI_FF_ESC_SZ = 6;  // FF_DL escape
+  static const uint8_t N_PCI_CF_SZ     = 1;
+
   static const uint8_t FC_CONTENT_SZ = 3;  // flow control content size in byte (FS/BS/STmin)
 
   static const char *isotp_state_to_string(isotp_states_t state);
-  static void fc_delay(uint8_t sep_time);
+  static uint8_t fix_sep_time(uint8_t sep_time);
+  static uint32_t sep_time_to_us(uint8_t sep_time);
+  static bool is_valid_frame_length(uint8_t len);
+  static bool time_reached(uint32_t now, uint32_t deadline);
   static void log_print(const char *format, ...);
-  static void log_print_buffer(uint32_t id, uint8_t *buffer, uint16_t len);
+  static void log_print_buffer(uint32_t id, const uint8_t *buffer, uint16_t len);
 
-  void can_send(uint32_t id, uint8_t len, uint8_t *data);
-  bool can_receive();
+  static bool is_29bit_id(const Message &msg);
+  static uint8_t pci_offset(Addressing addressing);
 
-  void send_fc(const Message_t &msg);
-  void send_sf(const Message_t &msg);
-  void send_ff(const Message_t &msg);
-  void send_cf(const Message_t &msg);
+  uint8_t frame_length(size_t len) const;
+  size_t max_message_len() const;
+  size_t sf_payload(uint8_t pci_offset) const;
+  size_t ff_payload(const Session &session) const;
+  size_t cf_payload(const Session &session) const;
 
-  void rcv_sf(Message_t &msg);
-  void rcv_ff(Message_t &msg);
-  void rcv_cf(Message_t &msg);
-  bool rcv_fc(Message_t &msg);
+  void build_frame(
+      const Session &session, size_t len, const uint8_t *pci, TxPriority priority, TwaiFrame &message) const;
+  bool can_send(const Session &session, size_t len, const uint8_t *pci, TxPriority priority = TxPriority::REQUEST);
+
+  void send_fc(const Session &session, uint8_t fc_status, uint8_t blocksize, uint8_t min_sep_time);
+  bool send_sf(const Session &session);
+  bool send_ff(const Session &session);
+  size_t send_cf(const Session &session, size_t count);
+  size_t cf_burst(const Session &session, uint32_t window);
+
+  static void deliver(Session &session, size_t offset, const uint8_t *data, size_t len);
+
+  void rcv_sf(Session &session, const TwaiFrame &frame);
+  void rcv_ff(Session &session, const TwaiFrame &frame);
+  void rcv_cf(Session &session, const TwaiFrame &frame);
+  void rcv_fc(Session &session, const TwaiFrame &frame);
+
+  Session *find_session(uint32_t rx_id, bool is_extended, uint8_t rx_address);
+  const Session *find_session(uint32_t tx_id, uint32_t rx_id) const;
+  Session *allocate_session(const Message &msg);
+
+  uint32_t tx_in_flight();
+  void sync_bus_off();
+  void wait_tx_done(Session &session);
+  static void wake_task(void *ctx);
+
+  size_t session_index(const Session &session) const;
+  void arm_assembly(Session &session);
+  void sync_assembly(Session &session);
+
+  void transmit_due_cf(Session &session, uint32_t now_us);
+  void poll_session(Session &session, uint32_t now_ms);
+  void arm_timer(Session &session, uint32_t timeout_ms);
+  void arm_timer(Session &session, uint32_t timeout_ms, uint32_t since_us);
+  static uint32_t frame_time_us(const TwaiFrame &frame);
+  void complete(Session &session, Result result);
+
+  bool wait_completion(Session &session, Completion &completion);
+
+  TransferStatsEntry *stats_entry(const Session &session);
+  void record_latency(const Session &session,
+                      LatencyHistogram TransferStatsEntry::*histogram,
+                      uint32_t since_us,
+                      uint32_t until_us);
+  void record_completion(const Session &session, Result result);
 
   IPhyInterface &_bus;
+  LinkConfig _link;
   TwaiSubscriberIsoTp _subscriber;
-  TwaiFrame rxFrame;
-
-  uint8_t fc_wait_frames = 0;
-  uint32_t wait_cf       = 0;
-  uint32_t wait_session  = 0;
-  uint16_t rest;
+  TxPacer _pacer;
+  uint32_t _tx_queued    = 0;  // Кадры, принятые драйвером на передачу (с переполнением)
+  uint32_t _bus_off_seen = 0;  // Обработанные переходы в bus-off
+  Session _sessions[MAX_SESSIONS];
+  FlowControlTuner _fc_tuner;
+  TransferStats _stats;
 };
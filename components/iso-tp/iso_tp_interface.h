@@ -3,15 +3,133 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "span.h"
+
 class IIsoTp {
  public:
+  /**
+   * @brief Режим адресации ISO 15765-2
+   *
+   * Для EXTENDED и MIXED тип CAN ID (11/29 бит) определяется значением
+   * идентификатора: ID больше 0x7FF передаются как 29-битные.
+   */
+  enum class Addressing : uint8_t {
+    NORMAL = 0,    // 11-битный CAN ID, N_PCI в байте 0
+    NORMAL_FIXED,  // 29-битный CAN ID 18DA/18DB (N_TA/N_SA в идентификаторе), N_PCI в байте 0
+    EXTENDED,      // Байт 0 - адрес N_TA, N_PCI в байте 1
+    MIXED          // Байт 0 - расширение адреса N_AE (18CE/18CD для 29 бит), N_PCI в байте 1
+  };
+
   struct Message {
-    uint32_t tx_id = 0;
-    uint32_t rx_id = 0;
-    size_t len     = 0;
-    uint8_t *data  = nullptr;
+    uint32_t tx_id        = 0;
+    uint32_t rx_id        = 0;
+    size_t len            = 0;
+    uint8_t *data         = nullptr;
+    Addressing addressing = Addressing::NORMAL;
+    uint8_t tx_address    = 0;  // N_TA/N_AE в байте 0 отправляемых кадров (EXTENDED, MIXED)
+    uint8_t rx_address    = 0;  // N_TA/N_AE в байте 0 принимаемых кадров (EXTENDED, MIXED)
+    uint32_t timestamp_us = 0;  // receive: время приема первого кадра (SF/FF), мкс
+  };
+
+  /**
+   * @brief CAN ID нормальной фиксированной адресации (29 бит)
+   * @param target Адрес получателя N_TA
+   * @param source Адрес отправителя N_SA
+   * @param functional Функциональный запрос (18DB) вместо физического (18DA)
+   */
+  static constexpr uint32_t normal_fixed_id(uint8_t target, uint8_t source, bool functional = false) {
+    return (functional ? 0x18DB0000 : 0x18DA0000) | (static_cast<uint32_t>(target) << 8) | source;
+  }
+
+  /**
+   * @brief Потребитель потокового приема
+   *
+   * Вызывается для каждого принятого фрагмента (SF, FF, CF). chunk указывает
+   * прямо в данные CAN кадра и действителен только на время вызова.
+   * offset == 0 означает начало нового сообщения: если отправитель начал
+   * передачу заново (повторный FF), потребитель должен сбросить состояние.
+   *
+   * @param offset Смещение фрагмента от начала сообщения
+   * @param chunk Данные фрагмента
+   * @param total_len Полная длина сообщения
+   * @param ctx Пользовательский контекст
+   */
+  using StreamConsumer = void (*)(size_t offset, Span<const uint8_t> chunk, size_t total_len, void *ctx);
+
+  /**
+   * @brief Буферы приема, заполняемые по порядку (scatter)
+   *
+   * Позволяет принять сообщение в несколько несмежных областей памяти,
+   * например заголовок ответа отдельно от полезной нагрузки.
+   */
+  struct ScatterBuffer {
+    Span<const Span<uint8_t>> segments;
+
+    /**
+     * @brief StreamConsumer, раскладывающий фрагменты по сегментам; ctx - ScatterBuffer*
+     */
+    static void consume(size_t offset, Span<const uint8_t> chunk, size_t total_len, void *ctx) {
+      (void)total_len;
+      const auto *scatter = static_cast<const ScatterBuffer *>(ctx);
+
+      size_t segment_start = 0;
+      size_t pos           = 0;
+      for (const Span<uint8_t> &segment : scatter->segments) {
+        const size_t segment_end = segment_start + segment.size();
+        while (pos < chunk.size() && offset + pos < segment_end) {
+          segment[offset + pos - segment_start] = chunk[pos];
+          pos++;
+        }
+        segment_start = segment_end;
+      }
+    }
+  };
+
+  /**
+   * @brief Ответ одного ЭБУ на функциональный запрос
+   *
+   * tx_id - физический адрес ЭБУ, на который отправляется FC при
+   * многокадровом ответе (например 0x7E0 для ответов 0x7E8).
+   */
+  struct FunctionalResponse {
+    uint32_t tx_id        = 0;
+    uint32_t rx_id        = 0;
+    uint8_t *data         = nullptr;  // Буфер ответа
+    size_t size           = 0;        // Размер буфера
+    size_t len            = 0;        // Полная длина принятого ответа
+    bool received         = false;
+    uint32_t timestamp_us = 0;  // Время приема первого кадра ответа, мкс
   };
 
   virtual bool send(Message &msg)                        = 0;
   virtual bool receive(Message &msg, size_t size_buffer) = 0;
+
+  /**
+   * @brief Потоковый прием без промежуточного буфера
+   *
+   * msg.data не используется; по завершении msg.len содержит полную длину
+   * сообщения (до 4095 байт).
+   *
+   * @param msg Адреса сообщения
+   * @param consumer Обработчик фрагментов
+   * @param ctx Контекст обработчика
+   * @return true если сообщение принято целиком
+   */
+  virtual bool receive_stream(Message &msg, StreamConsumer consumer, void *ctx) = 0;
+
+  /**
+   * @brief Функциональный запрос с приемом ответов всех ЭБУ
+   *
+   * Запрос (только SF) отправляется один раз на msg.tx_id (например 0x7DF),
+   * после чего ответы принимаются параллельно по rx_id каждого элемента
+   * responses, включая многокадровые с отдельным FC для каждого ЭБУ.
+   * Прием завершается, когда ответили все ЭБУ или истекло окно сбора;
+   * начатые до конца окна многокадровые ответы принимаются до конца.
+   *
+   * @param msg Запрос; msg.rx_id не используется
+   * @param responses Ожидаемые ответы; по завершении received/len заполнены
+   * @param window_ms Окно сбора ответов в миллисекундах
+   * @return Количество ЭБУ, ответ которых принят целиком
+   */
+  virtual size_t send_functional(Message &msg, Span<FunctionalResponse> responses, uint32_t window_ms) = 0;
 };
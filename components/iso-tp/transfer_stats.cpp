@@ -0,0 +1,117 @@
+#include "transfer_stats.h"
+
+#include <cinttypes>
+#include <cstdio>
+
+#include "esp_log.h"
+
+static const char* const TAG = "ISO_TP_STATS";
+
+void LatencyHistogram::add(uint32_t latency_us) {
+  size_t bucket = 0;
+  while (bucket < BUCKETS - 1 && latency_us > BUCKET_LIMITS_US[bucket]) {
+    bucket++;
+  }
+  counts[bucket]++;
+  samples++;
+  total_us += latency_us;
+  if (latency_us > max_us) {
+    max_us = latency_us;
+  }
+}
+
+uint32_t LatencyHistogram::average_us() const {
+  return (samples > 0) ? static_cast<uint32_t>(total_us / samples) : 0;
+}
+
+TransferStatsEntry* TransferStats::acquire(uint32_t tx_id, uint32_t rx_id) {
+  for (size_t i = 0; i < _count; i++) {
+    if (_entries[i].tx_id == tx_id && _entries[i].rx_id == rx_id) {
+      return &_entries[i];
+    }
+  }
+  if (_count >= MAX_PAIRS) {
+    return nullptr;
+  }
+  TransferStatsEntry& entry = _entries[_count++];
+  entry                     = TransferStatsEntry();
+  entry.tx_id               = tx_id;
+  entry.rx_id               = rx_id;
+  return &entry;
+}
+
+const TransferStatsEntry* TransferStats::find(uint32_t tx_id, uint32_t rx_id) const {
+  for (size_t i = 0; i < _count; i++) {
+    if (_entries[i].tx_id == tx_id && _entries[i].rx_id == rx_id) {
+      return &_entries[i];
+    }
+  }
+  return nullptr;
+}
+
+const TransferStatsEntry* TransferStats::at(size_t index) const {
+  return (index < _count) ? &_entries[index] : nullptr;
+}
+
+void TransferStats::reset() {
+  _count = 0;
+}
+
+static int format_histogram(const char* name, const LatencyHistogram& histogram, char* buffer, size_t size) {
+  return snprintf(buffer,
+                  size,
+                  " %s[n=%" PRIu32 " avg=%" PRIu32 "us max=%" PRIu32 "us %" PRIu32 "/%" PRIu32 "/%" PRIu32
+                  "/%" PRIu32 "/%" PRIu32 "/%" PRIu32 "/%" PRIu32 "/%" PRIu32 "]",
+                  name,
+                  histogram.samples,
+                  histogram.average_us(),
+                  histogram.max_us,
+                  histogram.counts[0],
+                  histogram.counts[1],
+                  histogram.counts[2],
+                  histogram.counts[3],
+                  histogram.counts[4],
+                  histogram.counts[5],
+                  histogram.counts[6],
+                  histogram.counts[7]);
+}
+
+int TransferStats::format(const TransferStatsEntry& entry, char* buffer, size_t size) {
+  int len = snprintf(buffer,
+                     size,
+                     "%" PRIX32 "/%" PRIX32 " ok tx=%" PRIu32 " rx=%" PRIu32 " timeout fc=%" PRIu32 " cf=%" PRIu32
+                     " ses=%" PRIu32 " tx=%" PRIu32 " txfail=%" PRIu32 " sn=%" PRIu32 " dup=%" PRIu32 " trunc=%" PRIu32 " ovfl=%" PRIu32
+                     " wft=%" PRIu32 " fs=%" PRIu32 " abort=%" PRIu32,
+                     entry.tx_id,
+                     entry.rx_id,
+                     entry.sent_ok,
+                     entry.received_ok,
+                     entry.timeout_fc,
+                     entry.timeout_cf,
+                     entry.timeout_session,
+                     entry.timeout_tx,
+                     entry.tx_failed,
+                     entry.wrong_sn,
+                     entry.duplicates,
+                     entry.truncations,
+                     entry.overflow,
+                     entry.wft_overrun,
+                     entry.invalid_fs,
+                     entry.aborted);
+
+  const LatencyHistogram* const histograms[] = {&entry.response, &entry.transfer, &entry.fc_wait};
+  const char* const names[]                  = {"resp", "xfer", "fcw"};
+  for (size_t i = 0; i < 3; i++) {
+    const size_t used = (len > 0 && static_cast<size_t>(len) < size) ? len : size;
+    len += format_histogram(names[i], *histograms[i], buffer + used, size - used);
+  }
+  return len;
+}
+
+void TransferStats::log() const {
+  char line[384];
+  for (size_t i = 0; i < _count; i++) {
+    format(_entries[i], line, sizeof(line));
+    ESP_LOGI(TAG, "%s", line);
+  }
+}
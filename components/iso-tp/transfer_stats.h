@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Гистограмма задержек с фиксированными корзинами
+ *
+ * Границы корзин подобраны под времена ответа ЭБУ (P2 до 50 мс) и
+ * передачи многокадровых сообщений; последняя корзина - все, что дольше 100 мс.
+ */
+struct LatencyHistogram {
+  static const size_t BUCKETS = 8;
+
+  // Верхние границы корзин в микросекундах (последняя корзина без границы)
+  static constexpr uint32_t BUCKET_LIMITS_US[BUCKETS - 1] = {1000, 2000, 5000, 10000, 20000, 50000, 100000};
+
+  uint32_t counts[BUCKETS] = {0};
+  uint32_t samples         = 0;
+  uint32_t max_us          = 0;
+  uint64_t total_us        = 0;
+
+  void add(uint32_t latency_us);
+  uint32_t average_us() const;
+};
+
+/**
+ * @brief Счетчики и задержки передач ISO-TP для пары адресов
+ */
+struct TransferStatsEntry {
+  uint32_t tx_id = 0;
+  uint32_t rx_id = 0;
+
+  uint32_t sent_ok     = 0;  // Успешно отправленные сообщения
+  uint32_t received_ok = 0;  // Успешно принятые сообщения
+
+  uint32_t timeout_fc      = 0;  // N_Bs: нет FC после FF или блока CF
+  uint32_t timeout_cf      = 0;  // N_Cr: нет очередного CF
+  uint32_t timeout_session = 0;  // Нет ответа (SF/FF)
+  uint32_t timeout_tx      = 0;  // N_As: кадр не покинул контроллер
+  uint32_t tx_failed       = 0;  // Драйвер не принял SF/FF
+  uint32_t wrong_sn        = 0;  // Пропущенные CF
+  uint32_t duplicates      = 0;  // Повторные CF, проигнорированные
+  uint32_t truncations     = 0;  // Ответы, не поместившиеся в буфер
+  uint32_t overflow        = 0;  // Получатель ответил FC OVFLW
+  uint32_t wft_overrun     = 0;  // Превышен лимит FC WAIT
+  uint32_t invalid_fs      = 0;  // Некорректный Flow Status
+  uint32_t aborted         = 0;  // Прерванные вызывающей стороной
+
+  LatencyHistogram response;  // Запрос (начало приема) -> SF/FF ответа
+  LatencyHistogram transfer;  // FF -> последний CF (прием и отправка)
+  LatencyHistogram fc_wait;   // FF или конец блока CF -> FC получателя
+};
+
+/**
+ * @brief Таблица статистики передач ISO-TP по парам адресов (tx_id, rx_id)
+ *
+ * Заполняется движком IsoTp; пары добавляются при первой транзакции.
+ * Когда таблица заполнена, статистика новых пар не собирается.
+ */
+class TransferStats {
+ public:
+  static const size_t MAX_PAIRS = 8;
+
+  /**
+   * @brief Запись пары адресов, добавляется при отсутствии
+   * @return nullptr если таблица заполнена
+   */
+  TransferStatsEntry* acquire(uint32_t tx_id, uint32_t rx_id);
+
+  /**
+   * @brief Статистика пары адресов
+   * @return nullptr если по паре не было транзакций
+   */
+  const TransferStatsEntry* find(uint32_t tx_id, uint32_t rx_id) const;
+
+  /**
+   * @brief Запись по индексу таблицы (для обхода всех пар)
+   * @return nullptr если запись не занята или индекс вне таблицы
+   */
+  const TransferStatsEntry* at(size_t index) const;
+
+  /**
+   * @brief Сброс статистики всех пар
+   */
+  void reset();
+
+  /**
+   * @brief Статистика пары одной строкой
+   * @param entry Запись статистики
+   * @param buffer Буфер строки
+   * @param size Размер буфера
+   * @return Длина строки (как snprintf)
+   */
+  static int format(const TransferStatsEntry& entry, char* buffer, size_t size);
+
+  /**
+   * @brief Вывод статистики всех пар в лог, одна строка на пару
+   */
+  void log() const;
+
+ private:
+  TransferStatsEntry _entries[MAX_PAIRS];
+  size_t _count = 0;
+};
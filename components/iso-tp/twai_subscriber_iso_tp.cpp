@@ -3,44 +3,204 @@
 #include <cstring>
 
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
 
 static const char* const TAG = "TwaiSubscriberIsoTp";
 
-TwaiSubscriberIsoTp::TwaiSubscriberIsoTp(uint32_t queue_size) {
-  xQueue_ = xQueueCreate(queue_size, sizeof(TwaiFrame));
-  if (xQueue_ == nullptr) {
-    ESP_LOGE(TAG, "Failed to create queue");
+bool TwaiSubscriberIsoTp::isInterested(const TwaiFrame& frame) {
+  const size_t count = rx_filter_count_.load(std::memory_order_acquire);
+  if (count == 0) {
+    return true;
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (rx_filters_[i].Matches(frame)) {
+      return true;
+    }
   }
+  return false;
+}
+
+Span<const CanIdFilter> TwaiSubscriberIsoTp::rxFilters() {
+  return Span<const CanIdFilter>(rx_filters_, rx_filter_count_.load(std::memory_order_acquire));
 }
 
-#ifdef TEST_INSTANCES
-#warning "only tests"
-TwaiSubscriberIsoTp::~TwaiSubscriberIsoTp() {
-  if (xQueue_ != nullptr) {
-    vQueueDelete(xQueue_);
+bool TwaiSubscriberIsoTp::AddRxFilter(uint32_t id, uint32_t mask, bool is_extended) {
+  const size_t count = rx_filter_count_.load(std::memory_order_relaxed);
+  if (count >= kMaxRxFilters) {
+    ESP_LOGW(TAG, "No free RX filter (max %u)", static_cast<unsigned>(kMaxRxFilters));
+    return false;
   }
+  rx_filters_[count].id          = id & mask;
+  rx_filters_[count].mask        = mask;
+  rx_filters_[count].is_extended = is_extended;
+  // Фильтр становится виден прерыванию только после заполнения
+  rx_filter_count_.store(count + 1, std::memory_order_release);
+  return true;
 }
-#endif
 
-bool TwaiSubscriberIsoTp::isInterested(const TwaiFrame& frame) {
+bool TwaiSubscriberIsoTp::onTwaiFrameFromISR(const TwaiFrame& frame, bool& need_yield) {
+  if (frame.data_length == 0) {
+    return false;
+  }
+  // Кадры, ожидающие задачу, приняты раньше: CF не должен их обогнать
+  if (!rx_ring_.Empty()) {
+    return false;
+  }
+
+  for (size_t slot = 0; slot < kMaxAssemblies; slot++) {
+    uint8_t expected = kSlotArmed;
+    if (!assembly_state_[slot].compare_exchange_strong(expected, kSlotBusy, std::memory_order_acquire)) {
+      continue;
+    }
+    RxAssembly& assembly = assemblies_[slot];
+    const bool same_address =
+        (assembly.pci_offset == 0) || (frame.data_length > assembly.pci_offset && frame.data[0] == assembly.rx_address);
+    if (assembly.id != frame.id || assembly.is_extended != frame.is_extended || !same_address) {
+      assembly_state_[slot].store(kSlotArmed, std::memory_order_release);
+      continue;
+    }
+
+    // SF, FF и FC обрабатывает задача
+    if ((frame.data[assembly.pci_offset] & 0xF0) != 0x20) {
+      assembly_state_[slot].store(kSlotArmed, std::memory_order_release);
+      return false;
+    }
+
+    if (!ProcessConsecutiveFrame(assembly, frame)) {
+      assembly_state_[slot].store(kSlotArmed, std::memory_order_release);
+      return true;
+    }
+    assembly_state_[slot].store(kSlotEvent, std::memory_order_release);
+    rx_ring_.NotifyFromISR(need_yield);
+    return true;
+  }
+  return false;
+}
+
+bool TwaiSubscriberIsoTp::ProcessConsecutiveFrame(RxAssembly& assembly, const TwaiFrame& frame) {
+  const uint8_t* const pci = frame.data + assembly.pci_offset;
+  const size_t frame_len   = frame.data_length - assembly.pci_offset;
+
+  const uint8_t received_seq_id = pci[0] & 0x0F;
+  const uint8_t expected_seq_id = assembly.seq_id & 0x0F;
+  if (received_seq_id != expected_seq_id) {
+    if (received_seq_id == ((expected_seq_id - 1) & 0x0F)) {
+      assembly.duplicates++;
+      return false;
+    }
+    assembly.event = AssemblyEvent::WRONG_SN;
+    return true;
+  }
+
+  const size_t rest    = assembly.len - assembly.offset;
+  const size_t payload = (frame_len > 1) ? frame_len - 1 : 0;
+  const size_t chunk   = (rest < payload) ? rest : payload;
+  const size_t space   = (assembly.max_len > assembly.offset) ? assembly.max_len - assembly.offset : 0;
+  const size_t copy    = (chunk < space) ? chunk : space;
+  memcpy(assembly.buffer + assembly.offset, pci + 1, copy);
+  if (copy < chunk) {
+    assembly.truncated = true;
+  }
+  assembly.offset += chunk;
+  assembly.seq_id++;
+  assembly.last_cf_us = (frame.timestamp_us != 0) ? frame.timestamp_us : static_cast<uint32_t>(esp_timer_get_time());
+
+  if (assembly.offset >= assembly.len) {
+    assembly.event = AssemblyEvent::COMPLETE;
+    return true;
+  }
+  if (assembly.blocksize > 0 && ++assembly.bs_count >= assembly.blocksize) {
+    assembly.bs_count = 0;
+    assembly.event    = AssemblyEvent::BLOCK_END;
+    return true;
+  }
+  return false;
+}
+
+bool TwaiSubscriberIsoTp::ArmAssembly(size_t slot, const RxAssembly& assembly) {
+  if (slot >= kMaxAssemblies || assembly_state_[slot].load(std::memory_order_acquire) != kSlotFree) {
+    return false;
+  }
+  assemblies_[slot]       = assembly;
+  assemblies_[slot].event = AssemblyEvent::NONE;
+  assembly_state_[slot].store(kSlotArmed, std::memory_order_release);
+  return true;
+}
+
+bool TwaiSubscriberIsoTp::TakeAssembly(size_t slot, RxAssembly& assembly) {
+  if (slot >= kMaxAssemblies) {
+    return false;
+  }
+  uint8_t state = assembly_state_[slot].load(std::memory_order_acquire);
+  while (true) {
+    if (state == kSlotFree) {
+      return false;
+    }
+    // На другом ядре прерывание может дописывать кадр: ждем окончания
+    if (state != kSlotBusy &&
+        assembly_state_[slot].compare_exchange_weak(state, kSlotFree, std::memory_order_acq_rel)) {
+      break;
+    }
+    state = assembly_state_[slot].load(std::memory_order_acquire);
+  }
+  assembly = assemblies_[slot];
   return true;
 }
 
-QueueHandle_t TwaiSubscriberIsoTp::onTwaiMessage() {
-  return xQueue_;
+bool TwaiSubscriberIsoTp::HasAssemblyEvent(size_t slot) const {
+  return slot < kMaxAssemblies && assembly_state_[slot].load(std::memory_order_acquire) == kSlotEvent;
+}
+
+TwaiRxRing* TwaiSubscriberIsoTp::onTwaiMessage() {
+  return &rx_ring_;
 }
 
 bool TwaiSubscriberIsoTp::Receive(TwaiFrame& frame, TickType_t timeout_ms) {
-  if (xQueue_ == nullptr) {
-    ESP_LOGE(TAG, "Queue not initialized");
+  // Пробуждение без кадра: вызывающая сторона обработает таймеры
+  return rx_ring_.Receive(frame, timeout_ms);
+}
+
+bool TwaiSubscriberIsoTp::onTwaiTxDone(const TwaiFrame& /*frame*/, bool /*success*/) {
+  last_tx_done_us_.store(static_cast<uint32_t>(esp_timer_get_time()), std::memory_order_relaxed);
+  tx_done_count_.fetch_add(1, std::memory_order_release);
+
+  if (!wake_on_tx_done_.exchange(false, std::memory_order_acq_rel)) {
     return false;
   }
 
-  if (xQueueReceive(xQueue_, &frame, timeout_ms) != pdTRUE) {
-    return false;
+  bool need_yield = false;
+  rx_ring_.NotifyFromISR(need_yield);
+  return need_yield;
+}
+
+void TwaiSubscriberIsoTp::onTwaiBusState(TwaiBusState state) {
+  if (state != TwaiBusState::BUS_OFF) {
+    return;
   }
+  bus_off_count_.fetch_add(1, std::memory_order_release);
 
-  return true;
+  // Задача не дождется завершений сброшенных кадров: будим ее сразу
+  bool need_yield = false;
+  rx_ring_.NotifyFromISR(need_yield);
+}
+
+void TwaiSubscriberIsoTp::Wake() {
+  rx_ring_.Notify();
+}
+
+void TwaiSubscriberIsoTp::RequestTxDoneWakeup() {
+  wake_on_tx_done_.store(true, std::memory_order_release);
+}
+
+uint32_t TwaiSubscriberIsoTp::GetTxDoneCount() const {
+  return tx_done_count_.load(std::memory_order_acquire);
+}
+
+uint32_t TwaiSubscriberIsoTp::GetLastTxDoneUs() const {
+  return last_tx_done_us_.load(std::memory_order_relaxed);
+}
+
+uint32_t TwaiSubscriberIsoTp::GetBusOffCount() const {
+  return bus_off_count_.load(std::memory_order_acquire);
 }
\ No newline at end of file
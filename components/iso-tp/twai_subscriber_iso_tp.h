@@ -1,31 +1,178 @@
 #pragma once
 
+#include <atomic>
+
 #include "freertos/FreeRTOS.h"
-#include "freertos/queue.h"
+#include "freertos/task.h"
 #include "phy_interface.h"
+#include "twai_rx_ring.h"
 
+/**
+ * @brief Подписчик ISO-TP на кадры TWAI
+ *
+ * Кадры отбираются по зарегистрированным фильтрам rx ID прямо в прерывании,
+ * чужой трафик шины в буфер задачи не попадает.
+ *
+ * CF многокадрового приема собираются в прерывании в буфер сессии
+ * (RxAssembly): задача будится только по завершении сообщения, концу блока
+ * (нужен FC) или ошибке последовательности. SF, FF и FC по-прежнему идут
+ * через кольцевой буфер TwaiRxRing. CF обрабатывается в прерывании, только
+ * если буфер пуст, иначе он встает за ранее принятыми кадрами - порядок
+ * сохраняется.
+ */
 class TwaiSubscriberIsoTp final : public ITwaiSubscriber {
  public:
-  explicit TwaiSubscriberIsoTp(uint32_t queue_size = 10);
-#ifdef TEST_INSTANCES
-  ~TwaiSubscriberIsoTp();
-#endif
+  static const size_t kMaxRxFilters  = 8;
+  static const size_t kMaxAssemblies = 8;
+
+  /**
+   * @brief Событие сборки, требующее внимания задачи
+   */
+  enum class AssemblyEvent : uint8_t {
+    NONE = 0,
+    COMPLETE,   // Принят последний CF
+    BLOCK_END,  // Принят блок из BS кадров, нужен FC
+    WRONG_SN    // Нарушена последовательность CF
+  };
+
+  /**
+   * @brief Состояние сборки многокадрового сообщения
+   */
+  struct RxAssembly {
+    uint32_t id         = 0;
+    bool is_extended    = false;
+    uint8_t pci_offset  = 0;
+    uint8_t rx_address  = 0;
+    uint8_t* buffer     = nullptr;
+    size_t len          = 0;  // Полная длина сообщения
+    size_t max_len      = 0;  // Размер буфера
+    size_t offset       = 0;  // Сколько байт уже принято
+    uint8_t seq_id      = 1;
+    uint8_t blocksize   = 0;
+    uint8_t bs_count    = 0;
+    bool truncated      = false;
+    uint32_t duplicates = 0;  // Повторные CF, проигнорированные
+    uint32_t last_cf_us = 0;  // Время приема последнего CF
+    AssemblyEvent event = AssemblyEvent::NONE;
+  };
+
+  /**
+   * @param consumer Задача, которая читает кадры через Receive() и будится из прерывания
+   */
+  explicit TwaiSubscriberIsoTp(TaskHandle_t consumer = nullptr) :
+      rx_ring_(consumer) {}
+
+  /**
+   * @brief Кадр проходит фильтры rx ID (без фильтров - любой кадр)
+   */
   bool isInterested(const TwaiFrame& frame) override;
 
   /**
-   * @brief Получение очереди для входящих TWAI сообщений
-   * @return Указатель на очередь для помещения сообщений
+   * @brief Фильтры rx ID для таблицы маршрутизации драйвера
+   */
+  Span<const CanIdFilter> rxFilters() override;
+
+  /**
+   * @brief Добавление фильтра rx ID: кадр принимается, если (id & mask) == (filter_id & mask)
+   *
+   * Фильтры настраиваются до начала обмена, удаления нет. Драйвер узнает
+   * о новом фильтре при повторной регистрации подписчика.
+   *
+   * @return false если таблица фильтров заполнена
+   */
+  bool AddRxFilter(uint32_t id, uint32_t mask, bool is_extended);
+
+  /**
+   * @brief Сборка CF в прерывании; кадр поглощается, если буфер кадров пуст
+   */
+  bool onTwaiFrameFromISR(const TwaiFrame& frame, bool& need_yield) override;
+
+  /**
+   * @brief Передача сборки в прерывание (из контекста задачи)
+   * @param slot Номер слота (номер сессии)
+   * @param assembly Начальное состояние; буфер должен оставаться валидным до TakeAssembly()
+   * @return false если слот занят или номер вне таблицы
+   */
+  bool ArmAssembly(size_t slot, const RxAssembly& assembly);
+
+  /**
+   * @brief Возврат сборки задаче вместе с накопленным состоянием и событием
+   * @return false если слот не был передан прерыванию
+   */
+  bool TakeAssembly(size_t slot, RxAssembly& assembly);
+
+  /**
+   * @brief Есть ли в слоте событие для задачи
+   */
+  bool HasAssemblyEvent(size_t slot) const;
+
+  /**
+   * @brief Получение буфера для входящих TWAI сообщений
+   * @return Указатель на буфер для помещения сообщений
    */
-  QueueHandle_t onTwaiMessage() override;
+  TwaiRxRing* onTwaiMessage() override;
 
   /**
-   * @brief Получение сообщения из очереди
+   * @brief Получение сообщения из буфера
    * @param frame Ссылка на структуру для сохранения полученного сообщения
    * @param timeout_ms Время ожидания в миллисекундах
-   * @return true если сообщение успешно получено, false в случае таймаута
+   * @return true если сообщение успешно получено, false в случае таймаута или пробуждения
    */
   bool Receive(TwaiFrame& frame, TickType_t timeout_ms);
 
+  /**
+   * @brief Учет завершенной передачи и пробуждение задачи, если оно запрошено
+   */
+  bool onTwaiTxDone(const TwaiFrame& frame, bool success) override;
+
+  /**
+   * @brief Учет bus-off: кадры, сброшенные драйвером, завершения не получат
+   */
+  void onTwaiBusState(TwaiBusState state) override;
+
+  /**
+   * @brief Прерывание ожидания в Receive() без кадра (из контекста задачи)
+   */
+  void Wake();
+
+  /**
+   * @brief Однократное пробуждение Receive() при следующем завершении передачи
+   */
+  void RequestTxDoneWakeup();
+
+  /**
+   * @brief Количество кадров, покинувших контроллер (с переполнением)
+   */
+  uint32_t GetTxDoneCount() const;
+
+  /**
+   * @brief Время завершения последней передачи в микросекундах
+   */
+  uint32_t GetLastTxDoneUs() const;
+
+  /**
+   * @brief Количество переходов в bus-off (с переполнением)
+   */
+  uint32_t GetBusOffCount() const;
+
  private:
-  QueueHandle_t xQueue_;
+  // Владелец слота сборки
+  enum SlotState : uint8_t {
+    kSlotFree = 0,
+    kSlotArmed,  // Сборку ведет прерывание
+    kSlotBusy,   // Прерывание обрабатывает кадр
+    kSlotEvent   // Событие ждет задачу
+  };
+
+  bool ProcessConsecutiveFrame(RxAssembly& assembly, const TwaiFrame& frame);
+
+  TwaiRxRing rx_ring_;
+  CanIdFilter rx_filters_[kMaxRxFilters];
+  std::atomic<size_t> rx_filter_count_{0};
+  RxAssembly assemblies_[kMaxAssemblies];
+  std::atomic<uint8_t> assembly_state_[kMaxAssemblies] = {};
+  std::atomic_uint32_t tx_done_count_{0};
+  std::atomic_uint32_t last_tx_done_us_{0};
+  std::atomic_bool wake_on_tx_done_{false};
+  std::atomic_uint32_t bus_off_count_{0};
 };
\ No newline at end of file
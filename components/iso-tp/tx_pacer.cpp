@@ -0,0 +1,63 @@
+#include "tx_pacer.h"
+
+#include "esp_log.h"
+
+static const char* const TAG = "TX_PACER";
+
+TxPacer::TxPacer(WakeCallback callback, void* ctx) :
+    _callback(callback),
+    _ctx(ctx) {
+  const esp_timer_create_args_t args = {.callback              = on_timer,
+                                        .arg                   = this,
+                                        .dispatch_method       = ESP_TIMER_TASK,
+                                        .name                  = "isotp_pacer",
+                                        .skip_unhandled_events = true};
+  if (esp_timer_create(&args, &_timer) != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to create pacing timer");
+    _timer = nullptr;
+  }
+}
+
+TxPacer::~TxPacer() {
+  if (_timer != nullptr) {
+    esp_timer_stop(_timer);
+    esp_timer_delete(_timer);
+  }
+}
+
+uint32_t TxPacer::now_us() {
+  return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+void TxPacer::schedule(uint32_t deadline_us) {
+  if (_timer == nullptr) {
+    return;
+  }
+  // Уже взведен на более ранний дедлайн - после него сессии перепланируются
+  if (is_armed() && static_cast<int32_t>(deadline_us - _deadline_us) >= 0) {
+    return;
+  }
+
+  const int32_t delay = static_cast<int32_t>(deadline_us - now_us());
+
+  esp_timer_stop(_timer);
+  _deadline_us = deadline_us;
+  _armed.store(esp_timer_start_once(_timer, (delay > 0) ? delay : 0) == ESP_OK, std::memory_order_relaxed);
+}
+
+void TxPacer::cancel() {
+  if (_timer != nullptr) {
+    esp_timer_stop(_timer);
+  }
+  _armed.store(false, std::memory_order_relaxed);
+}
+
+bool TxPacer::is_armed() const {
+  return _armed.load(std::memory_order_relaxed);
+}
+
+void TxPacer::on_timer(void* arg) {
+  TxPacer* pacer = static_cast<TxPacer*>(arg);
+  pacer->_armed.store(false, std::memory_order_relaxed);
+  pacer->_callback(pacer->_ctx);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "esp_timer.h"
+
+/**
+ * @brief Планировщик отправки CF на высокоточном таймере
+ *
+ * Вместо vTaskDelay (округление STmin до тика) и esp_rom_delay_us
+ * (занятый процессор) задача ISO-TP засыпает в ожидании кадра, а
+ * одноразовый esp_timer будит ее точно к дедлайну очередного CF.
+ * Один таймер обслуживает все сессии: всегда взведен на ближайший дедлайн.
+ */
+class TxPacer {
+ public:
+  using WakeCallback = void (*)(void* ctx);
+
+  /**
+   * @param callback Пробуждение задачи ISO-TP (вызывается из задачи esp_timer)
+   * @param ctx Контекст обработчика
+   */
+  TxPacer(WakeCallback callback, void* ctx);
+  ~TxPacer();
+
+  TxPacer(const TxPacer&)            = delete;
+  TxPacer& operator=(const TxPacer&) = delete;
+
+  /**
+   * @brief Текущее время в микросекундах (переполнение через ~71 минуту)
+   */
+  static uint32_t now_us();
+
+  /**
+   * @brief Пробуждение в момент deadline_us, если он раньше уже запланированного
+   * @param deadline_us Абсолютное время в микросекундах
+   */
+  void schedule(uint32_t deadline_us);
+
+  /**
+   * @brief Отмена запланированного пробуждения
+   */
+  void cancel();
+
+  bool is_armed() const;
+
+ private:
+  static void on_timer(void* arg);
+
+  esp_timer_handle_t _timer = nullptr;
+  WakeCallback _callback;
+  void* _ctx;
+  std::atomic_bool _armed{false};  // Сбрасывается из задачи esp_timer
+  uint32_t _deadline_us = 0;
+};
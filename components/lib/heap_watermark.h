@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Контроль кучи в установившемся режиме
+ *
+ * Очереди, сессии и буферы создаются при старте, после чего приложение не
+ * должно обращаться к куче: выделения на ESP32-C3 дают джиттер и
+ * фрагментацию. Arm() фиксирует точку отсчета после инициализации,
+ * Check() сравнивает с ней текущий снимок. Счетчики выделений ведут хуки
+ * аллокатора платформы, свободную память дает сам аллокатор.
+ */
+class HeapWatermark {
+ public:
+  /**
+   * @brief Состояние кучи в момент снимка
+   */
+  struct Snapshot {
+    uint32_t allocations  = 0;  // Выделений с запуска (с переполнением)
+    uint32_t frees        = 0;  // Освобождений с запуска (с переполнением)
+    size_t free_bytes     = 0;  // Свободно сейчас
+    size_t min_free_bytes = 0;  // Минимум свободной памяти с запуска
+  };
+
+  /**
+   * @brief Изменения с момента Arm()
+   */
+  struct Report {
+    uint32_t allocations  = 0;     // Выделений после Arm()
+    uint32_t frees        = 0;     // Освобождений после Arm()
+    int32_t free_delta    = 0;     // Изменение свободной памяти, байт (меньше нуля - убыль)
+    size_t min_free_bytes = 0;     // Минимум свободной памяти с запуска
+    bool steady           = true;  // Ни одного выделения, минимум не опустился
+  };
+
+  /**
+   * @brief Точка отсчета: вызывается после создания всех объектов
+   * @param counts_allocations Хуки считают выделения контролируемой задачи: минимум
+   *                           свободной памяти общий для всех задач и режим не нарушает
+   */
+  void Arm(const Snapshot& snapshot, bool counts_allocations = false) {
+    base_               = snapshot;
+    counts_allocations_ = counts_allocations;
+    armed_              = true;
+  }
+
+  /**
+   * @brief Учет известного выделения после Arm() (например, записи в NVS)
+   *
+   * Свободная память и ее минимум из снимка становятся новой точкой отсчета.
+   * Счетчики не меняются: выделения на это время хуки не считают.
+   */
+  void Accept(const Snapshot& snapshot) {
+    base_.free_bytes     = snapshot.free_bytes;
+    base_.min_free_bytes = snapshot.min_free_bytes;
+  }
+
+  bool IsArmed() const {
+    return armed_;
+  }
+
+  /**
+   * @brief Сравнение снимка с точкой отсчета
+   *
+   * Без хуков аллокатора счетчики остаются нулевыми, и выделение видно
+   * только по снижению минимума свободной памяти.
+   */
+  Report Check(const Snapshot& snapshot) const {
+    Report report;
+    if (!armed_) {
+      return report;
+    }
+    report.allocations    = snapshot.allocations - base_.allocations;
+    report.frees          = snapshot.frees - base_.frees;
+    report.free_delta     = static_cast<int32_t>(snapshot.free_bytes - base_.free_bytes);
+    report.min_free_bytes = snapshot.min_free_bytes;
+    report.steady =
+        report.allocations == 0 && (counts_allocations_ || snapshot.min_free_bytes >= base_.min_free_bytes);
+    return report;
+  }
+
+ private:
+  Snapshot base_;
+  bool counts_allocations_ = false;
+  bool armed_              = false;
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "span.h"
+
+/**
+ * @brief Энергонезависимое хранилище двоичных записей по ключу
+ *
+ * На устройстве реализуется поверх NVS (ключ до 15 символов), в тестах -
+ * в памяти.
+ */
+class IKeyValueStore {
+ public:
+  virtual ~IKeyValueStore() = default;
+
+  /**
+   * @brief Читает запись
+   *
+   * @param key Ключ записи
+   * @param buffer Буфер для данных
+   * @param[out] len Длина записи
+   * @return True если запись есть и поместилась в буфер
+   */
+  virtual bool read(const char *key, Span<uint8_t> buffer, size_t &len) = 0;
+
+  /**
+   * @brief Записывает запись, заменяя прежнюю
+   *
+   * @param key Ключ записи
+   * @param data Данные
+   * @return True если запись сохранена
+   */
+  virtual bool write(const char *key, Span<const uint8_t> data) = 0;
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+ * @brief Невладеющее представление непрерывного диапазона элементов
+ *
+ * Минимальная замена std::span для C++17: указатель и длина без копирования данных.
+ */
+template <typename T>
+class Span {
+ public:
+  constexpr Span() = default;
+  constexpr Span(T* data, size_t size) :
+      data_(data),
+      size_(size) {}
+
+  template <size_t N>
+  constexpr Span(T (&array)[N]) :
+      data_(array),
+      size_(N) {}
+
+  constexpr T* data() const {
+    return data_;
+  }
+  constexpr size_t size() const {
+    return size_;
+  }
+  constexpr bool empty() const {
+    return size_ == 0;
+  }
+
+  constexpr T& operator[](size_t index) const {
+    return data_[index];
+  }
+
+  constexpr T* begin() const {
+    return data_;
+  }
+  constexpr T* end() const {
+    return data_ + size_;
+  }
+
+  /**
+   * @brief Подмножество элементов [offset, offset + count), ограниченное размером
+   */
+  constexpr Span subspan(size_t offset, size_t count = SIZE_MAX_COUNT) const {
+    if (offset > size_) {
+      return Span();
+    }
+    const size_t rest = size_ - offset;
+    return Span(data_ + offset, count < rest ? count : rest);
+  }
+
+ private:
+  static constexpr size_t SIZE_MAX_COUNT = static_cast<size_t>(-1);
+
+  T* data_     = nullptr;
+  size_t size_ = 0;
+};
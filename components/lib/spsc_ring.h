@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Кольцевой буфер без блокировок: один писатель и один читатель
+ *
+ * Писатель двигает только head_, читатель - только tail_, поэтому критическая
+ * секция не нужна. Индексы растут непрерывно и сворачиваются маской, отсюда
+ * размер - степень двойки. Переполнение не трогает накопленные элементы:
+ * новый элемент отбрасывается и учитывается в dropped().
+ */
+template <typename T, size_t N>
+class SpscRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "Capacity must be a power of two");
+
+ public:
+  static constexpr size_t capacity() {
+    return N;
+  }
+
+  /**
+   * @brief Добавление элемента (только писатель)
+   * @param was_empty true, если читатель мог застать буфер пустым и ждет уведомления
+   * @return false если буфер полон и элемент отброшен
+   */
+  bool push(const T& value, bool& was_empty) {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) >= N) {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      was_empty = false;
+      return false;
+    }
+    items_[head & kMask] = value;
+    head_.store(head + 1, std::memory_order_seq_cst);
+    // Пара seq_cst с pop(): если читатель увидел пустой буфер, здесь виден его tail_
+    was_empty = tail_.load(std::memory_order_seq_cst) == head;
+    return true;
+  }
+
+  bool push(const T& value) {
+    bool was_empty = false;
+    return push(value, was_empty);
+  }
+
+  /**
+   * @brief Извлечение самого старого элемента (только читатель)
+   * @return false если буфер пуст
+   */
+  bool pop(T& value) {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (head_.load(std::memory_order_seq_cst) == tail) {
+      return false;
+    }
+    value = items_[tail & kMask];
+    tail_.store(tail + 1, std::memory_order_seq_cst);
+    return true;
+  }
+
+  /**
+   * @brief Количество элементов (точное только в потоке читателя или писателя)
+   */
+  size_t size() const {
+    const uint32_t tail = tail_.load(std::memory_order_acquire);
+    return head_.load(std::memory_order_acquire) - tail;
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  /**
+   * @brief Количество элементов, отброшенных из-за переполнения
+   */
+  uint32_t dropped() const {
+    return dropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr uint32_t kMask    = N - 1;
+  static constexpr size_t kCacheLine = 64;
+
+  // Индексы на разных строках кэша: писатель и читатель не делят строку
+  alignas(kCacheLine) std::atomic<uint32_t> head_{0};
+  alignas(kCacheLine) std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> dropped_{0};
+  T items_[N];
+};
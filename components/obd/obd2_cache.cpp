@@ -22,89 +22,187 @@ static const char* const TAG = "OBD2";
  * @return bool True, если PID поддерживается, иначе False
  */
 bool OBD2::IsPidSupported(uint8_t pid) {
-  const uint32_t kCurrentTime = xTaskGetTickCount() * portTICK_PERIOD_MS;
-  const bool kIsCacheExpired  = (kCurrentTime - pid_support_cache_.last_update_time) > kPidCacheTimeotMs;
-
-  if (!pid_support_cache_.initialized || kIsCacheExpired) {
+  // Синхронно только первое заполнение; устаревший кэш обновляет stepPidDiscovery, геттеры его не ждут
+  if (!pid_support_cache_.initialized) {
     UpdatePidSupportCache();
   }
 
-  // PID 0 используется для запроса поддерживаемых PID 1-20, поэтому вычитаем 1
-  const uint8_t adjusted_pid  = (pid == 0) ? 0 : pid - 1;
-  const uint8_t array_index   = adjusted_pid / 32;
-  const uint32_t bit_position = 1 << (31 - (adjusted_pid % 32));
-
-  if (array_index >= 7) {
+  uint8_t array_index   = 0;
+  uint32_t bit_position = 0;
+  if (!PidCacheBit(pid, array_index, bit_position)) {
     return false;
   }
 
-  return (pid_support_cache_.supported_pids[array_index] & bit_position) != 0;
+  return (pid_support_cache_.supported_pids[array_index] & ~pid_support_cache_.rejected_pids[array_index] &
+          bit_position) != 0;
+}
+
+/**
+ * @brief Положение PID в битовых масках кэша
+ *
+ * @param pid Parameter ID (PID)
+ * @param[out] index Номер маски
+ * @param[out] bit Бит PID в маске
+ * @return bool False, если PID вне масок кэша
+ */
+bool OBD2::PidCacheBit(uint8_t pid, uint8_t& index, uint32_t& bit) {
+  // PID 0 используется для запроса поддерживаемых PID 1-20, поэтому вычитаем 1
+  const uint8_t adjusted_pid = (pid == 0) ? 0 : pid - 1;
+  index                      = adjusted_pid / 32;
+  bit                        = 1UL << (31 - (adjusted_pid % 32));
+  return index < 7;
+}
+
+/**
+ * @brief Исключает PID из поддерживаемых после постоянного отрицательного ответа ЭБУ
+ *
+ * Маски поддержки (0x00, 0x20, ...) не исключаются: их заново читает обновление кэша.
+ *
+ * @param pid Parameter ID (PID)
+ */
+void OBD2::MarkPidUnsupported(uint8_t pid) {
+  uint8_t array_index   = 0;
+  uint32_t bit_position = 0;
+  if (IsSupportPid(pid) || !PidCacheBit(pid, array_index, bit_position)) {
+    return;
+  }
+  pid_support_cache_.rejected_pids[array_index] |= bit_position;
+  ESP_LOGW(TAG, "PID 0x%02X rejected by the ECU, marked as unsupported", pid);
 }
 
 /**
  * @brief Обновляет кэш поддерживаемых PID, запрашивая информацию у автомобиля
+ *
+ * Маски читаются по порядку, пока в очередной маске выставлен бит следующей
+ * группы. Без маски 1-20 прежние маски остаются в кэше.
+ *
+ * @return bool True если маска 1-20 получена
  */
-void OBD2::UpdatePidSupportCache() {
-  for (int i = 0; i < 7; i++) {
-    pid_support_cache_.supported_pids[i] = 0;
+bool OBD2::UpdatePidSupportCache() {
+  SupportedPidMasks masks = {0};
+  bool has_first_mask     = false;
+
+  for (size_t i = 0; i < kSupportedPidMasks; i++) {
+    const auto mask = GetSupportedPids(static_cast<uint8_t>(i * PID_INTERVAL_OFFSET));
+    if (!mask.has_value()) {
+      break;
+    }
+    masks[i]       = mask.value();
+    has_first_mask = true;
+    // Бит 0 маски - поддерживается следующая группа
+    if ((mask.value() & 1) == 0) {
+      break;
+    }
   }
 
-  // Запрашиваем поддерживаемые PID по группам
-  // Группа 1-20 (PID 0x00)
-  auto pids_1_20 = GetSupportedPids(SUPPORTED_PIDS_1_20);
-  if (pids_1_20.has_value()) {
-    pid_support_cache_.supported_pids[0] = pids_1_20.value();
+  if (has_first_mask) {
+    pid_support_cache_.supported_pids = masks;
   }
 
-  if (pids_1_20.has_value() && (pids_1_20.value() & 1)) {
-    // Группа 21-40 (PID 0x20)
-    auto pids_21_40 = GetSupportedPids(SUPPORTED_PIDS_21_40);
-    if (pids_21_40.has_value()) {
-      pid_support_cache_.supported_pids[1] = pids_21_40.value();
+  // Обновляем время последнего обновления и помечаем кэш как инициализированный
+  pid_support_cache_.last_update_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  pid_support_cache_.initialized      = true;
+  return has_first_mask;
+}
+
+bool OBD2::refreshSupportedPids() {
+  return UpdatePidSupportCache();
+}
+
+void OBD2::restoreSupportedPids(const SupportedPidMasks& masks) {
+  pid_support_cache_.supported_pids   = masks;
+  pid_support_cache_.last_update_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  pid_support_cache_.initialized      = true;
+}
+
+/**
+ * @brief Истек ли срок кэша поддерживаемых PID
+ */
+bool OBD2::IsPidCacheExpired() const {
+  const uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  return (now_ms - pid_support_cache_.last_update_time) > kPidCacheTimeotMs;
+}
+
+bool OBD2::stepPidDiscovery() {
+  PidDiscovery& discovery = pid_discovery_;
+  if (!discovery.active) {
+    if (!discovery.due && !IsPidCacheExpired()) {
+      return false;
     }
+    discovery        = PidDiscovery();
+    discovery.active = true;
+  }
 
-    if (pids_21_40.has_value() && (pids_21_40.value() & 1)) {
-      // Группа 41-60 (PID 0x40)
-      auto pids_41_60 = GetSupportedPids(SUPPORTED_PIDS_41_60);
-      if (pids_41_60.has_value()) {
-        pid_support_cache_.supported_pids[2] = pids_41_60.value();
-      }
-
-      if (pids_41_60.has_value() && (pids_41_60.value() & 1)) {
-        // Группа 61-80 (PID 0x60)
-        auto pids_61_80 = GetSupportedPids(SUPPORTED_PIDS_61_80);
-        if (pids_61_80.has_value()) {
-          pid_support_cache_.supported_pids[3] = pids_61_80.value();
-        }
-
-        if (pids_61_80.has_value() && (pids_61_80.value() & 1)) {
-          // Группа 81-100 (PID 0x80)
-          auto pids_81_100 = GetSupportedPids(SUPPORTED_PIDS_81_100);
-          if (pids_81_100.has_value()) {
-            pid_support_cache_.supported_pids[4] = pids_81_100.value();
-          }
-
-          if (pids_81_100.has_value() && (pids_81_100.value() & 1)) {
-            // Группа 101-120 (PID 0xA0)
-            auto pids_101_120 = GetSupportedPids(SUPPORTED_PIDS_101_120);
-            if (pids_101_120.has_value()) {
-              pid_support_cache_.supported_pids[5] = pids_101_120.value();
-            }
-
-            if (pids_101_120.has_value() && (pids_101_120.value() & 1)) {
-              // Группа 121-140 (PID 0xC0)
-              auto pids_121_140 = GetSupportedPids(SUPPORTED_PIDS_121_140);
-              if (pids_121_140.has_value()) {
-                pid_support_cache_.supported_pids[6] = pids_121_140.value();
-              }
-            }
-          }
-        }
-      }
+  // Группа next_range (есть по маскам этого прохода) и следующие, которые есть по маскам кэша
+  const uint8_t first = discovery.next_range;
+  uint8_t ranges[kMaxPidsPerRequest];
+  size_t count = 0;
+  for (size_t i = first; (i < kSupportedPidMasks) && (count < discovery.batch_limit); i++) {
+    if ((i != first) && ((pid_support_cache_.supported_pids[i - 1] & 1) == 0)) {
+      break;
     }
+    ranges[count++] = static_cast<uint8_t>(i * PID_INTERVAL_OFFSET);
   }
 
-  // Обновляем время последнего обновления и помечаем кэш как инициализированный
+  PidResults results;
+  if (readPids(Span<const uint8_t>(ranges, count), results) == 0) {
+    if (count > 1) {
+      // ЭБУ не отвечает на групповой запрос: дальше по одной группе
+      ESP_LOGW(TAG, "Multi-range supported PID request failed, falling back to single ranges");
+      discovery.batch_limit = 1;
+      return false;
+    }
+    FinishPidDiscovery(false);
+    return false;
+  }
+
+  // Маски по порядку, пока очередная открывает следующую группу
+  while (discovery.next_range < kSupportedPidMasks) {
+    const Span<const uint8_t> data = results.data(discovery.next_range * PID_INTERVAL_OFFSET);
+    if (data.size() < 4) {
+      break;
+    }
+    const uint32_t mask = (static_cast<uint32_t>(data[A]) << 24) | (data[B] << 16) | (data[C] << 8) | data[D];
+    discovery.masks[discovery.next_range++] = mask;
+    if ((mask & 1) == 0) {
+      FinishPidDiscovery(true);
+      return true;
+    }
+  }
+
+  if (discovery.next_range >= first + count) {
+    // Следующая группа не запрашивалась: маски кэша ее не предполагали
+    if (discovery.next_range == kSupportedPidMasks) {
+      FinishPidDiscovery(true);
+      return true;
+    }
+    return false;
+  }
+
+  if (count > 1) {
+    // Групповой ответ без части групп: недостающие дочитываются по одной, полученные маски сохранены
+    ESP_LOGW(TAG, "Multi-range supported PID reply is partial, falling back to single ranges");
+    discovery.batch_limit = 1;
+    return false;
+  }
+
+  // Запрошенной группы нет в ответе: цепочка масок оборвана, прежние маски остаются
+  FinishPidDiscovery(false);
+  return false;
+}
+
+/**
+ * @brief Завершение прохода обновления масок
+ *
+ * @param success True - маски прохода заменяют маски кэша
+ */
+void OBD2::FinishPidDiscovery(bool success) {
+  if (success) {
+    pid_support_cache_.supported_pids = pid_discovery_.masks;
+    pid_support_cache_.initialized    = true;
+  } else {
+    ESP_LOGW(TAG, "Supported PID refresh failed, keeping previous masks");
+  }
   pid_support_cache_.last_update_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
-  pid_support_cache_.initialized      = true;
+  pid_discovery_.active               = false;
 }
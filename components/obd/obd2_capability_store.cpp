@@ -0,0 +1,117 @@
+#include "obd2_capability_store.h"
+
+#include <cstdio>
+#include <cstring>
+
+#include "esp_log.h"
+
+static const char* const TAG = "OBD2_CAPS";
+
+bool Obd2CapabilityStore::IsValidVin(const char* vin) {
+  return (vin != nullptr) && (strnlen(vin, ObdCapabilities::kVinLength + 1) == ObdCapabilities::kVinLength);
+}
+
+void Obd2CapabilityStore::makeKey(const char* vin, char (&key)[kKeySize]) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; (i < ObdCapabilities::kVinLength) && (vin[i] != '\0'); i++) {
+    hash = (hash ^ static_cast<uint8_t>(vin[i])) * 16777619u;
+  }
+  snprintf(key, kKeySize, "v%08lx", static_cast<unsigned long>(hash));
+}
+
+size_t Obd2CapabilityStore::serialize(const ObdCapabilities& caps, Span<uint8_t> out) {
+  if ((out.size() < kMaxRecordSize) || !IsValidVin(caps.vin.data()) || (caps.ecu_count > OBD2::kMaxEcus)) {
+    return 0;
+  }
+
+  size_t pos = 0;
+  out[pos++] = kFormatVersion;
+  memcpy(&out[pos], caps.vin.data(), ObdCapabilities::kVinLength);
+  pos += ObdCapabilities::kVinLength;
+  for (const uint32_t mask : caps.supported_pids) {
+    for (size_t i = 0; i < 4; i++) {
+      out[pos++] = static_cast<uint8_t>(mask >> (8 * i));
+    }
+  }
+  out[pos++] = caps.ecu_count;
+  for (size_t i = 0; i < caps.ecu_count; i++) {
+    out[pos++] = static_cast<uint8_t>(caps.ecu_ids[i]);
+    out[pos++] = static_cast<uint8_t>(caps.ecu_ids[i] >> 8);
+  }
+  return pos;
+}
+
+bool Obd2CapabilityStore::deserialize(Span<const uint8_t> record, ObdCapabilities& caps) {
+  if ((record.size() < kFixedSize) || (record[0] != kFormatVersion)) {
+    return false;
+  }
+  const uint8_t ecu_count = record[kFixedSize - 1];
+  if ((ecu_count > OBD2::kMaxEcus) || (record.size() != kFixedSize + 2 * ecu_count)) {
+    return false;
+  }
+
+  ObdCapabilities result;
+  size_t pos = 1;
+  memcpy(result.vin.data(), &record[pos], ObdCapabilities::kVinLength);
+  pos += ObdCapabilities::kVinLength;
+  for (uint32_t& mask : result.supported_pids) {
+    mask = 0;
+    for (size_t i = 0; i < 4; i++) {
+      mask |= static_cast<uint32_t>(record[pos++]) << (8 * i);
+    }
+  }
+  result.ecu_count = record[pos++];
+  for (size_t i = 0; i < result.ecu_count; i++) {
+    result.ecu_ids[i] = static_cast<uint16_t>(record[pos] | (record[pos + 1] << 8));
+    pos += 2;
+  }
+  if (!IsValidVin(result.vin.data())) {
+    return false;
+  }
+
+  caps = result;
+  return true;
+}
+
+bool Obd2CapabilityStore::load(const char* vin, ObdCapabilities& caps) {
+  if (!IsValidVin(vin)) {
+    return false;
+  }
+
+  char key[kKeySize];
+  makeKey(vin, key);
+  uint8_t record[kMaxRecordSize];
+  size_t len = 0;
+  if (!store_.read(key, Span<uint8_t>(record, sizeof(record)), len)) {
+    return false;
+  }
+
+  ObdCapabilities stored;
+  if (!deserialize(Span<const uint8_t>(record, len), stored)) {
+    ESP_LOGW(TAG, "Stored capabilities for %s are corrupted", vin);
+    return false;
+  }
+  // Хэши разных VIN могут совпасть: запись принимается только для своего VIN
+  if (strncmp(stored.vin.data(), vin, ObdCapabilities::kVinLength) != 0) {
+    return false;
+  }
+
+  caps = stored;
+  return true;
+}
+
+bool Obd2CapabilityStore::save(const ObdCapabilities& caps) {
+  uint8_t record[kMaxRecordSize];
+  const size_t len = serialize(caps, Span<uint8_t>(record, sizeof(record)));
+  if (len == 0) {
+    return false;
+  }
+
+  char key[kKeySize];
+  makeKey(caps.vin.data(), key);
+  if (!store_.write(key, Span<const uint8_t>(record, len))) {
+    ESP_LOGW(TAG, "Failed to store capabilities for %s", caps.vin.data());
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "kv_store_interface.h"
+#include "obd2.h"
+#include "span.h"
+
+/**
+ * @brief Возможности автомобиля, сохраняемые между запусками
+ */
+struct ObdCapabilities {
+  static constexpr size_t kVinLength = 17;
+
+  std::array<char, kVinLength + 1> vin         = {0};
+  OBD2::SupportedPidMasks supported_pids       = {0};
+  uint8_t ecu_count                            = 0;  // Ответивших ЭБУ, первые ecu_count элементов ecu_ids
+  std::array<uint16_t, OBD2::kMaxEcus> ecu_ids = {0};
+};
+
+/**
+ * @brief Хранилище возможностей автомобиля по VIN
+ *
+ * Маски поддерживаемых PID, список ЭБУ и VIN сохраняются одной записью.
+ * Ключ записи - хэш VIN (ключи NVS не длиннее 15 символов), сама запись
+ * содержит полный VIN и принимается только при его совпадении. Формат
+ * записи не зависит от порядка байт платформы:
+ *
+ *   [версия][VIN, 17 байт][7 масок, uint32 LE][число ЭБУ][CAN ID ЭБУ, uint16 LE]
+ */
+class Obd2CapabilityStore final {
+ public:
+  static constexpr uint8_t kFormatVersion = 1;
+  static constexpr size_t kKeySize        = 10;  // "v" + 8 hex + '\0'
+  static constexpr size_t kFixedSize      = 1 + ObdCapabilities::kVinLength + 4 * OBD2::kSupportedPidMasks + 1;
+  static constexpr size_t kMaxRecordSize  = kFixedSize + 2 * OBD2::kMaxEcus;
+
+  explicit Obd2CapabilityStore(IKeyValueStore& store) :
+      store_(store) {}
+
+  /**
+   * @brief Загружает возможности автомобиля с данным VIN
+   *
+   * @param vin VIN (17 символов)
+   * @param[out] caps Возможности автомобиля
+   * @return True если запись найдена, цела и относится к этому VIN
+   */
+  bool load(const char* vin, ObdCapabilities& caps);
+
+  /**
+   * @brief Сохраняет возможности автомобиля под ключом его VIN
+   */
+  bool save(const ObdCapabilities& caps);
+
+  /**
+   * @brief Запись возможностей в формат хранения
+   *
+   * @param caps Возможности автомобиля
+   * @param out Буфер не меньше kMaxRecordSize
+   * @return Длина записи, 0 - буфер мал или данные неверны
+   */
+  static size_t serialize(const ObdCapabilities& caps, Span<uint8_t> out);
+
+  /**
+   * @brief Разбор записи формата хранения
+   *
+   * @return True если версия, длина и число ЭБУ корректны
+   */
+  static bool deserialize(Span<const uint8_t> record, ObdCapabilities& caps);
+
+  /**
+   * @brief Ключ записи по VIN: "v" и FNV-1a хэш VIN
+   */
+  static void makeKey(const char* vin, char (&key)[kKeySize]);
+
+ private:
+  static bool IsValidVin(const char* vin);
+
+  IKeyValueStore& store_;
+};
@@ -74,12 +74,81 @@ OBD2::OBD2(IIsoTp& driver, uint16_t tx_id, uint16_t rx_id) :
 void OBD2::QueryPid(uint8_t service, uint8_t pid) {
   log_print("Service: %d PID: %d\n", service, pid);
   uint8_t data[8]{service, pid, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-  IsoTp::Message msg{tx_id_, rx_id_, 3, data};
+  IsoTp::Message msg{tx_id_, rx_id_, 2, data};
   log_print("Sending the following command/query\n");
   log_print_buffer(msg.tx_id, msg.data, msg.len);
   iso_tp_.send(msg);
 }
 
+/**
+ * @brief Потребитель ISO-TP: отделяет заголовок ответа от полезной нагрузки
+ *
+ * @param offset Смещение фрагмента от начала ответа
+ * @param chunk Фрагмент ответа
+ * @param total_len Полная длина ответа
+ * @param ctx Указатель на ResponseStream
+ */
+void OBD2::ConsumeResponse(size_t offset, Span<const uint8_t> chunk, size_t total_len, void* ctx) {
+  auto* stream = static_cast<ResponseStream*>(ctx);
+  if (offset == 0) {
+    // Начало ответа (или повторная передача FF) - разбираем заново
+    stream->header_len = 0;
+    stream->nrc        = 0;
+  }
+  stream->total_len = total_len;
+
+  size_t pos = 0;
+  while ((stream->header_len < sizeof(stream->header)) && (pos < chunk.size())) {
+    stream->header[stream->header_len++] = chunk[pos++];
+  }
+  if (pos >= chunk.size()) {
+    return;
+  }
+
+  const size_t payload_offset = offset + pos - sizeof(stream->header);
+  if (stream->IsPositive()) {
+    if (stream->sink != nullptr) {
+      stream->sink(payload_offset, chunk.subspan(pos), stream->ctx);
+    }
+  } else if ((stream->header[0] == 0x7F) && (payload_offset == 0)) {
+    stream->nrc = chunk[pos];
+  }
+}
+
+/**
+ * @brief Получатель полезной нагрузки, копирующий данные в ResponseType
+ *
+ * @param offset Смещение фрагмента от начала полезной нагрузки
+ * @param chunk Фрагмент данных
+ * @param ctx Указатель на ResponseType
+ */
+void OBD2::StoreResponse(size_t offset, Span<const uint8_t> chunk, void* ctx) {
+  auto* response = static_cast<ResponseType*>(ctx);
+  for (size_t i = 0; (i < chunk.size()) && (offset + i < response->size()); i++) {
+    (*response)[offset + i] = chunk[i];
+  }
+}
+
+/**
+ * @brief Принимает ответ ЭБУ в потоковом режиме
+ *
+ * @param stream Параметры разбора; по завершении содержит заголовок и длину ответа
+ * @return bool True если ответ принят целиком
+ */
+bool OBD2::ReceiveResponse(ResponseStream& stream) {
+  stream.header_len = 0;
+  stream.total_len  = 0;
+
+  IsoTp::Message msg{tx_id_, rx_id_, 0, nullptr};
+  if (!iso_tp_.receive_stream(msg, ConsumeResponse, &stream)) {
+    return false;
+  }
+  stream.total_len  = msg.len;
+  stream.rx_us      = msg.timestamp_us;
+  last_response_us_ = msg.timestamp_us;
+  return true;
+}
+
 /**
  * @brief Безопасно запрашивает PID с предварительной проверкой поддержки через кэш
  *
@@ -96,6 +165,37 @@ bool OBD2::ProcessPid(uint8_t service, uint16_t pid, ResponseType& response) {
   return ProcessPidWithoutCheck(service, pid, response);
 }
 
+/**
+ * @brief Принимает окончательный ответ ЭБУ, пропуская 0x78 (ResponsePending)
+ *
+ * После 0x78 запрос не повторяется: ответ ждем дальше, каждый 0x78
+ * продлевает ожидание на P2*.
+ *
+ * @param stream Параметры разбора; по завершении содержит заголовок и длину ответа
+ * @return bool True если принят ответ, отличный от 0x78
+ */
+bool OBD2::ReceiveFinalResponse(ResponseStream& stream) {
+  uint8_t pending           = 0;
+  uint32_t pending_since_ms = 0;
+
+  while (true) {
+    if (ReceiveResponse(stream)) {
+      const NegativeResponseCode error_code = static_cast<NegativeResponseCode>(stream.nrc);
+      if (!stream.IsNegative() || (error_code != NegativeResponseCode::REQUEST_CORRECTLY_RECEIVED_RESPONSE_PENDING) ||
+          (pending == kMaxResponsePending)) {
+        return true;
+      }
+      pending++;
+      pending_since_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+      log_print("Response pending (0x78) for service 0x%02X, waiting up to %u ms\n",
+                stream.service,
+                static_cast<unsigned>(kP2StarMs));
+    } else if ((pending == 0) || ((xTaskGetTickCount() * portTICK_PERIOD_MS - pending_since_ms) >= kP2StarMs)) {
+      return false;
+    }
+  }
+}
+
 /**
  * @brief Внутренний метод для обработки PID с возможностью отключения проверки поддержки
  *
@@ -105,75 +205,61 @@ bool OBD2::ProcessPid(uint8_t service, uint16_t pid, ResponseType& response) {
  * @return bool True если данные успешно получены и обработаны, иначе False
  */
 bool OBD2::ProcessPidWithoutCheck(uint8_t service, uint16_t pid, ResponseType& response) {
-  int attempt_count      = 0;
-  const int max_attempts = 3;
-
-  while (attempt_count < max_attempts) {
-    attempt_count++;
+  uint32_t backoff_ms = kBusyBackoffMs;
 
+  for (int attempt = 0; attempt < kMaxRequestAttempts; attempt++) {
     QueryPid(service, pid);
 
-    uint8_t payload[128];
-    IsoTp::Message msg{tx_id_, rx_id_, 0, payload};
-
-    if (iso_tp_.receive(msg, sizeof(payload))) {
-      // Проверяем на отрицательный ответ
-      if ((msg.len >= 3) && (msg.data[0] == 0x7F) && (msg.data[1] == pid)) {
-        const NegativeResponseCode error_code = static_cast<NegativeResponseCode>(msg.data[2]);
-        auto str                              = GetErrorDescription(error_code);
-
-        ESP_LOGW(TAG,
-                 "OBD2 negative response received: service=0x%02X, pid=0x%02X, Error=0x%02X, %s",
-                 msg.data[0],
-                 msg.data[1],
-                 msg.data[2],
-                 str);
-
-        vTaskDelay(pdMS_TO_TICKS(1000));
-        continue;
-
-        // auto strategy_info = error_handler_->handleNegativeResponse(service, pid, error_code);
+    ResponseStream stream;
+    stream.service = service;
+    stream.pid     = pid;
+    stream.sink    = StoreResponse;
+    stream.ctx     = &response;
 
-        // switch (strategy_info.strategy) {
-        //   case HandlingStrategy::RETRY_IMMEDIATELY:
-        //     continue;
+    if (!ReceiveFinalResponse(stream)) {
+      // Таймаут приема: повторяем запрос
+      continue;
+    }
 
-        //   case HandlingStrategy::RETRY_WITH_DELAY:
-        //   case HandlingStrategy::RETRY_WITH_BACKOFF:
-        //     vTaskDelay(pdMS_TO_TICKS(strategy_info.delay_ms));
-        //     continue;
+    // Положительный ответ; данные уже записаны в response
+    if (stream.IsPositive()) {
+      if (stream.PayloadLength() > response.size()) {
+        ESP_LOGW(TAG, "ProcessPid: trim data");
+      }
+      return true;
+    }
 
-        //   case HandlingStrategy::SKIP_SERVICE:
-        //   case HandlingStrategy::ABORT_OPERATION:
-        //     return false;
+    if (!stream.IsNegative()) {
+      // Ответ не на этот запрос
+      continue;
+    }
 
-        //   default:
-        //     break;
-        // }
-      }
+    const NegativeResponseCode error_code = static_cast<NegativeResponseCode>(stream.nrc);
+    ESP_LOGW(TAG,
+             "OBD2 negative response received: service=0x%02X, pid=0x%02X, Error=0x%02X, %s",
+             service,
+             pid,
+             stream.nrc,
+             GetErrorDescription(error_code));
 
-      // Проверяем положительный ответ
-      const uint8_t response_service = service + 0x40;
-      if ((msg.data[0] == response_service) && (msg.data[1] == pid)) {
-        size_t data_len = msg.len - 2;
-        if (data_len > response.size()) {
-          ESP_LOGW(TAG, "ProcessPid: trim data");
-          data_len = response.size();
+    switch (GetNrcStrategy(error_code)) {
+      case NrcStrategy::RETRY_BACKOFF:
+        if (attempt + 1 < kMaxRequestAttempts) {
+          vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+          backoff_ms = (backoff_ms * 2 < kBusyBackoffMaxMs) ? backoff_ms * 2 : kBusyBackoffMaxMs;
         }
-        std::copy(msg.data + 2, msg.data + 2 + data_len, response.begin());
-        return true;
-      }
-    } else {
-      // Таймаут приема
-      // NegativeResponseCode timeout_code = NegativeResponseCode::BUSY_REPEAT_REQUEST;
+        continue;
 
-      // auto strategy_info = error_handler_->handleNegativeResponse(service, pid, timeout_code, context);
+      case NrcStrategy::UNSUPPORTED:
+        if (service == SERVICE_01) {
+          MarkPidUnsupported(pid);
+        }
+        return false;
 
-      // if (strategy_info.strategy == HandlingStrategy::RETRY_WITH_DELAY ||
-      //     strategy_info.strategy == HandlingStrategy::RETRY_WITH_BACKOFF) {
-      //   vTaskDelay(pdMS_TO_TICKS(strategy_info.delay_ms));
-      //   continue;
-      // }
+      case NrcStrategy::WAIT_PENDING:  // Предел 0x78 исчерпан
+      case NrcStrategy::FAIL:
+      default:
+        return false;
     }
   }
 
@@ -300,3 +386,63 @@ bool OBD2::IsTemporaryError(NegativeResponseCode error_code) const {
       return false;
   }
 }
+
+/**
+ * @brief Реакция на отрицательный ответ ЭБУ
+ *
+ * @param error_code Код отрицательного ответа
+ * @return NrcStrategy 0x78 - ждать, 0x21 - повторить, прочие временные - отказ, постоянные - PID не поддерживается
+ */
+OBD2::NrcStrategy OBD2::GetNrcStrategy(NegativeResponseCode error_code) const {
+  if (error_code == NegativeResponseCode::REQUEST_CORRECTLY_RECEIVED_RESPONSE_PENDING) {
+    return NrcStrategy::WAIT_PENDING;
+  }
+  if (error_code == NegativeResponseCode::BUSY_REPEAT_REQUEST) {
+    return NrcStrategy::RETRY_BACKOFF;
+  }
+  return IsTemporaryError(error_code) ? NrcStrategy::FAIL : NrcStrategy::UNSUPPORTED;
+}
+
+/**
+ * @brief Функциональный запрос ко всем ЭБУ с приемом ответов за одно окно
+ *
+ * @param service ID диагностического сервиса
+ * @param pid Parameter ID (PID)
+ * @param[out] ecus Положительные ответы ЭБУ, первые N элементов
+ * @param window_ms Окно сбора ответов
+ * @return size_t Количество ЭБУ, давших положительный ответ
+ */
+size_t OBD2::queryAllEcus(uint8_t service, uint8_t pid, std::array<EcuResponse, kMaxEcus>& ecus, uint32_t window_ms) {
+  log_print("Functional query: Service: %d PID: %d\n", service, pid);
+
+  // SID и PID ответа принимаются вместе с полезной нагрузкой
+  std::array<std::array<uint8_t, kEcuResponseSize + 2>, kMaxEcus> buffers;
+  std::array<IIsoTp::FunctionalResponse, kMaxEcus> responses;
+  for (size_t i = 0; i < kMaxEcus; i++) {
+    responses[i].rx_id = rx_id_ + i;
+    responses[i].tx_id = rx_id_ + i - 8;  // Физический адрес ЭБУ для FC
+    responses[i].data  = buffers[i].data();
+    responses[i].size  = buffers[i].size();
+  }
+
+  uint8_t data[8]{service, pid, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  IsoTp::Message msg{tx_id_, rx_id_, 2, data};
+  iso_tp_.send_functional(msg, Span<IIsoTp::FunctionalResponse>(responses.data(), responses.size()), window_ms);
+
+  size_t count = 0;
+  for (size_t i = 0; i < kMaxEcus; i++) {
+    const IIsoTp::FunctionalResponse& response = responses[i];
+    const uint8_t* const raw                   = buffers[i].data();
+    if (!response.received || (response.len < 2) || (raw[0] != service + 0x40) || (raw[1] != pid)) {
+      continue;
+    }
+
+    EcuResponse& ecu = ecus[count++];
+    ecu.rx_id        = response.rx_id;
+    ecu.len          = (response.len - 2 < kEcuResponseSize) ? response.len - 2 : kEcuResponseSize;
+    ecu.timestamp_us = response.timestamp_us;
+    memcpy(ecu.data.data(), raw + 2, ecu.len);
+    log_print_buffer(ecu.rx_id, ecu.data.data(), ecu.len);
+  }
+  return count;
+}
@@ -0,0 +1,244 @@
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "obd2.h"
+#include "obd2_pid_table.h"
+
+static const char* const TAG = "OBD2_MULTI";
+
+namespace {
+
+/**
+ * @brief Сборщик ответа на групповой запрос: SID, первый PID из заголовка, затем полезная нагрузка
+ */
+struct PidResponseCollector {
+  uint8_t* buffer = nullptr;
+  size_t capacity = 0;
+};
+
+void CollectPidResponse(size_t offset, Span<const uint8_t> chunk, void* ctx) {
+  auto* collector = static_cast<PidResponseCollector*>(ctx);
+  for (size_t i = 0; (i < chunk.size()) && (2 + offset + i < collector->capacity); i++) {
+    collector->buffer[2 + offset + i] = chunk[i];
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief PID маски поддерживаемых PID (0x00, 0x20, 0x40, ...)
+ */
+bool OBD2::IsSupportPid(uint8_t pid) {
+  return (pid % PID_INTERVAL_OFFSET) == 0;
+}
+
+/**
+ * @brief Длина данных PID Service 01 в ответе
+ *
+ * @param pid Parameter ID (PID)
+ * @return uint8_t Количество байт данных по kPidTable, 0 - PID нельзя читать групповым запросом
+ */
+uint8_t OBD2::Service01DataLength(uint8_t pid) {
+  if (IsSupportPid(pid)) {
+    return 4;
+  }
+  const PidDescriptor* descriptor = pidDescriptor(pid);
+  return (descriptor != nullptr) ? descriptor->length : 0;
+}
+
+/**
+ * @brief Разбор ответа на групповой запрос: [PID, данные PID] x N
+ *
+ * @param payload Ответ без SID
+ * @param pids PID запроса; в ответе допустимы только они
+ * @param[out] results Значения PID
+ * @return size_t Количество разобранных PID до первого несоответствия запросу
+ */
+size_t OBD2::ParsePidResponse(Span<const uint8_t> payload, Span<const uint8_t> pids, PidResults& results) {
+  results.count_ = 0;
+
+  size_t pos = 0;
+  while (pos < payload.size()) {
+    const uint8_t pid = payload[pos++];
+
+    bool requested = false;
+    for (const uint8_t requested_pid : pids) {
+      requested = requested || (requested_pid == pid);
+    }
+    const uint8_t len = Service01DataLength(pid);
+    if (!requested || (len == 0) || (pos + len > payload.size()) || (results.count_ == kMaxPidsPerRequest)) {
+      // Границы следующих PID неизвестны: остаются только уже разобранные
+      ESP_LOGW(TAG, "Unexpected PID 0x%02X at offset %d in multi-PID response", pid, static_cast<int>(pos - 1));
+      break;
+    }
+
+    PidResults::Entry& entry = results.entries_[results.count_++];
+    entry.pid                = pid;
+    entry.len                = (len < kMaxPidDataLength) ? len : kMaxPidDataLength;
+    entry.data.fill(0);
+    memcpy(entry.data.data(), &payload[pos], entry.len);
+    pos += len;
+  }
+  return results.count_;
+}
+
+/**
+ * @brief Чтение до шести PID Service 01 одним запросом
+ *
+ * @param pids Запрашиваемые PID
+ * @param[out] results Значения PID, вошедших в ответ
+ * @return size_t Количество PID в ответе
+ */
+size_t OBD2::readPids(Span<const uint8_t> pids, PidResults& results) {
+  results.count_ = 0;
+
+  // Запрос: SID и до шести PID; маски поддержки не смешиваются с данными
+  const Span<const uint8_t> batch = pids.subspan(0, kMaxPidsPerRequest);
+  const bool support_request      = !batch.empty() && IsSupportPid(batch[0]);
+  for (const uint8_t pid : batch) {
+    if (IsSupportPid(pid) != support_request) {
+      ESP_LOGW(TAG, "PID 0x%02X: supported-PID masks cannot be mixed with data PIDs", pid);
+      return 0;
+    }
+    if (Service01DataLength(pid) == 0) {
+      ESP_LOGW(TAG, "PID 0x%02X has no fixed length, read it with a single request", pid);
+      return 0;
+    }
+  }
+
+  uint8_t request[1 + kMaxPidsPerRequest] = {SERVICE_01};
+  size_t count                            = 0;
+  for (const uint8_t pid : batch) {
+    if (!support_request && !IsPidSupported(pid)) {
+      log_print("PID 0x%02X is not supported by the vehicle, skipping\n", pid);
+      continue;
+    }
+    request[1 + count++] = pid;
+  }
+  if (count == 0) {
+    return 0;
+  }
+
+  // SID + (PID + до 5 байт данных) x 6
+  uint8_t response[kEcuResponseSize];
+  PidResponseCollector collector;
+  collector.buffer    = response;
+  collector.capacity  = sizeof(response);
+  uint32_t backoff_ms = kBusyBackoffMs;
+
+  for (int attempt = 0; attempt < kMaxRequestAttempts; attempt++) {
+    IsoTp::Message msg{tx_id_, rx_id_, 1 + count, request};
+    log_print_buffer(msg.tx_id, msg.data, msg.len);
+    if (!iso_tp_.send(msg)) {
+      return 0;
+    }
+
+    ResponseStream stream;
+    stream.service = SERVICE_01;
+    stream.pid     = request[1];
+    stream.any_pid = true;
+    stream.sink    = CollectPidResponse;
+    stream.ctx     = &collector;
+
+    if (!ReceiveFinalResponse(stream)) {
+      // Таймаут приема: без повтора, ЭБУ может не поддерживать групповые запросы
+      return 0;
+    }
+
+    if (stream.IsPositive()) {
+      const size_t len = (stream.total_len < sizeof(response)) ? stream.total_len : sizeof(response);
+      response[0]      = stream.header[0];
+      response[1]      = stream.header[1];
+      log_print_buffer(rx_id_, response, len);
+      return ParsePidResponse(Span<const uint8_t>(response + 1, len - 1),
+                              Span<const uint8_t>(request + 1, count),
+                              results);
+    }
+
+    if (!stream.IsNegative()) {
+      // Ответ не на этот запрос
+      continue;
+    }
+
+    const NegativeResponseCode error_code = static_cast<NegativeResponseCode>(stream.nrc);
+    ESP_LOGW(TAG,
+             "OBD2 negative response to multi-PID request: Error=0x%02X, %s",
+             stream.nrc,
+             GetErrorDescription(error_code));
+
+    switch (GetNrcStrategy(error_code)) {
+      case NrcStrategy::RETRY_BACKOFF:
+        if (attempt + 1 < kMaxRequestAttempts) {
+          vTaskDelay(pdMS_TO_TICKS(backoff_ms));
+          backoff_ms = (backoff_ms * 2 < kBusyBackoffMaxMs) ? backoff_ms * 2 : kBusyBackoffMaxMs;
+        }
+        continue;
+
+      case NrcStrategy::UNSUPPORTED:
+        // Отклоненный PID известен, только если он в запросе один
+        if (count == 1) {
+          MarkPidUnsupported(request[1]);
+        }
+        return 0;
+
+      case NrcStrategy::WAIT_PENDING:  // Предел 0x78 исчерпан
+      case NrcStrategy::FAIL:
+      default:
+        return 0;
+    }
+  }
+
+  return 0;
+}
+
+bool OBD2::PidResults::has(uint8_t pid) const {
+  return Find(pid, 0) != nullptr;
+}
+
+Span<const uint8_t> OBD2::PidResults::data(uint8_t pid) const {
+  const Entry* entry = Find(pid, 0);
+  return (entry != nullptr) ? Span<const uint8_t>(entry->data.data(), entry->len) : Span<const uint8_t>();
+}
+
+const OBD2::PidResults::Entry* OBD2::PidResults::Find(uint8_t pid, size_t min_len) const {
+  for (size_t i = 0; i < count_; i++) {
+    if ((entries_[i].pid == pid) && (entries_[i].len >= min_len)) {
+      return &entries_[i];
+    }
+  }
+  return nullptr;
+}
+
+std::optional<float> OBD2::PidResults::value(uint8_t pid, uint8_t field) const {
+  const PidDescriptor* descriptor = pidDescriptor(pid, field);
+  return (descriptor != nullptr) ? Value<float>(*descriptor) : std::nullopt;
+}
+
+std::optional<float> OBD2::PidResults::engineLoad() const {
+  return Get<float, ENGINE_LOAD>();
+}
+
+std::optional<int16_t> OBD2::PidResults::engineCoolantTemp() const {
+  return Get<int16_t, ENGINE_COOLANT_TEMP>();
+}
+
+std::optional<float> OBD2::PidResults::rpm() const {
+  return Get<float, ENGINE_RPM>();
+}
+
+std::optional<uint8_t> OBD2::PidResults::kph() const {
+  return Get<uint8_t, VEHICLE_SPEED>();
+}
+
+std::optional<int16_t> OBD2::PidResults::intakeAirTemp() const {
+  return Get<int16_t, INTAKE_AIR_TEMP>();
+}
+
+std::optional<float> OBD2::PidResults::throttle() const {
+  return Get<float, THROTTLE_POSITION>();
+}
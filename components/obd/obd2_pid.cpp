@@ -7,6 +7,7 @@
 #include <optional>
 
 #include "obd2.h"
+#include "obd2_pid_table.h"
 
 /**
  * @brief Вспомогательный метод для получения поддерживаемых PID
@@ -21,3 +22,44 @@ std::optional<uint32_t> OBD2::GetSupportedPids(uint8_t pid) {
   }
   return std::nullopt;
 }
+
+/**
+ * @brief Маски поддерживаемых PID всех ЭБУ одним функциональным запросом
+ *
+ * @param pid PID группы поддерживаемых PID
+ * @param[out] ecus Ответы ЭБУ; маска в data[A..D]
+ * @return size_t Количество ЭБУ, вернувших маску
+ */
+size_t OBD2::supportedPidsAllEcus(uint8_t pid, std::array<EcuResponse, kMaxEcus>& ecus) {
+  size_t count = 0;
+  for (size_t i = 0, total = queryAllEcus(SERVICE_01, pid, ecus); i < total; i++) {
+    if (ecus[i].len >= 4) {
+      ecus[count++] = ecus[i];
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Описание величины PID Service 01 в таблице kPidTable
+ *
+ * @param pid Parameter ID (PID)
+ * @param field Номер величины внутри PID
+ * @return const PidDescriptor* Запись таблицы, nullptr если ее нет
+ */
+const PidDescriptor* OBD2::pidDescriptor(uint8_t pid, uint8_t field) {
+  const size_t index = PidTableFind(pid, field);
+  return (index < kPidTableSize) ? &kPidTable[index] : nullptr;
+}
+
+/**
+ * @brief Чтение величины PID Service 01 по номеру через таблицу kPidTable
+ *
+ * @param pid Parameter ID (PID)
+ * @param field Номер величины внутри PID
+ * @return std::optional<float> Физическое значение
+ */
+std::optional<float> OBD2::readPidValue(uint8_t pid, uint8_t field) {
+  const PidDescriptor* descriptor = pidDescriptor(pid, field);
+  return (descriptor != nullptr) ? ReadPidEntry<float>(*descriptor) : std::nullopt;
+}
@@ -8,6 +8,7 @@
 #include <optional>
 
 #include "obd2.h"
+#include "obd2_pid_table.h"
 
 /**
  * @brief Получает список поддерживаемых PID в диапазоне 1-20
@@ -30,11 +31,7 @@ std::optional<uint32_t> OBD2::supportedPIDs_1_20() {
  * @return std::optional<uint32_t> Статус в битовом формате
  */
 std::optional<uint32_t> OBD2::monitorStatus() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, MONITOR_STATUS_SINCE_DTC_CLEARED, response)) {
-    return {(response[A] << 24) | (response[B] << 16) | (response[C] << 8) | response[D]};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, MONITOR_STATUS_SINCE_DTC_CLEARED>();
 }
 
 /**
@@ -46,11 +43,7 @@ std::optional<uint32_t> OBD2::monitorStatus() {
  * @return std::optional<uint16_t> Различные параметры автомобиля
  */
 std::optional<uint16_t> OBD2::freezeDTC() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FREEZE_DTC, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, FREEZE_DTC>();
 }
 
 /**
@@ -61,11 +54,7 @@ std::optional<uint16_t> OBD2::freezeDTC() {
  * @return std::optional<uint16_t> Статус в битовом формате
  */
 std::optional<uint16_t> OBD2::fuelSystemStatus() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_SYSTEM_STATUS, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, FUEL_SYSTEM_STATUS>();
 }
 
 /**
@@ -74,11 +63,7 @@ std::optional<uint16_t> OBD2::fuelSystemStatus() {
  * @return std::optional<float> Нагрузка двигателя в процентах [0-100%]
  */
 std::optional<float> OBD2::engineLoad() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_LOAD, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ENGINE_LOAD>();
 }
 
 /**
@@ -87,11 +72,7 @@ std::optional<float> OBD2::engineLoad() {
  * @return std::optional<int16_t> Температура в градусах Цельсия
  */
 std::optional<int16_t> OBD2::engineCoolantTemp() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_COOLANT_TEMP, response)) {
-    return {static_cast<int16_t>(response[A]) - 40.0};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, ENGINE_COOLANT_TEMP>();
 }
 
 /**
@@ -100,11 +81,7 @@ std::optional<int16_t> OBD2::engineCoolantTemp() {
  * @return std::optional<float> Коррекция топливоподачи в процентах [-100..99.2%]
  */
 std::optional<float> OBD2::shortTermFuelTrimBank_1() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, SHORT_TERM_FUEL_TRIM_BANK_1, response)) {
-    return {(response[A] * 100.0 / 128.0) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, SHORT_TERM_FUEL_TRIM_BANK_1>();
 }
 
 /**
@@ -113,11 +90,7 @@ std::optional<float> OBD2::shortTermFuelTrimBank_1() {
  * @return std::optional<float> Коррекция топливоподачи в процентах [-100..99.2%]
  */
 std::optional<float> OBD2::longTermFuelTrimBank_1() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, LONG_TERM_FUEL_TRIM_BANK_1, response)) {
-    return {(response[A] * 100.0 / 128.0) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, LONG_TERM_FUEL_TRIM_BANK_1>();
 }
 
 /**
@@ -126,11 +99,7 @@ std::optional<float> OBD2::longTermFuelTrimBank_1() {
  * @return std::optional<float> Коррекция топливоподачи в процентах [-100..99.2%]
  */
 std::optional<float> OBD2::shortTermFuelTrimBank_2() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, SHORT_TERM_FUEL_TRIM_BANK_2, response)) {
-    return {(response[A] * 100.0 / 128.0) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, SHORT_TERM_FUEL_TRIM_BANK_2>();
 }
 
 /**
@@ -139,11 +108,7 @@ std::optional<float> OBD2::shortTermFuelTrimBank_2() {
  * @return std::optional<float> Коррекция топливоподачи в процентах [-100..99.2%]
  */
 std::optional<float> OBD2::longTermFuelTrimBank_2() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, LONG_TERM_FUEL_TRIM_BANK_2, response)) {
-    return {(response[A] * 100.0 / 128.0) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, LONG_TERM_FUEL_TRIM_BANK_2>();
 }
 
 /**
@@ -152,11 +117,7 @@ std::optional<float> OBD2::longTermFuelTrimBank_2() {
  * @return std::optional<uint16_t> Давление топлива в кПа
  */
 std::optional<uint16_t> OBD2::fuelPressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_PRESSURE, response)) {
-    return {static_cast<uint16_t>(response[A]) * 3.0};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, FUEL_PRESSURE>();
 }
 
 /**
@@ -165,11 +126,7 @@ std::optional<uint16_t> OBD2::fuelPressure() {
  * @return std::optional<uint8_t> Давление в кПа
  */
 std::optional<uint8_t> OBD2::manifoldPressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, INTAKE_MANIFOLD_ABS_PRESSURE, response)) {
-    return {response[A]};
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, INTAKE_MANIFOLD_ABS_PRESSURE>();
 }
 
 /**
@@ -178,11 +135,7 @@ std::optional<uint8_t> OBD2::manifoldPressure() {
  * @return std::optional<float> Обороты двигателя в об/мин
  */
 std::optional<float> OBD2::rpm() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_RPM, response)) {
-    return {((response[A] << 8) | response[B]) / 4.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ENGINE_RPM>();
 }
 
 /**
@@ -191,11 +144,7 @@ std::optional<float> OBD2::rpm() {
  * @return std::optional<uint8_t> Скорость в км/ч
  */
 std::optional<uint8_t> OBD2::kph() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, VEHICLE_SPEED, response)) {
-    return response[A];
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, VEHICLE_SPEED>();
 }
 
 /**
@@ -204,11 +153,7 @@ std::optional<uint8_t> OBD2::kph() {
  * @return std::optional<float> Угол опережения в градусах до ВМТ
  */
 std::optional<float> OBD2::timingAdvance() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, TIMING_ADVANCE, response)) {
-    return {response[A] / 2.0 - 64.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, TIMING_ADVANCE>();
 }
 
 /**
@@ -217,11 +162,7 @@ std::optional<float> OBD2::timingAdvance() {
  * @return std::optional<int16_t> Температура в градусах Цельсия
  */
 std::optional<int16_t> OBD2::intakeAirTemp() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, INTAKE_AIR_TEMP, response)) {
-    return {static_cast<int16_t>(response[A]) - 40.0};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, INTAKE_AIR_TEMP>();
 }
 
 /**
@@ -230,11 +171,7 @@ std::optional<int16_t> OBD2::intakeAirTemp() {
  * @return std::optional<float> Расход воздуха в г/с
  */
 std::optional<float> OBD2::mafRate() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, MAF_FLOW_RATE, response)) {
-    return {((response[A] << 8) | response[B]) / 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, MAF_FLOW_RATE>();
 }
 
 /**
@@ -243,11 +180,7 @@ std::optional<float> OBD2::mafRate() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::throttle() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, THROTTLE_POSITION, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, THROTTLE_POSITION>();
 }
 
 /**
@@ -258,11 +191,7 @@ std::optional<float> OBD2::throttle() {
  * @return std::optional<uint8_t> Статус в битовом формате
  */
 std::optional<uint8_t> OBD2::commandedSecAirStatus() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, COMMANDED_SECONDARY_AIR_STATUS, response)) {
-    return response[A];
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, COMMANDED_SECONDARY_AIR_STATUS>();
 }
 
 /**
@@ -273,11 +202,7 @@ std::optional<uint8_t> OBD2::commandedSecAirStatus() {
  * @return std::optional<uint8_t> Битовая маска присутствующих датчиков
  */
 std::optional<uint8_t> OBD2::oxygenSensorsPresent_2banks() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSORS_PRESENT_2_BANKS, response)) {
-    return response[A];
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, OXYGEN_SENSORS_PRESENT_2_BANKS>();
 }
 
 /**
@@ -286,11 +211,7 @@ std::optional<uint8_t> OBD2::oxygenSensorsPresent_2banks() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor1Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_1_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_1_A>();
 }
 
 /**
@@ -299,11 +220,7 @@ std::optional<float> OBD2::oxygenSensor1Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor1FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_1_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_1_A, 1>();
 }
 
 /**
@@ -312,11 +229,7 @@ std::optional<float> OBD2::oxygenSensor1FuelTrim() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor2Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_2_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_2_A>();
 }
 
 /**
@@ -325,11 +238,7 @@ std::optional<float> OBD2::oxygenSensor2Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor2FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_2_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_2_A, 1>();
 }
 
 /**
@@ -338,11 +247,7 @@ std::optional<float> OBD2::oxygenSensor2FuelTrim() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor3Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_3_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_3_A>();
 }
 
 /**
@@ -351,11 +256,7 @@ std::optional<float> OBD2::oxygenSensor3Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor3FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_3_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_3_A, 1>();
 }
 
 /**
@@ -364,11 +265,7 @@ std::optional<float> OBD2::oxygenSensor3FuelTrim() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor4Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_4_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_4_A>();
 }
 
 /**
@@ -377,11 +274,7 @@ std::optional<float> OBD2::oxygenSensor4Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor4FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_4_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_4_A, 1>();
 }
 
 /**
@@ -390,11 +283,7 @@ std::optional<float> OBD2::oxygenSensor4FuelTrim() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor5Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_5_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_5_A>();
 }
 
 /**
@@ -403,11 +292,7 @@ std::optional<float> OBD2::oxygenSensor5Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor5FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_5_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_5_A, 1>();
 }
 
 /**
@@ -416,11 +301,7 @@ std::optional<float> OBD2::oxygenSensor5FuelTrim() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor6Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_6_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_6_A>();
 }
 
 /**
@@ -429,11 +310,7 @@ std::optional<float> OBD2::oxygenSensor6Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor6FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_6_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_6_A, 1>();
 }
 
 /**
@@ -442,11 +319,7 @@ std::optional<float> OBD2::oxygenSensor6FuelTrim() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor7Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_7_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_7_A>();
 }
 
 /**
@@ -455,11 +328,7 @@ std::optional<float> OBD2::oxygenSensor7Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor7FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_7_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_7_A, 1>();
 }
 
 /**
@@ -468,11 +337,7 @@ std::optional<float> OBD2::oxygenSensor7FuelTrim() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::oxygenSensor8Voltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_8_A, response)) {
-    return {response[A] / 200.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_8_A>();
 }
 
 /**
@@ -481,11 +346,7 @@ std::optional<float> OBD2::oxygenSensor8Voltage() {
  * @return std::optional<float> Коррекция топлива в процентах
  */
 std::optional<float> OBD2::oxygenSensor8FuelTrim() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSOR_8_A, response)) {
-    return {(response[B] * 100.0f / 128.0f) - 100.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, OXYGEN_SENSOR_8_A, 1>();
 }
 
 /**
@@ -496,11 +357,7 @@ std::optional<float> OBD2::oxygenSensor8FuelTrim() {
  * @return std::optional<uint8_t> Код стандарта OBD
  */
 std::optional<uint8_t> OBD2::obdStandards() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OBD_STANDARDS, response)) {
-    return response[A];
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, OBD_STANDARDS>();
 }
 
 /**
@@ -511,11 +368,7 @@ std::optional<uint8_t> OBD2::obdStandards() {
  * @return std::optional<uint8_t> Битовая маска присутствующих датчиков
  */
 std::optional<uint8_t> OBD2::oxygenSensorsPresent_4banks() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, OXYGEN_SENSORS_PRESENT_4_BANKS, response)) {
-    return response[A];
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, OXYGEN_SENSORS_PRESENT_4_BANKS>();
 }
 
 /**
@@ -524,11 +377,7 @@ std::optional<uint8_t> OBD2::oxygenSensorsPresent_4banks() {
  * @return std::optional<bool> Статус PTO
  */
 std::optional<bool> OBD2::auxInputStatus() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, AUX_INPUT_STATUS, response)) {
-    return static_cast<bool>(response[A]);
-  }
-  return std::nullopt;
+  return ReadPid<bool, AUX_INPUT_STATUS>();
 }
 
 /**
@@ -537,9 +386,5 @@ std::optional<bool> OBD2::auxInputStatus() {
  * @return std::optional<uint16_t> Время в секундах
  */
 std::optional<uint16_t> OBD2::runTime() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, RUN_TIME_SINCE_ENGINE_START, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, RUN_TIME_SINCE_ENGINE_START>();
 }
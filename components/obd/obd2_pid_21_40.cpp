@@ -8,6 +8,7 @@
 #include <optional>
 
 #include "obd2.h"
+#include "obd2_pid_table.h"
 
 /**
  * @brief Получает список поддерживаемых PID в диапазоне 21-40
@@ -27,11 +28,7 @@ std::optional<uint32_t> OBD2::supportedPIDs_21_40() {
  * @return std::optional<uint16_t> Расстояние в километрах
  */
 std::optional<uint16_t> OBD2::distTravelWithMIL() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, DISTANCE_TRAVELED_WITH_MIL_ON, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, DISTANCE_TRAVELED_WITH_MIL_ON>();
 }
 
 /**
@@ -40,11 +37,7 @@ std::optional<uint16_t> OBD2::distTravelWithMIL() {
  * @return std::optional<float> Давление в кПа
  */
 std::optional<float> OBD2::fuelRailPressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_RAIL_PRESSURE, response)) {
-    return {((response[A] << 8) | response[B]) * 0.079};
-  }
-  return std::nullopt;
+  return ReadPid<float, FUEL_RAIL_PRESSURE>();
 }
 
 /**
@@ -53,11 +46,7 @@ std::optional<float> OBD2::fuelRailPressure() {
  * @return std::optional<uint32_t> Давление в кПа
  */
 std::optional<uint32_t> OBD2::fuelRailGuagePressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_RAIL_GUAGE_PRESSURE, response)) {
-    return {((response[A] << 8) | response[B]) * 10};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, FUEL_RAIL_GUAGE_PRESSURE>();
 }
 
 /*
@@ -80,11 +69,7 @@ constexpr std::optional<uint8_t> OXYGEN_SENSOR_8_B             = 43;  // 0x2B -
  * @return std::optional<float> Процент EGR [0-100%]
  */
 std::optional<float> OBD2::commandedEGR() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, COMMANDED_EGR, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, COMMANDED_EGR>();
 }
 
 /**
@@ -93,11 +78,7 @@ std::optional<float> OBD2::commandedEGR() {
  * @return std::optional<float> Ошибка в процентах [-100..99.2%]
  */
 std::optional<float> OBD2::egrError() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, EGR_ERROR, response)) {
-    return {(response[A] * 100.0 / 128.0) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, EGR_ERROR>();
 }
 
 /**
@@ -106,11 +87,7 @@ std::optional<float> OBD2::egrError() {
  * @return std::optional<float> Процент продувки [0-100%]
  */
 std::optional<float> OBD2::commandedEvapPurge() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, COMMANDED_EVAPORATIVE_PURGE, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, COMMANDED_EVAPORATIVE_PURGE>();
 }
 
 /**
@@ -119,11 +96,7 @@ std::optional<float> OBD2::commandedEvapPurge() {
  * @return std::optional<float> Уровень в процентах [0-100%]
  */
 std::optional<float> OBD2::fuelLevel() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_TANK_LEVEL_INPUT, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, FUEL_TANK_LEVEL_INPUT>();
 }
 
 /**
@@ -132,11 +105,7 @@ std::optional<float> OBD2::fuelLevel() {
  * @return std::optional<uint8_t> Количество прогреваний
  */
 std::optional<uint8_t> OBD2::warmUpsSinceCodesCleared() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, WARM_UPS_SINCE_CODES_CLEARED, response)) {
-    return {response[A]};
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, WARM_UPS_SINCE_CODES_CLEARED>();
 }
 
 /**
@@ -145,11 +114,7 @@ std::optional<uint8_t> OBD2::warmUpsSinceCodesCleared() {
  * @return std::optional<uint16_t> Расстояние в километрах
  */
 std::optional<uint16_t> OBD2::distSinceCodesCleared() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, DIST_TRAV_SINCE_CODES_CLEARED, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, DIST_TRAV_SINCE_CODES_CLEARED>();
 }
 
 /**
@@ -158,11 +123,7 @@ std::optional<uint16_t> OBD2::distSinceCodesCleared() {
  * @return std::optional<float> Давление в Па
  */
 std::optional<float> OBD2::evapSysVapPressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, EVAP_SYSTEM_VAPOR_PRESSURE, response)) {
-    return {((response[A] << 8) | response[B]) / 4.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, EVAP_SYSTEM_VAPOR_PRESSURE>();
 }
 
 /**
@@ -171,11 +132,7 @@ std::optional<float> OBD2::evapSysVapPressure() {
  * @return std::optional<uint8_t> Давление в кПа
  */
 std::optional<uint8_t> OBD2::absBaroPressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_BAROMETRIC_PRESSURE, response)) {
-    return {response[A]};
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, ABS_BAROMETRIC_PRESSURE>();
 }
 
 /*
@@ -198,11 +155,7 @@ constexpr std::optional<uint8_t> OXYGEN_SENSOR_8_C             = 59;  // 0x3B -
  * @return std::optional<float> Температура в градусах Цельсия
  */
 std::optional<float> OBD2::catTempB1S1() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, CATALYST_TEMP_BANK_1_SENSOR_1, response)) {
-    return {(((response[A] << 8) | response[B]) / 10.0) - 40.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, CATALYST_TEMP_BANK_1_SENSOR_1>();
 }
 
 /**
@@ -211,11 +164,7 @@ std::optional<float> OBD2::catTempB1S1() {
  * @return std::optional<float> Температура в градусах Цельсия
  */
 std::optional<float> OBD2::catTempB2S1() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, CATALYST_TEMP_BANK_2_SENSOR_1, response)) {
-    return {(((response[A] << 8) | response[B]) / 10.0) - 40.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, CATALYST_TEMP_BANK_2_SENSOR_1>();
 }
 
 /**
@@ -224,11 +173,7 @@ std::optional<float> OBD2::catTempB2S1() {
  * @return std::optional<float> Температура в градусах Цельсия
  */
 std::optional<float> OBD2::catTempB1S2() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, CATALYST_TEMP_BANK_1_SENSOR_2, response)) {
-    return {(((response[A] << 8) | response[B]) / 10.0) - 40.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, CATALYST_TEMP_BANK_1_SENSOR_2>();
 }
 
 /**
@@ -237,9 +182,5 @@ std::optional<float> OBD2::catTempB1S2() {
  * @return std::optional<float> Температура в градусах Цельсия
  */
 std::optional<float> OBD2::catTempB2S2() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, CATALYST_TEMP_BANK_2_SENSOR_2, response)) {
-    return {(((response[A] << 8) | response[B]) / 10.0) - 40.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, CATALYST_TEMP_BANK_2_SENSOR_2>();
 }
\ No newline at end of file
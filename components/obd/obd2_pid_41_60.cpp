@@ -7,6 +7,7 @@
 #include <optional>
 
 #include "obd2.h"
+#include "obd2_pid_table.h"
 
 /**
  * @brief Получает список поддерживаемых PID в диапазоне 41-60
@@ -27,11 +28,7 @@ std::optional<uint32_t> OBD2::supportedPIDs_41_60() {
  * @return std::optional<uint32_t> Статус в битовом формате
  */
 std::optional<uint32_t> OBD2::monitorDriveCycleStatus() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, MONITOR_STATUS_THIS_DRIVE_CYCLE, response)) {
-    return {(response[A] << 24) | (response[B] << 16) | (response[C] << 8) | response[D]};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, MONITOR_STATUS_THIS_DRIVE_CYCLE>();
 }
 
 /**
@@ -40,11 +37,7 @@ std::optional<uint32_t> OBD2::monitorDriveCycleStatus() {
  * @return std::optional<float> Напряжение в вольтах
  */
 std::optional<float> OBD2::ctrlModVoltage() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, CONTROL_MODULE_VOLTAGE, response)) {
-    return {((response[A] << 8) | response[B]) / 1000.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, CONTROL_MODULE_VOLTAGE>();
 }
 
 /**
@@ -53,11 +46,7 @@ std::optional<float> OBD2::ctrlModVoltage() {
  * @return std::optional<float> Нагрузка в процентах [0-100%]
  */
 std::optional<float> OBD2::absLoad() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_LOAD_VALUE, response)) {
-    return {((response[A] << 8) | response[B]) * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ABS_LOAD_VALUE>();
 }
 
 /**
@@ -66,11 +55,7 @@ std::optional<float> OBD2::absLoad() {
  * @return std::optional<float> Коэффициент эквивалентности
  */
 std::optional<float> OBD2::commandedAirFuelRatio() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_AIR_COMMANDED_EQUIV_RATIO, response)) {
-    return {((response[A] << 8) | response[B]) / 32768.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, FUEL_AIR_COMMANDED_EQUIV_RATIO>();
 }
 
 /**
@@ -79,11 +64,7 @@ std::optional<float> OBD2::commandedAirFuelRatio() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::relativeThrottle() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, RELATIVE_THROTTLE_POSITION, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, RELATIVE_THROTTLE_POSITION>();
 }
 
 /**
@@ -92,11 +73,7 @@ std::optional<float> OBD2::relativeThrottle() {
  * @return std::optional<int16_t> Температура в градусах Цельсия
  */
 std::optional<int16_t> OBD2::ambientAirTemp() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, AMBIENT_AIR_TEMP, response)) {
-    return {static_cast<int16_t>(response[A]) - 40};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, AMBIENT_AIR_TEMP>();
 }
 
 /**
@@ -105,11 +82,7 @@ std::optional<int16_t> OBD2::ambientAirTemp() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::absThrottlePosB() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_THROTTLE_POSITION_B, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ABS_THROTTLE_POSITION_B>();
 }
 
 /**
@@ -118,11 +91,7 @@ std::optional<float> OBD2::absThrottlePosB() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::absThrottlePosC() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_THROTTLE_POSITION_C, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ABS_THROTTLE_POSITION_C>();
 }
 
 /**
@@ -131,11 +100,7 @@ std::optional<float> OBD2::absThrottlePosC() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::absThrottlePosD() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_THROTTLE_POSITION_D, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ABS_THROTTLE_POSITION_D>();
 }
 
 /**
@@ -144,11 +109,7 @@ std::optional<float> OBD2::absThrottlePosD() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::absThrottlePosE() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_THROTTLE_POSITION_E, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ABS_THROTTLE_POSITION_E>();
 }
 
 /**
@@ -157,11 +118,7 @@ std::optional<float> OBD2::absThrottlePosE() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::absThrottlePosF() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_THROTTLE_POSITION_F, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ABS_THROTTLE_POSITION_F>();
 }
 
 /**
@@ -170,11 +127,7 @@ std::optional<float> OBD2::absThrottlePosF() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::commandedThrottleActuator() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, COMMANDED_THROTTLE_ACTUATOR, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, COMMANDED_THROTTLE_ACTUATOR>();
 }
 
 /**
@@ -183,11 +136,7 @@ std::optional<float> OBD2::commandedThrottleActuator() {
  * @return std::optional<uint16_t> Время в минутах
  */
 std::optional<uint16_t> OBD2::timeRunWithMIL() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, TIME_RUN_WITH_MIL_ON, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, TIME_RUN_WITH_MIL_ON>();
 }
 
 /**
@@ -196,11 +145,7 @@ std::optional<uint16_t> OBD2::timeRunWithMIL() {
  * @return std::optional<uint16_t> Время в минутах
  */
 std::optional<uint16_t> OBD2::timeSinceCodesCleared() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, TIME_SINCE_CODES_CLEARED, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, TIME_SINCE_CODES_CLEARED>();
 }
 
 /*
@@ -216,11 +161,7 @@ constexpr std::optional<uint8_t> MAX_VALUES_EQUIV_V_I_PRESSURE = 79;  // 0x4F -
  * @return std::optional<uint16_t> Расход воздуха в г/с
  */
 std::optional<uint16_t> OBD2::maxMafRate() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, MAX_MAF_RATE, response)) {
-    return {response[A] * 10};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, MAX_MAF_RATE>();
 }
 
 /**
@@ -230,11 +171,7 @@ std::optional<uint16_t> OBD2::maxMafRate() {
  * @return std::optional<uint8_t> Код типа топлива
  */
 std::optional<uint8_t> OBD2::fuelType() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_TYPE, response)) {
-    return {response[A]};
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, FUEL_TYPE>();
 }
 
 /**
@@ -243,11 +180,7 @@ std::optional<uint8_t> OBD2::fuelType() {
  * @return std::optional<float> Процент этанола [0-100%]
  */
 std::optional<float> OBD2::ethanolPercent() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ETHANOL_FUEL_PERCENT, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ETHANOL_FUEL_PERCENT>();
 }
 
 /**
@@ -256,11 +189,7 @@ std::optional<float> OBD2::ethanolPercent() {
  * @return std::optional<float> Давление в кПа
  */
 std::optional<float> OBD2::absEvapSysVapPressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ABS_EVAP_SYS_VAPOR_PRESSURE, response)) {
-    return {((response[A] << 8) | response[B]) / 200.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ABS_EVAP_SYS_VAPOR_PRESSURE>();
 }
 
 /**
@@ -269,11 +198,7 @@ std::optional<float> OBD2::absEvapSysVapPressure() {
  * @return std::optional<int32_t> Давление в Па
  */
 std::optional<int32_t> OBD2::evapSysVapPressure2() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, EVAP_SYS_VAPOR_PRESSURE, response)) {
-    return {static_cast<int32_t>((response[A] << 8) | response[B]) - 32767};
-  }
-  return std::nullopt;
+  return ReadPid<int32_t, EVAP_SYS_VAPOR_PRESSURE>();
 }
 
 /**
@@ -282,11 +207,7 @@ std::optional<int32_t> OBD2::evapSysVapPressure2() {
  * @return std::optional<float> Коррекция в процентах [-100.0 до +99.2%]
  */
 std::optional<float> OBD2::shortTermSecOxyTrim13() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, SHORT_TERM_SEC_OXY_SENS_TRIM_1_3, response)) {
-    return {(response[A] * (100.0 / 128.0)) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, SHORT_TERM_SEC_OXY_SENS_TRIM_1_3>();
 }
 
 /**
@@ -295,11 +216,7 @@ std::optional<float> OBD2::shortTermSecOxyTrim13() {
  * @return std::optional<float> Коррекция в процентах [-100.0 до +99.2%]
  */
 std::optional<float> OBD2::longTermSecOxyTrim13() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, LONG_TERM_SEC_OXY_SENS_TRIM_1_3, response)) {
-    return {(response[A] * (100.0 / 128.0)) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, LONG_TERM_SEC_OXY_SENS_TRIM_1_3>();
 }
 
 /**
@@ -308,11 +225,7 @@ std::optional<float> OBD2::longTermSecOxyTrim13() {
  * @return std::optional<float> Коррекция в процентах [-100.0 до +99.2%]
  */
 std::optional<float> OBD2::shortTermSecOxyTrim24() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, SHORT_TERM_SEC_OXY_SENS_TRIM_2_4, response)) {
-    return {(response[A] * (100.0 / 128.0)) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, SHORT_TERM_SEC_OXY_SENS_TRIM_2_4>();
 }
 
 /**
@@ -321,11 +234,7 @@ std::optional<float> OBD2::shortTermSecOxyTrim24() {
  * @return std::optional<float> Коррекция в процентах [-100.0 до +99.2%]
  */
 std::optional<float> OBD2::longTermSecOxyTrim24() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, LONG_TERM_SEC_OXY_SENS_TRIM_2_4, response)) {
-    return {(response[A] * (100.0 / 128.0)) - 100.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, LONG_TERM_SEC_OXY_SENS_TRIM_2_4>();
 }
 
 /**
@@ -334,11 +243,7 @@ std::optional<float> OBD2::longTermSecOxyTrim24() {
  * @return std::optional<uint32_t> Давление в кПа
  */
 std::optional<uint32_t> OBD2::absFuelRailPressure() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_RAIL_ABS_PRESSURE, response)) {
-    return {((response[A] << 8) | response[B]) * 10};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, FUEL_RAIL_ABS_PRESSURE>();
 }
 
 /**
@@ -347,11 +252,7 @@ std::optional<uint32_t> OBD2::absFuelRailPressure() {
  * @return std::optional<float> Положение в процентах [0-100%]
  */
 std::optional<float> OBD2::relativePedalPos() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, RELATIVE_ACCELERATOR_PEDAL_POS, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, RELATIVE_ACCELERATOR_PEDAL_POS>();
 }
 
 /**
@@ -360,11 +261,7 @@ std::optional<float> OBD2::relativePedalPos() {
  * @return std::optional<float> Остаток ресурса в процентах [0-100%]
  */
 std::optional<float> OBD2::hybridBatLife() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, HYBRID_BATTERY_REMAINING_LIFE, response)) {
-    return {response[A] * 100.0 / 255.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, HYBRID_BATTERY_REMAINING_LIFE>();
 }
 
 /**
@@ -373,11 +270,7 @@ std::optional<float> OBD2::hybridBatLife() {
  * @return std::optional<int16_t> Температура в градусах Цельсия
  */
 std::optional<int16_t> OBD2::oilTemp() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_OIL_TEMP, response)) {
-    return {static_cast<int16_t>(response[A]) - 40.0};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, ENGINE_OIL_TEMP>();
 }
 
 /**
@@ -386,11 +279,7 @@ std::optional<int16_t> OBD2::oilTemp() {
  * @return std::optional<float> Угол в градусах
  */
 std::optional<float> OBD2::fuelInjectTiming() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_INJECTION_TIMING, response)) {
-    return {(((response[A] << 8) | response[B]) / 128.0) - 210};
-  }
-  return std::nullopt;
+  return ReadPid<float, FUEL_INJECTION_TIMING>();
 }
 
 /**
@@ -399,11 +288,7 @@ std::optional<float> OBD2::fuelInjectTiming() {
  * @return std::optional<float> Расход в литрах в час
  */
 std::optional<float> OBD2::fuelRate() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_FUEL_RATE, response)) {
-    return {((response[A] << 8) | response[B]) / 20.0};
-  }
-  return std::nullopt;
+  return ReadPid<float, ENGINE_FUEL_RATE>();
 }
 
 /**
@@ -412,9 +297,5 @@ std::optional<float> OBD2::fuelRate() {
  * @return std::optional<uint8_t> Код стандарта выбросов
  */
 std::optional<uint8_t> OBD2::emissionRqmts() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, EMISSION_REQUIREMENTS, response)) {
-    return {response[A]};
-  }
-  return std::nullopt;
+  return ReadPid<uint8_t, EMISSION_REQUIREMENTS>();
 }
\ No newline at end of file
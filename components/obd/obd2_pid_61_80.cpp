@@ -7,6 +7,7 @@
 #include <optional>
 
 #include "obd2.h"
+#include "obd2_pid_table.h"
 
 /**
  * @brief Получает список поддерживаемых PID в диапазоне 61-80
@@ -26,11 +27,7 @@ std::optional<uint32_t> OBD2::supportedPIDs_61_80() {
  * @return std::optional<int16_t> Крутящий момент в процентах [-125..125%]
  */
 std::optional<int16_t> OBD2::demandedTorque() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, DEMANDED_ENGINE_PERCENT_TORQUE, response)) {
-    return {static_cast<int16_t>(response[A]) - 125.0};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, DEMANDED_ENGINE_PERCENT_TORQUE>();
 }
 
 /**
@@ -39,11 +36,7 @@ std::optional<int16_t> OBD2::demandedTorque() {
  * @return std::optional<int16_t> Крутящий момент в процентах [-125..125%]
  */
 std::optional<int16_t> OBD2::torque() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ACTUAL_ENGINE_TORQUE, response)) {
-    return {static_cast<int16_t>(response[A]) - 125.0};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, ACTUAL_ENGINE_TORQUE>();
 }
 
 /**
@@ -52,11 +45,7 @@ std::optional<int16_t> OBD2::torque() {
  * @return std::optional<uint16_t> Крутящий момент в Н·м
  */
 std::optional<uint16_t> OBD2::referenceTorque() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_REFERENCE_TORQUE, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, ENGINE_REFERENCE_TORQUE>();
 }
 
 /**
@@ -72,15 +61,7 @@ std::optional<uint16_t> OBD2::referenceTorque() {
  * @return std::optional<std::array<int16_t, 5>> Массив процентов крутящего момента [-125..125%]
  */
 std::optional<std::array<int16_t, 5>> OBD2::enginePercentTorqueData() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_PERCENT_TORQUE_DATA, response)) {
-    std::array<int16_t, 5> result;
-    for (size_t i = 0; i < 5; ++i) {
-      result[i] = static_cast<int16_t>(response[i]) - 125;
-    }
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<int16_t, ENGINE_PERCENT_TORQUE_DATA, 5>();
 }
 
 /**
@@ -89,9 +70,5 @@ std::optional<std::array<int16_t, 5>> OBD2::enginePercentTorqueData() {
  * @return std::optional<uint16_t> Битовая маска поддерживаемых функций
  */
 std::optional<uint16_t> OBD2::auxSupported() {
-  ResponseType response;
-  if (ProcessPid(SERVICE_01, AUX_INPUT_OUTPUT_SUPPORTED, response)) {
-    return {(response[A] << 8) | response[B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, AUX_INPUT_OUTPUT_SUPPORTED>();
 }
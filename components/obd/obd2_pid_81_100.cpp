@@ -8,6 +8,7 @@
 #include <optional>
 
 #include "obd2.h"
+#include "obd2_pid_table.h"
 
 /**
  * @brief Получает список поддерживаемых PID в диапазоне 81-100
@@ -26,11 +27,7 @@ std::optional<uint32_t> OBD2::supportedPIDs81_100() {
  * @return std::optional<uint32_t> Время работы в секундах
  */
 std::optional<uint32_t> OBD2::engineRunTimeAECD1_2() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_RUN_TIME_AECD_1_2, response)) {
-    return {((response[OBD2::A] << 24) | (response[OBD2::B] << 16) | (response[OBD2::C] << 8) | response[OBD2::D])};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, ENGINE_RUN_TIME_AECD_1_2>();
 }
 
 /**
@@ -39,11 +36,7 @@ std::optional<uint32_t> OBD2::engineRunTimeAECD1_2() {
  * @return std::optional<uint32_t> Время работы в секундах
  */
 std::optional<uint32_t> OBD2::engineRunTimeAECD3_4() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_RUN_TIME_AECD_3_4, response)) {
-    return {((response[OBD2::A] << 24) | (response[OBD2::B] << 16) | (response[OBD2::C] << 8) | response[OBD2::D])};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, ENGINE_RUN_TIME_AECD_3_4>();
 }
 
 /**
@@ -52,14 +45,7 @@ std::optional<uint32_t> OBD2::engineRunTimeAECD3_4() {
  * @return std::optional<std::array<uint16_t, 2>> Концентрация NOx в ppm для двух датчиков
  */
 std::optional<std::array<uint16_t, 2>> OBD2::noxSensor() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, NOX_SENSOR, response)) {
-    std::array<uint16_t, 2> result;
-    result[0] = (response[OBD2::A] << 8) | response[OBD2::B];
-    result[1] = (response[OBD2::C] << 8) | response[OBD2::D];
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<uint16_t, NOX_SENSOR, 2>();
 }
 
 /**
@@ -68,11 +54,7 @@ std::optional<std::array<uint16_t, 2>> OBD2::noxSensor() {
  * @return std::optional<int16_t> Температура в градусах Цельсия
  */
 std::optional<int16_t> OBD2::manifoldSurfaceTemp() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, MANIFOLD_SURFACE_TEMP, response)) {
-    return {static_cast<int16_t>((response[OBD2::A] << 8) | response[OBD2::B]) - 40};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, MANIFOLD_SURFACE_TEMP>();
 }
 
 /**
@@ -81,11 +63,7 @@ std::optional<int16_t> OBD2::manifoldSurfaceTemp() {
  * @return std::optional<float> Уровень реагента в процентах [0-100%]
  */
 std::optional<float> OBD2::noxReagentSystem() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, NOX_REAGENT_SYSTEM, response)) {
-    return {response[OBD2::A] * 100.0f / 255.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, NOX_REAGENT_SYSTEM>();
 }
 
 /**
@@ -95,15 +73,7 @@ std::optional<float> OBD2::noxReagentSystem() {
  * °C]
  */
 std::optional<std::array<uint16_t, 3>> OBD2::pmSensor() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, PM_SENSOR, response)) {
-    std::array<uint16_t, 3> result;
-    result[0] = (response[OBD2::A] << 8) | response[OBD2::B];  // Масса
-    result[1] = (response[OBD2::C] << 8) | response[OBD2::D];  // Количество света
-    result[2] = (response[OBD2::E] << 8) | response[OBD2::F];  // Температура
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<uint16_t, PM_SENSOR, 3>();
 }
 
 /**
@@ -112,11 +82,7 @@ std::optional<std::array<uint16_t, 3>> OBD2::pmSensor() {
  * @return std::optional<uint16_t> Давление в кПа
  */
 std::optional<uint16_t> OBD2::intakeManifoldAbsPressure() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, INTAKE_MANIFOLD_ABS_PRESSURE_81_100, response)) {
-    return {(response[OBD2::A] << 8) | response[OBD2::B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, INTAKE_MANIFOLD_ABS_PRESSURE_81_100>();
 }
 
 /**
@@ -126,17 +92,7 @@ std::optional<uint16_t> OBD2::intakeManifoldAbsPressure() {
  * с последней дозировки, время работы насоса, время работы клапана]
  */
 std::optional<std::array<uint16_t, 5>> OBD2::scrInduceSystem() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, SCR_INDUCE_SYSTEM, response)) {
-    std::array<uint16_t, 5> result;
-    result[0] = (response[OBD2::A] << 8) | response[OBD2::B];  // Состояние
-    result[1] = (response[OBD2::C] << 8) | response[OBD2::D];  // Время до следующей дозировки
-    result[2] = (response[OBD2::E] << 8) | response[OBD2::F];  // Время с последней дозировки
-    result[3] = (response[OBD2::G] << 8) | response[OBD2::H];  // Время работы насоса
-    // response[OBD2::H] не используется
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<uint16_t, SCR_INDUCE_SYSTEM, 5>();
 }
 
 /**
@@ -145,11 +101,7 @@ std::optional<std::array<uint16_t, 5>> OBD2::scrInduceSystem() {
  * @return std::optional<uint32_t> Время работы в секундах
  */
 std::optional<uint32_t> OBD2::runTimeAECD11_15() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, RUN_TIME_AECD_11_15, response)) {
-    return {((response[OBD2::A] << 24) | (response[OBD2::B] << 16) | (response[OBD2::C] << 8) | response[OBD2::D])};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, RUN_TIME_AECD_11_15>();
 }
 
 /**
@@ -158,11 +110,7 @@ std::optional<uint32_t> OBD2::runTimeAECD11_15() {
  * @return std::optional<uint32_t> Время работы в секундах
  */
 std::optional<uint32_t> OBD2::runTimeAECD16_20() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, RUN_TIME_AECD_16_20, response)) {
-    return {((response[OBD2::A] << 24) | (response[OBD2::B] << 16) | (response[OBD2::C] << 8) | response[OBD2::D])};
-  }
-  return std::nullopt;
+  return ReadPid<uint32_t, RUN_TIME_AECD_16_20>();
 }
 
 /**
@@ -172,17 +120,7 @@ std::optional<uint32_t> OBD2::runTimeAECD16_20() {
  * температура 2, температура 3, температура 4, давление 1, давление 2]
  */
 std::optional<std::array<uint16_t, 7>> OBD2::dieselAftertreatment() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, DIESEL_AFTERTREATMENT, response)) {
-    std::array<uint16_t, 7> result;
-    result[0] = (response[OBD2::A] << 8) | response[OBD2::B];  // Состояние
-    result[1] = (response[OBD2::C] << 8) | response[OBD2::D];  // Температура 1
-    result[2] = (response[OBD2::E] << 8) | response[OBD2::F];  // Температура 2
-    result[3] = (response[OBD2::G] << 8) | response[OBD2::H];  // Температура 3
-    // response[OBD2::H] не используется
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<uint16_t, DIESEL_AFTERTREATMENT, 7>();
 }
 
 /**
@@ -191,14 +129,7 @@ std::optional<std::array<uint16_t, 7>> OBD2::dieselAftertreatment() {
  * @return std::optional<std::array<float, 2>> Напряжение датчиков O2 в вольтах
  */
 std::optional<std::array<float, 2>> OBD2::o2SensorWideRange() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, O2_SENSOR_WIDE_RANGE, response)) {
-    std::array<float, 2> result;
-    result[0] = ((response[OBD2::A] << 8) | response[OBD2::B]) * 0.001f;  // Напряжение 1
-    result[1] = ((response[OBD2::C] << 8) | response[OBD2::D]) * 0.001f;  // Напряжение 2
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<float, O2_SENSOR_WIDE_RANGE, 2>();
 }
 
 /**
@@ -207,11 +138,7 @@ std::optional<std::array<float, 2>> OBD2::o2SensorWideRange() {
  * @return std::optional<float> Положение дроссельной заслонки в процентах [0-100%]
  */
 std::optional<float> OBD2::throttlePositionG() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, THROTTLE_POSITION_G, response)) {
-    return {response[OBD2::A] * 100.0f / 255.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, THROTTLE_POSITION_G>();
 }
 
 /**
@@ -220,11 +147,7 @@ std::optional<float> OBD2::throttlePositionG() {
  * @return std::optional<int16_t> Процент крутящего момента [-125..125%]
  */
 std::optional<int16_t> OBD2::engineFrictionPercentTorque() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_FRICTION_PERCENT_TORQUE, response)) {
-    return {static_cast<int16_t>(response[OBD2::A]) - 125};
-  }
-  return std::nullopt;
+  return ReadPid<int16_t, ENGINE_FRICTION_PERCENT_TORQUE>();
 }
 
 /**
@@ -233,16 +156,7 @@ std::optional<int16_t> OBD2::engineFrictionPercentTorque() {
  * @return std::optional<std::array<uint16_t, 4>> Данные PM сенсоров: [масса 1, масса 2, температура 1, температура 2]
  */
 std::optional<std::array<uint16_t, 4>> OBD2::pmSensorBank1_2() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, PM_SENSOR_BANK_1_2, response)) {
-    std::array<uint16_t, 4> result;
-    result[0] = (response[OBD2::A] << 8) | response[OBD2::B];  // Масса 1
-    result[1] = (response[OBD2::C] << 8) | response[OBD2::D];  // Масса 2
-    result[2] = (response[OBD2::E] << 8) | response[OBD2::F];  // Температура 1
-    result[3] = (response[OBD2::G] << 8) | response[OBD2::H];  // Температура 2
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<uint16_t, PM_SENSOR_BANK_1_2, 4>();
 }
 
 /**
@@ -251,11 +165,7 @@ std::optional<std::array<uint16_t, 4>> OBD2::pmSensorBank1_2() {
  * @return std::optional<uint16_t> Информация о системе OBD
  */
 std::optional<uint16_t> OBD2::wwhObdVehicleInfo() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, WWH_OBD_VEHICLE_INFO_1, response)) {
-    return {(response[OBD2::A] << 8) | response[OBD2::B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, WWH_OBD_VEHICLE_INFO_1>();
 }
 
 /**
@@ -264,11 +174,7 @@ std::optional<uint16_t> OBD2::wwhObdVehicleInfo() {
  * @return std::optional<uint16_t> Информация о системе OBD
  */
 std::optional<uint16_t> OBD2::wwhObdVehicleInfo2() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, WWH_OBD_VEHICLE_INFO_2, response)) {
-    return {(response[OBD2::A] << 8) | response[OBD2::B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, WWH_OBD_VEHICLE_INFO_2>();
 }
 
 /**
@@ -277,11 +183,7 @@ std::optional<uint16_t> OBD2::wwhObdVehicleInfo2() {
  * @return std::optional<uint16_t> Управление топливной системой
  */
 std::optional<uint16_t> OBD2::fuelSystemControl() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_SYSTEM_CONTROL, response)) {
-    return {(response[OBD2::A] << 8) | response[OBD2::B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, FUEL_SYSTEM_CONTROL>();
 }
 
 /**
@@ -290,11 +192,7 @@ std::optional<uint16_t> OBD2::fuelSystemControl() {
  * @return std::optional<uint16_t> Поддержка счетчиков OBD
  */
 std::optional<uint16_t> OBD2::wwhObdCountersSupport() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, WWH_OBD_COUNTERS_SUPPORT, response)) {
-    return {(response[OBD2::A] << 8) | response[OBD2::B]};
-  }
-  return std::nullopt;
+  return ReadPid<uint16_t, WWH_OBD_COUNTERS_SUPPORT>();
 }
 
 /**
@@ -304,15 +202,7 @@ std::optional<uint16_t> OBD2::wwhObdCountersSupport() {
  * индуцирования, время индуцирования, количество индуцирований]
  */
 std::optional<std::array<uint16_t, 4>> OBD2::noxWarningInducementSystem() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, NOX_WARNING_INDUCTION_SYSTEM, response)) {
-    std::array<uint16_t, 4> result;
-    result[0] = (response[OBD2::A] << 8) | response[OBD2::B];  // Состояние
-    result[1] = (response[OBD2::C] << 8) | response[OBD2::D];  // Время до индуцирования
-    // response[OBD2::E] и response[OBD2::F] не используются
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<uint16_t, NOX_WARNING_INDUCTION_SYSTEM, 4>();
 }
 
 /**
@@ -321,14 +211,7 @@ std::optional<std::array<uint16_t, 4>> OBD2::noxWarningInducementSystem() {
  * @return std::optional<std::array<int16_t, 2>> Температура выхлопных газов в °C для двух датчиков
  */
 std::optional<std::array<int16_t, 2>> OBD2::exhaustGasTempSensor() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, EXHAUST_GAS_TEMP_SENSOR_1, response)) {
-    std::array<int16_t, 2> result;
-    result[0] = static_cast<int16_t>((response[OBD2::A] << 8) | response[OBD2::B]) - 40;  // Температура 1
-    result[1] = static_cast<int16_t>((response[OBD2::C] << 8) | response[OBD2::D]) - 40;  // Температура 2
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<int16_t, EXHAUST_GAS_TEMP_SENSOR_1, 2>();
 }
 
 /**
@@ -337,14 +220,7 @@ std::optional<std::array<int16_t, 2>> OBD2::exhaustGasTempSensor() {
  * @return std::optional<std::array<int16_t, 2>> Температура выхлопных газов в °C для двух датчиков
  */
 std::optional<std::array<int16_t, 2>> OBD2::exhaustGasTempSensor2() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, EXHAUST_GAS_TEMP_SENSOR_2, response)) {
-    std::array<int16_t, 2> result;
-    result[0] = static_cast<int16_t>((response[OBD2::A] << 8) | response[OBD2::B]) - 40;  // Температура 1
-    result[1] = static_cast<int16_t>((response[OBD2::C] << 8) | response[OBD2::D]) - 40;  // Температура 2
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<int16_t, EXHAUST_GAS_TEMP_SENSOR_2, 2>();
 }
 
 /**
@@ -353,11 +229,7 @@ std::optional<std::array<int16_t, 2>> OBD2::exhaustGasTempSensor2() {
  * @return std::optional<float> Напряжение батареи в вольтах
  */
 std::optional<float> OBD2::hybridEvBatteryVoltage() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, HYBRID_EV_BATTERY_VOLTAGE, response)) {
-    return {((response[OBD2::A] << 8) | response[OBD2::B]) * 0.001f};
-  }
-  return std::nullopt;
+  return ReadPid<float, HYBRID_EV_BATTERY_VOLTAGE>();
 }
 
 /**
@@ -366,11 +238,7 @@ std::optional<float> OBD2::hybridEvBatteryVoltage() {
  * @return std::optional<float> Уровень DEF в процентах [0-100%]
  */
 std::optional<float> OBD2::dieselExhaustFluidSensor() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, DIESEL_EXHAUST_FLUID_SENSOR_DATA, response)) {
-    return {response[OBD2::D] * 100.0f / 255.0f};
-  }
-  return std::nullopt;
+  return ReadPid<float, DIESEL_EXHAUST_FLUID_SENSOR_DATA>();
 }
 
 /**
@@ -379,16 +247,7 @@ std::optional<float> OBD2::dieselExhaustFluidSensor() {
  * @return std::optional<std::array<float, 4>> Данные датчиков O2: [напряжение 1, напряжение 2, ток 1, ток 2]
  */
 std::optional<std::array<float, 4>> OBD2::o2SensorData() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, O2_SENSOR_DATA_81_100, response)) {
-    std::array<float, 4> result;
-    result[0] = ((response[OBD2::A] << 8) | response[OBD2::B]) * 0.001f;  // Напряжение 1
-    result[1] = ((response[OBD2::C] << 8) | response[OBD2::D]) * 0.001f;  // Напряжение 2
-    result[2] = ((response[OBD2::E] << 8) | response[OBD2::F]) * 0.001f;  // Ток 1
-    result[3] = ((response[OBD2::G] << 8) | response[OBD2::H]) * 0.001f;  // Ток 2
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<float, O2_SENSOR_DATA_81_100, 4>();
 }
 
 /**
@@ -397,11 +256,7 @@ std::optional<std::array<float, 4>> OBD2::o2SensorData() {
  * @return std::optional<float> Расход топлива в г/с
  */
 std::optional<float> OBD2::engineFuelRate() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_FUEL_RATE_81_100, response)) {
-    return {((response[OBD2::A] << 8) | response[OBD2::B]) * 0.05f};
-  }
-  return std::nullopt;
+  return ReadPid<float, ENGINE_FUEL_RATE_81_100>();
 }
 
 /**
@@ -410,11 +265,7 @@ std::optional<float> OBD2::engineFuelRate() {
  * @return std::optional<float> Поток выхлопа в кг/ч
  */
 std::optional<float> OBD2::engineExhaustFlowRate() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, ENGINE_EXHAUST_FLOW_RATE, response)) {
-    return {((response[OBD2::A] << 8) | response[OBD2::B]) * 0.1f};
-  }
-  return std::nullopt;
+  return ReadPid<float, ENGINE_EXHAUST_FLOW_RATE>();
 }
 
 /**
@@ -423,14 +274,5 @@ std::optional<float> OBD2::engineExhaustFlowRate() {
  * @return std::optional<std::array<float, 4>> Процент использования топлива: [дизель, бензин, CNG, LPG]
  */
 std::optional<std::array<float, 4>> OBD2::fuelSystemPercentageUse() {
-  OBD2::ResponseType response;
-  if (ProcessPid(SERVICE_01, FUEL_SYSTEM_PERCENTAGE_USE, response)) {
-    std::array<float, 4> result;
-    result[0] = response[OBD2::A] * 100.0f / 255.0f;  // Дизель
-    result[1] = response[OBD2::B] * 100.0f / 255.0f;  // Бензин
-    result[2] = response[OBD2::C] * 100.0f / 255.0f;  // CNG
-    result[3] = response[OBD2::D] * 100.0f / 255.0f;  // LPG
-    return result;
-  }
-  return std::nullopt;
+  return ReadPidFields<float, FUEL_SYSTEM_PERCENTAGE_USE, 4>();
 }
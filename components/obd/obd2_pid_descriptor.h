@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Пересчет сырого значения PID в физическое
+ */
+enum class PidFormula : uint8_t {
+  RAW = 0,  // Целое без пересчета: битовые поля, перечисления, счетчики
+  LINEAR    // raw * mul / div + offset
+};
+
+/**
+ * @brief Единица измерения значения PID
+ */
+enum class PidUnit : uint8_t {
+  NONE = 0,  // Битовые поля, перечисления
+  PERCENT,
+  CELSIUS,
+  KPA,
+  PA,
+  RPM,
+  KMH,
+  DEGREE,
+  GRAMS_PER_SEC,
+  KG_PER_HOUR,
+  LITERS_PER_HOUR,
+  VOLT,
+  MILLIAMPERE,
+  RATIO,
+  SECOND,
+  MINUTE,
+  KM,
+  NM,
+  PPM,
+  COUNT
+};
+
+/**
+ * @brief Описание одной величины в ответе PID
+ *
+ * Величина - беззнаковое big-endian число из width байт, начиная с байта
+ * byte данных PID (0 - байт A). PID с несколькими величинами (кислородные
+ * датчики, массивы) описываются несколькими записями с одним pid и
+ * разными field. Масштаб задан дробью mul / div: целые множитель и
+ * делитель дают точный результат для формул вида A * 100 / 255.
+ */
+struct PidDescriptor {
+  uint8_t service    = 0;  // Сервис, в котором определен PID (Service 02 использует те же описания)
+  uint8_t pid        = 0;
+  uint8_t length     = 0;  // Длина данных PID в ответе, 0 - переменная (только одиночный запрос)
+  uint8_t field      = 0;  // Номер величины внутри PID
+  uint8_t byte       = 0;  // Смещение величины в данных PID
+  uint8_t width      = 1;  // Ширина величины, 1..4 байт
+  PidFormula formula = PidFormula::RAW;
+  PidUnit unit       = PidUnit::NONE;
+  int16_t mul        = 1;
+  uint16_t div       = 1;
+  int16_t offset     = 0;
+  float min          = 0.0f;  // Диапазон физического значения
+  float max          = 0.0f;
+
+  /**
+   * @brief Сырое значение величины
+   * @param data Данные PID (байты A, B, ...), не короче byte + width
+   */
+  constexpr uint32_t Raw(const uint8_t* data) const {
+    uint32_t raw = 0;
+    for (uint8_t i = 0; i < width; i++) {
+      raw = (raw << 8) | data[byte + i];
+    }
+    return raw;
+  }
+
+  /**
+   * @brief Значение величины в типе геттера
+   *
+   * RAW приводится к T без потери разрядов, LINEAR считается во float.
+   */
+  template <typename T>
+  constexpr T Decode(const uint8_t* data) const {
+    const uint32_t raw = Raw(data);
+    if (formula == PidFormula::RAW) {
+      return static_cast<T>(raw);
+    }
+    return static_cast<T>(static_cast<float>(raw) * mul / div + offset);
+  }
+};
@@ -0,0 +1,363 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "obd2.h"
+#include "obd2_pid_descriptor.h"
+
+/**
+ * @brief Таблица PID Service 01 и типизированные геттеры на ее основе
+ *
+ * Формула, длина и единица каждого PID описаны один раз в kPidTable.
+ * Геттеры OBD2 и PidResults разворачиваются шаблонами по номеру PID:
+ * запись таблицы выбирается при компиляции, и геттер сводится к вызову
+ * общего чтения с адресом записи. По той же таблице PID читается по
+ * номеру во время работы (readPidValue) и разбирается групповой ответ
+ * (readPids).
+ */
+
+// Запись с линейной формулой raw * mul / div + offset; диапазон - по ширине величины
+constexpr PidDescriptor PidLinear(uint8_t pid,
+                                  uint8_t length,
+                                  PidUnit unit,
+                                  int16_t mul,
+                                  uint16_t div,
+                                  int16_t offset,
+                                  uint8_t field = 0,
+                                  uint8_t byte  = 0,
+                                  uint8_t width = 1) {
+  PidDescriptor descriptor;
+  descriptor.service    = OBD2::SERVICE_01;
+  descriptor.pid        = pid;
+  descriptor.length     = length;
+  descriptor.field      = field;
+  descriptor.byte       = byte;
+  descriptor.width      = width;
+  descriptor.formula    = PidFormula::LINEAR;
+  descriptor.unit       = unit;
+  descriptor.mul        = mul;
+  descriptor.div        = div;
+  descriptor.offset     = offset;
+  const float raw_max   = (width >= 4) ? 4294967295.0f : static_cast<float>((1UL << (8 * width)) - 1);
+  const float at_raw_0  = offset;
+  const float at_raw_max = raw_max * mul / div + offset;
+  descriptor.min         = (at_raw_0 < at_raw_max) ? at_raw_0 : at_raw_max;
+  descriptor.max         = (at_raw_0 < at_raw_max) ? at_raw_max : at_raw_0;
+  return descriptor;
+}
+
+// Запись без пересчета
+constexpr PidDescriptor PidRaw(uint8_t pid,
+                               uint8_t length,
+                               PidUnit unit,
+                               uint8_t field = 0,
+                               uint8_t byte  = 0,
+                               uint8_t width = 1) {
+  PidDescriptor descriptor = PidLinear(pid, length, unit, 1, 1, 0, field, byte, width);
+  descriptor.formula       = PidFormula::RAW;
+  return descriptor;
+}
+
+// Записи упорядочены по PID, величины одного PID идут подряд с field = 0, 1, ...
+// clang-format off
+inline constexpr PidDescriptor kPidTable[] = {
+  //       PID                                        len  unit                      mul   div   offset field byte width
+  PidRaw   (OBD2::MONITOR_STATUS_SINCE_DTC_CLEARED,  4,   PidUnit::NONE,                                0,    0,   4),
+  PidRaw   (OBD2::FREEZE_DTC,                        2,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::FUEL_SYSTEM_STATUS,                2,   PidUnit::NONE,                                0,    0,   2),
+  PidLinear(OBD2::ENGINE_LOAD,                       1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ENGINE_COOLANT_TEMP,               1,   PidUnit::CELSIUS,           1,    1,  -40),
+  // 06-09: байт B (банк 3) может отсутствовать, длина переменная
+  PidLinear(OBD2::SHORT_TERM_FUEL_TRIM_BANK_1,       0,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::LONG_TERM_FUEL_TRIM_BANK_1,        0,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::SHORT_TERM_FUEL_TRIM_BANK_2,       0,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::LONG_TERM_FUEL_TRIM_BANK_2,        0,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::FUEL_PRESSURE,                     1,   PidUnit::KPA,               3,    1,    0),
+  PidRaw   (OBD2::INTAKE_MANIFOLD_ABS_PRESSURE,      1,   PidUnit::KPA),
+  PidLinear(OBD2::ENGINE_RPM,                        2,   PidUnit::RPM,               1,    4,    0,    0,    0,   2),
+  PidRaw   (OBD2::VEHICLE_SPEED,                     1,   PidUnit::KMH),
+  PidLinear(OBD2::TIMING_ADVANCE,                    1,   PidUnit::DEGREE,            1,    2,  -64),
+  PidLinear(OBD2::INTAKE_AIR_TEMP,                   1,   PidUnit::CELSIUS,           1,    1,  -40),
+  PidLinear(OBD2::MAF_FLOW_RATE,                     2,   PidUnit::GRAMS_PER_SEC,     1,  100,    0,    0,    0,   2),
+  PidLinear(OBD2::THROTTLE_POSITION,                 1,   PidUnit::PERCENT,         100,  255,    0),
+  PidRaw   (OBD2::COMMANDED_SECONDARY_AIR_STATUS,    1,   PidUnit::NONE),
+  PidRaw   (OBD2::OXYGEN_SENSORS_PRESENT_2_BANKS,    1,   PidUnit::NONE),
+  // 14-1B: напряжение A / 200 и краткосрочная коррекция топлива B
+  PidLinear(OBD2::OXYGEN_SENSOR_1_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_1_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidLinear(OBD2::OXYGEN_SENSOR_2_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_2_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidLinear(OBD2::OXYGEN_SENSOR_3_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_3_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidLinear(OBD2::OXYGEN_SENSOR_4_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_4_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidLinear(OBD2::OXYGEN_SENSOR_5_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_5_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidLinear(OBD2::OXYGEN_SENSOR_6_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_6_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidLinear(OBD2::OXYGEN_SENSOR_7_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_7_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidLinear(OBD2::OXYGEN_SENSOR_8_A,                 2,   PidUnit::VOLT,              1,  200,    0,    0,    0),
+  PidLinear(OBD2::OXYGEN_SENSOR_8_A,                 2,   PidUnit::PERCENT,         100,  128, -100,    1,    1),
+  PidRaw   (OBD2::OBD_STANDARDS,                     1,   PidUnit::NONE),
+  PidRaw   (OBD2::OXYGEN_SENSORS_PRESENT_4_BANKS,    1,   PidUnit::NONE),
+  PidRaw   (OBD2::AUX_INPUT_STATUS,                  1,   PidUnit::NONE),
+  PidRaw   (OBD2::RUN_TIME_SINCE_ENGINE_START,       2,   PidUnit::SECOND,                              0,    0,   2),
+
+  PidRaw   (OBD2::DISTANCE_TRAVELED_WITH_MIL_ON,     2,   PidUnit::KM,                                  0,    0,   2),
+  PidLinear(OBD2::FUEL_RAIL_PRESSURE,                2,   PidUnit::KPA,              79, 1000,    0,    0,    0,   2),
+  PidLinear(OBD2::FUEL_RAIL_GUAGE_PRESSURE,          2,   PidUnit::KPA,              10,    1,    0,    0,    0,   2),
+  // 24-2B: эквивалентное соотношение 2 / 65536 * AB и напряжение 8 / 65536 * CD
+  PidLinear(OBD2::OXYGEN_SENSOR_1_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_1_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_2_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_2_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_3_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_3_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_4_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_4_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_5_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_5_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_6_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_6_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_7_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_7_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_8_B,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_8_B,                 4,   PidUnit::VOLT,              1,  8192,   0,    1,    2,   2),
+  PidLinear(OBD2::COMMANDED_EGR,                     1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::EGR_ERROR,                         1,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::COMMANDED_EVAPORATIVE_PURGE,       1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::FUEL_TANK_LEVEL_INPUT,             1,   PidUnit::PERCENT,         100,  255,    0),
+  PidRaw   (OBD2::WARM_UPS_SINCE_CODES_CLEARED,      1,   PidUnit::COUNT),
+  PidRaw   (OBD2::DIST_TRAV_SINCE_CODES_CLEARED,     2,   PidUnit::KM,                                  0,    0,   2),
+  PidLinear(OBD2::EVAP_SYSTEM_VAPOR_PRESSURE,        2,   PidUnit::PA,                1,    4,    0,    0,    0,   2),
+  PidRaw   (OBD2::ABS_BAROMETRIC_PRESSURE,           1,   PidUnit::KPA),
+  // 34-3B: эквивалентное соотношение 2 / 65536 * AB и ток CD / 256 - 128
+  PidLinear(OBD2::OXYGEN_SENSOR_1_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_1_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_2_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_2_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_3_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_3_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_4_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_4_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_5_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_5_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_6_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_6_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_7_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_7_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_8_C,                 4,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::OXYGEN_SENSOR_8_C,                 4,   PidUnit::MILLIAMPERE,       1,  256, -128,    1,    2,   2),
+  PidLinear(OBD2::CATALYST_TEMP_BANK_1_SENSOR_1,     2,   PidUnit::CELSIUS,           1,   10,  -40,    0,    0,   2),
+  PidLinear(OBD2::CATALYST_TEMP_BANK_2_SENSOR_1,     2,   PidUnit::CELSIUS,           1,   10,  -40,    0,    0,   2),
+  PidLinear(OBD2::CATALYST_TEMP_BANK_1_SENSOR_2,     2,   PidUnit::CELSIUS,           1,   10,  -40,    0,    0,   2),
+  PidLinear(OBD2::CATALYST_TEMP_BANK_2_SENSOR_2,     2,   PidUnit::CELSIUS,           1,   10,  -40,    0,    0,   2),
+
+  PidRaw   (OBD2::MONITOR_STATUS_THIS_DRIVE_CYCLE,   4,   PidUnit::NONE,                                0,    0,   4),
+  PidLinear(OBD2::CONTROL_MODULE_VOLTAGE,            2,   PidUnit::VOLT,              1, 1000,    0,    0,    0,   2),
+  PidLinear(OBD2::ABS_LOAD_VALUE,                    2,   PidUnit::PERCENT,         100,  255,    0,    0,    0,   2),
+  PidLinear(OBD2::FUEL_AIR_COMMANDED_EQUIV_RATIO,    2,   PidUnit::RATIO,             1, 32768,   0,    0,    0,   2),
+  PidLinear(OBD2::RELATIVE_THROTTLE_POSITION,        1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::AMBIENT_AIR_TEMP,                  1,   PidUnit::CELSIUS,           1,    1,  -40),
+  PidLinear(OBD2::ABS_THROTTLE_POSITION_B,           1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ABS_THROTTLE_POSITION_C,           1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ABS_THROTTLE_POSITION_D,           1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ABS_THROTTLE_POSITION_E,           1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ABS_THROTTLE_POSITION_F,           1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::COMMANDED_THROTTLE_ACTUATOR,       1,   PidUnit::PERCENT,         100,  255,    0),
+  PidRaw   (OBD2::TIME_RUN_WITH_MIL_ON,              2,   PidUnit::MINUTE,                              0,    0,   2),
+  PidRaw   (OBD2::TIME_SINCE_CODES_CLEARED,          2,   PidUnit::MINUTE,                              0,    0,   2),
+  // 4F: максимумы эквивалентного соотношения, напряжения, тока датчика O2 и давления MAP
+  PidRaw   (OBD2::MAX_VALUES_EQUIV_V_I_PRESSURE,     4,   PidUnit::RATIO,                               0,    0),
+  PidRaw   (OBD2::MAX_VALUES_EQUIV_V_I_PRESSURE,     4,   PidUnit::VOLT,                                1,    1),
+  PidRaw   (OBD2::MAX_VALUES_EQUIV_V_I_PRESSURE,     4,   PidUnit::MILLIAMPERE,                         2,    2),
+  PidLinear(OBD2::MAX_VALUES_EQUIV_V_I_PRESSURE,     4,   PidUnit::KPA,              10,    1,    0,    3,    3),
+  PidLinear(OBD2::MAX_MAF_RATE,                      4,   PidUnit::GRAMS_PER_SEC,    10,    1,    0),
+  PidRaw   (OBD2::FUEL_TYPE,                         1,   PidUnit::NONE),
+  PidLinear(OBD2::ETHANOL_FUEL_PERCENT,              1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ABS_EVAP_SYS_VAPOR_PRESSURE,       2,   PidUnit::KPA,               1,  200,    0,    0,    0,   2),
+  PidLinear(OBD2::EVAP_SYS_VAPOR_PRESSURE,           2,   PidUnit::PA,                1,    1, -32767,  0,    0,   2),
+  PidLinear(OBD2::SHORT_TERM_SEC_OXY_SENS_TRIM_1_3,  2,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::LONG_TERM_SEC_OXY_SENS_TRIM_1_3,   2,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::SHORT_TERM_SEC_OXY_SENS_TRIM_2_4,  2,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::LONG_TERM_SEC_OXY_SENS_TRIM_2_4,   2,   PidUnit::PERCENT,         100,  128, -100),
+  PidLinear(OBD2::FUEL_RAIL_ABS_PRESSURE,            2,   PidUnit::KPA,              10,    1,    0,    0,    0,   2),
+  PidLinear(OBD2::RELATIVE_ACCELERATOR_PEDAL_POS,    1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::HYBRID_BATTERY_REMAINING_LIFE,     1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ENGINE_OIL_TEMP,                   1,   PidUnit::CELSIUS,           1,    1,  -40),
+  PidLinear(OBD2::FUEL_INJECTION_TIMING,             2,   PidUnit::DEGREE,            1,  128, -210,    0,    0,   2),
+  PidLinear(OBD2::ENGINE_FUEL_RATE,                  2,   PidUnit::LITERS_PER_HOUR,   1,   20,    0,    0,    0,   2),
+  PidRaw   (OBD2::EMISSION_REQUIREMENTS,             1,   PidUnit::NONE),
+
+  PidLinear(OBD2::DEMANDED_ENGINE_PERCENT_TORQUE,    1,   PidUnit::PERCENT,           1,    1, -125),
+  PidLinear(OBD2::ACTUAL_ENGINE_TORQUE,              1,   PidUnit::PERCENT,           1,    1, -125),
+  PidRaw   (OBD2::ENGINE_REFERENCE_TORQUE,           2,   PidUnit::NM,                                  0,    0,   2),
+  // 64: точки 1-5 (холостой ход ... точка 4) кривой крутящего момента
+  PidLinear(OBD2::ENGINE_PERCENT_TORQUE_DATA,        5,   PidUnit::PERCENT,           1,    1, -125,    0,    0),
+  PidLinear(OBD2::ENGINE_PERCENT_TORQUE_DATA,        5,   PidUnit::PERCENT,           1,    1, -125,    1,    1),
+  PidLinear(OBD2::ENGINE_PERCENT_TORQUE_DATA,        5,   PidUnit::PERCENT,           1,    1, -125,    2,    2),
+  PidLinear(OBD2::ENGINE_PERCENT_TORQUE_DATA,        5,   PidUnit::PERCENT,           1,    1, -125,    3,    3),
+  PidLinear(OBD2::ENGINE_PERCENT_TORQUE_DATA,        5,   PidUnit::PERCENT,           1,    1, -125,    4,    4),
+  PidRaw   (OBD2::AUX_INPUT_OUTPUT_SUPPORTED,        2,   PidUnit::NONE,                                0,    0,   2),
+
+  // 81-9F: длина по SAE J1979, в ResponseType доступны первые 8 байт
+  PidRaw   (OBD2::ENGINE_RUN_TIME_AECD_1_2,         21,   PidUnit::SECOND,                              0,    0,   4),
+  PidRaw   (OBD2::ENGINE_RUN_TIME_AECD_3_4,         21,   PidUnit::SECOND,                              0,    0,   4),
+  PidRaw   (OBD2::NOX_SENSOR,                        9,   PidUnit::PPM,                                 0,    0,   2),
+  PidRaw   (OBD2::NOX_SENSOR,                        9,   PidUnit::PPM,                                 1,    2,   2),
+  PidLinear(OBD2::MANIFOLD_SURFACE_TEMP,             1,   PidUnit::CELSIUS,           1,    1,  -40),
+  PidLinear(OBD2::NOX_REAGENT_SYSTEM,               10,   PidUnit::PERCENT,         100,  255,    0),
+  PidRaw   (OBD2::PM_SENSOR,                         5,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::PM_SENSOR,                         5,   PidUnit::NONE,                                1,    2,   2),
+  PidRaw   (OBD2::PM_SENSOR,                         5,   PidUnit::NONE,                                2,    4,   2),
+  PidRaw   (OBD2::INTAKE_MANIFOLD_ABS_PRESSURE_81_100, 5, PidUnit::KPA,                                 0,    0,   2),
+  PidRaw   (OBD2::SCR_INDUCE_SYSTEM,                13,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::SCR_INDUCE_SYSTEM,                13,   PidUnit::NONE,                                1,    2,   2),
+  PidRaw   (OBD2::SCR_INDUCE_SYSTEM,                13,   PidUnit::NONE,                                2,    4,   2),
+  PidRaw   (OBD2::SCR_INDUCE_SYSTEM,                13,   PidUnit::NONE,                                3,    6,   2),
+  PidRaw   (OBD2::RUN_TIME_AECD_11_15,              41,   PidUnit::SECOND,                              0,    0,   4),
+  PidRaw   (OBD2::RUN_TIME_AECD_16_20,              41,   PidUnit::SECOND,                              0,    0,   4),
+  PidRaw   (OBD2::DIESEL_AFTERTREATMENT,             7,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::DIESEL_AFTERTREATMENT,             7,   PidUnit::NONE,                                1,    2,   2),
+  PidRaw   (OBD2::DIESEL_AFTERTREATMENT,             7,   PidUnit::NONE,                                2,    4,   2),
+  PidRaw   (OBD2::DIESEL_AFTERTREATMENT,             7,   PidUnit::NONE,                                3,    6,   2),
+  PidLinear(OBD2::O2_SENSOR_WIDE_RANGE,             17,   PidUnit::VOLT,              1, 1000,    0,    0,    0,   2),
+  PidLinear(OBD2::O2_SENSOR_WIDE_RANGE,             17,   PidUnit::VOLT,              1, 1000,    0,    1,    2,   2),
+  PidLinear(OBD2::THROTTLE_POSITION_G,               1,   PidUnit::PERCENT,         100,  255,    0),
+  PidLinear(OBD2::ENGINE_FRICTION_PERCENT_TORQUE,    1,   PidUnit::PERCENT,           1,    1, -125),
+  PidRaw   (OBD2::PM_SENSOR_BANK_1_2,                7,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::PM_SENSOR_BANK_1_2,                7,   PidUnit::NONE,                                1,    2,   2),
+  PidRaw   (OBD2::PM_SENSOR_BANK_1_2,                7,   PidUnit::NONE,                                2,    4,   2),
+  PidRaw   (OBD2::PM_SENSOR_BANK_1_2,                7,   PidUnit::NONE,                                3,    6,   2),
+  PidRaw   (OBD2::WWH_OBD_VEHICLE_INFO_1,            3,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::WWH_OBD_VEHICLE_INFO_2,            5,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::FUEL_SYSTEM_CONTROL,               2,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::WWH_OBD_COUNTERS_SUPPORT,          3,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::NOX_WARNING_INDUCTION_SYSTEM,     12,   PidUnit::NONE,                                0,    0,   2),
+  PidRaw   (OBD2::NOX_WARNING_INDUCTION_SYSTEM,     12,   PidUnit::NONE,                                1,    2,   2),
+  PidLinear(OBD2::EXHAUST_GAS_TEMP_SENSOR_1,         9,   PidUnit::CELSIUS,           1,    1,  -40,    0,    0,   2),
+  PidLinear(OBD2::EXHAUST_GAS_TEMP_SENSOR_1,         9,   PidUnit::CELSIUS,           1,    1,  -40,    1,    2,   2),
+  PidLinear(OBD2::EXHAUST_GAS_TEMP_SENSOR_2,         9,   PidUnit::CELSIUS,           1,    1,  -40,    0,    0,   2),
+  PidLinear(OBD2::EXHAUST_GAS_TEMP_SENSOR_2,         9,   PidUnit::CELSIUS,           1,    1,  -40,    1,    2,   2),
+  PidLinear(OBD2::HYBRID_EV_BATTERY_VOLTAGE,         6,   PidUnit::VOLT,              1, 1000,    0,    0,    0,   2),
+  PidLinear(OBD2::DIESEL_EXHAUST_FLUID_SENSOR_DATA,  4,   PidUnit::PERCENT,         100,  255,    0,    0,    3),
+  PidLinear(OBD2::O2_SENSOR_DATA_81_100,            17,   PidUnit::VOLT,              1, 1000,    0,    0,    0,   2),
+  PidLinear(OBD2::O2_SENSOR_DATA_81_100,            17,   PidUnit::VOLT,              1, 1000,    0,    1,    2,   2),
+  PidLinear(OBD2::O2_SENSOR_DATA_81_100,            17,   PidUnit::MILLIAMPERE,       1, 1000,    0,    2,    4,   2),
+  PidLinear(OBD2::O2_SENSOR_DATA_81_100,            17,   PidUnit::MILLIAMPERE,       1, 1000,    0,    3,    6,   2),
+  PidLinear(OBD2::ENGINE_FUEL_RATE_81_100,           4,   PidUnit::GRAMS_PER_SEC,     1,   20,    0,    0,    0,   2),
+  PidLinear(OBD2::ENGINE_EXHAUST_FLOW_RATE,          2,   PidUnit::KG_PER_HOUR,       1,   10,    0,    0,    0,   2),
+  // 9F: доля дизеля, бензина, CNG и LPG
+  PidLinear(OBD2::FUEL_SYSTEM_PERCENTAGE_USE,        9,   PidUnit::PERCENT,         100,  255,    0,    0,    0),
+  PidLinear(OBD2::FUEL_SYSTEM_PERCENTAGE_USE,        9,   PidUnit::PERCENT,         100,  255,    0,    1,    1),
+  PidLinear(OBD2::FUEL_SYSTEM_PERCENTAGE_USE,        9,   PidUnit::PERCENT,         100,  255,    0,    2,    2),
+  PidLinear(OBD2::FUEL_SYSTEM_PERCENTAGE_USE,        9,   PidUnit::PERCENT,         100,  255,    0,    3,    3),
+};
+// clang-format on
+
+inline constexpr size_t kPidTableSize = sizeof(kPidTable) / sizeof(kPidTable[0]);
+inline constexpr uint8_t kPidNoEntry  = 0xFF;
+
+// Порядок записей, на который опираются индекс и поиск величин
+constexpr bool PidTableIsValid() {
+  for (size_t i = 0; i < kPidTableSize; i++) {
+    const PidDescriptor& entry = kPidTable[i];
+    if ((entry.width == 0) || (entry.width > 4) || (entry.div == 0) ||
+        (entry.byte + entry.width > OBD2::kMaxPidDataLength)) {
+      return false;
+    }
+    const bool same_pid = (i > 0) && (kPidTable[i - 1].pid == entry.pid);
+    if (same_pid ? (entry.field != kPidTable[i - 1].field + 1) || (entry.length != kPidTable[i - 1].length)
+                 : (entry.field != 0) || ((i > 0) && (kPidTable[i - 1].pid > entry.pid))) {
+      return false;
+    }
+  }
+  return kPidTableSize < kPidNoEntry;
+}
+static_assert(PidTableIsValid(), "kPidTable must be sorted by PID with consecutive fields");
+
+// Индекс первой записи каждого PID: поиск без перебора таблицы
+constexpr std::array<uint8_t, 256> BuildPidTableIndex() {
+  std::array<uint8_t, 256> index = {};
+  for (auto& first : index) {
+    first = kPidNoEntry;
+  }
+  for (size_t i = kPidTableSize; i-- > 0;) {
+    index[kPidTable[i].pid] = static_cast<uint8_t>(i);
+  }
+  return index;
+}
+inline constexpr std::array<uint8_t, 256> kPidTableIndex = BuildPidTableIndex();
+
+/**
+ * @brief Позиция записи величины в kPidTable
+ * @return kPidTableSize, если PID или величины нет в таблице
+ */
+constexpr size_t PidTableFind(uint8_t pid, size_t field) {
+  const uint8_t first = kPidTableIndex[pid];
+  if (first == kPidNoEntry) {
+    return kPidTableSize;
+  }
+  const size_t i = first + field;
+  return ((i < kPidTableSize) && (kPidTable[i].pid == pid)) ? i : kPidTableSize;
+}
+
+// Геттер разворачивается в вызов общего чтения с записью таблицы, найденной при компиляции
+template <typename T, uint8_t Pid, uint8_t Field>
+std::optional<T> OBD2::ReadPid() {
+  constexpr size_t kIndex = PidTableFind(Pid, Field);
+  static_assert(kIndex < kPidTableSize, "PID is missing in kPidTable");
+  return ReadPidEntry<T>(kPidTable[kIndex]);
+}
+
+template <typename T, uint8_t Pid, size_t N>
+std::optional<std::array<T, N>> OBD2::ReadPidFields() {
+  constexpr size_t kIndex = PidTableFind(Pid, 0);
+  static_assert(kIndex < kPidTableSize, "PID is missing in kPidTable");
+  return ReadPidEntries<T, N>(kPidTable[kIndex]);
+}
+
+template <typename T>
+std::optional<T> OBD2::ReadPidEntry(const PidDescriptor& descriptor) {
+  ResponseType response = {};
+  if (ProcessPid(descriptor.service, descriptor.pid, response)) {
+    return descriptor.Decode<T>(response.data());
+  }
+  return std::nullopt;
+}
+
+// Величины PID подряд с первой; элементы, которых нет в таблице, равны нулю
+template <typename T, size_t N>
+std::optional<std::array<T, N>> OBD2::ReadPidEntries(const PidDescriptor& first) {
+  ResponseType response = {};
+  if (!ProcessPid(first.service, first.pid, response)) {
+    return std::nullopt;
+  }
+  std::array<T, N> result = {};
+  const PidDescriptor* descriptor = &first;
+  for (size_t i = 0; (i < N) && (descriptor < kPidTable + kPidTableSize) && (descriptor->pid == first.pid); i++) {
+    result[i] = descriptor->Decode<T>(response.data());
+    descriptor++;
+  }
+  return result;
+}
+
+template <typename T, uint8_t Pid, uint8_t Field>
+std::optional<T> OBD2::PidResults::Get() const {
+  constexpr size_t kIndex = PidTableFind(Pid, Field);
+  static_assert(kIndex < kPidTableSize, "PID is missing in kPidTable");
+  return Value<T>(kPidTable[kIndex]);
+}
+
+template <typename T>
+std::optional<T> OBD2::PidResults::Value(const PidDescriptor& descriptor) const {
+  const Entry* entry = Find(descriptor.pid, descriptor.byte + descriptor.width);
+  if (entry != nullptr) {
+    return descriptor.Decode<T>(entry->data.data());
+  }
+  return std::nullopt;
+}
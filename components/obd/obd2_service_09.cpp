@@ -10,6 +10,100 @@
 
 static const char* const TAG = "OBD2_VIN";
 
+namespace {
+
+/**
+ * @brief Сборщик ASCII строки из полезной нагрузки Service 09
+ *
+ * Первый байт полезной нагрузки - количество элементов данных (NODI), он пропускается.
+ * Непечатаемые символы (в т.ч. заполнение 0x00) отбрасываются.
+ */
+struct AsciiCollector {
+  char* buffer    = nullptr;
+  size_t capacity = 0;  // Максимальное количество символов без нулевого терминатора
+  size_t count    = 0;
+};
+
+void CollectAscii(size_t offset, Span<const uint8_t> chunk, void* ctx) {
+  auto* collector = static_cast<AsciiCollector*>(ctx);
+  if (offset == 0) {
+    collector->count = 0;
+  }
+  for (size_t i = 0; i < chunk.size(); i++) {
+    if ((offset + i) == 0) {
+      continue;  // NODI
+    }
+    if ((chunk[i] >= 0x20) && (chunk[i] <= 0x7E) && (collector->count < collector->capacity)) {
+      collector->buffer[collector->count++] = static_cast<char>(chunk[i]);
+    }
+  }
+}
+
+/**
+ * @brief Сборщик big-endian значений фиксированной ширины из полезной нагрузки Service 09
+ *
+ * Значения могут пересекать границы CAN кадров, поэтому неполное значение
+ * накапливается между вызовами.
+ */
+template <typename T>
+struct ValueCollector {
+  T* values       = nullptr;
+  size_t capacity = 0;
+  size_t count    = 0;
+  uint32_t acc    = 0;
+};
+
+template <typename T>
+void CollectValues(size_t offset, Span<const uint8_t> chunk, void* ctx) {
+  auto* collector = static_cast<ValueCollector<T>*>(ctx);
+  if (offset == 0) {
+    collector->count = 0;
+    collector->acc   = 0;
+  }
+  for (size_t i = 0; i < chunk.size(); i++) {
+    const size_t index = offset + i;
+    if (index == 0) {
+      continue;  // NODI
+    }
+    collector->acc = (collector->acc << 8) | chunk[i];
+    if ((((index - 1) % sizeof(T)) == (sizeof(T) - 1)) && (collector->count < collector->capacity)) {
+      collector->values[collector->count++] = static_cast<T>(collector->acc);
+      collector->acc                        = 0;
+    }
+  }
+}
+
+}  // namespace
+
+/**
+ * @brief Запрашивает PID Service 09 и передает полезную нагрузку ответа в sink
+ *
+ * Ответ разбирается по мере приема кадров, поэтому его длина ограничена только ISO-TP.
+ *
+ * @param pid PID Service 09
+ * @param sink Получатель полезной нагрузки
+ * @param ctx Контекст получателя
+ * @return bool True если получен положительный ответ
+ */
+bool OBD2::ReadVehicleInfo(uint8_t pid, PayloadSink sink, void* ctx) {
+  QueryPid(SERVICE_09, pid);
+
+  ResponseStream stream;
+  stream.service = SERVICE_09;
+  stream.pid     = pid;
+  stream.sink    = sink;
+  stream.ctx     = ctx;
+
+  if (!ReceiveResponse(stream)) {
+    return false;
+  }
+  if (stream.IsNegative()) {
+    log_print("OBD2 negative response received: service=0x%02X, pid=0x%02X\n", stream.header[0], stream.header[1]);
+    return false;
+  }
+  return stream.IsPositive() && (stream.PayloadLength() >= 2);
+}
+
 /**
  * @brief Получает список поддерживаемых PID в Service 09 (диапазон 01-20)
  *
@@ -58,42 +152,20 @@ bool OBD2::getVIN(char* vin_buffer, size_t buffer_size) {
   }
 
   log_print("Getting VIN...\n");
-
-  // Отправляем запрос для получения VIN (Service 09, PID 02)
-  QueryPid(0x09, 0x02);
-
-  uint8_t payload[128];
-  IsoTp::Message msg{tx_id_, rx_id_, 0, payload};
-  if (iso_tp_.receive(msg, sizeof(payload))) {
-    if (msg.len >= 3 && msg.data[0] == 0x7F) {
-      log_print("OBD2 negative response received: service=0x%02X, pid=0x%02X\n", msg.data[0], msg.data[1]);
-      return false;
-    }
-
-    // Проверяем, что это правильный ответ на запрос VIN
-    if (msg.len >= 4 && msg.data[0] == 0x49 && msg.data[1] == 0x02) {
-      // Очищаем буфер
-      memset(vin_buffer, 0, buffer_size);
-
-      // Пропускаем заголовок и обрабатываем данные
-      // Формат ответа: 49 02 01 [VIN данные в ASCII]
-      size_t data_start = 4;  // Пропускаем 49 02 01
-      size_t vin_index  = 0;
-
-      for (size_t i = data_start; i < msg.len && vin_index < 17; i++) {
-        if (msg.data[i] >= 0x20 && msg.data[i] <= 0x7E) {  // Проверяем, что это печатаемый ASCII символ
-          vin_buffer[vin_index++] = static_cast<char>(msg.data[i]);
-        }
-      }
-
-      if (vin_index == 17) {
-        vin_buffer[17] = '\0';  // Гарантируем нулевое завершение строки
-        log_print("VIN: %s\n", vin_buffer);
-        return true;
-      } else {
-        log_print("Invalid VIN length: %d\n", vin_index);
-      }
+  memset(vin_buffer, 0, buffer_size);
+
+  // Формат ответа: 49 02 01 [VIN данные в ASCII]
+  AsciiCollector collector;
+  collector.buffer   = vin_buffer;
+  collector.capacity = 17;
+
+  if (ReadVehicleInfo(SERVICE_09_VIN, CollectAscii, &collector)) {
+    if (collector.count == 17) {
+      vin_buffer[17] = '\0';  // Гарантируем нулевое завершение строки
+      log_print("VIN: %s\n", vin_buffer);
+      return true;
     }
+    log_print("Invalid VIN length: %d\n", collector.count);
   }
 
   log_print("No VIN response\n");
@@ -132,38 +204,17 @@ bool OBD2::getCalibrationId(char* calib_buffer, size_t buffer_size) {
     return false;
   }
 
-  QueryPid(SERVICE_09, SERVICE_09_CALIBRATION_ID);
+  memset(calib_buffer, 0, buffer_size);
 
-  uint8_t payload[128];
-  IsoTp::Message msg{tx_id_, rx_id_, 0, payload};
-  if (iso_tp_.receive(msg, sizeof(payload))) {
-    if (msg.len >= 3 && msg.data[0] == 0x7F) {
-      log_print("OBD2 negative response received: service=0x%02X, pid=0x%02X\n", msg.data[0], msg.data[1]);
-      return false;
-    }
+  // Формат ответа: 49 04 [NODI] [Calibration ID данные в ASCII]
+  AsciiCollector collector;
+  collector.buffer   = calib_buffer;
+  collector.capacity = buffer_size - 1;
 
-    // Проверяем, что это правильный ответ на запрос Calibration ID
-    if (msg.len >= 4 && msg.data[0] == 0x49 && msg.data[1] == 0x04) {
-      // Очищаем буфер
-      memset(calib_buffer, 0, buffer_size);
-
-      // Пропускаем заголовок и обрабатываем данные
-      // Формат ответа: 49 04 [Calibration ID данные в ASCII]
-      size_t data_start  = 3;  // Пропускаем 49 04
-      size_t calib_index = 0;
-
-      for (size_t i = data_start; i < msg.len && calib_index < buffer_size - 1; i++) {
-        if (msg.data[i] >= 0x20 && msg.data[i] <= 0x7E) {  // Проверяем, что это печатаемый ASCII символ
-          calib_buffer[calib_index++] = static_cast<char>(msg.data[i]);
-        }
-      }
-
-      if (calib_index > 0) {
-        calib_buffer[calib_index] = '\0';  // Гарантируем нулевое завершение строки
-        log_print("Calibration ID: %s\n", calib_buffer);
-        return true;
-      }
-    }
+  if (ReadVehicleInfo(SERVICE_09_CALIBRATION_ID, CollectAscii, &collector) && (collector.count > 0)) {
+    calib_buffer[collector.count] = '\0';  // Гарантируем нулевое завершение строки
+    log_print("Calibration ID: %s\n", calib_buffer);
+    return true;
   }
 
   log_print("No Calibration ID response\n");
@@ -204,34 +255,16 @@ bool OBD2::getCalibrationVerificationNumbers(uint32_t* cvn_buffer, size_t buffer
     return false;
   }
 
-  QueryPid(SERVICE_09, SERVICE_09_CALIBRATION_VERIFICATION_NUMBERS);
-
-  uint8_t payload[128];
-  IsoTp::Message msg{tx_id_, rx_id_, 0, payload};
-  if (iso_tp_.receive(msg, sizeof(payload))) {
-    if (msg.len >= 3 && msg.data[0] == 0x7F) {
-      log_print("OBD2 negative response received: service=0x%02X, pid=0x%02X\n", msg.data[0], msg.data[1]);
-      return false;
-    }
+  // Формат ответа: 49 06 [NODI] [CVN данные в формате 4 байта каждый]
+  ValueCollector<uint32_t> collector;
+  collector.values   = cvn_buffer;
+  collector.capacity = buffer_size;
 
-    // Проверяем, что это правильный ответ на запрос CVN
-    if (msg.len >= 4 && msg.data[0] == 0x49 && msg.data[1] == 0x06) {
-      // Пропускаем заголовок и обрабатываем данные
-      // Формат ответа: 49 06 [CVN данные в формате 4 байта каждый]
-      size_t data_start = 3;  // Пропускаем 49 06
-
-      *count = 0;
-      // CVN состоит из 4 байт каждый
-      for (size_t i = data_start; i + 3 < msg.len && *count < buffer_size; i += 4) {
-        cvn_buffer[*count] = (msg.data[i] << 24) | (msg.data[i + 1] << 16) | (msg.data[i + 2] << 8) | msg.data[i + 3];
-        (*count)++;
-      }
-
-      if (*count > 0) {
-        log_print("CVNs count: %d\n", *count);
-        return true;
-      }
-    }
+  if (ReadVehicleInfo(SERVICE_09_CALIBRATION_VERIFICATION_NUMBERS, CollectValues<uint32_t>, &collector) &&
+      (collector.count > 0)) {
+    *count = collector.count;
+    log_print("CVNs count: %d\n", *count);
+    return true;
   }
 
   log_print("No CVN response\n");
@@ -273,34 +306,16 @@ bool OBD2::getPerformanceTrackingSparkIgnition(uint16_t* tracking_buffer, size_t
     return false;
   }
 
-  QueryPid(SERVICE_09, SERVICE_09_PERF_TRACK_SPARK_IGNITION);
-
-  uint8_t payload[128];
-  IsoTp::Message msg{tx_id_, rx_id_, 0, payload};
-  if (iso_tp_.receive(msg, sizeof(payload))) {
-    if (msg.len >= 3 && msg.data[0] == 0x7F) {
-      log_print("OBD2 negative response received: service=0x%02X, pid=0x%02X\n", msg.data[0], msg.data[1]);
-      return false;
-    }
+  // Формат ответа: 49 08 [NODI] [данные отслеживания в формате 2 байта на значение]
+  ValueCollector<uint16_t> collector;
+  collector.values   = tracking_buffer;
+  collector.capacity = buffer_size;
 
-    // Проверяем, что это правильный ответ на запрос отслеживания производительности
-    if (msg.len >= 4 && msg.data[0] == 0x49 && msg.data[1] == 0x08) {
-      // Пропускаем заголовок и обрабатываем данные
-      // Формат ответа: 49 08 [данные отслеживания в формате 2 байта на значение]
-      size_t data_start = 3;  // Пропускаем 49 08
-
-      *count = 0;
-      // Каждое значение состоит из 2 байт
-      for (size_t i = data_start; i + 1 < msg.len && *count < buffer_size; i += 2) {
-        tracking_buffer[*count] = (msg.data[i] << 8) | msg.data[i + 1];
-        (*count)++;
-      }
-
-      if (*count > 0) {
-        log_print("Spark ignition tracking values count: %d\n", *count);
-        return true;
-      }
-    }
+  if (ReadVehicleInfo(SERVICE_09_PERF_TRACK_SPARK_IGNITION, CollectValues<uint16_t>, &collector) &&
+      (collector.count > 0)) {
+    *count = collector.count;
+    log_print("Spark ignition tracking values count: %d\n", *count);
+    return true;
   }
 
   log_print("No spark ignition tracking response\n");
@@ -335,38 +350,17 @@ bool OBD2::getEcuName(char* ecu_buffer, size_t buffer_size) {
     return false;
   }
 
-  QueryPid(SERVICE_09, SERVICE_09_ECU_NAME);
+  memset(ecu_buffer, 0, buffer_size);
 
-  uint8_t payload[128];
-  IsoTp::Message msg{tx_id_, rx_id_, 0, payload};
-  if (iso_tp_.receive(msg, sizeof(payload))) {
-    if (msg.len >= 3 && msg.data[0] == 0x7F) {
-      log_print("OBD2 negative response received: service=0x%02X, pid=0x%02X\n", msg.data[0], msg.data[1]);
-      return false;
-    }
+  // Формат ответа: 49 0A [NODI] [ECU name данные в ASCII]
+  AsciiCollector collector;
+  collector.buffer   = ecu_buffer;
+  collector.capacity = buffer_size - 1;
 
-    // Проверяем, что это правильный ответ на запрос ECU name
-    if (msg.len >= 4 && msg.data[0] == 0x49 && msg.data[1] == 0x0A) {
-      // Очищаем буфер
-      memset(ecu_buffer, 0, buffer_size);
-
-      // Пропускаем заголовок и обрабатываем данные
-      // Формат ответа: 49 0A [ECU name данные в ASCII]
-      size_t data_start = 3;  // Пропускаем 49 0A
-      size_t ecu_index  = 0;
-
-      for (size_t i = data_start; i < msg.len && ecu_index < buffer_size - 1; i++) {
-        if (msg.data[i] >= 0x20 && msg.data[i] <= 0x7E) {  // Проверяем, что это печатаемый ASCII символ
-          ecu_buffer[ecu_index++] = static_cast<char>(msg.data[i]);
-        }
-      }
-
-      if (ecu_index > 0) {
-        ecu_buffer[ecu_index] = '\0';  // Гарантируем нулевое завершение строки
-        log_print("ECU Name: %s\n", ecu_buffer);
-        return true;
-      }
-    }
+  if (ReadVehicleInfo(SERVICE_09_ECU_NAME, CollectAscii, &collector) && (collector.count > 0)) {
+    ecu_buffer[collector.count] = '\0';  // Гарантируем нулевое завершение строки
+    log_print("ECU Name: %s\n", ecu_buffer);
+    return true;
   }
 
   log_print("No ECU name response\n");
@@ -389,34 +383,16 @@ bool OBD2::getPerformanceTrackingCompressionIgnition(uint16_t* tracking_buffer,
     return false;
   }
 
-  QueryPid(SERVICE_09, SERVICE_09_PERF_TRACK_COMPRESSION_IGNITION);
+  // Формат ответа: 49 0B [NODI] [данные отслеживания в формате 2 байта на значение]
+  ValueCollector<uint16_t> collector;
+  collector.values   = tracking_buffer;
+  collector.capacity = buffer_size;
 
-  uint8_t payload[128];
-  IsoTp::Message msg{tx_id_, rx_id_, 0, payload};
-  if (iso_tp_.receive(msg, sizeof(payload))) {
-    if (msg.len >= 3 && msg.data[0] == 0x7F) {
-      log_print("OBD2 negative response received: service=0x%02X, pid=0x%02X\n", msg.data[0], msg.data[1]);
-      return false;
-    }
-
-    // Проверяем, что это правильный ответ на запрос отслеживания производительности
-    if (msg.len >= 4 && msg.data[0] == 0x49 && msg.data[1] == 0x0B) {
-      // Пропускаем заголовок и обрабатываем данные
-      // Формат ответа: 49 0B [данные отслеживания в формате 2 байта на значение]
-      size_t data_start = 3;  // Пропускаем 49 0B
-
-      *count = 0;
-      // Каждое значение состоит из 2 байт
-      for (size_t i = data_start; i + 1 < msg.len && *count < buffer_size; i += 2) {
-        tracking_buffer[*count] = (msg.data[i] << 8) | msg.data[i + 1];
-        (*count)++;
-      }
-
-      if (*count > 0) {
-        log_print("Compression ignition tracking values count: %d\n", *count);
-        return true;
-      }
-    }
+  if (ReadVehicleInfo(SERVICE_09_PERF_TRACK_COMPRESSION_IGNITION, CollectValues<uint16_t>, &collector) &&
+      (collector.count > 0)) {
+    *count = collector.count;
+    log_print("Compression ignition tracking values count: %d\n", *count);
+    return true;
   }
 
   log_print("No compression ignition tracking response\n");
@@ -0,0 +1,162 @@
+#include "bus_load_meter.h"
+
+#include <algorithm>
+
+BusLoadMeter::BusLoadMeter(uint32_t bitrate) : bitrate_(bitrate) {}
+
+uint32_t BusLoadMeter::FrameBits(const TwaiFrame& frame) {
+  // Поля от SOF до CRC, в которых вставляются биты стаффинга
+  const uint32_t header_bits = frame.is_extended ? 54 : 34;
+  const uint32_t data_bits   = frame.is_rtr ? 0 : 8 * static_cast<uint32_t>(frame.data_length);
+  const uint32_t stuffed     = header_bits + data_bits;
+
+  // Худший случай: бит стаффинга на каждые 4 бита после первого.
+  // 13 бит без стаффинга: разделитель CRC, ACK, разделитель ACK, EOF и межкадровый интервал
+  return stuffed + 13 + (stuffed - 1) / 4;
+}
+
+void BusLoadMeter::OnFrame(const TwaiFrame& frame, uint32_t now_us) {
+  Advance(now_us);
+
+  const uint32_t seq = bucket_seq_.load(std::memory_order_relaxed);
+  Bucket& bucket     = buckets_[seq % kBuckets];
+  bucket.frames.fetch_add(1, std::memory_order_relaxed);
+  bucket.bits.fetch_add(FrameBits(frame), std::memory_order_relaxed);
+
+  const uint32_t key    = MakeKey(frame.id, frame.is_extended);
+  const uint32_t second = seq / kBucketsPerS;
+  size_t index          = SlotIndex(key);
+  for (size_t probe = 0; probe < kMaxProbes; probe++, index = (index + 1) & (kIdSlots - 1)) {
+    IdSlot& slot            = ids_[index];
+    const uint32_t slot_key = slot.key.load(std::memory_order_relaxed);
+    if (slot_key == 0) {
+      // Новый ID: поля заполняются до публикации ключа
+      slot.second.store(second, std::memory_order_relaxed);
+      slot.count.store(0, std::memory_order_relaxed);
+      slot.last_count.store(0, std::memory_order_relaxed);
+      slot.key.store(key, std::memory_order_release);
+    } else if (slot_key != key) {
+      continue;
+    }
+
+    const uint32_t slot_second = slot.second.load(std::memory_order_relaxed);
+    if (slot_second != second) {
+      slot.last_count.store((second - slot_second == 1) ? slot.count.load(std::memory_order_relaxed) : 0,
+                            std::memory_order_relaxed);
+      slot.count.store(0, std::memory_order_relaxed);
+      slot.second.store(second, std::memory_order_relaxed);
+    }
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  untracked_frames_.fetch_add(1, std::memory_order_relaxed);
+}
+
+BusLoadMeter::Load BusLoadMeter::GetLoad(Window window, uint32_t now_us) const {
+  Load load;
+  if (!started_.load(std::memory_order_acquire)) {
+    return load;
+  }
+
+  const uint32_t count   = static_cast<uint32_t>(window);
+  const uint32_t seq     = bucket_seq_.load(std::memory_order_relaxed);
+  const uint32_t seq_now = BucketSeq(now_us);  // Корзина, которая еще заполняется
+  for (uint32_t back = 1; back <= count; back++) {
+    const uint32_t target = seq_now - back;
+    const uint32_t age    = seq - target;
+    // Корзины новее записанной пусты: кадров в них не было
+    if (static_cast<int32_t>(age) < 0 || age >= kBuckets) {
+      continue;
+    }
+    const Bucket& bucket = buckets_[target % kBuckets];
+    load.frames += bucket.frames.load(std::memory_order_relaxed);
+    load.bits += bucket.bits.load(std::memory_order_relaxed);
+  }
+
+  load.frames_per_s = load.frames * kBucketsPerS / count;
+  // Время окна в битах: bitrate * count / kBucketsPerS
+  const uint64_t window_bits = std::max<uint64_t>(static_cast<uint64_t>(bitrate_) * count, 1);
+  const uint64_t permille    = static_cast<uint64_t>(load.bits) * 1000 * kBucketsPerS / window_bits;
+  load.permille              = static_cast<uint16_t>(std::min<uint64_t>(permille, 1000));
+  return load;
+}
+
+uint32_t BusLoadMeter::FrameRate(uint32_t id, bool is_extended, uint32_t now_us) const {
+  if (!started_.load(std::memory_order_acquire)) {
+    return 0;
+  }
+
+  const uint32_t key    = MakeKey(id, is_extended);
+  const uint32_t second = BucketSeq(now_us) / kBucketsPerS;
+  size_t index          = SlotIndex(key);
+  for (size_t probe = 0; probe < kMaxProbes; probe++, index = (index + 1) & (kIdSlots - 1)) {
+    const IdSlot& slot      = ids_[index];
+    const uint32_t slot_key = slot.key.load(std::memory_order_acquire);
+    if (slot_key == 0) {
+      return 0;
+    }
+    if (slot_key != key) {
+      continue;
+    }
+
+    const uint32_t slot_second = slot.second.load(std::memory_order_relaxed);
+    if (slot_second == second) {
+      return slot.last_count.load(std::memory_order_relaxed);
+    }
+    if (second - slot_second == 1) {
+      return slot.count.load(std::memory_order_relaxed);
+    }
+    return 0;  // ID молчал последнюю секунду
+  }
+  return 0;
+}
+
+uint32_t BusLoadMeter::UntrackedFrames() const {
+  return untracked_frames_.load(std::memory_order_relaxed);
+}
+
+uint32_t BusLoadMeter::MakeKey(uint32_t id, bool is_extended) {
+  return (id & 0x1FFFFFFF) | (is_extended ? kExtendedFlag : 0) | kUsedFlag;
+}
+
+size_t BusLoadMeter::SlotIndex(uint32_t key) {
+  // Мультипликативный хеш: соседние ID расходятся по таблице
+  return ((key * 2654435761u) >> 16) & (kIdSlots - 1);
+}
+
+uint32_t BusLoadMeter::BucketSeq(uint32_t now_us) const {
+  const uint32_t seq     = bucket_seq_.load(std::memory_order_relaxed);
+  const uint32_t elapsed = now_us - bucket_start_us_.load(std::memory_order_relaxed);
+  // Время чтения могло быть взято до кадра, уже учтенного прерыванием
+  if (static_cast<int32_t>(elapsed) < 0) {
+    return seq;
+  }
+  return seq + elapsed / kBucketUs;
+}
+
+void BusLoadMeter::Advance(uint32_t now_us) {
+  if (!started_.load(std::memory_order_relaxed)) {
+    bucket_start_us_.store(now_us, std::memory_order_relaxed);
+    started_.store(true, std::memory_order_release);
+    return;
+  }
+
+  const uint32_t start = bucket_start_us_.load(std::memory_order_relaxed);
+  const uint32_t delta = now_us - start;
+  // Кадр с меткой чуть раньше начала корзины (прием и передача в одном прерывании) - в текущую
+  if (static_cast<int32_t>(delta) < 0 || delta < kBucketUs) {
+    return;
+  }
+  const uint32_t elapsed = delta / kBucketUs;
+
+  // Пропущенные корзины обнуляются: не больше kBuckets за вызов, в среднем O(1) на кадр
+  const uint32_t seq   = bucket_seq_.load(std::memory_order_relaxed);
+  const uint32_t clear = std::min<uint32_t>(elapsed, kBuckets);
+  for (uint32_t i = 1; i <= clear; i++) {
+    Bucket& bucket = buckets_[(seq + i) % kBuckets];
+    bucket.frames.store(0, std::memory_order_relaxed);
+    bucket.bits.store(0, std::memory_order_relaxed);
+  }
+  bucket_start_us_.store(start + elapsed * kBucketUs, std::memory_order_relaxed);
+  bucket_seq_.store(seq + elapsed, std::memory_order_relaxed);
+}
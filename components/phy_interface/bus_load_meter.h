@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "phy_interface.h"
+
+/**
+ * @brief Измеритель загрузки шины CAN и частоты кадров по ID
+ *
+ * Каждый кадр учитывается в прерывании за O(1): число кадров и битов на
+ * шине добавляется в текущую корзину 100 мс, счетчик ID ищется в таблице
+ * с открытой адресацией (не больше kMaxProbes проб). Окна 100 мс, 1 с и
+ * 10 с складываются из завершенных корзин при чтении (из задачи).
+ *
+ * Биты кадра считаются с худшим случаем бит-стаффинга, поэтому загрузка
+ * оценивается сверху. Контроллер видит только кадры, прошедшие аппаратный
+ * фильтр, и собственные передачи: при суженном фильтре загрузка занижена.
+ *
+ * Запись ведет только прерывание. Чтение не блокирует его: на границе
+ * корзины результат может сдвинуться на одну корзину.
+ */
+class BusLoadMeter {
+ public:
+  static const uint32_t kBucketUs  = 100000;   // Длительность корзины
+  static const size_t kBuckets     = 100 + 1;  // Окно 10 с и заполняемая корзина
+  static const size_t kIdSlots     = 128;      // Размер таблицы ID (степень двойки)
+  static const size_t kMaxProbes   = 8;        // Длина поиска свободного слота
+  static const size_t kBucketsPerS = 10;
+
+  static_assert((kIdSlots & (kIdSlots - 1)) == 0, "kIdSlots must be a power of two");
+
+  /**
+   * @brief Окно усреднения, значение - число корзин
+   */
+  enum class Window : uint8_t {
+    WINDOW_100MS = 1,
+    WINDOW_1S    = 10,
+    WINDOW_10S   = 100,
+  };
+
+  /**
+   * @brief Загрузка шины за окно
+   */
+  struct Load {
+    uint32_t frames       = 0;  // Кадры за окно
+    uint32_t bits         = 0;  // Биты на шине за окно
+    uint32_t frames_per_s = 0;
+    uint16_t permille     = 0;  // Доля занятого времени шины, 0-1000
+  };
+
+  /**
+   * @param bitrate Скорость шины в бит/с
+   */
+  explicit BusLoadMeter(uint32_t bitrate);
+
+  BusLoadMeter(const BusLoadMeter&)            = delete;
+  BusLoadMeter& operator=(const BusLoadMeter&) = delete;
+
+  /**
+   * @brief Длина кадра на шине в битах с худшим случаем бит-стаффинга
+   *
+   * Включает межкадровый интервал. Для 8 байт данных: 135 бит со
+   * стандартным ID, 160 бит с расширенным.
+   */
+  static uint32_t FrameBits(const TwaiFrame& frame);
+
+  /**
+   * @brief Учет кадра на шине (принятого или переданного), из прерывания
+   * @param now_us Время кадра в микросекундах
+   */
+  void OnFrame(const TwaiFrame& frame, uint32_t now_us);
+
+  /**
+   * @brief Загрузка за последние завершенные корзины окна
+   */
+  Load GetLoad(Window window, uint32_t now_us) const;
+
+  /**
+   * @brief Кадров ID за последнюю завершенную секунду
+   */
+  uint32_t FrameRate(uint32_t id, bool is_extended, uint32_t now_us) const;
+
+  /**
+   * @brief Кадры ID, не поместившихся в таблицу (учтены только в общей загрузке)
+   */
+  uint32_t UntrackedFrames() const;
+
+ private:
+  struct Bucket {
+    std::atomic_uint32_t frames{0};
+    std::atomic_uint32_t bits{0};
+  };
+
+  struct IdSlot {
+    std::atomic_uint32_t key{0};     // ID | kExtendedFlag | kUsedFlag, 0 - свободен
+    std::atomic_uint32_t second{0};  // Номер секунды, к которой относится count
+    std::atomic_uint32_t count{0};
+    std::atomic_uint32_t last_count{0};  // Кадры секунды second - 1
+  };
+
+  static const uint32_t kExtendedFlag = 1u << 29;
+  static const uint32_t kUsedFlag     = 1u << 31;
+
+  static uint32_t MakeKey(uint32_t id, bool is_extended);
+  static size_t SlotIndex(uint32_t key);
+
+  // Номер корзины, в которую попадает now_us (продолжает bucket_seq_)
+  uint32_t BucketSeq(uint32_t now_us) const;
+  void Advance(uint32_t now_us);
+
+  const uint32_t bitrate_;
+  std::array<Bucket, kBuckets> buckets_;
+  std::array<IdSlot, kIdSlots> ids_;
+  std::atomic_uint32_t bucket_seq_{0};       // Номер текущей корзины (с переполнением)
+  std::atomic_uint32_t bucket_start_us_{0};  // Начало текущей корзины
+  std::atomic_bool started_{false};          // Первый кадр задал начало корзин
+  std::atomic_uint32_t untracked_frames_{0};
+};
@@ -0,0 +1,130 @@
+#include "can_acceptance_filter.h"
+
+static const uint32_t kStandardIdMask = 0x7FF;
+static const uint32_t kExtendedIdMask = 0x1FFFFFFF;
+
+// Маска, при которой пара фильтров пропускает оба набора ID
+static CanIdFilter merge_pair(const CanIdFilter& a, const CanIdFilter& b) {
+  CanIdFilter merged;
+  merged.mask        = a.mask & b.mask & ~(a.id ^ b.id);
+  merged.id          = a.id & merged.mask;
+  merged.is_extended = a.is_extended;
+  return merged;
+}
+
+static uint32_t id_mask(bool is_extended) {
+  return is_extended ? kExtendedIdMask : kStandardIdMask;
+}
+
+static uint32_t coverage(const CanIdFilter& filter) {
+  const uint32_t mask = id_mask(filter.is_extended);
+  const int free_bits = __builtin_popcount(mask) - __builtin_popcount(filter.mask & mask);
+  return 1u << free_bits;
+}
+
+CanAcceptanceFilter CanAcceptanceFilter::Merge(Span<const CanIdFilter> filters) {
+  CanAcceptanceFilter result;
+  if (filters.empty() || filters.size() > kMaxInputFilters) {
+    return result;
+  }
+
+  const bool is_extended = filters[0].is_extended;
+  CanIdFilter clusters[kMaxInputFilters];
+  size_t count = 0;
+  for (const CanIdFilter& filter : filters) {
+    if (filter.is_extended != is_extended) {
+      return result;
+    }
+    CanIdFilter normalized;
+    normalized.mask        = filter.mask & id_mask(is_extended);
+    normalized.id          = filter.id & normalized.mask;
+    normalized.is_extended = is_extended;
+    clusters[count++]      = normalized;
+  }
+
+  // Жадное объединение: на каждом шаге сливается пара с наименьшим приростом покрытия
+  while (count > 2) {
+    size_t best_i     = 0;
+    size_t best_j     = 1;
+    int64_t best_cost = INT64_MAX;
+    for (size_t i = 0; i < count; i++) {
+      for (size_t j = i + 1; j < count; j++) {
+        // Отрицательная стоимость: фильтры пересекаются
+        const int64_t cost = static_cast<int64_t>(coverage(merge_pair(clusters[i], clusters[j]))) -
+                             coverage(clusters[i]) - coverage(clusters[j]);
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_i    = i;
+          best_j    = j;
+        }
+      }
+    }
+    clusters[best_i] = merge_pair(clusters[best_i], clusters[best_j]);
+    clusters[best_j] = clusters[--count];
+  }
+
+  result.is_extended = is_extended;
+  result.mode        = Mode::SINGLE;
+  result.filters[0]  = (count == 2) ? merge_pair(clusters[0], clusters[1]) : clusters[0];
+
+  if (count == 2) {
+    CanAcceptanceFilter dual;
+    dual.is_extended = is_extended;
+    dual.mode        = Mode::DUAL;
+    for (size_t i = 0; i < 2; i++) {
+      dual.filters[i] = clusters[i];
+      if (is_extended) {
+        dual.filters[i].mask &= kDualExtendedMask;
+        dual.filters[i].id &= kDualExtendedMask;
+      }
+    }
+    if (dual.Coverage() < result.Coverage()) {
+      result = dual;
+    }
+  }
+
+  if (result.filters[0].mask == 0 || (result.mode == Mode::DUAL && result.filters[1].mask == 0)) {
+    return CanAcceptanceFilter();
+  }
+  return result;
+}
+
+bool CanAcceptanceFilter::Accepts(const TwaiFrame& frame) const {
+  switch (mode) {
+    case Mode::SINGLE:
+      return filters[0].Matches(frame);
+    case Mode::DUAL:
+      return filters[0].Matches(frame) || filters[1].Matches(frame);
+    case Mode::ACCEPT_ALL:
+    default:
+      return true;
+  }
+}
+
+uint32_t CanAcceptanceFilter::Coverage() const {
+  switch (mode) {
+    case Mode::SINGLE:
+      return coverage(filters[0]);
+    case Mode::DUAL:
+      return coverage(filters[0]) + coverage(filters[1]);
+    case Mode::ACCEPT_ALL:
+    default:
+      return UINT32_MAX;
+  }
+}
+
+bool CanAcceptanceFilter::operator==(const CanAcceptanceFilter& other) const {
+  if (mode != other.mode) {
+    return false;
+  }
+  if (mode == Mode::ACCEPT_ALL) {
+    return true;
+  }
+  const size_t count = (mode == Mode::DUAL) ? 2 : 1;
+  for (size_t i = 0; i < count; i++) {
+    if (filters[i].id != other.filters[i].id || filters[i].mask != other.filters[i].mask) {
+      return false;
+    }
+  }
+  return is_extended == other.is_extended;
+}
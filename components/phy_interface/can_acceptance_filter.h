@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "phy_interface.h"
+#include "span.h"
+
+/**
+ * @brief Аппаратный фильтр приема TWAI (код/маска), покрывающий фильтры подписчиков
+ *
+ * Контроллер TWAI имеет один фильтр: одиночный (один код/маска на весь ID)
+ * или двойной (два кода/маски). В двойном режиме 11-битные ID сравниваются
+ * полностью, а у 29-битных только старшие 16 бит (28..13).
+ *
+ * Merge() сводит фильтры подписчиков к самому узкому аппаратному фильтру,
+ * который пропускает все нужные кадры. Лишние кадры, прошедшие аппаратный
+ * фильтр, отбрасывает программная таблица маршрутизации.
+ */
+struct CanAcceptanceFilter {
+  enum class Mode : uint8_t {
+    ACCEPT_ALL = 0,  // Фильтр не сужает прием
+    SINGLE,          // filters[0]
+    DUAL             // filters[0] или filters[1]
+  };
+
+  static const size_t kMaxInputFilters = 32;
+
+  // Биты 29-битного ID, которые сравнивает двойной фильтр
+  static const uint32_t kDualExtendedMask = 0x1FFFE000;
+
+  Mode mode        = Mode::ACCEPT_ALL;
+  bool is_extended = false;  // Формат ID, который пропускает фильтр
+  CanIdFilter filters[2];
+
+  /**
+   * @brief Самый узкий аппаратный фильтр для объединения фильтров
+   *
+   * Пустой список, смешение 11- и 29-битных ID или больше kMaxInputFilters
+   * фильтров дают ACCEPT_ALL.
+   */
+  static CanAcceptanceFilter Merge(Span<const CanIdFilter> filters);
+
+  /**
+   * @brief Пропустит ли аппаратный фильтр кадр
+   */
+  bool Accepts(const TwaiFrame& frame) const;
+
+  /**
+   * @brief Количество ID, пропускаемых фильтром (оценка сверху)
+   */
+  uint32_t Coverage() const;
+
+  bool operator==(const CanAcceptanceFilter& other) const;
+  bool operator!=(const CanAcceptanceFilter& other) const {
+    return !(*this == other);
+  }
+};
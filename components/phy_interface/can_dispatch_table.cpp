@@ -0,0 +1,71 @@
+#include "can_dispatch_table.h"
+
+#include <cstring>
+
+void CanDispatchTable::Clear() {
+  memset(standard_, 0, sizeof(standard_));
+  extended_count_ = 0;
+  all_frames_     = 0;
+}
+
+bool CanDispatchTable::AddRoute(size_t route, Span<const CanIdFilter> filters) {
+  if (route >= kMaxRoutes) {
+    return false;
+  }
+  const RouteMask route_bit = static_cast<RouteMask>(1u << route);
+
+  if (filters.empty()) {
+    all_frames_ |= route_bit;
+    return true;
+  }
+
+  bool result = true;
+  for (const CanIdFilter& filter : filters) {
+    if (filter.is_extended) {
+      result = AddExtendedFilter(filter, route_bit) && result;
+      continue;
+    }
+    // Все 11-битные ID, проходящие через фильтр
+    const uint32_t id   = filter.id & filter.mask & kStandardIdMask;
+    const uint32_t mask = filter.mask & kStandardIdMask;
+    for (uint32_t i = 0; i < kStandardIdCount; i++) {
+      if ((i & mask) == id) {
+        standard_[i] |= route_bit;
+      }
+    }
+  }
+  return result;
+}
+
+bool CanDispatchTable::AddExtendedFilter(const CanIdFilter& filter, RouteMask route_bit) {
+  const uint32_t id = filter.id & filter.mask;
+  // Одинаковые фильтры разных маршрутов занимают одну запись
+  for (size_t i = 0; i < extended_count_; i++) {
+    if (extended_[i].id == id && extended_[i].mask == filter.mask) {
+      extended_[i].routes |= route_bit;
+      return true;
+    }
+  }
+  if (extended_count_ >= kMaxExtendedFilters) {
+    return false;
+  }
+  extended_[extended_count_].id     = id;
+  extended_[extended_count_].mask   = filter.mask;
+  extended_[extended_count_].routes = route_bit;
+  extended_count_++;
+  return true;
+}
+
+CanDispatchTable::RouteMask CanDispatchTable::Lookup(const TwaiFrame& frame) const {
+  if (!frame.is_extended) {
+    return all_frames_ | standard_[frame.id & kStandardIdMask];
+  }
+
+  RouteMask routes = all_frames_;
+  for (size_t i = 0; i < extended_count_; i++) {
+    if ((frame.id & extended_[i].mask) == extended_[i].id) {
+      routes |= extended_[i].routes;
+    }
+  }
+  return routes;
+}
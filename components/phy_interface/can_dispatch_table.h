@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "phy_interface.h"
+#include "span.h"
+
+/**
+ * @brief Таблица маршрутизации принятых кадров по CAN ID
+ *
+ * Фильтры подписчиков компилируются при регистрации, в прерывании остается
+ * только поиск: для 11-битных ID - одно чтение из таблицы на 2048 записей,
+ * для 29-битных - проход по не более чем kMaxExtendedFilters фильтрам.
+ * Результат - битовая маска маршрутов (номеров подписчиков).
+ *
+ * Построение выполняется из задачи; таблица, которую читает прерывание,
+ * при этом меняться не должна (драйвер держит две копии).
+ */
+class CanDispatchTable {
+ public:
+  using RouteMask = uint8_t;
+
+  static const size_t kMaxRoutes          = 8;  // Разрядность RouteMask
+  static const size_t kMaxExtendedFilters = 16;
+
+  /**
+   * @brief Удаление всех маршрутов
+   */
+  void Clear();
+
+  /**
+   * @brief Добавление маршрута
+   * @param route Номер маршрута (0..kMaxRoutes-1)
+   * @param filters Фильтры маршрута; пустой список - все кадры
+   * @return false если номер вне таблицы или исчерпаны фильтры 29-битных ID
+   */
+  bool AddRoute(size_t route, Span<const CanIdFilter> filters);
+
+  /**
+   * @brief Маршруты кадра (вызывается из прерывания)
+   */
+  RouteMask Lookup(const TwaiFrame& frame) const;
+
+ private:
+  static const uint32_t kStandardIdCount = 0x800;
+  static const uint32_t kStandardIdMask  = 0x7FF;
+
+  struct ExtendedFilter {
+    uint32_t id      = 0;
+    uint32_t mask    = 0;
+    RouteMask routes = 0;
+  };
+
+  bool AddExtendedFilter(const CanIdFilter& filter, RouteMask route_bit);
+
+  RouteMask standard_[kStandardIdCount] = {};
+  ExtendedFilter extended_[kMaxExtendedFilters];
+  size_t extended_count_ = 0;
+  RouteMask all_frames_  = 0;  // Маршруты без фильтров
+};
@@ -0,0 +1,37 @@
+#include "can_signal.h"
+
+bool CanSignal::ExtractRaw(const TwaiFrame& frame, uint32_t& raw) const {
+  if (length == 0 || length > kMaxLength) {
+    return false;
+  }
+
+  uint32_t value = 0;
+  uint32_t bit   = start_bit;
+  for (uint8_t i = 0; i < length; i++) {
+    const uint32_t byte = bit / 8;
+    if (byte >= frame.data_length || byte >= sizeof(frame.data)) {
+      return false;
+    }
+    const uint32_t bit_value = (frame.data[byte] >> (bit % 8)) & 1;
+
+    if (byte_order == ByteOrder::INTEL) {
+      value |= bit_value << i;
+      bit++;
+    } else {
+      // От старшего бита к младшему; после бита 0 байта - бит 7 следующего байта
+      value = (value << 1) | bit_value;
+      bit   = (bit % 8 == 0) ? bit + 15 : bit - 1;
+    }
+  }
+
+  if (is_signed && length < kMaxLength && (value & (1u << (length - 1))) != 0) {
+    value |= ~0u << length;
+  }
+  raw = value;
+  return true;
+}
+
+float CanSignal::ToPhysical(uint32_t raw) const {
+  const float value = is_signed ? static_cast<float>(static_cast<int32_t>(raw)) : static_cast<float>(raw);
+  return value * scale + offset;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+
+#include "phy_interface.h"
+
+/**
+ * @brief Описание сигнала в кадре CAN в духе DBC
+ *
+ * Физическое значение = raw * scale + offset. Нумерация битов как в DBC:
+ * бит i - бит (i % 8) байта i / 8. Для INTEL start_bit - младший бит
+ * сигнала, для MOTOROLA - старший, следующие биты идут к младшему
+ * внутри байта и дальше в следующий байт.
+ */
+struct CanSignal {
+  enum class ByteOrder : uint8_t {
+    INTEL = 0,  // Little endian (@1 в DBC)
+    MOTOROLA    // Big endian (@0 в DBC)
+  };
+
+  static const uint8_t kMaxLength = 32;
+
+  uint32_t id          = 0;
+  bool is_extended     = false;
+  uint8_t start_bit    = 0;
+  uint8_t length       = 0;  // 1..kMaxLength бит
+  ByteOrder byte_order = ByteOrder::INTEL;
+  bool is_signed       = false;
+  float scale          = 1.0f;
+  float offset         = 0.0f;
+  uint8_t tag          = 0;  // Параметр приложения, которому принадлежит сигнал
+
+  bool Matches(const TwaiFrame& frame) const {
+    return id == frame.id && is_extended == frame.is_extended;
+  }
+
+  /**
+   * @brief Извлечение сырого значения без арифметики с плавающей точкой (можно из прерывания)
+   * @param raw Значение; у знакового сигнала расширено знаком до 32 бит
+   * @return false если длина некорректна или сигнал выходит за данные кадра
+   */
+  bool ExtractRaw(const TwaiFrame& frame, uint32_t& raw) const;
+
+  /**
+   * @brief Физическое значение из сырого
+   */
+  float ToPhysical(uint32_t raw) const;
+};
@@ -0,0 +1,93 @@
+#include "can_sniffer.h"
+
+CanSniffer::CanSniffer(Span<const CanSignal> signals) :
+    signals_(signals.subspan(0, kMaxSignals)) {
+  for (const CanSignal& signal : signals_) {
+    bool known = false;
+    for (size_t i = 0; i < filter_count_; i++) {
+      known = known || (filters_[i].id == signal.id && filters_[i].is_extended == signal.is_extended);
+    }
+    if (known) {
+      continue;
+    }
+    if (filter_count_ == kMaxFilters) {
+      // Слишком много ID для таблицы маршрутизации: принимаем все кадры
+      filter_count_ = 0;
+      return;
+    }
+
+    CanIdFilter& filter = filters_[filter_count_++];
+    filter.id           = signal.id;
+    filter.mask         = signal.is_extended ? 0x1FFFFFFF : 0x7FF;
+    filter.is_extended  = signal.is_extended;
+  }
+}
+
+TwaiRxRing* CanSniffer::onTwaiMessage() {
+  // Все кадры обрабатываются в прерывании
+  return nullptr;
+}
+
+bool CanSniffer::isInterested(const TwaiFrame& frame) {
+  for (const CanSignal& signal : signals_) {
+    if (signal.Matches(frame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+Span<const CanIdFilter> CanSniffer::rxFilters() {
+  return Span<const CanIdFilter>(filters_, filter_count_);
+}
+
+bool CanSniffer::onTwaiFrameFromISR(const TwaiFrame& frame, bool& /*need_yield*/) {
+  for (size_t i = 0; i < signals_.size(); i++) {
+    uint32_t raw = 0;
+    if (!signals_[i].Matches(frame) || !signals_[i].ExtractRaw(frame, raw)) {
+      continue;
+    }
+    Slot& slot = slots_[i];
+    slot.raw.store(raw, std::memory_order_relaxed);
+    slot.timestamp_us.store(frame.timestamp_us, std::memory_order_relaxed);
+    slot.updates.fetch_add(1, std::memory_order_release);
+  }
+  return true;
+}
+
+size_t CanSniffer::Poll(SignalSink sink, void* ctx) {
+  size_t published = 0;
+  for (size_t i = 0; i < signals_.size(); i++) {
+    const Slot& slot = slots_[i];
+
+    // Повтор, если прерывание обновило сигнал во время чтения
+    uint32_t updates = slot.updates.load(std::memory_order_acquire);
+    uint32_t raw     = 0;
+    while (true) {
+      raw                          = slot.raw.load(std::memory_order_relaxed);
+      const uint32_t updates_after = slot.updates.load(std::memory_order_acquire);
+      if (updates_after == updates) {
+        break;
+      }
+      updates = updates_after;
+    }
+
+    if (updates == seen_[i]) {
+      continue;
+    }
+    seen_[i] = updates;
+    if (sink != nullptr) {
+      sink(signals_[i], signals_[i].ToPhysical(raw), ctx);
+    }
+    published++;
+  }
+  return published;
+}
+
+uint32_t CanSniffer::GetUpdateCount(size_t index) const {
+  return (index < kMaxSignals) ? slots_[index].updates.load(std::memory_order_acquire) : 0;
+}
+
+uint32_t CanSniffer::GetTimestampUs(size_t index) const {
+  return (index < kMaxSignals) ? slots_[index].timestamp_us.load(std::memory_order_relaxed) : 0;
+}
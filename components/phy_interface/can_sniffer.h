@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "can_signal.h"
+#include "phy_interface.h"
+#include "span.h"
+
+/**
+ * @brief Пассивный подписчик: сигналы широковещательных кадров по таблице
+ *
+ * Сырые значения извлекаются прямо в прерывании (только целочисленная
+ * арифметика) и сохраняются как последнее значение сигнала; буфер кадров
+ * не нужен и не переполняется. Задача периодически вызывает Poll(),
+ * который пересчитывает обновленные сигналы в физические величины.
+ *
+ * Драйверу передается по фильтру на каждый ID таблицы. Если разных ID
+ * больше kMaxFilters, подписчик получает все кадры.
+ */
+class CanSniffer final : public ITwaiSubscriber {
+ public:
+  static const size_t kMaxSignals = 16;
+  static const size_t kMaxFilters = 8;
+
+  using SignalSink = void (*)(const CanSignal& signal, float value, void* ctx);
+
+  /**
+   * @param signals Таблица сигналов; память должна жить дольше подписчика.
+   *                Сигналы сверх kMaxSignals не декодируются
+   */
+  explicit CanSniffer(Span<const CanSignal> signals);
+
+  TwaiRxRing* onTwaiMessage() override;
+  bool isInterested(const TwaiFrame& frame) override;
+  Span<const CanIdFilter> rxFilters() override;
+
+  /**
+   * @brief Извлечение сигналов кадра в прерывании; кадр всегда поглощается
+   */
+  bool onTwaiFrameFromISR(const TwaiFrame& frame, bool& need_yield) override;
+
+  /**
+   * @brief Передача сигналов, обновленных с прошлого вызова (из задачи)
+   * @return Количество переданных сигналов
+   */
+  size_t Poll(SignalSink sink, void* ctx);
+
+  /**
+   * @brief Количество кадров, обновивших сигнал (с переполнением)
+   */
+  uint32_t GetUpdateCount(size_t index) const;
+
+  /**
+   * @brief Время приема кадра, последним обновившего сигнал, в микросекундах
+   */
+  uint32_t GetTimestampUs(size_t index) const;
+
+ private:
+  // Последнее значение сигнала, пишет только прерывание
+  struct Slot {
+    std::atomic_uint32_t raw{0};
+    std::atomic_uint32_t timestamp_us{0};
+    std::atomic_uint32_t updates{0};
+  };
+
+  Span<const CanSignal> signals_;
+  CanIdFilter filters_[kMaxFilters];
+  size_t filter_count_ = 0;
+  Slot slots_[kMaxSignals];
+  uint32_t seen_[kMaxSignals] = {};  // Значение updates при прошлом Poll()
+};
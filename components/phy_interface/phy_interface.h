@@ -2,33 +2,83 @@
 
 #include <cstdint>
 
+#include "span.h"
 #include "time_utils.h"
 
+/**
+ * @brief Класс приоритета кадра в очереди передачи
+ *
+ * Драйвер всегда передает следующим кадр старшего класса: FLOW_CONTROL,
+ * затем REQUEST, затем BULK. Нулевое значение - REQUEST, поэтому кадр,
+ * созданный как TwaiFrame frame = {}, передается как обычный запрос.
+ */
+enum class TxPriority : uint8_t {
+  REQUEST = 0,   // Одиночные запросы, FF, tester present
+  FLOW_CONTROL,  // FC: задержка ограничена временем передачи одного кадра
+  BULK           // CF многокадровой передачи
+};
+
+/**
+ * @brief Состояние узла на шине (ISO 11898-1) и восстановление драйвера
+ */
+enum class TwaiBusState : uint8_t {
+  ERROR_ACTIVE = 0,  // Нормальная работа
+  ERROR_WARNING,     // Счетчик ошибок выше 96
+  ERROR_PASSIVE,     // Счетчик ошибок выше 127: передача в карантине
+  BUS_OFF,           // Узел отключен от шины, восстановление запланировано
+  RECOVERING         // Идет восстановление (128 x 11 рецессивных бит)
+};
+
 // Определение структуры TwaiFrame перед использованием
+//
+// Буфер данных рассчитан на классический CAN (ESP32-C3). Сборка с TWAI_CAN_FD
+// расширяет его до 64 байт: кадр хранится в кольцах приема и очереди передачи,
+// поэтому без контроллера CAN FD лишние байты только занимают RAM.
 struct TwaiFrame {
-  uint32_t id;          // Идентификатор сообщения
-  bool is_extended;     // Флаг расширенного идентификатора (29 бит)
-  bool is_rtr;          // Флаг удаленного запроса (Remote Transmission Request)
-  bool is_fd;           // Флаг CAN FD
-  bool brs;             // Bit Rate Switch (для CAN FD)
-  uint8_t data[8];      // Данные (максимум 64 байта для CAN FD)
-  uint8_t data_length;  // Длина данных (DLC)
+#ifdef TWAI_CAN_FD
+  static constexpr uint8_t kMaxDataLength = 64;  // CAN FD
+#else
+  static constexpr uint8_t kMaxDataLength = 8;  // Классический CAN
+#endif
+
+  uint32_t id;                   // Идентификатор сообщения
+  bool is_extended;              // Флаг расширенного идентификатора (29 бит)
+  bool is_rtr;                   // Флаг удаленного запроса (Remote Transmission Request)
+  bool is_fd;                    // Флаг CAN FD
+  bool brs;                      // Bit Rate Switch (для CAN FD)
+  uint8_t data[kMaxDataLength];  // Данные (8 байт для классического CAN, до 64 байт для CAN FD)
+  uint8_t data_length;           // Длина данных в байтах: 0-8, для CAN FD также 12/16/20/24/32/48/64
+  uint32_t timestamp_us;         // Время приема в мкс (esp_timer, переполнение ~71 мин), 0 - не задано
+  TxPriority tx_priority;        // Класс приоритета передачи (для принятых кадров не используется)
 };
 
+/**
+ * @brief Фильтр CAN ID: кадр проходит, если (id & mask) == (filter.id & mask)
+ */
+struct CanIdFilter {
+  uint32_t id      = 0;
+  uint32_t mask    = 0;
+  bool is_extended = false;  // Фильтр для 29-битных ID
+
+  bool Matches(const TwaiFrame& frame) const {
+    return is_extended == frame.is_extended && ((frame.id ^ id) & mask) == 0;
+  }
+};
+
+class TwaiRxRing;
+
 class ITwaiSubscriber {
  public:
   /**
-   * @brief Получение очереди для входящего TWAI сообщения
+   * @brief Получение буфера для входящих TWAI сообщений
    *
-   * Этот метод вызывается, когда получено TWAI сообщение,
-   * в котором подписчик выразил заинтересованность.
-   * Метод должен вернуть указатель на очередь, в которую
-   * будет помещено сообщение. Если подписчик не хочет
-   * обрабатывать сообщение, должен вернуть nullptr.
+   * Драйвер запрашивает буфер при регистрации подписчика и помещает
+   * в него из прерывания кадры, в которых подписчик заинтересован.
+   * Если подписчик не хочет получать кадры, должен вернуть nullptr.
    *
-   * @return Указатель на очередь для помещения сообщения или nullptr
+   * @return Указатель на буфер подписчика или nullptr
    */
-  virtual QueueHandle_t onTwaiMessage() = 0;
+  virtual TwaiRxRing* onTwaiMessage() = 0;
 
   /**
    * @brief Проверка заинтересованности подписчика в конкретном TWAI сообщении
@@ -42,6 +92,61 @@ class ITwaiSubscriber {
    */
   virtual bool isInterested(const TwaiFrame& frame) = 0;
 
+  /**
+   * @brief Фильтры CAN ID подписчика
+   *
+   * Драйвер читает фильтры при регистрации и строит по ним таблицу
+   * маршрутизации, поэтому в прерывании isInterested() не вызывается.
+   * Пустой список - подписчик получает все кадры.
+   *
+   * @return Фильтры; память должна оставаться валидной до отмены регистрации
+   */
+  virtual Span<const CanIdFilter> rxFilters() {
+    return Span<const CanIdFilter>();
+  }
+
+  /**
+   * @brief Уведомление о завершении передачи кадра
+   *
+   * Вызывается из прерывания TWAI для каждого кадра, покинувшего контроллер
+   * (успешно или после исчерпания повторов). Позволяет отправителю
+   * продвигать передачу по событиям, а не по задержкам.
+   *
+   * @param frame Переданный кадр (заполнены только заголовок и длина)
+   * @param success true если кадр подтвержден на шине
+   * @return true если разбужена более приоритетная задача (нужно переключение контекста)
+   */
+  virtual bool onTwaiTxDone(const TwaiFrame& /*frame*/, bool /*success*/) {
+    return false;
+  }
+
+  /**
+   * @brief Обработка принятого кадра в прерывании до помещения в очередь
+   *
+   * Вызывается из прерывания TWAI для кадров, в которых подписчик
+   * заинтересован. Позволяет обработать кадр на месте (например, собрать
+   * многокадровое сообщение) и будить задачу только по значимым событиям.
+   *
+   * @param frame Принятый кадр
+   * @param need_yield Устанавливается в true, если разбужена более приоритетная задача
+   * @return true если кадр обработан и не должен помещаться в очередь подписчика
+   */
+  virtual bool onTwaiFrameFromISR(const TwaiFrame& /*frame*/, bool& /*need_yield*/) {
+    return false;
+  }
+
+  /**
+   * @brief Уведомление о смене состояния узла на шине
+   *
+   * Вызывается из прерывания TWAI (переходы контроллера) или из задачи
+   * esp_timer (запуск восстановления после bus-off). В BUS_OFF очередь
+   * передачи драйвера сброшена: отправителю следует прервать текущие
+   * передачи, а не ждать их таймаутов.
+   *
+   * @param state Новое состояние
+   */
+  virtual void onTwaiBusState(TwaiBusState /*state*/) {}
+
  protected:
   virtual ~ITwaiSubscriber() = default;
 };
@@ -74,8 +179,36 @@ class IPhyInterface {
    */
   virtual TwaiError Transmit(const TwaiFrame& message, Time_ms timeout_ms) = 0;
 
+  /**
+   * @brief Передача пачки CAN сообщений
+   *
+   * Кадры ставятся в очередь передачи подряд и уходят на шину в том же
+   * порядке; запуск передачи выполняется один раз на пачку. Реализация по
+   * умолчанию передает кадры по одному через Transmit().
+   *
+   * @param frames Кадры для передачи
+   * @param timeout_ms Время ожидания места в очереди для каждого кадра в ms
+   * @param[out] queued Количество кадров, принятых в очередь (первые queued из frames)
+   * @return TwaiError::OK если приняты все кадры
+   */
+  virtual TwaiError TransmitBatch(Span<const TwaiFrame> frames, Time_ms timeout_ms, size_t& queued) {
+    queued = 0;
+    for (const TwaiFrame& frame : frames) {
+      const TwaiError result = Transmit(frame, timeout_ms);
+      if (result != TwaiError::OK) {
+        return result;
+      }
+      queued++;
+    }
+    return TwaiError::OK;
+  }
+
   /**
    * @brief Регистрация подписчика на сообщения
+   *
+   * Повторная регистрация уже зарегистрированного подписчика
+   * обновляет его фильтры CAN ID.
+   *
    * @param subscriber Ссылка на подписчика
    */
   virtual void RegisterSubscriber(ITwaiSubscriber& subscriber) = 0;
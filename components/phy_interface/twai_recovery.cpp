@@ -0,0 +1,81 @@
+#include "twai_recovery.h"
+
+bool TwaiRecovery::OnStateChange(TwaiBusState state, uint32_t now_us) {
+  const TwaiBusState previous = state_.load(std::memory_order_acquire);
+  if (state == previous) {
+    return false;
+  }
+
+  switch (state) {
+    case TwaiBusState::BUS_OFF:
+      bus_off_count_.fetch_add(1, std::memory_order_relaxed);
+      // Шина долго работала после прошлого восстановления: новая серия начинается с короткой задержки
+      if (recovered_.load(std::memory_order_relaxed) &&
+          now_us - recovered_us_.load(std::memory_order_relaxed) >= kStableUs) {
+        attempts_.store(0, std::memory_order_relaxed);
+      }
+      break;
+
+    case TwaiBusState::ERROR_ACTIVE:
+    case TwaiBusState::ERROR_WARNING:
+    case TwaiBusState::ERROR_PASSIVE:
+      if (previous == TwaiBusState::BUS_OFF || previous == TwaiBusState::RECOVERING) {
+        recovery_count_.fetch_add(1, std::memory_order_relaxed);
+        recovered_us_.store(now_us, std::memory_order_relaxed);
+        recovered_.store(true, std::memory_order_relaxed);
+      }
+      break;
+
+    case TwaiBusState::RECOVERING:
+      // Восстановление запускает только OnRecoveryStarted()
+      return false;
+  }
+
+  state_.store(state, std::memory_order_release);
+  return true;
+}
+
+bool TwaiRecovery::OnRecoveryStarted() {
+  TwaiBusState expected = TwaiBusState::BUS_OFF;
+  if (!state_.compare_exchange_strong(expected, TwaiBusState::RECOVERING, std::memory_order_acq_rel)) {
+    return false;
+  }
+  attempts_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+uint32_t TwaiRecovery::OnRecoveryFailed() {
+  TwaiBusState expected = TwaiBusState::RECOVERING;
+  state_.compare_exchange_strong(expected, TwaiBusState::BUS_OFF, std::memory_order_acq_rel);
+  return BackoffUs();
+}
+
+uint32_t TwaiRecovery::BackoffUs() const {
+  uint32_t backoff      = kInitialBackoffUs;
+  const uint32_t shifts = attempts_.load(std::memory_order_relaxed);
+  for (uint32_t i = 0; i < shifts && backoff < kMaxBackoffUs; i++) {
+    backoff *= 2;
+  }
+  return (backoff < kMaxBackoffUs) ? backoff : kMaxBackoffUs;
+}
+
+bool TwaiRecovery::AcceptsFrames() const {
+  const TwaiBusState state = state_.load(std::memory_order_acquire);
+  return state != TwaiBusState::BUS_OFF && state != TwaiBusState::RECOVERING;
+}
+
+bool TwaiRecovery::Quarantined() const {
+  return state_.load(std::memory_order_acquire) >= TwaiBusState::ERROR_PASSIVE;
+}
+
+TwaiBusState TwaiRecovery::State() const {
+  return state_.load(std::memory_order_acquire);
+}
+
+uint32_t TwaiRecovery::BusOffCount() const {
+  return bus_off_count_.load(std::memory_order_relaxed);
+}
+
+uint32_t TwaiRecovery::RecoveryCount() const {
+  return recovery_count_.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "phy_interface.h"
+
+/**
+ * @brief Автомат восстановления узла TWAI после ошибок шины
+ *
+ * Получает переходы состояния контроллера и решает:
+ * - когда запускать восстановление после bus-off: задержка растет вдвое
+ *   от kInitialBackoffUs до kMaxBackoffUs и сбрасывается, если после
+ *   предыдущего восстановления шина проработала без bus-off kStableUs;
+ * - можно ли передавать: в error-passive передача в карантине (кадры
+ *   принимаются в очередь и уходят строго по одному, следующий - после
+ *   завершения текущего), в bus-off и во время восстановления новые кадры
+ *   не принимаются.
+ *
+ * Методы вызываются из прерывания TWAI и из задачи esp_timer, поэтому
+ * состояние хранится в атомарных переменных. От ESP-IDF автомат не зависит.
+ */
+class TwaiRecovery {
+ public:
+  static const uint32_t kInitialBackoffUs = 10000;    // Первая попытка через 10 мс
+  static const uint32_t kMaxBackoffUs     = 1000000;  // Попытки не реже раза в секунду
+  static const uint32_t kStableUs         = 1000000;  // Работа без bus-off, сбрасывающая задержку
+
+  /**
+   * @brief Переход контроллера в новое состояние
+   * @param state Состояние из события контроллера (кроме RECOVERING)
+   * @param now_us Текущее время в микросекундах
+   * @return true если состояние изменилось и подписчиков нужно уведомить
+   */
+  bool OnStateChange(TwaiBusState state, uint32_t now_us);
+
+  /**
+   * @brief Запуск восстановления по истечении задержки
+   * @return false если узел уже не в bus-off и восстанавливать нечего
+   */
+  bool OnRecoveryStarted();
+
+  /**
+   * @brief Контроллер отклонил запуск восстановления
+   * @return Задержка до следующей попытки в микросекундах
+   */
+  uint32_t OnRecoveryFailed();
+
+  /**
+   * @brief Задержка запуска восстановления для текущей серии bus-off
+   */
+  uint32_t BackoffUs() const;
+
+  /**
+   * @brief Драйвер может ставить новые кадры в очередь (не bus-off и не восстановление)
+   */
+  bool AcceptsFrames() const;
+
+  /**
+   * @brief Передача в карантине: в полете не больше одного кадра
+   */
+  bool Quarantined() const;
+
+  TwaiBusState State() const;
+  uint32_t BusOffCount() const;
+  uint32_t RecoveryCount() const;  // Восстановления, завершенные возвратом в error-active
+
+ private:
+  std::atomic<TwaiBusState> state_{TwaiBusState::ERROR_ACTIVE};
+  std::atomic_uint32_t attempts_{0};  // Попытки восстановления в текущей серии bus-off
+  std::atomic_uint32_t bus_off_count_{0};
+  std::atomic_uint32_t recovery_count_{0};
+  std::atomic_uint32_t recovered_us_{0};  // Время последнего восстановления
+  std::atomic_bool recovered_{false};     // recovered_us_ задано
+};
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "phy_interface.h"
+#include "spsc_ring.h"
+
+/**
+ * @brief Принятые кадры подписчика: прерывание TWAI -> задача
+ *
+ * Кадр копируется в кольцевой буфер без критической секции. Задача-читатель
+ * получает уведомление (task notification) только при переходе буфера
+ * из пустого в непустой, так что пачка кадров будит ее один раз.
+ * При переполнении отбрасываются новые кадры, принятые раньше сохраняются.
+ *
+ * Задача-читатель задается явно (конструктор или SetConsumer()), уведомление
+ * приходит в отдельный индекс kNotifyIndex: индекс 0 остается прочему коду задачи.
+ * Без читателя буфер только опрашивается, Receive() не ждет.
+ */
+class TwaiRxRing {
+ public:
+  static const size_t kCapacity         = 16;
+  static const UBaseType_t kNotifyIndex = 1;
+
+  static_assert(kNotifyIndex < configTASK_NOTIFICATION_ARRAY_ENTRIES,
+                "CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES must be at least 2");
+
+  explicit TwaiRxRing(TaskHandle_t consumer = nullptr) :
+      consumer_(consumer) {}
+
+  /**
+   * @brief Назначение задачи-читателя (до начала приема кадров)
+   */
+  void SetConsumer(TaskHandle_t consumer) {
+    consumer_.store(consumer, std::memory_order_release);
+  }
+
+  /**
+   * @brief Добавление кадра (из прерывания)
+   * @param need_yield Устанавливается в true, если разбужена задача-читатель
+   * @return false если буфер полон и кадр отброшен
+   */
+  bool PushFromISR(const TwaiFrame& frame, bool& need_yield) {
+    bool was_empty = false;
+    if (!ring_.push(frame, was_empty)) {
+      return false;
+    }
+    if (was_empty) {
+      NotifyFromISR(need_yield);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Пробуждение задачи-читателя без кадра (из прерывания)
+   */
+  void NotifyFromISR(bool& need_yield) {
+    TaskHandle_t consumer = consumer_.load(std::memory_order_acquire);
+    if (consumer == nullptr) {
+      return;
+    }
+    BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+    vTaskNotifyGiveIndexedFromISR(consumer, kNotifyIndex, &xHigherPriorityTaskWoken);
+    need_yield = need_yield || (xHigherPriorityTaskWoken == pdTRUE);
+  }
+
+  /**
+   * @brief Пробуждение задачи-читателя без кадра (из контекста задачи)
+   */
+  void Notify() {
+    TaskHandle_t consumer = consumer_.load(std::memory_order_acquire);
+    if (consumer != nullptr) {
+      xTaskNotifyGiveIndexed(consumer, kNotifyIndex);
+    }
+  }
+
+  /**
+   * @brief Получение кадра; вызывается только задачей-читателем
+   *
+   * Пробуждение без кадра (Notify) возвращает false: вызывающая сторона
+   * проверяет таймеры и вызывает метод снова.
+   *
+   * @param timeout Время ожидания в тиках (без читателя не ждет)
+   * @return true если кадр получен
+   */
+  bool Receive(TwaiFrame& frame, TickType_t timeout) {
+    if (ring_.pop(frame)) {
+      return true;
+    }
+    if (consumer_.load(std::memory_order_relaxed) == nullptr) {
+      return false;
+    }
+    if (ulTaskNotifyTakeIndexed(kNotifyIndex, pdTRUE, timeout) == 0) {
+      return false;
+    }
+    return ring_.pop(frame);
+  }
+
+  bool Empty() const {
+    return ring_.empty();
+  }
+
+  size_t Size() const {
+    return ring_.size();
+  }
+
+  /**
+   * @brief Количество кадров, отброшенных из-за переполнения
+   */
+  uint32_t GetDropCount() const {
+    return ring_.dropped();
+  }
+
+ private:
+  SpscRing<TwaiFrame, kCapacity> ring_;
+  std::atomic<TaskHandle_t> consumer_;
+};
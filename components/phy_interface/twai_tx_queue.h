@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "phy_interface.h"
+
+/**
+ * @brief Очередь передачи с классами приоритета (задача -> прерывание TWAI)
+ *
+ * По одной очереди FreeRTOS на каждый TxPriority. Следующим всегда
+ * выбирается кадр старшего непустого класса, внутри класса - по порядку
+ * постановки. Поэтому FC, поставленный за пачкой CF, ждет только кадр,
+ * уже переданный контроллеру, а переполнение BULK не мешает FC и запросам.
+ *
+ * Очереди создаются через xQueueCreateStatic: хранилище кадров и управляющие
+ * структуры лежат в объекте, куча не используется.
+ */
+class TwaiTxQueue {
+ public:
+  static const size_t kClasses = 3;
+
+  // Глубина очереди класса, индекс - значение TxPriority
+  static constexpr UBaseType_t kDepth[kClasses] = {
+      4,   // REQUEST
+      4,   // FLOW_CONTROL
+      10,  // BULK
+  };
+
+  // Суммарная глубина всех классов
+  static constexpr UBaseType_t kTotalDepth = kDepth[0] + kDepth[1] + kDepth[2];
+  static_assert(kClasses == 3, "kTotalDepth must cover every class");
+
+  TwaiTxQueue() = default;
+  TwaiTxQueue(const TwaiTxQueue&) = delete;
+  TwaiTxQueue& operator=(const TwaiTxQueue&) = delete;
+
+  ~TwaiTxQueue() {
+    for (QueueHandle_t queue : queues_) {
+      if (queue != nullptr) {
+        vQueueDelete(queue);
+      }
+    }
+  }
+
+  /**
+   * @brief Создание очередей классов в памяти объекта
+   * @return false если очередь не создана
+   */
+  bool Create() {
+    uint8_t* storage = storage_;
+    for (size_t i = 0; i < kClasses; i++) {
+      queues_[i] = xQueueCreateStatic(kDepth[i], sizeof(TwaiFrame), storage, &queue_buffers_[i]);
+      if (queues_[i] == nullptr) {
+        return false;
+      }
+      storage += kDepth[i] * sizeof(TwaiFrame);
+    }
+    return true;
+  }
+
+  /**
+   * @brief Постановка кадра в очередь его класса (frame.tx_priority)
+   * @param timeout Время ожидания места в тиках
+   * @return false если очередь класса заполнена
+   */
+  bool Send(const TwaiFrame& frame, TickType_t timeout) {
+    return xQueueSend(queues_[ClassIndex(frame)], &frame, timeout) == pdTRUE;
+  }
+
+  /**
+   * @brief Извлечение кадра старшего класса (из контекста задачи)
+   * @return false если все очереди пусты
+   */
+  bool Receive(TwaiFrame& frame) {
+    for (const TxPriority priority : kServiceOrder) {
+      if (xQueueReceive(queues_[static_cast<size_t>(priority)], &frame, 0) == pdTRUE) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Извлечение кадра старшего класса (из прерывания)
+   */
+  bool ReceiveFromISR(TwaiFrame& frame, BaseType_t* higher_priority_task_woken) {
+    for (const TxPriority priority : kServiceOrder) {
+      if (xQueueReceiveFromISR(queues_[static_cast<size_t>(priority)], &frame, higher_priority_task_woken) ==
+          pdTRUE) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Возврат кадра, не принятого контроллером, в начало очереди его класса
+   */
+  void Return(const TwaiFrame& frame) {
+    xQueueSendToFront(queues_[ClassIndex(frame)], &frame, 0);
+  }
+
+  void ReturnFromISR(const TwaiFrame& frame, BaseType_t* higher_priority_task_woken) {
+    xQueueSendToFrontFromISR(queues_[ClassIndex(frame)], &frame, higher_priority_task_woken);
+  }
+
+ private:
+  static constexpr TxPriority kServiceOrder[kClasses] = {
+      TxPriority::FLOW_CONTROL, TxPriority::REQUEST, TxPriority::BULK};
+
+  static size_t ClassIndex(const TwaiFrame& frame) {
+    const size_t index = static_cast<size_t>(frame.tx_priority);
+    return (index < kClasses) ? index : static_cast<size_t>(TxPriority::REQUEST);
+  }
+
+  std::array<QueueHandle_t, kClasses> queues_{};
+  std::array<StaticQueue_t, kClasses> queue_buffers_;
+  alignas(TwaiFrame) uint8_t storage_[kTotalDepth * sizeof(TwaiFrame)];
+};
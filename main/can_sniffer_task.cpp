@@ -0,0 +1,75 @@
+#include "can_sniffer_task.h"
+
+#include <inttypes.h>
+
+#include <array>
+
+#include "can_sniffer.h"
+#include "esp_log.h"
+#include "heap_monitor.h"
+#include "twai_driver.h"
+#include "vehicle_params.h"
+
+static const char* const TAG = "can_sniffer";
+
+extern VehicleParams vehicle_params;
+
+// Период переноса сигналов в VehicleParams
+static constexpr uint32_t kPublishPeriodMs = 20;
+
+// Сигналы широковещательных кадров конкретного автомобиля (из DBC).
+// Логи can_log сняты через OBD-разъем за шлюзом и содержат только диагностический
+// трафик, поэтому таблица пуста. Формат записи:
+//   {ID, расширенный, стартовый бит, длина, порядок байт, знаковый, масштаб, смещение, параметр}
+// Пример:
+//   {0x316, false, 16, 16, CanSignal::ByteOrder::INTEL, false, 0.25f, 0.0f,
+//    static_cast<uint8_t>(VehicleSignal::RPM)},
+static const std::array<CanSignal, 0> kVehicleSignals = {};
+
+static void ApplySignal(const CanSignal& signal, float value, void* ctx) {
+  VehicleParams* params = static_cast<VehicleParams*>(ctx);
+  switch (static_cast<VehicleSignal>(signal.tag)) {
+    case VehicleSignal::RPM:
+      params->setRpm(value);
+      break;
+    case VehicleSignal::SPEED:
+      params->setSpeed(static_cast<int>(value));
+      break;
+    case VehicleSignal::COOLANT_TEMP:
+      params->setCoolantTemp(static_cast<int>(value));
+      break;
+    case VehicleSignal::THROTTLE_POSITION:
+      params->setThrottlePosition(static_cast<int>(value));
+      break;
+    case VehicleSignal::ENGINE_LOAD:
+      params->setEngineLoad(static_cast<int>(value));
+      break;
+    case VehicleSignal::INTAKE_AIR_TEMP:
+      params->setIntakeAirTemp(static_cast<int>(value));
+      break;
+    default:
+      ESP_LOGW(TAG, "Unknown signal tag %d for ID 0x%" PRIX32, signal.tag, signal.id);
+      break;
+  }
+}
+
+void can_sniffer_task(void* arg) {
+  TwaiDriver* can_driver = static_cast<TwaiDriver*>(arg);
+  if (can_driver == nullptr) {
+    ESP_LOGE(TAG, "can_driver parameter is null");
+    vTaskDelete(nullptr);
+    return;
+  }
+
+  static CanSniffer sniffer(Span<const CanSignal>(kVehicleSignals.data(), kVehicleSignals.size()));
+  can_driver->RegisterSubscriber(sniffer);
+  can_driver->InstallStart();  // Фильтры сниффера заданы: узел запускается сразу с ними
+  ESP_LOGI(TAG, "Listening for %d signals", static_cast<int>(kVehicleSignals.size()));
+
+  heap_monitor_arm();
+
+  while (1) {
+    sniffer.Poll(ApplySignal, &vehicle_params);
+    vTaskDelay(pdMS_TO_TICKS(kPublishPeriodMs));
+  }
+}
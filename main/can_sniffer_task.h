@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * @brief Параметры VehicleParams, которые можно получить из широковещательных кадров
+ */
+enum class VehicleSignal : uint8_t {
+  RPM = 0,
+  SPEED,
+  COOLANT_TEMP,
+  THROTTLE_POSITION,
+  ENGINE_LOAD,
+  INTAKE_AIR_TEMP,
+};
+
+/**
+ * @brief Функция задачи FreeRTOS пассивного приема сигналов
+ *
+ * Регистрирует CanSniffer с таблицей сигналов автомобиля, запускает драйвер
+ * и переносит обновленные значения в VehicleParams. Драйвер должен работать
+ * в режиме listen-only: шина не нагружается запросами.
+ *
+ * @param arg Параметр задачи - указатель на TwaiDriver
+ */
+void can_sniffer_task(void* arg);
@@ -0,0 +1,104 @@
+#include "heap_monitor.h"
+
+#include <inttypes.h>
+
+#include <atomic>
+
+#include "esp_attr.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "heap_watermark.h"
+
+static const char* const TAG = "heap_monitor";
+
+static std::atomic_uint32_t heap_allocations{0};
+static std::atomic_uint32_t heap_frees{0};
+static std::atomic<TaskHandle_t> monitored_task{nullptr};  // Задача, вызвавшая heap_monitor_arm()
+static std::atomic_bool exempt{false};                     // Идет известное выделение (HeapMonitorExemption)
+
+static HeapWatermark watermark;
+static portMUX_TYPE watermark_lock = portMUX_INITIALIZER_UNLOCKED;
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+// Хуки аллокатора ESP-IDF вызываются при каждом выделении и освобождении во всех задачах
+// и прерываниях: считаются только обращения контролируемой задачи
+static bool IRAM_ATTR IsMonitored() {
+  if (xPortInIsrContext() || exempt.load(std::memory_order_relaxed)) {
+    return false;
+  }
+  const TaskHandle_t task = monitored_task.load(std::memory_order_relaxed);
+  return task != nullptr && task == xTaskGetCurrentTaskHandle();
+}
+
+extern "C" void IRAM_ATTR esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+  if (IsMonitored()) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+extern "C" void IRAM_ATTR esp_heap_trace_free_hook(void* ptr) {
+  if (IsMonitored()) {
+    heap_frees.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+static const bool kCountsAllocations = true;
+#else
+static const bool kCountsAllocations = false;
+#endif
+
+static HeapWatermark::Snapshot TakeSnapshot() {
+  HeapWatermark::Snapshot snapshot;
+  snapshot.allocations    = heap_allocations.load(std::memory_order_relaxed);
+  snapshot.frees          = heap_frees.load(std::memory_order_relaxed);
+  snapshot.free_bytes     = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+  snapshot.min_free_bytes = heap_caps_get_minimum_free_size(MALLOC_CAP_DEFAULT);
+  return snapshot;
+}
+
+void heap_monitor_arm() {
+  monitored_task.store(xTaskGetCurrentTaskHandle(), std::memory_order_relaxed);
+  const HeapWatermark::Snapshot snapshot = TakeSnapshot();
+  portENTER_CRITICAL(&watermark_lock);
+  watermark.Arm(snapshot, kCountsAllocations);
+  portEXIT_CRITICAL(&watermark_lock);
+  ESP_LOGI(TAG,
+           "Heap armed: free %u, minimum %u",
+           static_cast<unsigned>(snapshot.free_bytes),
+           static_cast<unsigned>(snapshot.min_free_bytes));
+}
+
+bool heap_monitor_check() {
+  const HeapWatermark::Snapshot snapshot = TakeSnapshot();
+  portENTER_CRITICAL(&watermark_lock);
+  const bool armed                   = watermark.IsArmed();
+  const HeapWatermark::Report report = watermark.Check(snapshot);
+  portEXIT_CRITICAL(&watermark_lock);
+
+  if (!armed) {
+    return true;
+  }
+  if (!report.steady) {
+    ESP_LOGE(TAG,
+             "Heap used after boot: %" PRIu32 " allocations, %" PRIu32 " frees, free %+" PRId32 ", minimum %u",
+             report.allocations,
+             report.frees,
+             report.free_delta,
+             static_cast<unsigned>(report.min_free_bytes));
+  }
+  return report.steady;
+}
+
+HeapMonitorExemption::HeapMonitorExemption() {
+  exempt.store(true, std::memory_order_relaxed);
+}
+
+HeapMonitorExemption::~HeapMonitorExemption() {
+  exempt.store(false, std::memory_order_relaxed);
+  const HeapWatermark::Snapshot snapshot = TakeSnapshot();
+  portENTER_CRITICAL(&watermark_lock);
+  watermark.Accept(snapshot);
+  portEXIT_CRITICAL(&watermark_lock);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * @brief Точка отсчета контроля кучи
+ *
+ * Вызывается задачей получения данных после создания всех своих объектов:
+ * дальше приложение работает без обращений к куче.
+ */
+void heap_monitor_arm();
+
+/**
+ * @brief Проверка кучи с момента heap_monitor_arm() и вывод в лог
+ *
+ * С CONFIG_HEAP_USE_HOOKS хуки аллокатора считают выделения только задачи,
+ * вызвавшей heap_monitor_arm(): выделения UI, esp_timer и прерываний не
+ * учитываются. Без хуков проверяется минимум свободной памяти всей системы.
+ *
+ * @return false если после точки отсчета куча использовалась
+ */
+bool heap_monitor_check();
+
+/**
+ * @brief Известное выделение после точки отсчета (запись в NVS)
+ *
+ * Пока объект существует, выделения не считаются. После него свободная
+ * память и ее минимум принимаются за новую точку отсчета.
+ */
+class HeapMonitorExemption {
+ public:
+  HeapMonitorExemption();
+  ~HeapMonitorExemption();
+
+  HeapMonitorExemption(const HeapMonitorExemption&)            = delete;
+  HeapMonitorExemption& operator=(const HeapMonitorExemption&) = delete;
+};
@@ -0,0 +1,51 @@
+#include "nvs_kv_store.h"
+
+#include "esp_log.h"
+#include "nvs_flash.h"
+
+static const char* const TAG = "nvs_kv_store";
+
+bool NvsKeyValueStore::open() {
+  esp_err_t err = nvs_flash_init();
+  if ((err == ESP_ERR_NVS_NO_FREE_PAGES) || (err == ESP_ERR_NVS_NEW_VERSION_FOUND)) {
+    // Раздел заполнен или записан другой версией NVS: хранятся только кэши, их можно стереть
+    ESP_LOGW(TAG, "NVS partition is outdated (%s), erasing", esp_err_to_name(err));
+    nvs_flash_erase();
+    err = nvs_flash_init();
+  }
+  if (err == ESP_OK) {
+    err = nvs_open(name_space_, NVS_READWRITE, &handle_);
+  }
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open NVS namespace %s: %s", name_space_, esp_err_to_name(err));
+    return false;
+  }
+  opened_ = true;
+  return true;
+}
+
+bool NvsKeyValueStore::read(const char* key, Span<uint8_t> buffer, size_t& len) {
+  if (!opened_) {
+    return false;
+  }
+  len                 = buffer.size();
+  const esp_err_t err = nvs_get_blob(handle_, key, buffer.data(), &len);
+  if ((err != ESP_OK) && (err != ESP_ERR_NVS_NOT_FOUND)) {
+    ESP_LOGW(TAG, "Failed to read %s: %s", key, esp_err_to_name(err));
+  }
+  return err == ESP_OK;
+}
+
+bool NvsKeyValueStore::write(const char* key, Span<const uint8_t> data) {
+  if (!opened_) {
+    return false;
+  }
+  esp_err_t err = nvs_set_blob(handle_, key, data.data(), data.size());
+  if (err == ESP_OK) {
+    err = nvs_commit(handle_);
+  }
+  if (err != ESP_OK) {
+    ESP_LOGW(TAG, "Failed to write %s: %s", key, esp_err_to_name(err));
+  }
+  return err == ESP_OK;
+}
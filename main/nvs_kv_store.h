@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "kv_store_interface.h"
+#include "nvs.h"
+
+/**
+ * @brief Хранилище записей по ключу в пространстве имен NVS
+ *
+ * open() выполняется до heap_monitor_arm(): инициализация NVS выделяет память.
+ * write() после точки отсчета оборачивается в HeapMonitorExemption.
+ */
+class NvsKeyValueStore final : public IKeyValueStore {
+ public:
+  explicit NvsKeyValueStore(const char* name_space) :
+      name_space_(name_space) {}
+
+  /**
+   * @brief Инициализирует раздел NVS и открывает пространство имен
+   * @return true если хранилище готово к работе
+   */
+  bool open();
+
+  bool read(const char* key, Span<uint8_t> buffer, size_t& len) override;
+  bool write(const char* key, Span<const uint8_t> data) override;
+
+ private:
+  const char* const name_space_;
+  nvs_handle_t handle_ = 0;
+  bool opened_         = false;
+};
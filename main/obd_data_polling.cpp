@@ -1,8 +1,14 @@
 #include "obd_data_polling.h"
 
+#include <array>
+#include <cinttypes>
+
 #include "esp_log.h"
+#include "heap_monitor.h"
 #include "iso_tp.h"
+#include "nvs_kv_store.h"
 #include "obd2.h"
+#include "obd2_capability_store.h"
 #include "twai_driver.h"
 #include "ui.h"
 #include "vehicle_params.h"
@@ -12,6 +18,49 @@ static const char* const TAG = "obd_polling";
 // Глобальные переменные для доступа из задачи
 extern VehicleParams vehicle_params;
 
+static const char* const kCapabilityNamespace = "obd_caps";
+
+// Чтение битовых масок поддерживаемых PID и списка ЭБУ, повтор до ответа ЭБУ
+static void DiscoverCapabilities(OBD2& obd2, ObdCapabilities& caps) {
+  ESP_LOGI(TAG, "Querying all supported PIDs...");
+  while (!obd2.refreshSupportedPids()) {
+    ESP_LOGW(TAG, "Failed to read supported PIDs, retrying");
+    vTaskDelay(pdMS_TO_TICKS(5000));
+  }
+  caps.supported_pids = obd2.supportedPidMasks();
+  for (size_t i = 0; i < caps.supported_pids.size(); i++) {
+    ESP_LOGI(TAG,
+             "Supported PIDs %3u-%3u: 0x%08" PRIX32,
+             static_cast<unsigned>(i * 32 + 1),
+             static_cast<unsigned>(i * 32 + 32),
+             caps.supported_pids[i]);
+  }
+
+  static std::array<OBD2::EcuResponse, OBD2::kMaxEcus> ecus;  // Около 650 байт: не на стеке задачи
+  caps.ecu_count = static_cast<uint8_t>(obd2.supportedPidsAllEcus(OBD2::SUPPORTED_PIDS_1_20, ecus));
+  for (size_t i = 0; i < caps.ecu_count; i++) {
+    caps.ecu_ids[i] = ecus[i].rx_id;
+    ESP_LOGI(TAG, "ECU 0x%03X", ecus[i].rx_id);
+  }
+}
+
+// Возможности автомобиля: по VIN из NVS, иначе опросом ЭБУ с сохранением в NVS
+static void LoadCapabilities(OBD2& obd2, Obd2CapabilityStore& store, ObdCapabilities& caps) {
+  const bool has_vin = obd2.getVIN(caps.vin.data(), caps.vin.size());
+  if (has_vin && store.load(caps.vin.data(), caps)) {
+    obd2.restoreSupportedPids(caps.supported_pids);
+    ESP_LOGI(TAG, "Capabilities of %s restored from NVS (%u ECUs)", caps.vin.data(), caps.ecu_count);
+    return;
+  }
+
+  DiscoverCapabilities(obd2, caps);
+  if (!has_vin) {
+    ESP_LOGW(TAG, "VIN is not available, capabilities are not stored");
+  } else if (store.save(caps)) {
+    ESP_LOGI(TAG, "Capabilities of %s stored in NVS", caps.vin.data());
+  }
+}
+
 void obd_polling_task(void* arg) {
   ESP_LOGI(TAG, "Starting OBD data polling loop");
 
@@ -23,32 +72,78 @@ void obd_polling_task(void* arg) {
     return;
   }
 
-  IsoTp iso_tp(*can_driver);  // ISO-TP протокол поверх CAN
-  OBD2 obd2(iso_tp);          // OBD2 поверх ISO-TP
+  // Единственные экземпляры на все время работы: создаются при первом входе, не на стеке задачи
+  static IsoTp iso_tp(*can_driver, xTaskGetCurrentTaskHandle());  // ISO-TP поверх CAN, кадры читает эта задача
+  static OBD2 obd2(iso_tp);                                        // OBD2 поверх ISO-TP
+
+  iso_tp.add_rx_filter(0x7E8, 0x7F8);  // Только ответы ЭБУ 7E8-7EF
+  can_driver->InstallStart();          // Фильтры заданы: узел запускается сразу с ними
 
+  // Маски поддержки PID и список ЭБУ между запусками: при известном VIN опрос начинается сразу
+  static NvsKeyValueStore nvs_store(kCapabilityNamespace);
+  static Obd2CapabilityStore capability_store(nvs_store);
+  static ObdCapabilities capabilities;
+  nvs_store.open();
+  LoadCapabilities(obd2, capability_store, capabilities);
+
+  // Все объекты созданы: дальше опрос работает без кучи
+  heap_monitor_arm();
+
+  // Все параметры панели одним запросом Service 01 вместо шести обменов
+  static const uint8_t kPolledPids[] = {OBD2::ENGINE_RPM,
+                                        OBD2::VEHICLE_SPEED,
+                                        OBD2::ENGINE_COOLANT_TEMP,
+                                        OBD2::THROTTLE_POSITION,
+                                        OBD2::ENGINE_LOAD,
+                                        OBD2::INTAKE_AIR_TEMP};
+  static_assert(sizeof(kPolledPids) <= OBD2::kMaxPidsPerRequest, "One request carries up to 6 PIDs");
+
+  OBD2::PidResults results;
   while (1) {
-    // Запрашиваем обороты двигателя
-    auto rpm = obd2.rpm();
+    if (obd2.readPids(Span<const uint8_t>(kPolledPids, sizeof(kPolledPids)), results) == 0) {
+      ESP_LOGW(TAG, "Failed to read engine parameters");
+    }
+
+    // Обороты двигателя
+    auto rpm = results.rpm();
     if (rpm.has_value()) {
       vehicle_params.setRpm(rpm.value());
-    } else {
-      ESP_LOGW(TAG, "Failed to read engine RPM");
     }
 
-    // Запрашиваем скорость автомобиля
-    auto speed = obd2.kph();
+    // Скорость автомобиля
+    auto speed = results.kph();
     if (speed.has_value()) {
       vehicle_params.setSpeed(speed.value());
-    } else {
-      ESP_LOGW(TAG, "Failed to read vehicle speed");
     }
 
-    // Запрашиваем температуру охлаждающей жидкости
-    auto coolant_temp = obd2.engineCoolantTemp();
+    // Температура охлаждающей жидкости
+    auto coolant_temp = results.engineCoolantTemp();
     if (coolant_temp.has_value()) {
       vehicle_params.setCoolantTemp(coolant_temp.value());
-    } else {
-      ESP_LOGW(TAG, "Failed to read coolant temperature");
+    }
+
+    auto throttle = results.throttle();
+    if (throttle.has_value()) {
+      vehicle_params.setThrottlePosition(static_cast<int>(throttle.value()));
+    }
+
+    auto engine_load = results.engineLoad();
+    if (engine_load.has_value()) {
+      vehicle_params.setEngineLoad(static_cast<int>(engine_load.value()));
+    }
+
+    auto intake_air_temp = results.intakeAirTemp();
+    if (intake_air_temp.has_value()) {
+      vehicle_params.setIntakeAirTemp(intake_air_temp.value());
+    }
+
+    // Шаг фонового обновления масок поддержки PID (раз в минуту); изменения сохраняются для следующего запуска
+    obd2.stepPidDiscovery();
+    if ((capabilities.vin[0] != '\0') && (obd2.supportedPidMasks() != capabilities.supported_pids)) {
+      capabilities.supported_pids = obd2.supportedPidMasks();
+      ESP_LOGI(TAG, "Supported PIDs changed, updating NVS");
+      HeapMonitorExemption nvs_write;  // nvs_set_blob/nvs_commit выделяют память
+      capability_store.save(capabilities);
     }
 
     // Задержка перед следующим опросом
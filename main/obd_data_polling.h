@@ -11,6 +11,9 @@ class UI;
 
 /**
  * @brief Функция задачи FreeRTOS для опроса данных OBD2
- * @param arg Параметр задачи (не используется)
+ *
+ * Подписывает ISO-TP на ответы ЭБУ и запускает драйвер с готовым аппаратным фильтром.
+ *
+ * @param arg Параметр задачи - указатель на TwaiDriver
  */
 void obd_polling_task(void* arg);
\ No newline at end of file
@@ -1,15 +1,11 @@
 #include "can_subscriber.h"
 
 CanSubscriber::CanSubscriber(CanMessageCallback callback) :
-    callback_(callback),
-    message_queue_(nullptr) {
-  // Создаем очередь для сообщений
-  message_queue_ = xQueueCreate(10, sizeof(TwaiFrame));
-}
+    callback_(callback) {}
 
-QueueHandle_t CanSubscriber::onTwaiMessage() {
-  // Возвращаем очередь для помещения сообщения
-  return message_queue_;
+TwaiRxRing* CanSubscriber::onTwaiMessage() {
+  // Возвращаем буфер для помещения сообщения
+  return &rx_ring_;
 }
 
 bool CanSubscriber::isInterested(const TwaiFrame& frame) {
@@ -19,8 +15,8 @@ bool CanSubscriber::isInterested(const TwaiFrame& frame) {
 
 void CanSubscriber::ProcessMessages() {
   TwaiFrame frame;
-  // Обрабатываем все сообщения в очереди
-  while (xQueueReceive(message_queue_, &frame, 0) == pdTRUE) {
+  // Обрабатываем все сообщения в буфере
+  while (rx_ring_.Receive(frame, 0)) {
     if (callback_ != nullptr) {
       callback_(frame);
     }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "phy_interface.h"
+#include "twai_rx_ring.h"
 
 // Определяем тип функции обратного вызова для CAN сообщений
 typedef void (*CanMessageCallback)(const TwaiFrame& frame);
@@ -9,11 +10,11 @@ class CanSubscriber : public ITwaiSubscriber {
  public:
   explicit CanSubscriber(CanMessageCallback callback);
 
-  QueueHandle_t onTwaiMessage() override;
+  TwaiRxRing* onTwaiMessage() override;
   bool isInterested(const TwaiFrame& frame) override;
-  void ProcessMessages();  // Обработка сообщений из очереди
+  void ProcessMessages();  // Обработка сообщений из буфера
 
  private:
   CanMessageCallback callback_;
-  QueueHandle_t message_queue_;
+  TwaiRxRing rx_ring_;
 };
\ No newline at end of file
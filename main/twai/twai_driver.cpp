@@ -1,26 +1,46 @@
 #include "twai_driver.h"
 
+#include <inttypes.h>
 #include <string.h>
 
 #include "esp_log.h"
 #include "esp_rom_sys.h"
 #include "esp_system.h"
+#include "esp_timer.h"
 #include "esp_twai_onchip.h"
 #include "portmacro.h"
 #include "time.h"
 
 static const char* const TAG = "TwaiDriver";
 
-TwaiDriver::TwaiDriver(gpio_num_t tx_pin, gpio_num_t rx_pin, uint32_t speed_kbps) :
+TwaiDriver::TwaiDriver(gpio_num_t tx_pin, gpio_num_t rx_pin, uint32_t speed_kbps, bool listen_only) :
     tx_pin_(tx_pin),
     rx_pin_(rx_pin),
     speed_kbps_(speed_kbps),
+    listen_only_(listen_only),
     init_(false),
     node_handle_(nullptr),
-    tx_queue_(nullptr),
+    subscribers_(),
+    active_dispatch_(0),
+    bus_load_(speed_kbps * 1000),
+    recovery_timer_(nullptr),
     is_transmitting_(false),
+    tx_in_flight_(),
     rx_error_count_(0),
-    tx_error_count_(0) {}
+    tx_error_count_(0) {
+  registration_mutex_.Create();
+}
+
+TwaiDriver::~TwaiDriver() {
+  if (recovery_timer_ != nullptr) {
+    esp_timer_stop(recovery_timer_);
+    esp_timer_delete(recovery_timer_);
+  }
+  if (node_handle_ != nullptr) {
+    twai_node_disable(node_handle_);
+    twai_node_delete(node_handle_);
+  }
+}
 
 void TwaiDriver::InstallStart() {
   twai_onchip_node_config_t node_config = {.io_cfg =
@@ -46,7 +66,7 @@ void TwaiDriver::InstallStart() {
                                            .flags          = {
                                                         .enable_self_test   = false,
                                                         .enable_loopback    = false,
-                                                        .enable_listen_only = false,
+                                                        .enable_listen_only = listen_only_,
                                                         .no_receive_rtr     = false,
                                            }};
 
@@ -72,15 +92,29 @@ void TwaiDriver::InstallStart() {
   }
 
   // Создание очередей FreeRTOS
-  tx_queue_ = xQueueCreate(kTxQueueDepth, sizeof(TwaiFrame));
-  if (tx_queue_ == nullptr) {
+  if (!tx_queue_.Create()) {
     ESP_LOGI(TAG, "Failed to create TX queue. Restarting in 5 seconds...");
     esp_rom_delay_us(5000000);
     esp_restart();
   }
 
+  // Таймер отложенного восстановления после bus-off
+  const esp_timer_create_args_t recovery_timer_args = {.callback              = RecoveryTimerCallback,
+                                                       .arg                   = this,
+                                                       .dispatch_method       = ESP_TIMER_TASK,
+                                                       .name                  = "twai_recovery",
+                                                       .skip_unhandled_events = true};
+  if (esp_timer_create(&recovery_timer_args, &recovery_timer_) != ESP_OK) {
+    ESP_LOGI(TAG, "Failed to create recovery timer. Restarting in 5 seconds...");
+    esp_rom_delay_us(5000000);
+    esp_restart();
+  }
+
   init_ = true;
 
+  // Аппаратный фильтр по подпискам, сделанным до запуска
+  ApplyHardwareFilter();
+
   // Включение узла
   err = twai_node_enable(node_handle_);
   if (err != ESP_OK) {
@@ -89,7 +123,7 @@ void TwaiDriver::InstallStart() {
     esp_restart();
   }
 
-  ESP_LOGI(TAG, "TWAI driver installed and started successfully");
+  ESP_LOGI(TAG, "TWAI driver installed and started successfully%s", listen_only_ ? " (listen-only)" : "");
 }
 
 bool IRAM_ATTR TwaiDriver::TxCallback(twai_node_handle_t handle,
@@ -98,29 +132,28 @@ bool IRAM_ATTR TwaiDriver::TxCallback(twai_node_handle_t handle,
   TwaiDriver* driver = static_cast<TwaiDriver*>(user_ctx);
   if (driver && driver->node_handle_ == handle) {
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    TwaiFrame next_frame;
 
-    if (xQueueReceiveFromISR(driver->tx_queue_, &next_frame, &xHigherPriorityTaskWoken) == pdTRUE) {
-      twai_frame_t frame = {};
-      frame.header.id    = next_frame.id;
-      frame.header.ide   = next_frame.is_extended;
-      frame.header.rtr   = next_frame.is_rtr;
-      frame.header.fdf   = next_frame.is_fd;
-      frame.header.brs   = next_frame.brs;
-      frame.header.dlc   = next_frame.data_length;
-      frame.buffer       = const_cast<uint8_t*>(next_frame.data);
-      frame.buffer_len   = next_frame.data_length;
-
-      // Используем нулевой таймаут, чтобы не блокироваться в прерывании
-      esp_err_t err = twai_node_transmit(handle, &frame, 0);
-      if (err != ESP_OK) {
-        ESP_DRAM_LOGE(TAG, "TxCallback: err %d", err);
-        xQueueSendToFrontFromISR(driver->tx_queue_, &next_frame, &xHigherPriorityTaskWoken);
-        driver->is_transmitting_.store(false, std::memory_order_relaxed);
+    // Уведомляем подписчиков до запуска следующего кадра: отправитель может сразу
+    // поставить в очередь очередной CF
+    if (edata->done_tx_frame != nullptr) {
+      TwaiFrame done_frame   = {};
+      done_frame.id          = edata->done_tx_frame->header.id;
+      done_frame.is_extended = edata->done_tx_frame->header.ide;
+      done_frame.is_rtr      = edata->done_tx_frame->header.rtr;
+      done_frame.is_fd       = edata->done_tx_frame->header.fdf;
+      done_frame.brs         = edata->done_tx_frame->header.brs;
+      done_frame.data_length = twaifd_dlc2len(edata->done_tx_frame->header.dlc);
+      if (edata->is_tx_success) {
+        driver->bus_load_.OnFrame(done_frame, static_cast<uint32_t>(esp_timer_get_time()));
+      }
+      if (driver->DispatchTxDone(done_frame, edata->is_tx_success)) {
+        xHigherPriorityTaskWoken = pdTRUE;
       }
-    } else {
-      driver->is_transmitting_.store(false, std::memory_order_relaxed);
     }
+
+    // Следующий кадр передается только после завершения текущего: в контроллере не больше
+    // одного кадра, в том числе в карантине error-passive
+    driver->TransmitNextFromISR(&xHigherPriorityTaskWoken);
     // Возвращаем true, если нужно переключение контекста
     return xHigherPriorityTaskWoken == pdTRUE;
   }
@@ -130,24 +163,27 @@ bool IRAM_ATTR TwaiDriver::TxCallback(twai_node_handle_t handle,
 bool IRAM_ATTR TwaiDriver::RxCallback(twai_node_handle_t handle,
                                       const twai_rx_done_event_data_t* edata,
                                       void* user_ctx) {
-  TwaiDriver* driver = static_cast<TwaiDriver*>(user_ctx);
+  // Момент приема фиксируется до чтения кадра: у контроллера TWAI ESP32-C3 нет аппаратной метки времени
+  const uint32_t timestamp_us = static_cast<uint32_t>(esp_timer_get_time());
+  TwaiDriver* driver          = static_cast<TwaiDriver*>(user_ctx);
   if (driver && driver->node_handle_ == handle) {
     twai_frame_t frame       = {};
     TwaiFrame received_frame = {};
     frame.buffer             = received_frame.data;
-    frame.buffer_len         = 8;
+    frame.buffer_len         = sizeof(received_frame.data);
 
     esp_err_t err = twai_node_receive_from_isr(handle, &frame);
     if (err == ESP_OK) {
-      received_frame.id          = frame.header.id;
-      received_frame.is_extended = frame.header.ide;
-      received_frame.is_rtr      = frame.header.rtr;
-      received_frame.is_fd       = frame.header.fdf;
-      received_frame.brs         = frame.header.brs;
-      received_frame.data_length = frame.header.dlc;
-
-      driver->DispatchMessage(received_frame);
-      return true;
+      received_frame.id           = frame.header.id;
+      received_frame.is_extended  = frame.header.ide;
+      received_frame.is_rtr       = frame.header.rtr;
+      received_frame.is_fd        = frame.header.fdf;
+      received_frame.brs          = frame.header.brs;
+      received_frame.data_length  = twaifd_dlc2len(frame.header.dlc);
+      received_frame.timestamp_us = timestamp_us;
+
+      driver->bus_load_.OnFrame(received_frame, timestamp_us);
+      return driver->DispatchMessage(received_frame);
     } else {
       ESP_DRAM_LOGE(TAG, "RxCallback: err %d", err);
     }
@@ -170,7 +206,73 @@ bool IRAM_ATTR TwaiDriver::StateChangeCallback(twai_node_handle_t handle,
   } else if (edata->new_sta == TWAI_ERROR_BUS_OFF) {
     ESP_DRAM_LOGE(TAG, "TWAI_ERROR_BUS_OFF");
   }
-  return true;
+
+  TwaiDriver* driver = static_cast<TwaiDriver*>(user_ctx);
+  if (!driver || driver->node_handle_ != handle) {
+    return false;
+  }
+
+  const TwaiBusState state = ToBusState(edata->new_sta);
+  if (!driver->recovery_.OnStateChange(state, static_cast<uint32_t>(esp_timer_get_time()))) {
+    return false;
+  }
+
+  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+  if (state == TwaiBusState::BUS_OFF) {
+    // Кадры, ждавшие в очереди, устареют к концу восстановления: отправители повторят запросы
+    TwaiFrame dropped;
+    while (driver->tx_queue_.ReceiveFromISR(dropped, &xHigherPriorityTaskWoken)) {
+    }
+    driver->is_transmitting_.store(false, std::memory_order_relaxed);
+
+    // esp_timer_stop/esp_timer_start_once можно вызывать из прерывания
+    esp_timer_stop(driver->recovery_timer_);
+    esp_timer_start_once(driver->recovery_timer_, driver->recovery_.BackoffUs());
+  } else {
+    // Цепочка могла остановиться на отказе twai_node_transmit: продолжаем передачу кадров из очереди
+    bool expected = false;
+    if (driver->is_transmitting_.compare_exchange_strong(
+            expected, true, std::memory_order_relaxed, std::memory_order_relaxed)) {
+      driver->TransmitNextFromISR(&xHigherPriorityTaskWoken);
+    }
+  }
+
+  driver->DispatchBusState(state);
+  return xHigherPriorityTaskWoken == pdTRUE;
+}
+
+void TwaiDriver::RecoveryTimerCallback(void* arg) {
+  TwaiDriver* driver = static_cast<TwaiDriver*>(arg);
+  // Узел мог вернуться в error-active раньше, чем истекла задержка
+  if (!driver->recovery_.OnRecoveryStarted()) {
+    return;
+  }
+
+  ESP_LOGW(TAG, "Starting bus-off recovery, bus-off count %" PRIu32, driver->recovery_.BusOffCount());
+  driver->DispatchBusState(TwaiBusState::RECOVERING);
+
+  // Завершение восстановления (128 x 11 рецессивных бит) придет событием смены состояния
+  const esp_err_t err = twai_node_recover(driver->node_handle_);
+  if (err != ESP_OK) {
+    const uint32_t delay_us = driver->recovery_.OnRecoveryFailed();
+    ESP_LOGE(TAG, "Bus-off recovery failed: %s, retry in %" PRIu32 " us", esp_err_to_name(err), delay_us);
+    driver->DispatchBusState(TwaiBusState::BUS_OFF);
+    esp_timer_start_once(driver->recovery_timer_, delay_us);
+  }
+}
+
+TwaiBusState TwaiDriver::ToBusState(twai_error_state_t state) {
+  switch (state) {
+    case TWAI_ERROR_WARNING:
+      return TwaiBusState::ERROR_WARNING;
+    case TWAI_ERROR_PASSIVE:
+      return TwaiBusState::ERROR_PASSIVE;
+    case TWAI_ERROR_BUS_OFF:
+      return TwaiBusState::BUS_OFF;
+    case TWAI_ERROR_ACTIVE:
+    default:
+      return TwaiBusState::ERROR_ACTIVE;
+  }
 }
 
 // Реализация обработчика ошибок TWAI
@@ -238,31 +340,81 @@ bool IRAM_ATTR TwaiDriver::ErrorCallback(twai_node_handle_t handle,
 }
 
 IPhyInterface::TwaiError TwaiDriver::Transmit(const TwaiFrame& message, Time_ms timeout_ms) {
-  if (xQueueSend(tx_queue_, &message, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+  const IPhyInterface::TwaiError state = CheckBusState();
+  if (state != IPhyInterface::TwaiError::OK) {
+    return state;
+  }
+  if (!tx_queue_.Send(message, pdMS_TO_TICKS(timeout_ms))) {
     ESP_LOGW(TAG, "Failed to add frame to TX queue: queue full or timeout");
     return IPhyInterface::TwaiError::TIMEOUT;
   }
+  return StartTransmission(timeout_ms);
+}
+
+IPhyInterface::TwaiError TwaiDriver::TransmitBatch(Span<const TwaiFrame> frames, Time_ms timeout_ms, size_t& queued) {
+  queued                             = 0;
+  const IPhyInterface::TwaiError state = CheckBusState();
+  if (state != IPhyInterface::TwaiError::OK) {
+    return state;
+  }
+  for (const TwaiFrame& message : frames) {
+    if (!tx_queue_.Send(message, pdMS_TO_TICKS(timeout_ms))) {
+      break;
+    }
+    queued++;
+  }
+  if (queued == 0) {
+    ESP_LOGW(TAG, "Failed to add batch to TX queue: queue full or timeout");
+    return IPhyInterface::TwaiError::TIMEOUT;
+  }
+
+  // Передачу запускает один захват is_transmitting_, остальные кадры пачки отправляет TxCallback
+  const IPhyInterface::TwaiError result = StartTransmission(timeout_ms);
+  if (result == IPhyInterface::TwaiError::OK && queued < frames.size()) {
+    ESP_LOGW(TAG,
+             "TX queue full: %u of %u frames queued",
+             static_cast<unsigned>(queued),
+             static_cast<unsigned>(frames.size()));
+    return IPhyInterface::TwaiError::TIMEOUT;
+  }
+  return result;
+}
+
+IPhyInterface::TwaiError TwaiDriver::CheckBusState() const {
+  if (listen_only_) {
+    return IPhyInterface::TwaiError::INVALID_STATE;
+  }
+  // В bus-off очередь сброшена, новые кадры не принимаются до восстановления.
+  // В карантине error-passive кадры ставятся в очередь и уходят по одному из TxCallback
+  if (!recovery_.AcceptsFrames()) {
+    return IPhyInterface::TwaiError::INVALID_STATE;
+  }
+  return IPhyInterface::TwaiError::OK;
+}
 
+IPhyInterface::TwaiError TwaiDriver::StartTransmission(Time_ms timeout_ms) {
   // Атомарно проверяем и устанавливаем флаг передачи
   // Для одноядерной системы достаточно relaxed - защита только от прерываний
   bool expected = false;
   if (is_transmitting_.compare_exchange_strong(expected, true, std::memory_order_relaxed, std::memory_order_relaxed)) {
     // Мы успешно захватили право на запуск передачи
     TwaiFrame next_frame;
-    if (xQueueReceive(tx_queue_, &next_frame, 0) == pdTRUE) {
+    if (tx_queue_.Receive(next_frame)) {
+      // Запоминаем до передачи: TxCallback может запустить следующий кадр раньше возврата
+      tx_in_flight_      = next_frame;
       twai_frame_t frame = {};
       frame.header.id    = next_frame.id;
       frame.header.ide   = next_frame.is_extended;
       frame.header.rtr   = next_frame.is_rtr;
       frame.header.fdf   = next_frame.is_fd;
       frame.header.brs   = next_frame.brs;
-      frame.header.dlc   = next_frame.data_length;
+      frame.header.dlc   = twaifd_len2dlc(next_frame.data_length);
       frame.buffer       = const_cast<uint8_t*>(next_frame.data);
       frame.buffer_len   = next_frame.data_length;
 
       esp_err_t result = twai_node_transmit(node_handle_, &frame, timeout_ms);
       if (result != ESP_OK) {
-        xQueueSendToFront(tx_queue_, &next_frame, 0);
+        tx_queue_.Return(next_frame);
         is_transmitting_.store(false, std::memory_order_relaxed);
         ESP_DRAM_LOGE(TAG, "Failed to transmit frame: %s", esp_err_to_name(result));
         if (result == ESP_ERR_TIMEOUT) {
@@ -278,7 +430,47 @@ IPhyInterface::TwaiError TwaiDriver::Transmit(const TwaiFrame& message, Time_ms
   return IPhyInterface::TwaiError::OK;
 }
 
+bool TwaiDriver::TransmitNextFromISR(BaseType_t* higher_priority_task_woken) {
+  // Следующим уходит кадр старшего класса: FC не ждет очередь CF
+  TwaiFrame next_frame;
+  if (!tx_queue_.ReceiveFromISR(next_frame, higher_priority_task_woken)) {
+    is_transmitting_.store(false, std::memory_order_relaxed);
+    return false;
+  }
+
+  tx_in_flight_      = next_frame;
+  twai_frame_t frame = {};
+  frame.header.id    = next_frame.id;
+  frame.header.ide   = next_frame.is_extended;
+  frame.header.rtr   = next_frame.is_rtr;
+  frame.header.fdf   = next_frame.is_fd;
+  frame.header.brs   = next_frame.brs;
+  frame.header.dlc   = twaifd_len2dlc(next_frame.data_length);
+  frame.buffer       = const_cast<uint8_t*>(next_frame.data);
+  frame.buffer_len   = next_frame.data_length;
+
+  // Используем нулевой таймаут, чтобы не блокироваться в прерывании
+  esp_err_t err = twai_node_transmit(node_handle_, &frame, 0);
+  if (err != ESP_OK) {
+    ESP_DRAM_LOGE(TAG, "TxCallback: err %d", err);
+    tx_queue_.ReturnFromISR(next_frame, higher_priority_task_woken);
+    is_transmitting_.store(false, std::memory_order_relaxed);
+    return false;
+  }
+  return true;
+}
+
 void TwaiDriver::RegisterSubscriber(ITwaiSubscriber& subscriber) {
+  FreeRtosLockGuard lock(registration_mutex_);
+
+  // Повторная регистрация обновляет фильтры
+  for (ITwaiSubscriber* registered : subscribers_) {
+    if (registered == &subscriber) {
+      RebuildDispatch();
+      return;
+    }
+  }
+
   bool has_free_slot = false;
   for (size_t i = 0; i < subscribers_.size(); ++i) {
     if (subscribers_[i] == nullptr) {
@@ -293,9 +485,12 @@ void TwaiDriver::RegisterSubscriber(ITwaiSubscriber& subscriber) {
     esp_rom_delay_us(5000000);
     esp_restart();
   }
+  RebuildDispatch();
 }
 
 void TwaiDriver::UnRegisterSubscriber(ITwaiSubscriber& subscriber) {
+  FreeRtosLockGuard lock(registration_mutex_);
+
   bool found_subscriber = false;
   for (size_t i = 0; i < subscribers_.size(); ++i) {
     if (subscribers_[i] == &subscriber) {
@@ -307,34 +502,142 @@ void TwaiDriver::UnRegisterSubscriber(ITwaiSubscriber& subscriber) {
 
   if (!found_subscriber) {
     ESP_LOGW(TAG, "UnRegisterSubscriber: subscriber not found");
+    return;
   }
+  RebuildDispatch();
 }
 
-void TwaiDriver::DispatchMessage(const TwaiFrame& message) {
-  for (size_t i = 0; i < subscribers_.size() && subscribers_[i] != nullptr; ++i) {
+void TwaiDriver::RebuildDispatch() {
+  const uint8_t next = active_dispatch_.load(std::memory_order_relaxed) ^ 1;
+  Dispatch& dispatch = dispatch_[next];
+
+  dispatch.table.Clear();
+  for (size_t i = 0; i < subscribers_.size(); ++i) {
+    dispatch.routes[i]          = Route();
     ITwaiSubscriber* subscriber = subscribers_[i];
+    if (subscriber == nullptr) {
+      continue;
+    }
+    dispatch.routes[i].subscriber = subscriber;
+    dispatch.routes[i].ring       = subscriber->onTwaiMessage();
+    if (!dispatch.table.AddRoute(i, subscriber->rxFilters())) {
+      ESP_LOGW(TAG, "RebuildDispatch: too many 29-bit filters, subscriber %u", static_cast<unsigned>(i));
+    }
+  }
+
+  active_dispatch_.store(next, std::memory_order_release);
+
+  const CanAcceptanceFilter hw_filter = MergeHardwareFilter();
+  if (hw_filter != hw_filter_) {
+    hw_filter_ = hw_filter;
+    if (init_) {
+      RestartWithHardwareFilter();
+    }
+  }
+}
+
+void TwaiDriver::RestartWithHardwareFilter() {
+  // Фильтр меняется только в выключенном узле: кадры, пришедшие на время перенастройки, теряются
+  ESP_LOGW(TAG, "Hardware filter changed on a running node, restarting");
+  twai_node_disable(node_handle_);
+
+  // Кадр, снятый с передачи выключением, не получит TxCallback: подписчики узнают о нем
+  // как о неудачной передаче и не ждут таймаута. Цепочку передачи запускаем заново
+  // с кадров, оставшихся в очереди
+  if (is_transmitting_.exchange(false, std::memory_order_relaxed)) {
+    DispatchTxDone(tx_in_flight_, false);
+  }
+  ApplyHardwareFilter();
+  twai_node_enable(node_handle_);
+  StartTransmission(0);
+}
+
+CanAcceptanceFilter TwaiDriver::MergeHardwareFilter() const {
+  std::array<CanIdFilter, CanAcceptanceFilter::kMaxInputFilters> filters;
+  size_t count = 0;
+  for (ITwaiSubscriber* subscriber : subscribers_) {
+    if (subscriber == nullptr) {
+      continue;
+    }
+    const Span<const CanIdFilter> subscriber_filters = subscriber->rxFilters();
+    // Подписчику без фильтров нужны все кадры
+    if (subscriber_filters.empty() || count + subscriber_filters.size() > filters.size()) {
+      return CanAcceptanceFilter();
+    }
+    for (const CanIdFilter& filter : subscriber_filters) {
+      filters[count++] = filter;
+    }
+  }
+  return CanAcceptanceFilter::Merge(Span<const CanIdFilter>(filters.data(), count));
+}
+
+void TwaiDriver::ApplyHardwareFilter() {
+  twai_mask_filter_config_t config = {};
+  switch (hw_filter_.mode) {
+    case CanAcceptanceFilter::Mode::SINGLE:
+      config.id     = hw_filter_.filters[0].id;
+      config.mask   = hw_filter_.filters[0].mask;
+      config.is_ext = hw_filter_.is_extended;
+      break;
+    case CanAcceptanceFilter::Mode::DUAL: {
+      // У 29-битных ID в двойном режиме передаются старшие 16 бит
+      const int shift          = hw_filter_.is_extended ? 13 : 0;
+      const CanIdFilter& first = hw_filter_.filters[0];
+      const CanIdFilter& other = hw_filter_.filters[1];
+      config                   = twai_make_dual_filter(
+          first.id >> shift, first.mask >> shift, other.id >> shift, other.mask >> shift, hw_filter_.is_extended);
+      break;
+    }
+    case CanAcceptanceFilter::Mode::ACCEPT_ALL:
+    default:
+      break;  // Нулевая маска пропускает все кадры
+  }
+
+  const esp_err_t err = twai_node_config_mask_filter(node_handle_, 0, &config);
+  if (err != ESP_OK) {
+    ESP_LOGE(TAG, "ApplyHardwareFilter: failed to configure filter: %s", esp_err_to_name(err));
+    return;
+  }
+  ESP_LOGI(TAG,
+           "Hardware filter mode %d, coverage %" PRIu32,
+           static_cast<int>(hw_filter_.mode),
+           hw_filter_.Coverage());
+}
+
+bool TwaiDriver::DispatchMessage(const TwaiFrame& message) {
+  bool need_yield          = false;
+  const Dispatch& dispatch = dispatch_[active_dispatch_.load(std::memory_order_acquire)];
+
+  CanDispatchTable::RouteMask routes = dispatch.table.Lookup(message);
+  while (routes != 0) {
+    const Route& route = dispatch.routes[__builtin_ctz(routes)];
+    routes &= routes - 1;
+
+    // Подписчик может обработать кадр прямо в прерывании, без копирования в буфер
+    if (route.subscriber->onTwaiFrameFromISR(message, need_yield) || route.ring == nullptr) {
+      continue;
+    }
+
+    // При переполнении кадр отбрасывается, счетчик потерь ведет буфер подписчика
+    route.ring->PushFromISR(message, need_yield);
+  }
+  return need_yield;
+}
+
+bool TwaiDriver::DispatchTxDone(const TwaiFrame& message, bool success) {
+  bool need_yield = false;
+  for (ITwaiSubscriber* subscriber : subscribers_) {
+    if (subscriber != nullptr && subscriber->onTwaiTxDone(message, success)) {
+      need_yield = true;
+    }
+  }
+  return need_yield;
+}
+
+void TwaiDriver::DispatchBusState(TwaiBusState state) {
+  for (ITwaiSubscriber* subscriber : subscribers_) {
     if (subscriber != nullptr) {
-      if (subscriber->isInterested(message)) {
-        QueueHandle_t queue = subscriber->onTwaiMessage();
-        if (queue != nullptr) {
-          // Помещаем сообщение в очередь подписчика
-          BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-          if (xQueueSendToBackFromISR(queue, &message, &xHigherPriorityTaskWoken) != pdTRUE) {
-            // Очередь полна, очищаем её вручную и пытаемся снова
-            TwaiFrame temp_frame;
-            while (xQueueReceiveFromISR(queue, &temp_frame, &xHigherPriorityTaskWoken) == pdTRUE) {
-              // Просто извлекаем все элементы из очереди
-            }
-
-            // Теперь пытаемся добавить новое сообщение
-            if (xQueueSendToBackFromISR(queue, &message, &xHigherPriorityTaskWoken) != pdTRUE) {
-              ESP_LOGW(TAG, "Failed to send message to subscriber queue even after clearing");
-            } else {
-              ESP_LOGW(TAG, "Subscriber queue was full, cleared and added new message");
-            }
-          }
-        }
-      }
+      subscriber->onTwaiBusState(state);
     }
   }
 }
@@ -351,3 +654,27 @@ uint32_t TwaiDriver::GetRxErrorCount() const {
 uint32_t TwaiDriver::GetTxErrorCount() const {
   return tx_error_count_.load(std::memory_order_relaxed);
 }
+
+TwaiBusState TwaiDriver::GetBusState() const {
+  return recovery_.State();
+}
+
+uint32_t TwaiDriver::GetBusOffCount() const {
+  return recovery_.BusOffCount();
+}
+
+uint32_t TwaiDriver::GetRecoveryCount() const {
+  return recovery_.RecoveryCount();
+}
+
+BusLoadMeter::Load TwaiDriver::GetBusLoad(BusLoadMeter::Window window) const {
+  return bus_load_.GetLoad(window, static_cast<uint32_t>(esp_timer_get_time()));
+}
+
+uint32_t TwaiDriver::GetFrameRate(uint32_t id, bool is_extended) const {
+  return bus_load_.FrameRate(id, is_extended, static_cast<uint32_t>(esp_timer_get_time()));
+}
+
+bool TwaiDriver::IsBusLoadComplete() const {
+  return hw_filter_.mode == CanAcceptanceFilter::Mode::ACCEPT_ALL;
+}
@@ -3,18 +3,41 @@
 #include <array>
 #include <atomic>
 
+#include "bus_load_meter.h"
+#include "can_acceptance_filter.h"
+#include "can_dispatch_table.h"
 #include "driver/gpio.h"
+#include "esp_timer.h"
 #include "esp_twai.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
+#include "freertos_mutex.h"
 #include "phy_interface.h"
 #include "time.h"
+#include "twai_recovery.h"
+#include "twai_rx_ring.h"
+#include "twai_tx_queue.h"
 
 class TwaiDriver final : public IPhyInterface {
  public:
-  TwaiDriver(gpio_num_t tx_pin, gpio_num_t rx_pin, uint32_t speed_kbps);
+  /**
+   * @param listen_only Пассивный режим: узел не передает кадры и не подтверждает (ACK) чужие,
+   *                    Transmit() возвращает INVALID_STATE
+   */
+  TwaiDriver(gpio_num_t tx_pin, gpio_num_t rx_pin, uint32_t speed_kbps, bool listen_only = false);
+  ~TwaiDriver();
+
+  /**
+   * @brief Установка и запуск узла
+   *
+   * Вызывается после регистрации подписчиков и их фильтров: аппаратный фильтр
+   * программируется до включения узла. Изменение фильтра на работающем узле
+   * требует его перезапуска: принимаемые в это время кадры теряются, а кадр,
+   * снятый с передачи, завершается для подписчиков onTwaiTxDone(frame, false).
+   */
   void InstallStart() override;
   TwaiError Transmit(const TwaiFrame& message, Time_ms timeout_ms) override;
+  TwaiError TransmitBatch(Span<const TwaiFrame> frames, Time_ms timeout_ms, size_t& queued) override;
   void RegisterSubscriber(ITwaiSubscriber& subscriber) override;
   void UnRegisterSubscriber(ITwaiSubscriber& subscriber) override;
 
@@ -22,9 +45,44 @@ class TwaiDriver final : public IPhyInterface {
   uint32_t GetRxErrorCount() const;
   uint32_t GetTxErrorCount() const;
 
+  TwaiBusState GetBusState() const;
+  uint32_t GetBusOffCount() const;
+  uint32_t GetRecoveryCount() const;
+
+  /**
+   * @brief Загрузка шины за окно (кадры, прошедшие аппаратный фильтр, и свои передачи)
+   */
+  BusLoadMeter::Load GetBusLoad(BusLoadMeter::Window window) const;
+
+  /**
+   * @brief Кадров ID за последнюю завершенную секунду
+   */
+  uint32_t GetFrameRate(uint32_t id, bool is_extended) const;
+
+  /**
+   * @brief Аппаратный фильтр пропускает все кадры: загрузка шины измеряется полностью
+   */
+  bool IsBusLoadComplete() const;
+
  private:
   static const int kTxQueueDepth   = 10;
-  static const int kMaxSubscribers = 2;
+  static const int kMaxSubscribers = 4;
+
+  static_assert(kMaxSubscribers <= CanDispatchTable::kMaxRoutes, "Route mask too narrow");
+
+  // Маршрут подписчика, подготовленный при регистрации
+  struct Route {
+    ITwaiSubscriber* subscriber = nullptr;
+    TwaiRxRing* ring            = nullptr;
+  };
+
+  // Прерывание читает активную копию, регистрация строит вторую и переключает индекс.
+  // Регистрации сериализованы registration_mutex_; на одноядерном ESP32-C3 прерывание,
+  // начавшее чтение старой копии, завершается до того, как задача перестроит ее снова
+  struct Dispatch {
+    CanDispatchTable table;
+    std::array<Route, kMaxSubscribers> routes;
+  };
 
   static bool IRAM_ATTR TxCallback(twai_node_handle_t handle, const twai_tx_done_event_data_t* edata, void* user_ctx);
   static bool IRAM_ATTR RxCallback(twai_node_handle_t handle, const twai_rx_done_event_data_t* edata, void* user_ctx);
@@ -32,19 +90,39 @@ class TwaiDriver final : public IPhyInterface {
                                             const twai_state_change_event_data_t* edata,
                                             void* user_ctx);
   static bool IRAM_ATTR ErrorCallback(twai_node_handle_t handle, const twai_error_event_data_t* edata, void* user_ctx);
+  static void RecoveryTimerCallback(void* arg);
+  static TwaiBusState ToBusState(twai_error_state_t state);
 
-  void DispatchMessage(const TwaiFrame& message);
+  TwaiError StartTransmission(Time_ms timeout_ms);
+  TwaiError CheckBusState() const;
+  bool TransmitNextFromISR(BaseType_t* higher_priority_task_woken);
+  void RebuildDispatch();
+  CanAcceptanceFilter MergeHardwareFilter() const;
+  void ApplyHardwareFilter();
+  void RestartWithHardwareFilter();
+  bool DispatchMessage(const TwaiFrame& message);
+  bool DispatchTxDone(const TwaiFrame& message, bool success);
+  void DispatchBusState(TwaiBusState state);
 
   const gpio_num_t tx_pin_;
   const gpio_num_t rx_pin_;
   const uint32_t speed_kbps_;
+  const bool listen_only_;
 
   bool init_;
 
   twai_node_handle_t node_handle_;
-  QueueHandle_t tx_queue_;
+  TwaiTxQueue tx_queue_;
   std::array<ITwaiSubscriber*, kMaxSubscribers> subscribers_;
+  FreeRtosMutex registration_mutex_;  // Регистрация из нескольких задач: одна перестройка dispatch_ за раз
+  std::array<Dispatch, 2> dispatch_;
+  std::atomic_uint8_t active_dispatch_;  // Индекс таблицы в dispatch_, которую читает прерывание
+  CanAcceptanceFilter hw_filter_;        // Фильтр, запрограммированный в контроллер
+  BusLoadMeter bus_load_;                // Загрузка шины, обновляется в прерываниях
+  TwaiRecovery recovery_;                // Состояние шины и задержка восстановления после bus-off
+  esp_timer_handle_t recovery_timer_;    // Отложенный запуск twai_node_recover()
   std::atomic_bool is_transmitting_;  // Флаг, указывающий, идет ли передача в данный момент
+  TwaiFrame tx_in_flight_;            // Кадр, переданный контроллеру последним
   std::atomic_uint32_t rx_error_count_;  // Счетчик ошибок приема CAN шины
   std::atomic_uint32_t tx_error_count_;  // Счетчик ошибок отправки CAN шины
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+// Номера выводов GPIO (только используемые тестами)
+typedef enum {
+  GPIO_NUM_NC = -1,
+  GPIO_NUM_0  = 0,
+  GPIO_NUM_1  = 1,
+  GPIO_NUM_2  = 2,
+  GPIO_NUM_3  = 3,
+} gpio_num_t;
@@ -27,3 +27,7 @@ inline void esp_log_writev(int level, const char* tag, const char* format, va_li
   do {                                                        \
     printf("[%s] WARNING: " format "\n", tag, ##__VA_ARGS__); \
   } while (0)
+
+// Логи из прерываний (строки формата в DRAM) выводятся так же
+#define ESP_DRAM_LOGI(tag, format, ...) ESP_LOGI(tag, format, ##__VA_ARGS__)
+#define ESP_DRAM_LOGE(tag, format, ...) ESP_LOGE(tag, format, ##__VA_ARGS__)
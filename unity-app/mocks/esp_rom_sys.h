@@ -0,0 +1,4 @@
+#pragma once
+
+// esp_rom_delay_us объявлен в моке task.h
+#include "freertos/task.h"
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <cstdlib>
+
+// Перезапуск чипа в тесте - аварийное завершение
+[[noreturn]] inline void esp_restart() {
+  abort();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "esp_err.h"
+
+// Мок высокоточного таймера ESP-IDF: время берется из steady_clock,
+// запуск таймера только запоминается, срабатывание вызывается тестом явно
+
+using esp_timer_cb_t = void (*)(void* arg);
+
+typedef enum { ESP_TIMER_TASK = 0, ESP_TIMER_ISR } esp_timer_dispatch_t;
+
+typedef struct {
+  esp_timer_cb_t callback;
+  void* arg;
+  esp_timer_dispatch_t dispatch_method;
+  const char* name;
+  bool skip_unhandled_events;
+} esp_timer_create_args_t;
+
+struct esp_timer {
+  esp_timer_cb_t callback = nullptr;
+  void* arg               = nullptr;
+  bool armed              = false;
+  uint64_t timeout_us     = 0;
+};
+
+using esp_timer_handle_t = esp_timer*;
+
+inline int64_t esp_timer_get_time() {
+  auto now = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+}
+
+inline esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+  auto timer      = new esp_timer();
+  timer->callback = create_args->callback;
+  timer->arg      = create_args->arg;
+  *out_handle     = timer;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  if (timer->armed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->armed      = true;
+  timer->timeout_us = timeout_us;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer->armed) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  timer->armed = false;
+  return ESP_OK;
+}
+
+inline esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  delete timer;
+  return ESP_OK;
+}
+
+// Срабатывание таймера (только для тестов)
+inline void mock_esp_timer_fire(esp_timer_handle_t timer) {
+  if (timer != nullptr && timer->armed) {
+    timer->armed = false;
+    timer->callback(timer->arg);
+  }
+}
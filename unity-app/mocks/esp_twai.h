@@ -0,0 +1,280 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "esp_err.h"
+
+// Мок API узла TWAI из ESP-IDF 5.5: узел запоминает переданные кадры,
+// события (завершение передачи, прием, смена состояния) вызывает тест явно
+
+typedef enum {
+  TWAI_ERROR_ACTIVE,
+  TWAI_ERROR_WARNING,
+  TWAI_ERROR_PASSIVE,
+  TWAI_ERROR_BUS_OFF,
+} twai_error_state_t;
+
+typedef struct {
+  uint32_t id;
+  uint16_t dlc;
+  uint32_t ide : 1;
+  uint32_t rtr : 1;
+  uint32_t fdf : 1;
+  uint32_t brs : 1;
+  uint32_t esi : 1;
+} twai_frame_header_t;
+
+typedef struct {
+  twai_frame_header_t header;
+  uint8_t* buffer;
+  size_t buffer_len;
+} twai_frame_t;
+
+typedef struct {
+  bool is_tx_success;
+  const twai_frame_t* done_tx_frame;
+} twai_tx_done_event_data_t;
+
+typedef struct {
+} twai_rx_done_event_data_t;
+
+typedef struct {
+  twai_error_state_t old_sta;
+  twai_error_state_t new_sta;
+} twai_state_change_event_data_t;
+
+typedef union {
+  struct {
+    uint32_t arb_lost : 1;
+    uint32_t bit_err : 1;
+    uint32_t form_err : 1;
+    uint32_t stuff_err : 1;
+    uint32_t ack_err : 1;
+    uint32_t reserved : 27;
+  };
+  uint32_t val;
+} twai_error_flags_t;
+
+typedef struct {
+  twai_error_flags_t err_flags;
+} twai_error_event_data_t;
+
+typedef struct {
+  twai_error_state_t state;
+  uint16_t tx_error_count;
+  uint16_t rx_error_count;
+} twai_node_status_t;
+
+typedef struct {
+  uint32_t bus_err_num;
+} twai_node_record_t;
+
+typedef struct {
+  uint32_t id;
+  uint32_t mask;
+  uint32_t is_ext : 1;
+  uint32_t dual_filter : 1;
+} twai_mask_filter_config_t;
+
+typedef struct twai_node* twai_node_handle_t;
+
+typedef bool (*twai_tx_done_cb_t)(twai_node_handle_t handle, const twai_tx_done_event_data_t* edata, void* user_ctx);
+typedef bool (*twai_rx_done_cb_t)(twai_node_handle_t handle, const twai_rx_done_event_data_t* edata, void* user_ctx);
+typedef bool (*twai_state_change_cb_t)(twai_node_handle_t handle,
+                                       const twai_state_change_event_data_t* edata,
+                                       void* user_ctx);
+typedef bool (*twai_error_cb_t)(twai_node_handle_t handle, const twai_error_event_data_t* edata, void* user_ctx);
+
+typedef struct {
+  twai_tx_done_cb_t on_tx_done;
+  twai_rx_done_cb_t on_rx_done;
+  twai_state_change_cb_t on_state_change;
+  twai_error_cb_t on_error;
+} twai_event_callbacks_t;
+
+// Кадр в памяти мока: заголовок и копия данных
+struct MockTwaiFrame {
+  twai_frame_header_t header = {};
+  uint8_t data[64]           = {};
+  size_t len                 = 0;
+
+  twai_frame_t view() {
+    twai_frame_t frame = {};
+    frame.header       = header;
+    frame.buffer       = data;
+    frame.buffer_len   = len;
+    return frame;
+  }
+};
+
+struct twai_node {
+  twai_event_callbacks_t callbacks = {};
+  void* user_ctx                   = nullptr;
+  bool enabled                     = false;
+  twai_error_state_t state         = TWAI_ERROR_ACTIVE;
+  twai_mask_filter_config_t filter = {};
+  int filter_writes                = 0;       // Программирований фильтра
+  esp_err_t transmit_result        = ESP_OK;  // Ответ twai_node_transmit
+  std::deque<MockTwaiFrame> in_flight;        // Переданы контроллеру, завершения еще не было
+  std::vector<MockTwaiFrame> transmitted;     // Все кадры, принятые twai_node_transmit
+  std::deque<MockTwaiFrame> rx_pending;       // Кадры для twai_node_receive_from_isr
+};
+
+// Последний созданный узел: драйвер хранит дескриптор в закрытом поле
+inline twai_node_handle_t& mock_twai_last_node() {
+  static twai_node_handle_t node = nullptr;
+  return node;
+}
+
+inline uint16_t twaifd_dlc2len(uint16_t dlc) {
+  static const uint16_t kLengths[16] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 12, 16, 20, 24, 32, 48, 64};
+  return (dlc < 16) ? kLengths[dlc] : 64;
+}
+
+inline uint16_t twaifd_len2dlc(uint16_t len) {
+  for (uint16_t dlc = 0; dlc < 16; dlc++) {
+    if (twaifd_dlc2len(dlc) >= len) {
+      return dlc;
+    }
+  }
+  return 15;
+}
+
+inline twai_mask_filter_config_t twai_make_dual_filter(
+    uint16_t id1, uint16_t mask1, uint16_t id2, uint16_t mask2, bool is_ext) {
+  twai_mask_filter_config_t config = {};
+  config.id                        = (static_cast<uint32_t>(id1) << 16) | id2;
+  config.mask                      = (static_cast<uint32_t>(mask1) << 16) | mask2;
+  config.is_ext                    = is_ext;
+  config.dual_filter               = true;
+  return config;
+}
+
+inline esp_err_t twai_node_register_event_callbacks(twai_node_handle_t node,
+                                                    const twai_event_callbacks_t* cbs,
+                                                    void* user_data) {
+  node->callbacks = *cbs;
+  node->user_ctx  = user_data;
+  return ESP_OK;
+}
+
+inline esp_err_t twai_node_enable(twai_node_handle_t node) {
+  node->enabled = true;
+  return ESP_OK;
+}
+
+// Выключение снимает кадр с передачи без события завершения, как контроллер
+inline esp_err_t twai_node_disable(twai_node_handle_t node) {
+  node->enabled = false;
+  node->in_flight.clear();
+  return ESP_OK;
+}
+
+inline esp_err_t twai_node_delete(twai_node_handle_t node) {
+  if (mock_twai_last_node() == node) {
+    mock_twai_last_node() = nullptr;
+  }
+  delete node;
+  return ESP_OK;
+}
+
+inline esp_err_t twai_node_recover(twai_node_handle_t node) {
+  return (node->state == TWAI_ERROR_BUS_OFF) ? ESP_OK : ESP_ERR_INVALID_STATE;
+}
+
+inline esp_err_t twai_node_config_mask_filter(twai_node_handle_t node,
+                                              uint8_t /*filter_id*/,
+                                              const twai_mask_filter_config_t* mask_cfg) {
+  if (node->enabled) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  node->filter = *mask_cfg;
+  node->filter_writes++;
+  return ESP_OK;
+}
+
+inline esp_err_t twai_node_transmit(twai_node_handle_t node, const twai_frame_t* frame, int /*timeout_ms*/) {
+  if (!node->enabled) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (node->transmit_result != ESP_OK) {
+    return node->transmit_result;
+  }
+  MockTwaiFrame copy;
+  copy.header = frame->header;
+  copy.len    = (frame->buffer_len < sizeof(copy.data)) ? frame->buffer_len : sizeof(copy.data);
+  memcpy(copy.data, frame->buffer, copy.len);
+  node->in_flight.push_back(copy);
+  node->transmitted.push_back(copy);
+  return ESP_OK;
+}
+
+inline esp_err_t twai_node_receive_from_isr(twai_node_handle_t node, twai_frame_t* rx_frame) {
+  if (node->rx_pending.empty()) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  MockTwaiFrame& pending = node->rx_pending.front();
+  rx_frame->header       = pending.header;
+  memcpy(rx_frame->buffer, pending.data, (pending.len < rx_frame->buffer_len) ? pending.len : rx_frame->buffer_len);
+  node->rx_pending.pop_front();
+  return ESP_OK;
+}
+
+inline esp_err_t twai_node_get_info(twai_node_handle_t node,
+                                    twai_node_status_t* status_ret,
+                                    twai_node_record_t* record_ret) {
+  if (status_ret != nullptr) {
+    *status_ret       = {};
+    status_ret->state = node->state;
+  }
+  if (record_ret != nullptr) {
+    *record_ret = {};
+  }
+  return ESP_OK;
+}
+
+// Завершение передачи старшего кадра в контроллере (только для тестов)
+// @return false если в контроллере нет кадров
+inline bool mock_twai_tx_done(twai_node_handle_t node, bool success = true) {
+  if (node->in_flight.empty()) {
+    return false;
+  }
+  MockTwaiFrame done = node->in_flight.front();
+  node->in_flight.pop_front();
+
+  const twai_frame_t frame              = done.view();
+  const twai_tx_done_event_data_t edata = {success, &frame};
+  if (node->callbacks.on_tx_done != nullptr) {
+    node->callbacks.on_tx_done(node, &edata, node->user_ctx);
+  }
+  return true;
+}
+
+// Прием кадра контроллером (только для тестов)
+inline void mock_twai_rx(twai_node_handle_t node, uint32_t id, const uint8_t* data, size_t len) {
+  MockTwaiFrame frame;
+  frame.header.id  = id;
+  frame.header.dlc = twaifd_len2dlc(len);
+  frame.len        = len;
+  memcpy(frame.data, data, len);
+  node->rx_pending.push_back(frame);
+
+  const twai_rx_done_event_data_t edata = {};
+  if (node->enabled && node->callbacks.on_rx_done != nullptr) {
+    node->callbacks.on_rx_done(node, &edata, node->user_ctx);
+  }
+  node->rx_pending.clear();
+}
+
+// Переход контроллера в новое состояние (только для тестов)
+inline void mock_twai_state_change(twai_node_handle_t node, twai_error_state_t state) {
+  const twai_state_change_event_data_t edata = {node->state, state};
+  node->state                                = state;
+  if (node->callbacks.on_state_change != nullptr) {
+    node->callbacks.on_state_change(node, &edata, node->user_ctx);
+  }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "driver/gpio.h"
+#include "esp_twai.h"
+
+// Мок создания встроенного узла TWAI (ESP-IDF 5.5)
+
+typedef enum {
+  TWAI_CLK_SRC_DEFAULT = 0,
+} twai_clock_source_t;
+
+typedef struct {
+  uint32_t bitrate;
+  uint16_t sp_permill;
+  uint16_t ssp_permill;
+} twai_timing_basic_config_t;
+
+typedef struct {
+  struct {
+    gpio_num_t tx;
+    gpio_num_t rx;
+    gpio_num_t quanta_clk_out;
+    gpio_num_t bus_off_indicator;
+  } io_cfg;
+  twai_clock_source_t clk_src;
+  twai_timing_basic_config_t bit_timing;
+  twai_timing_basic_config_t data_timing;
+  int8_t fail_retry_cnt;
+  uint32_t tx_queue_depth;
+  int intr_priority;
+  struct {
+    uint32_t enable_self_test : 1;
+    uint32_t enable_loopback : 1;
+    uint32_t enable_listen_only : 1;
+    uint32_t no_receive_rtr : 1;
+  } flags;
+} twai_onchip_node_config_t;
+
+inline esp_err_t twai_new_node_onchip(const twai_onchip_node_config_t* /*node_config*/,
+                                      twai_node_handle_t* node_ret) {
+  *node_ret             = new twai_node();
+  mock_twai_last_node() = *node_ret;
+  return ESP_OK;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+// Размер массива уведомлений задачи (CONFIG_FREERTOS_TASK_NOTIFICATION_ARRAY_ENTRIES)
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES 2
+
+// Размещение обработчиков прерываний в IRAM (esp_attr.h) на хосте не нужно
+#define IRAM_ATTR
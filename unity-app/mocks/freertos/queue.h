@@ -3,36 +3,46 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
-#include <queue>
+#include <new>
 
-#include "phy_interface.h"
 #include "task.h"
 
-// Структура для хранения элемента очереди
-struct QueueItem {
-  uint8_t data[64];  // Буфер для данных
-  size_t size;       // Размер данных
-};
-
-// Структура для хранения очереди с информацией о размере
+// Очередь - кольцевой буфер поверх хранилища элементов, как в FreeRTOS:
+// xQueueCreate выделяет хранилище в куче, xQueueCreateStatic использует переданное
 struct Queue {
-  std::queue<QueueItem> items;
+  uint8_t* storage;
+  UBaseType_t item_size;
   UBaseType_t max_size;
+  UBaseType_t head;
+  UBaseType_t count;
+  bool is_static;
 };
 
-// Глобальная переменная для хранения очередей
-inline std::queue<Queue*> g_queues;
+// Память под управляющую структуру статической очереди
+struct StaticQueue_t {
+  alignas(Queue) uint8_t data[sizeof(Queue)];
+};
 
 // Создание очереди
 inline QueueHandle_t xQueueCreate(UBaseType_t uxQueueLength, UBaseType_t uxItemSize) {
-  auto queue      = new Queue();
-  queue->max_size = uxQueueLength;
-  g_queues.push(queue);
+  auto queue = new Queue{new uint8_t[uxQueueLength * uxItemSize], uxItemSize, uxQueueLength, 0, 0, false};
   return static_cast<QueueHandle_t>(queue);
 }
 
-// Отправка элемента в очередь
-inline BaseType_t xQueueSend(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait) {
+// Создание очереди без обращения к куче
+inline QueueHandle_t xQueueCreateStatic(UBaseType_t uxQueueLength,
+                                        UBaseType_t uxItemSize,
+                                        uint8_t* pucQueueStorage,
+                                        StaticQueue_t* pxStaticQueue) {
+  if (pucQueueStorage == nullptr || pxStaticQueue == nullptr) {
+    return nullptr;
+  }
+  auto queue = new (pxStaticQueue->data) Queue{pucQueueStorage, uxItemSize, uxQueueLength, 0, 0, true};
+  return static_cast<QueueHandle_t>(queue);
+}
+
+// Отправка элемента в начало или конец очереди
+inline BaseType_t mock_queue_send(QueueHandle_t xQueue, const void* pvItemToQueue, bool to_front) {
   if (xQueue == nullptr) {
     return pdFALSE;
   }
@@ -40,23 +50,31 @@ inline BaseType_t xQueueSend(QueueHandle_t xQueue, const void* pvItemToQueue, Ti
   auto queue = static_cast<Queue*>(xQueue);
 
   // Проверка на переполнение
-  if (queue->items.size() >= queue->max_size) {
+  if (queue->count >= queue->max_size) {
     return pdFALSE;
   }
 
-  // Создаем новый элемент очереди
-  QueueItem item;
-  memset(item.data, 0, sizeof(item.data));
+  UBaseType_t index = 0;
+  if (to_front) {
+    queue->head = (queue->head + queue->max_size - 1) % queue->max_size;
+    index       = queue->head;
+  } else {
+    index = (queue->head + queue->count) % queue->max_size;
+  }
+  memcpy(queue->storage + index * queue->item_size, pvItemToQueue, queue->item_size);
+  queue->count++;
 
-  // Копируем данные в элемент очереди
-  const TwaiFrame* frame = static_cast<const TwaiFrame*>(pvItemToQueue);
-  memcpy(item.data, frame, sizeof(TwaiFrame));
-  item.size = sizeof(TwaiFrame);
+  return pdTRUE;
+}
 
-  // Добавляем элемент в очередь
-  queue->items.push(item);
+// Отправка элемента в очередь
+inline BaseType_t xQueueSend(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait) {
+  return mock_queue_send(xQueue, pvItemToQueue, false);
+}
 
-  return pdTRUE;
+// Отправка элемента в начало очереди
+inline BaseType_t xQueueSendToFront(QueueHandle_t xQueue, const void* pvItemToQueue, TickType_t xTicksToWait) {
+  return mock_queue_send(xQueue, pvItemToQueue, true);
 }
 
 // Получение элемента из очереди
@@ -68,17 +86,14 @@ inline BaseType_t xQueueReceive(QueueHandle_t xQueue, void* pvBuffer, TickType_t
   auto queue = static_cast<Queue*>(xQueue);
 
   // Проверка на пустую очередь
-  if (queue->items.empty()) {
+  if (queue->count == 0) {
     return pdFALSE;
   }
 
-  // Получаем первый элемент из очереди
-  QueueItem item = queue->items.front();
-  queue->items.pop();
-
-  // Копируем данные в буфер
-  TwaiFrame* frame = static_cast<TwaiFrame*>(pvBuffer);
-  memcpy(frame, item.data, sizeof(TwaiFrame));
+  // Копируем первый элемент в буфер
+  memcpy(pvBuffer, queue->storage + queue->head * queue->item_size, queue->item_size);
+  queue->head = (queue->head + 1) % queue->max_size;
+  queue->count--;
 
   return pdTRUE;
 }
@@ -87,7 +102,12 @@ inline BaseType_t xQueueReceive(QueueHandle_t xQueue, void* pvBuffer, TickType_t
 inline void vQueueDelete(QueueHandle_t xQueue) {
   if (xQueue != nullptr) {
     auto queue = static_cast<Queue*>(xQueue);
-    delete queue;
+    if (queue->is_static) {
+      queue->~Queue();
+    } else {
+      delete[] queue->storage;
+      delete queue;
+    }
   }
 }
 
@@ -108,10 +128,28 @@ inline BaseType_t xQueueSendToBackFromISR(QueueHandle_t xQueue,
   return xQueueSendFromISR(xQueue, pvItemToQueue, pxHigherPriorityTaskWoken);
 }
 
+// Отправка элемента в начало очереди из ISR
+inline BaseType_t xQueueSendToFrontFromISR(QueueHandle_t xQueue,
+                                           const void* pvItemToQueue,
+                                           BaseType_t* pxHigherPriorityTaskWoken) {
+  if (pxHigherPriorityTaskWoken != nullptr) {
+    *pxHigherPriorityTaskWoken = pdFALSE;
+  }
+  return xQueueSendToFront(xQueue, pvItemToQueue, 0);
+}
+
 // Получение элемента из очереди из ISR
 inline BaseType_t xQueueReceiveFromISR(QueueHandle_t xQueue, void* pvBuffer, BaseType_t* pxHigherPriorityTaskWoken) {
   if (pxHigherPriorityTaskWoken != nullptr) {
     *pxHigherPriorityTaskWoken = pdFALSE;
   }
   return xQueueReceive(xQueue, pvBuffer, 0);
+}
+
+// Количество элементов в очереди из ISR
+inline UBaseType_t uxQueueMessagesWaitingFromISR(QueueHandle_t xQueue) {
+  if (xQueue == nullptr) {
+    return 0;
+  }
+  return static_cast<Queue*>(xQueue)->count;
 }
\ No newline at end of file
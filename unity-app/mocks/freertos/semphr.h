@@ -0,0 +1,30 @@
+#pragma once
+
+#include "task.h"
+
+// Мьютекс без ожидания: тесты вызывают драйвер из одного потока
+struct StaticSemaphore_t {
+  bool taken;
+};
+using SemaphoreHandle_t = StaticSemaphore_t*;
+
+inline SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t* pxMutexBuffer) {
+  pxMutexBuffer->taken = false;
+  return pxMutexBuffer;
+}
+
+inline BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t /*xTicksToWait*/) {
+  if (xSemaphore->taken) {
+    return pdFALSE;
+  }
+  xSemaphore->taken = true;
+  return pdTRUE;
+}
+
+inline BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore) {
+  if (!xSemaphore->taken) {
+    return pdFALSE;
+  }
+  xSemaphore->taken = false;
+  return pdTRUE;
+}
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <thread>
 
+#include "FreeRTOS.h"
+
 // Типы данных FreeRTOS
 using TickType_t    = uint32_t;
 using BaseType_t    = int32_t;
@@ -38,4 +41,63 @@ inline void vTaskDelay(uint32_t ms) {
 // Заменяем esp_rom_delay_us на std::this_thread::sleep_for
 inline void esp_rom_delay_us(uint32_t us) {
   std::this_thread::sleep_for(std::chrono::microseconds(us));
-}
\ No newline at end of file
+}
+
+// Уведомления задач: счетчики на поток, ожидание не блокирует (как очереди мока)
+struct MockTask {
+  std::atomic<uint32_t> notify_value[configTASK_NOTIFICATION_ARRAY_ENTRIES] = {};
+};
+using TaskHandle_t = MockTask*;
+
+inline TaskHandle_t xTaskGetCurrentTaskHandle() {
+  static thread_local MockTask task;
+  return &task;
+}
+
+inline BaseType_t xTaskNotifyGiveIndexed(TaskHandle_t task, UBaseType_t uxIndexToNotify) {
+  task->notify_value[uxIndexToNotify].fetch_add(1);
+  return pdTRUE;
+}
+
+inline BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  return xTaskNotifyGiveIndexed(task, 0);
+}
+
+inline void vTaskNotifyGiveIndexedFromISR(TaskHandle_t task,
+                                          UBaseType_t uxIndexToNotify,
+                                          BaseType_t* pxHigherPriorityTaskWoken) {
+  task->notify_value[uxIndexToNotify].fetch_add(1);
+  if (pxHigherPriorityTaskWoken != nullptr) {
+    *pxHigherPriorityTaskWoken = pdTRUE;
+  }
+}
+
+inline void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* pxHigherPriorityTaskWoken) {
+  vTaskNotifyGiveIndexedFromISR(task, 0, pxHigherPriorityTaskWoken);
+}
+
+inline uint32_t ulTaskNotifyTakeIndexed(UBaseType_t uxIndexToWaitOn,
+                                        BaseType_t xClearCountOnExit,
+                                        TickType_t xTicksToWait) {
+  std::atomic<uint32_t>& notify_value = xTaskGetCurrentTaskHandle()->notify_value[uxIndexToWaitOn];
+  if (xClearCountOnExit == pdTRUE) {
+    return notify_value.exchange(0);
+  }
+  uint32_t value = notify_value.load();
+  while (value > 0 && !notify_value.compare_exchange_weak(value, value - 1)) {
+  }
+  return value;
+}
+
+inline uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait) {
+  return ulTaskNotifyTakeIndexed(0, xClearCountOnExit, xTicksToWait);
+}
+
+// Значение уведомления; сбрасываются только биты ulBitsToClear
+inline uint32_t ulTaskNotifyValueClearIndexed(TaskHandle_t task, UBaseType_t uxIndexToClear, uint32_t ulBitsToClear) {
+  return task->notify_value[uxIndexToClear].fetch_and(~ulBitsToClear);
+}
+
+inline uint32_t ulTaskNotifyValueClear(TaskHandle_t task, uint32_t ulBitsToClear) {
+  return ulTaskNotifyValueClearIndexed(task, 0, ulBitsToClear);
+}
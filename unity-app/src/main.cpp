@@ -7,6 +7,25 @@ extern "C" void run_iso_tp_tests();
 extern "C" void run_iso_tp_extended_tests();
 extern "C" void run_iso_tp_edge_case_tests();
 extern "C" void run_twai_subscriber_iso_tp_tests();
+extern "C" void run_iso_tp_reactor_tests();
+extern "C" void run_flow_control_tuner_tests();
+extern "C" void run_tx_pacing_tests();
+extern "C" void run_link_config_tests();
+extern "C" void run_addressing_tests();
+extern "C" void run_functional_tests();
+extern "C" void run_transfer_stats_tests();
+extern "C" void run_rx_assembly_tests();
+extern "C" void run_can_dispatch_table_tests();
+extern "C" void run_can_acceptance_filter_tests();
+extern "C" void run_spsc_ring_tests();
+extern "C" void run_rx_timestamp_tests();
+extern "C" void run_tx_batch_tests();
+extern "C" void run_twai_tx_queue_tests();
+extern "C" void run_twai_recovery_tests();
+extern "C" void run_bus_load_meter_tests();
+extern "C" void run_can_sniffer_tests();
+extern "C" void run_heap_watermark_tests();
+extern "C" void run_twai_driver_tests();
 
 extern "C" void run_obd_pid_group_1_20_tests();
 extern "C" void run_obd_pid_group_21_40_tests();
@@ -14,6 +33,12 @@ extern "C" void run_obd_pid_group_41_60_tests();
 extern "C" void run_obd_pid_group_61_80_tests();
 extern "C" void run_obd_pid_group_81_xx_tests();
 extern "C" void run_obd2_cache_big_endian_tests();
+extern "C" void run_obd2_service_09_tests();
+extern "C" void run_obd2_multi_pid_tests();
+extern "C" void run_obd2_pid_table_tests();
+extern "C" void run_obd2_nrc_tests();
+extern "C" void run_obd2_capability_store_tests();
+extern "C" void run_obd2_pid_discovery_tests();
 
 // Функции, необходимые для работы Unity
 extern "C" void setUp() {
@@ -37,6 +62,25 @@ int main() {
   run_iso_tp_extended_tests();
   run_iso_tp_edge_case_tests();
   run_twai_subscriber_iso_tp_tests();
+  run_iso_tp_reactor_tests();
+  run_flow_control_tuner_tests();
+  run_tx_pacing_tests();
+  run_link_config_tests();
+  run_addressing_tests();
+  run_functional_tests();
+  run_transfer_stats_tests();
+  run_rx_assembly_tests();
+  run_can_dispatch_table_tests();
+  run_can_acceptance_filter_tests();
+  run_spsc_ring_tests();
+  run_rx_timestamp_tests();
+  run_tx_batch_tests();
+  run_twai_tx_queue_tests();
+  run_twai_recovery_tests();
+  run_bus_load_meter_tests();
+  run_can_sniffer_tests();
+  run_heap_watermark_tests();
+  run_twai_driver_tests();
 
   // Отключаем тесты OBD2, так как они не работают с текущей версией кода
   // printf("\n=== Запуск тестов OBD2 ===\n");
@@ -49,6 +93,24 @@ int main() {
   printf("\n=== Запуск тестов OBD2 Cache Big Endian ===\n");
   run_obd2_cache_big_endian_tests();
 
+  printf("\n=== Запуск тестов OBD2 Service 09 ===\n");
+  run_obd2_service_09_tests();
+
+  printf("\n=== Запуск тестов группового запроса PID ===\n");
+  run_obd2_multi_pid_tests();
+
+  printf("\n=== Запуск тестов таблицы PID ===\n");
+  run_obd2_pid_table_tests();
+
+  printf("\n=== Запуск тестов отрицательных ответов OBD2 ===\n");
+  run_obd2_nrc_tests();
+
+  printf("\n=== Запуск тестов хранения возможностей автомобиля ===\n");
+  run_obd2_capability_store_tests();
+
+  printf("\n=== Запуск тестов фонового обновления масок PID ===\n");
+  run_obd2_pid_discovery_tests();
+
   // Завершение Unity и получение результата
   int failures = UNITY_END();
 
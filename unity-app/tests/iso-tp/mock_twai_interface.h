@@ -1,11 +1,16 @@
 #pragma once
 
+#include <cstdint>
+#include <initializer_list>
 #include <queue>
 #include <vector>
 
-#include "freertos/queue.h"
+#include "esp_timer.h"
+#include "iso_tp.h"
+#include "iso_tp_interface.h"
 #include "phy_interface.h"
 #include "time_utils.h"
+#include "twai_rx_ring.h"
 
 // Мок-класс для IPhyInterface для тестирования ISO-TP протокола
 class MockTwaiInterface : public IPhyInterface {
@@ -15,10 +20,35 @@ class MockTwaiInterface : public IPhyInterface {
   TwaiError Transmit(const TwaiFrame& message, Time_ms timeout_ms) override {
     transmitted_frames.push_back(message);
     transmit_called = true;
+    if (transmit_result == TwaiError::OK) {
+      pending_tx_done.push(message);
+      if (auto_tx_done) {
+        complete_tx();
+      }
+    }
     return transmit_result;
   }
 
+  TwaiError TransmitBatch(Span<const TwaiFrame> frames, Time_ms timeout_ms, size_t& queued) override {
+    transmitted_batches.push_back(frames.size());
+    queued = 0;
+    for (const TwaiFrame& frame : frames) {
+      const TwaiError result = Transmit(frame, timeout_ms);
+      if (result != TwaiError::OK) {
+        return result;
+      }
+      queued++;
+    }
+    return TwaiError::OK;
+  }
+
   void RegisterSubscriber(ITwaiSubscriber& subscriber) override {
+    // Повторная регистрация только обновляет фильтры
+    for (auto registered : subscribers) {
+      if (registered == &subscriber) {
+        return;
+      }
+    }
     subscribers.push_back(&subscriber);
   }
 
@@ -34,19 +64,52 @@ class MockTwaiInterface : public IPhyInterface {
   // Методы для управления состоянием мока
   void reset() {
     transmitted_frames.clear();
+    transmitted_batches.clear();
     subscribers.clear();
     transmit_called = false;
     receive_called  = false;
     transmit_result = TwaiError::OK;
+    auto_tx_done    = true;
+    pending_tx_done = {};
+  }
+
+  // Завершение передачи кадров, ожидающих подтверждения (как TxCallback драйвера)
+  void complete_tx(size_t count = SIZE_MAX) {
+    while (count-- > 0 && !pending_tx_done.empty()) {
+      const TwaiFrame frame = pending_tx_done.front();
+      pending_tx_done.pop();
+      for (auto subscriber : subscribers) {
+        subscriber->onTwaiTxDone(frame, true);
+      }
+    }
+  }
+
+  // Переход в bus-off (как StateChangeCallback драйвера): очередь передачи сброшена
+  void bus_off() {
+    pending_tx_done = {};
+    for (auto subscriber : subscribers) {
+      subscriber->onTwaiBusState(TwaiBusState::BUS_OFF);
+    }
   }
 
-  void add_receive_frame(const TwaiFrame& frame) {
+  void add_receive_frame(const TwaiFrame& received) {
+    // Как RxCallback драйвера: кадр без метки времени получает время приема
+    TwaiFrame frame = received;
+    if (frame.timestamp_us == 0) {
+      frame.timestamp_us = static_cast<uint32_t>(esp_timer_get_time());
+    }
+
     // Передаем фрейм всем подписчикам
     for (auto subscriber : subscribers) {
       if (subscriber->isInterested(frame)) {
-        QueueHandle_t queue = subscriber->onTwaiMessage();
-        if (queue != nullptr) {
-          xQueueSend(queue, &frame, 0);
+        // Как DispatchMessage драйвера: подписчик может поглотить кадр в прерывании
+        bool need_yield = false;
+        if (subscriber->onTwaiFrameFromISR(frame, need_yield)) {
+          continue;
+        }
+        TwaiRxRing* ring = subscriber->onTwaiMessage();
+        if (ring != nullptr) {
+          ring->PushFromISR(frame, need_yield);
         }
       }
     }
@@ -54,14 +117,57 @@ class MockTwaiInterface : public IPhyInterface {
 
   // Публичные поля для проверки в тестах
   std::vector<TwaiFrame> transmitted_frames;
+  std::vector<size_t> transmitted_batches;  // Размеры пачек TransmitBatch() по порядку
   std::vector<ITwaiSubscriber*> subscribers;
   bool transmit_called      = false;
   bool receive_called       = false;
   TwaiError transmit_result = TwaiError::OK;
+  bool auto_tx_done         = true;  // Подтверждать передачу сразу в Transmit()
+  std::queue<TwaiFrame> pending_tx_done;
 };
 
 // Вспомогательные функции для создания различных типов кадров
 
+// Создание сообщения ISO-TP (по умолчанию запрос к ЭБУ двигателя 0x7E0 -> 0x7E8)
+inline IIsoTp::Message make_message(uint8_t* data,
+                                    size_t len,
+                                    uint32_t tx_id               = 0x7E0,
+                                    uint32_t rx_id               = 0x7E8,
+                                    IIsoTp::Addressing addressing = IIsoTp::Addressing::NORMAL) {
+  IIsoTp::Message msg;
+  msg.tx_id      = tx_id;
+  msg.rx_id      = rx_id;
+  msg.len        = len;
+  msg.data       = data;
+  msg.addressing = addressing;
+  return msg;
+}
+
+// Журнал завершений транзакций IsoTp: ctx обратного вызова on_complete
+struct CompletionLog {
+  int calls = 0;
+  IsoTp::Completion last;
+};
+
+inline void on_complete(const IsoTp::Completion& completion, void* ctx) {
+  auto* log = static_cast<CompletionLog*>(ctx);
+  log->calls++;
+  log->last = completion;
+}
+
+// Создание кадра с произвольным содержимым, DLC равен числу байт
+inline TwaiFrame make_frame(uint32_t id, std::initializer_list<uint8_t> bytes, bool is_extended = false) {
+  TwaiFrame frame   = {};
+  frame.id          = id;
+  frame.is_extended = is_extended;
+  frame.data_length = static_cast<uint8_t>(bytes.size());
+  size_t i          = 0;
+  for (uint8_t byte : bytes) {
+    frame.data[i++] = byte;
+  }
+  return frame;
+}
+
 // Создание одиночного кадра (Single Frame)
 inline TwaiFrame create_single_frame(uint32_t id, uint8_t length, const uint8_t* data) {
   TwaiFrame frame   = {};
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <initializer_list>
+
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ РЕЖИМОВ АДРЕСАЦИИ (normal, normal fixed, extended, mixed)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ NORMAL FIXED:
+ * - CAN ID 18DA/18DB из N_TA/N_SA, 29-битные кадры
+ * - Прием ответа ECU по 29-битному ID
+ *
+ * ✅ EXTENDED:
+ * - Байт адреса в каждом кадре (SF, FF, CF, FC), полезная нагрузка SF/CF 6, FF 5
+ *
+ * ✅ MIXED:
+ * - Кадры с чужим N_AE игнорируются
+ * - Две сессии на одном CAN ID различаются по N_AE
+ */
+
+// Тест 1: Нормальная фиксированная адресация - 29-битные 18DA/18DB
+void test_iso_tp_addressing_normal_fixed() {
+  TEST_ASSERT_EQUAL_HEX32(0x18DA10F1, IsoTp::normal_fixed_id(0x10, 0xF1));
+  TEST_ASSERT_EQUAL_HEX32(0x18DB33F1, IsoTp::normal_fixed_id(0x33, 0xF1, true));
+
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  const uint32_t tx_id = IsoTp::normal_fixed_id(0x10, 0xF1);
+  const uint32_t rx_id = IsoTp::normal_fixed_id(0xF1, 0x10);
+
+  uint8_t request[2] = {0x01, 0x0D};
+  IsoTp::Message msg = make_message(request, sizeof(request), tx_id, rx_id, IsoTp::Addressing::NORMAL_FIXED);
+  TEST_ASSERT_TRUE(iso_tp.send(msg));
+
+  const TwaiFrame& sf = mock_can.transmitted_frames[0];
+  TEST_ASSERT_EQUAL_HEX32(tx_id, sf.id);
+  TEST_ASSERT_TRUE(sf.is_extended);
+  TEST_ASSERT_EQUAL_HEX8(0x02, sf.data[0]);
+
+  uint8_t buffer[8]     = {0};
+  IsoTp::Message rx_msg = make_message(buffer, 0, tx_id, rx_id, IsoTp::Addressing::NORMAL_FIXED);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(rx_msg, sizeof(buffer)));
+
+  // Кадр с тем же ID без флага 29 бит не относится к сессии
+  iso_tp.on_frame(make_frame(rx_id, {0x03, 0x41, 0x0D, 0x20}));
+  TEST_ASSERT_TRUE(iso_tp.is_busy());
+
+  iso_tp.on_frame(make_frame(rx_id, {0x03, 0x41, 0x0D, 0x20}, true));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  const uint8_t expected[3] = {0x41, 0x0D, 0x20};
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buffer, 3);
+}
+
+// Тест 2: Расширенная адресация - байт N_TA перед N_PCI
+void test_iso_tp_addressing_extended_send() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[16];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+
+  IsoTp::Message msg = make_message(data, 6, 0x6F1, 0x612, IsoTp::Addressing::EXTENDED);
+  msg.tx_address     = 0x12;
+  msg.rx_address     = 0xF1;
+  TEST_ASSERT_TRUE(iso_tp.send(msg));
+  const TwaiFrame& sf = mock_can.transmitted_frames[0];
+  TEST_ASSERT_FALSE(sf.is_extended);
+  TEST_ASSERT_EQUAL_HEX8(0x12, sf.data[0]);
+  TEST_ASSERT_EQUAL_HEX8_MESSAGE(0x06, sf.data[1], "SF carries up to 6 bytes");
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, &sf.data[2], 6);
+
+  // 16 байт = FF 5 + CF 6 + CF 5
+  mock_can.reset();
+  msg.len = sizeof(data);
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg));
+  const TwaiFrame& ff = mock_can.transmitted_frames[0];
+  TEST_ASSERT_EQUAL_HEX8(0x12, ff.data[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x10, ff.data[1]);
+  TEST_ASSERT_EQUAL_UINT8(16, ff.data[2]);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, &ff.data[3], 5);
+
+  // FC без байта адреса получателя игнорируется
+  iso_tp.on_frame(create_flow_control_frame(0x612, 0, 0, 0));
+  iso_tp.poll(0);
+  TEST_ASSERT_EQUAL_INT(1, mock_can.transmitted_frames.size());
+
+  iso_tp.on_frame(make_frame(0x612, {0xF1, 0x30, 0x00, 0x00}));
+  iso_tp.poll(0);
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_INT(3, mock_can.transmitted_frames.size());
+
+  const TwaiFrame& cf1 = mock_can.transmitted_frames[1];
+  TEST_ASSERT_EQUAL_HEX8(0x12, cf1.data[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x21, cf1.data[1]);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&data[5], &cf1.data[2], 6);
+
+  const TwaiFrame& cf2 = mock_can.transmitted_frames[2];
+  TEST_ASSERT_EQUAL_HEX8(0x22, cf2.data[1]);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&data[11], &cf2.data[2], 5);
+}
+
+// Тест 3: Расширенная адресация - прием многокадрового ответа
+void test_iso_tp_addressing_extended_receive() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t buffer[32]    = {0};
+  IsoTp::Message rx_msg = make_message(buffer, 0, 0x6F1, 0x612, IsoTp::Addressing::EXTENDED);
+  rx_msg.tx_address     = 0x12;
+  rx_msg.rx_address     = 0xF1;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(rx_msg, sizeof(buffer)));
+
+  iso_tp.on_frame(make_frame(0x612, {0xF1, 0x10, 0x0B, 0x00, 0x01, 0x02, 0x03, 0x04}));
+  TEST_ASSERT_EQUAL_INT(1, mock_can.transmitted_frames.size());
+  const TwaiFrame& fc = mock_can.transmitted_frames[0];
+  TEST_ASSERT_EQUAL_HEX32(0x6F1, fc.id);
+  TEST_ASSERT_EQUAL_HEX8(0x12, fc.data[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x30, fc.data[1]);
+
+  iso_tp.on_frame(make_frame(0x612, {0xF1, 0x21, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A}));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  for (uint8_t i = 0; i < 11; i++) {
+    TEST_ASSERT_EQUAL_HEX8(i, buffer[i]);
+  }
+}
+
+// Тест 4: Смешанная адресация - сессии на одном CAN ID различаются по N_AE
+void test_iso_tp_addressing_mixed_filter() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t buffer_a[8]  = {0};
+  uint8_t buffer_b[8]  = {0};
+  IsoTp::Message msg_a = make_message(buffer_a, 0, 0x18CE10F1, 0x18CEF110, IsoTp::Addressing::MIXED);
+  msg_a.tx_address     = 0x01;
+  msg_a.rx_address     = 0x01;
+  IsoTp::Message msg_b = msg_a;
+  msg_b.data           = buffer_b;
+  msg_b.tx_address     = 0x02;
+  msg_b.rx_address     = 0x02;
+
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg_a, sizeof(buffer_a)));
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg_b, sizeof(buffer_b)));
+  TEST_ASSERT_FALSE_MESSAGE(iso_tp.start_receive(msg_a, sizeof(buffer_a)), "Same N_AE is busy");
+
+  iso_tp.on_frame(make_frame(0x18CEF110, {0x03, 0x02, 0xAA, 0xBB}, true));  // Чужой N_AE
+  iso_tp.on_frame(make_frame(0x18CEF110, {0x02, 0x02, 0xB1, 0xB2}, true));
+  TEST_ASSERT_TRUE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_HEX8(0xB1, buffer_b[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x00, buffer_a[0]);
+
+  iso_tp.on_frame(make_frame(0x18CEF110, {0x01, 0x03, 0xA1, 0xA2, 0xA3}, true));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  const uint8_t expected[3] = {0xA1, 0xA2, 0xA3};
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, buffer_a, 3);
+}
+
+extern "C" void run_addressing_tests() {
+  RUN_TEST(test_iso_tp_addressing_normal_fixed);
+  RUN_TEST(test_iso_tp_addressing_extended_send);
+  RUN_TEST(test_iso_tp_addressing_extended_receive);
+  RUN_TEST(test_iso_tp_addressing_mixed_filter);
+}
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "flow_control_tuner.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ПАРАМЕТРОВ FC ПРИЕМНИКА И АДАПТИВНОЙ ПОДСТРОЙКИ
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ FlowControlTuner:
+ * - Ужесточение: BS -> SAFE_BLOCKSIZE -> BS/2 ... -> 1, затем рост STmin
+ * - Ослабление после CLEAN_TRANSFERS_TO_RELAX успешных передач
+ * - Неадаптивные ЭБУ не подстраиваются
+ *
+ * ✅ IsoTp:
+ * - FC приемника содержит настроенные BS/STmin, FC повторяется после каждого блока
+ * - Ошибка последовательности ужесточает параметры следующего приема
+ */
+
+// Тест 1: Последовательность ужесточения параметров
+void test_fc_tuner_tighten_sequence() {
+  FlowControlTuner tuner;
+
+  TEST_ASSERT_EQUAL_UINT8(0, tuner.params(0x7E8).blocksize);
+
+  tuner.on_error(0x7E8);
+  TEST_ASSERT_EQUAL_UINT8(FlowControlTuner::SAFE_BLOCKSIZE, tuner.params(0x7E8).blocksize);
+  tuner.on_error(0x7E8);
+  TEST_ASSERT_EQUAL_UINT8(4, tuner.params(0x7E8).blocksize);
+  tuner.on_error(0x7E8);
+  tuner.on_error(0x7E8);
+  TEST_ASSERT_EQUAL_UINT8(1, tuner.params(0x7E8).blocksize);
+  TEST_ASSERT_EQUAL_UINT8(0, tuner.params(0x7E8).min_sep_time);
+
+  tuner.on_error(0x7E8);
+  TEST_ASSERT_EQUAL_UINT8(1, tuner.params(0x7E8).min_sep_time);
+  for (int i = 0; i < 10; i++) {
+    tuner.on_error(0x7E8);
+  }
+  TEST_ASSERT_EQUAL_UINT8(FlowControlTuner::MAX_ADAPTIVE_STMIN, tuner.params(0x7E8).min_sep_time);
+
+  // Другой ЭБУ не затронут
+  TEST_ASSERT_EQUAL_UINT8(0, tuner.params(0x7E9).blocksize);
+}
+
+// Тест 2: Возврат к базовым параметрам после успешных передач
+void test_fc_tuner_relax_to_base() {
+  FlowControlTuner tuner;
+  FlowControlParams base;
+  base.blocksize = 0;
+  tuner.configure(0x7E8, base);
+
+  tuner.on_error(0x7E8);  // BS 8
+  tuner.on_error(0x7E8);  // BS 4
+  tuner.on_error(0x7E8);  // BS 2
+  tuner.on_error(0x7E8);  // BS 1
+  tuner.on_error(0x7E8);  // STmin 1
+
+  for (int i = 0; i < FlowControlTuner::CLEAN_TRANSFERS_TO_RELAX - 1; i++) {
+    tuner.on_success(0x7E8);
+  }
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(1, tuner.params(0x7E8).min_sep_time, "Too early to relax");
+  tuner.on_success(0x7E8);
+  TEST_ASSERT_EQUAL_UINT8(0, tuner.params(0x7E8).min_sep_time);
+  TEST_ASSERT_EQUAL_UINT8(1, tuner.params(0x7E8).blocksize);
+
+  const uint8_t expected_bs[] = {2, 4, 8, 0};
+  for (uint8_t bs : expected_bs) {
+    for (int i = 0; i < FlowControlTuner::CLEAN_TRANSFERS_TO_RELAX; i++) {
+      tuner.on_success(0x7E8);
+    }
+    TEST_ASSERT_EQUAL_UINT8(bs, tuner.params(0x7E8).blocksize);
+  }
+}
+
+// Тест 3: Фиксированные параметры без подстройки
+void test_fc_tuner_non_adaptive() {
+  FlowControlTuner tuner;
+  FlowControlParams base;
+  base.blocksize    = 3;
+  base.min_sep_time = 5;
+  base.wft_max      = 2;
+  TEST_ASSERT_TRUE(tuner.configure(0x661, base, false));
+
+  tuner.on_error(0x661);
+  TEST_ASSERT_EQUAL_UINT8(3, tuner.params(0x661).blocksize);
+  TEST_ASSERT_EQUAL_UINT8(5, tuner.params(0x661).min_sep_time);
+  TEST_ASSERT_EQUAL_UINT8(2, tuner.params(0x661).wft_max);
+}
+
+// Тест 4: FC приемника с BS и повтор FC после каждого блока
+void test_iso_tp_receive_with_blocksize() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  FlowControlParams params;
+  params.blocksize    = 2;
+  params.min_sep_time = 0xF5;
+  iso_tp.configure_flow_control(0x7E8, params, false);
+
+  uint8_t expected[34];
+  for (size_t i = 0; i < sizeof(expected); i++) {
+    expected[i] = static_cast<uint8_t>(i);
+  }
+  uint8_t buffer[64] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.data  = buffer;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+
+  // 34 байта = FF (6) + 4 CF (7+7+7+7)
+  iso_tp.on_frame(create_first_frame(0x7E8, sizeof(expected), expected));
+  TEST_ASSERT_EQUAL_INT(1, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_HEX8(0x30, mock_can.transmitted_frames[0].data[0]);
+  TEST_ASSERT_EQUAL_UINT8(2, mock_can.transmitted_frames[0].data[1]);
+  TEST_ASSERT_EQUAL_HEX8(0xF5, mock_can.transmitted_frames[0].data[2]);
+
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 1, &expected[6], 7));
+  TEST_ASSERT_EQUAL_INT(1, mock_can.transmitted_frames.size());
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 2, &expected[13], 7));
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "FC after block of 2 CF");
+
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 3, &expected[20], 7));
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 4, &expected[27], 7));
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "No FC after the last CF");
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buffer, sizeof(expected));
+}
+
+// Тест 5: Ошибка последовательности снижает BS для следующего приема от ЭБУ
+void test_iso_tp_adaptive_blocksize_after_sequence_error() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[20]   = {0};
+  uint8_t buffer[32] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.data  = buffer;
+
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+  iso_tp.on_frame(create_first_frame(0x7E8, sizeof(data), data));
+  TEST_ASSERT_EQUAL_UINT8(0, mock_can.transmitted_frames.back().data[1]);
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 2, data, 7));  // Пропущен CF 1
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+
+  TEST_ASSERT_EQUAL_UINT8(FlowControlTuner::SAFE_BLOCKSIZE, iso_tp.flow_control(0x7E8).blocksize);
+  TEST_ASSERT_EQUAL_UINT8(0, iso_tp.flow_control(0x7E9).blocksize);
+
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+  iso_tp.on_frame(create_first_frame(0x7E8, sizeof(data), data));
+  TEST_ASSERT_EQUAL_UINT8(FlowControlTuner::SAFE_BLOCKSIZE, mock_can.transmitted_frames.back().data[1]);
+  iso_tp.abort();
+}
+
+extern "C" void run_flow_control_tuner_tests() {
+  RUN_TEST(test_fc_tuner_tighten_sequence);
+  RUN_TEST(test_fc_tuner_relax_to_base);
+  RUN_TEST(test_fc_tuner_non_adaptive);
+  RUN_TEST(test_iso_tp_receive_with_blocksize);
+  RUN_TEST(test_iso_tp_adaptive_blocksize_after_sequence_error);
+}
@@ -0,0 +1,108 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ФУНКЦИОНАЛЬНОГО ЗАПРОСА (0x7DF -> 7E8..7EF)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ СБОР ОТВЕТОВ:
+ * - Один SF на 0x7DF, ответы нескольких ЭБУ за одно окно
+ * - Параллельные многокадровые ответы с FC на физический адрес каждого ЭБУ
+ * - Молчащий ЭБУ завершается по окончании окна, не считаясь таймаутом в статистике
+ *
+ * ✅ ОГРАНИЧЕНИЯ:
+ * - Многокадровый функциональный запрос отклоняется
+ */
+
+// Тест 1: Ответы трех ЭБУ, два из них многокадровые и перемежаются на шине
+void test_iso_tp_functional_fan_in() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  const uint8_t engine[]  = {0x41, 0x00, 0xBE, 0x1F};
+  const uint8_t gearbox[] = {0x49, 0x02, 0x01, 0x31, 0x47, 0x31, 0x4A, 0x43, 0x35, 0x34, 0x34, 0x34, 0x52, 0x37};
+  const uint8_t brakes[]  = {0x49, 0x0A, 0x01, 0x41, 0x42, 0x53, 0x2D, 0x45, 0x43, 0x55, 0x00};
+
+  // 7E8 - SF, 7E9 - FF + 2 CF, 7EA - FF + 1 CF, 7EB молчит
+  mock_can.add_receive_frame(create_first_frame(0x7E9, sizeof(gearbox), gearbox));
+  mock_can.add_receive_frame(create_single_frame(0x7E8, sizeof(engine), engine));
+  mock_can.add_receive_frame(create_first_frame(0x7EA, sizeof(brakes), brakes));
+  mock_can.add_receive_frame(create_consecutive_frame(0x7E9, 1, &gearbox[6], 7));
+  mock_can.add_receive_frame(create_consecutive_frame(0x7EA, 1, &brakes[6], 5));
+  mock_can.add_receive_frame(create_consecutive_frame(0x7E9, 2, &gearbox[13], 1));
+
+  uint8_t buffers[4][32] = {};
+  IsoTp::FunctionalResponse responses[4];
+  for (size_t i = 0; i < 4; i++) {
+    responses[i].tx_id = 0x7E0 + i;
+    responses[i].rx_id = 0x7E8 + i;
+    responses[i].data  = buffers[i];
+    responses[i].size  = sizeof(buffers[i]);
+  }
+
+  uint8_t request[2] = {0x01, 0x00};
+  IsoTp::Message msg = make_message(request, sizeof(request), 0x7DF);
+  TEST_ASSERT_EQUAL_INT(3, iso_tp.send_functional(msg, Span<IsoTp::FunctionalResponse>(responses, 4), 50));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+
+  TEST_ASSERT_EQUAL_HEX32(0x7DF, mock_can.transmitted_frames[0].id);
+  TEST_ASSERT_EQUAL_HEX8(0x02, mock_can.transmitted_frames[0].data[0]);
+
+  // Запрос + FC для каждого многокадрового ответа на физический адрес ЭБУ
+  TEST_ASSERT_EQUAL_INT(3, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_HEX32(0x7E1, mock_can.transmitted_frames[1].id);
+  TEST_ASSERT_EQUAL_HEX8(0x30, mock_can.transmitted_frames[1].data[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x7E2, mock_can.transmitted_frames[2].id);
+
+  TEST_ASSERT_TRUE(responses[0].received);
+  TEST_ASSERT_EQUAL_size_t(sizeof(engine), responses[0].len);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(engine, buffers[0], sizeof(engine));
+
+  TEST_ASSERT_TRUE(responses[1].received);
+  TEST_ASSERT_EQUAL_size_t(sizeof(gearbox), responses[1].len);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(gearbox, buffers[1], sizeof(gearbox));
+
+  TEST_ASSERT_TRUE(responses[2].received);
+  TEST_ASSERT_EQUAL_size_t(sizeof(brakes), responses[2].len);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(brakes, buffers[2], sizeof(brakes));
+
+  TEST_ASSERT_FALSE_MESSAGE(responses[3].received, "Silent ECU closed by the collection window");
+
+  // Молчание ЭБУ в окне сбора - штатный исход, а не таймаут
+  const TransferStatsEntry* silent = iso_tp.transfer_stats().find(0x7E3, 0x7EB);
+  TEST_ASSERT_NOT_NULL(silent);
+  TEST_ASSERT_EQUAL_UINT32(0, silent->timeout_session);
+}
+
+// Тест 2: Функциональный запрос длиннее SF не отправляется
+void test_iso_tp_functional_rejects_multi_frame() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t buffer[8] = {0};
+  IsoTp::FunctionalResponse response;
+  response.tx_id = 0x7E0;
+  response.rx_id = 0x7E8;
+  response.data  = buffer;
+  response.size  = sizeof(buffer);
+
+  uint8_t request[8] = {0};
+  IsoTp::Message msg = make_message(request, sizeof(request), 0x7DF);
+  TEST_ASSERT_EQUAL_INT(0, iso_tp.send_functional(msg, Span<IsoTp::FunctionalResponse>(&response, 1), 50));
+  TEST_ASSERT_EQUAL_INT(0, mock_can.transmitted_frames.size());
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+}
+
+extern "C" void run_functional_tests() {
+  RUN_TEST(test_iso_tp_functional_fan_in);
+  RUN_TEST(test_iso_tp_functional_rejects_multi_frame);
+}
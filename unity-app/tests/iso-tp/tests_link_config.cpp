@@ -0,0 +1,261 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ФОРМАТА КАДРОВ (оптимизированный DLC, заполнение, CAN FD)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ КЛАССИЧЕСКИЙ CAN:
+ * - Оптимизированный DLC: SF, FC и последний CF без заполнения
+ * - Заполнение настраиваемым байтом (0xCC)
+ *
+ * ✅ CAN FD:
+ * - SF с escape SF_DL, FF/CF по 64 байта, округление длины до ряда DLC
+ * - Прием SF с escape SF_DL и FF с escape FF_DL (> 4095 байт)
+ * - Недопустимый TX_DL заменяется на 8
+ *
+ * ✅ НЕДОПУСТИМЫЕ ДЛИНЫ (ISO 15765-2):
+ * - SF_DL = 0, escape FF_DL в классическом кадре и escape FF_DL <= 4095 игнорируются
+ */
+
+namespace {
+
+struct StreamLog {
+  size_t received  = 0;
+  size_t total_len = 0;
+  bool in_order    = true;
+};
+
+void on_stream(size_t offset, Span<const uint8_t> chunk, size_t total_len, void* ctx) {
+  auto* log = static_cast<StreamLog*>(ctx);
+  for (size_t i = 0; i < chunk.size(); i++) {
+    if (chunk[i] != static_cast<uint8_t>(offset + i)) {
+      log->in_order = false;
+    }
+  }
+  log->received  = offset + chunk.size();
+  log->total_len = total_len;
+}
+
+TwaiFrame make_fd_frame(uint32_t id, const uint8_t* data, uint8_t len) {
+  TwaiFrame frame   = {};
+  frame.id          = id;
+  frame.is_fd       = true;
+  frame.data_length = len;
+  memcpy(frame.data, data, len);
+  return frame;
+}
+
+}  // namespace
+
+// Тест 1: Оптимизированный DLC без заполнения
+void test_iso_tp_link_optimized_dlc() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp::LinkConfig link;
+  link.padding = false;
+  IsoTp iso_tp(mock_can, link);
+
+  uint8_t sf_data[3]    = {0x01, 0x0C, 0x0D};
+  IsoTp::Message sf_msg = make_message(sf_data, sizeof(sf_data));
+  TEST_ASSERT_TRUE(iso_tp.send(sf_msg));
+  TEST_ASSERT_EQUAL_UINT8(4, mock_can.transmitted_frames[0].data_length);
+  TEST_ASSERT_EQUAL_HEX8(0x03, mock_can.transmitted_frames[0].data[0]);
+
+  mock_can.reset();
+  uint8_t long_data[16] = {0};
+  IsoTp::Message ff_msg = make_message(long_data, sizeof(long_data));  // FF 6 + CF 7 + CF 3
+  TEST_ASSERT_TRUE(iso_tp.start_send(ff_msg));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+  iso_tp.poll(0);
+  TEST_ASSERT_EQUAL_INT(3, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_UINT8(8, mock_can.transmitted_frames[0].data_length);
+  TEST_ASSERT_EQUAL_UINT8(8, mock_can.transmitted_frames[1].data_length);
+  TEST_ASSERT_EQUAL_UINT8(4, mock_can.transmitted_frames[2].data_length);
+
+  mock_can.reset();
+  uint8_t rx_buffer[32] = {0};
+  IsoTp::Message rx_msg = make_message(rx_buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(rx_msg, sizeof(rx_buffer)));
+  iso_tp.on_frame(create_first_frame(0x7E8, 20, long_data));
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(3, mock_can.transmitted_frames[0].data_length, "FC has 3 bytes");
+  iso_tp.abort();
+}
+
+// Тест 2: Заполнение кадров байтом 0xCC
+void test_iso_tp_link_pad_byte() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp::LinkConfig link;
+  link.pad_byte = 0xCC;
+  IsoTp iso_tp(mock_can, link);
+
+  uint8_t data[2]    = {0x09, 0x02};
+  IsoTp::Message msg = make_message(data, sizeof(data));
+  TEST_ASSERT_TRUE(iso_tp.send(msg));
+
+  const TwaiFrame& frame = mock_can.transmitted_frames[0];
+  TEST_ASSERT_EQUAL_UINT8(8, frame.data_length);
+  TEST_ASSERT_FALSE(frame.is_fd);
+  const uint8_t expected[8] = {0x02, 0x09, 0x02, 0xCC, 0xCC, 0xCC, 0xCC, 0xCC};
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, frame.data, 8);
+}
+
+// Тест 3: Отправка по CAN FD: escape SF_DL и кадры по 64 байта
+void test_iso_tp_link_fd_send() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp::LinkConfig link;
+  link.tx_dl           = 64;
+  link.pad_byte        = 0xAA;
+  link.bit_rate_switch = true;
+  IsoTp iso_tp(mock_can, link);
+
+  uint8_t data[100];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+
+  IsoTp::Message sf_msg = make_message(data, 20);
+  TEST_ASSERT_TRUE(iso_tp.send(sf_msg));
+  const TwaiFrame& sf = mock_can.transmitted_frames[0];
+  TEST_ASSERT_TRUE(sf.is_fd);
+  TEST_ASSERT_TRUE(sf.brs);
+  TEST_ASSERT_EQUAL_UINT8_MESSAGE(24, sf.data_length, "22 bytes rounded up to DLC 24");
+  TEST_ASSERT_EQUAL_HEX8(0x00, sf.data[0]);
+  TEST_ASSERT_EQUAL_UINT8(20, sf.data[1]);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, &sf.data[2], 20);
+  TEST_ASSERT_EQUAL_HEX8(0xAA, sf.data[23]);
+
+  mock_can.reset();
+  IsoTp::Message ff_msg = make_message(data, sizeof(data));
+  TEST_ASSERT_TRUE(iso_tp.start_send(ff_msg));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+  iso_tp.poll(0);
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "FF 62 bytes + CF 38 bytes");
+
+  const TwaiFrame& ff = mock_can.transmitted_frames[0];
+  TEST_ASSERT_EQUAL_UINT8(64, ff.data_length);
+  TEST_ASSERT_EQUAL_HEX8(0x10, ff.data[0]);
+  TEST_ASSERT_EQUAL_UINT8(100, ff.data[1]);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, &ff.data[2], 62);
+
+  const TwaiFrame& cf = mock_can.transmitted_frames[1];
+  TEST_ASSERT_EQUAL_UINT8(48, cf.data_length);
+  TEST_ASSERT_EQUAL_HEX8(0x21, cf.data[0]);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&data[62], &cf.data[1], 38);
+  TEST_ASSERT_EQUAL_HEX8(0xAA, cf.data[47]);
+}
+
+// Тест 4: Прием по CAN FD: escape SF_DL и escape FF_DL
+void test_iso_tp_link_fd_receive_escape() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp::LinkConfig link;
+  link.tx_dl = 64;
+  IsoTp iso_tp(mock_can, link);
+
+  uint8_t payload[64];
+  for (size_t i = 0; i < sizeof(payload); i++) {
+    payload[i] = static_cast<uint8_t>(i);
+  }
+
+  // SF с escape SF_DL
+  uint8_t sf[32] = {0x00, 30};
+  memcpy(&sf[2], payload, 30);
+  uint8_t buffer[64]    = {0};
+  IsoTp::Message rx_msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(rx_msg, sizeof(buffer)));
+  iso_tp.on_frame(make_fd_frame(0x7E8, sf, sizeof(sf)));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(payload, buffer, 30);
+
+  // FF с escape FF_DL: 5000 байт = FF 58 + 78 CF по 63 + CF 28
+  const uint32_t total = 5000;
+  StreamLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive_stream(rx_msg, on_stream, &log));
+
+  uint8_t frame[64] = {0x10, 0x00, 0x00, 0x00, total >> 8, total & 0xFF};
+  for (size_t i = 6; i < sizeof(frame); i++) {
+    frame[i] = static_cast<uint8_t>(i - 6);
+  }
+  iso_tp.on_frame(make_fd_frame(0x7E8, frame, sizeof(frame)));
+  TEST_ASSERT_EQUAL_UINT32(total, log.total_len);
+
+  size_t offset = 58;
+  for (uint8_t seq = 1; offset < total; seq++) {
+    const size_t chunk = std::min<size_t>(63, total - offset);
+    frame[0]           = 0x20 | (seq & 0x0F);
+    for (size_t i = 0; i < chunk; i++) {
+      frame[1 + i] = static_cast<uint8_t>(offset + i);
+    }
+    iso_tp.on_frame(make_fd_frame(0x7E8, frame, (chunk == 63) ? 64 : 32));
+    offset += chunk;
+  }
+
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_UINT32(total, log.received);
+  TEST_ASSERT_TRUE(log.in_order);
+}
+
+// Тест 5: Недопустимая длина кадра заменяется на классический CAN
+void test_iso_tp_link_invalid_tx_dl() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp::LinkConfig link;
+  link.tx_dl = 40;
+  IsoTp iso_tp(mock_can, link);
+
+  uint8_t data[10]   = {0};
+  IsoTp::Message msg = make_message(data, sizeof(data));
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg));
+  TEST_ASSERT_EQUAL_UINT8(8, mock_can.transmitted_frames[0].data_length);
+  TEST_ASSERT_FALSE(mock_can.transmitted_frames[0].is_fd);
+  iso_tp.abort();
+}
+
+// Тест 6: Кадры с недопустимой длиной сообщения игнорируются
+void test_iso_tp_link_invalid_length_ignored() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp::LinkConfig link;
+  link.tx_dl = 64;
+  IsoTp iso_tp(mock_can, link);
+
+  uint8_t buffer[64]    = {0};
+  IsoTp::Message rx_msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(rx_msg, sizeof(buffer)));
+
+  // SF_DL = 0 в классическом кадре
+  iso_tp.on_frame(make_frame(0x7E8, {0x00, 0x41, 0x0D, 0x20, 0x00, 0x00, 0x00, 0x00}));
+  TEST_ASSERT_TRUE_MESSAGE(iso_tp.is_busy(), "SF_DL 0 must be ignored");
+
+  // Escape FF_DL допустим только в кадре CAN FD
+  iso_tp.on_frame(make_frame(0x7E8, {0x10, 0x00, 0x00, 0x00, 0x13, 0x88, 0x01, 0x02}));
+  TEST_ASSERT_TRUE_MESSAGE(iso_tp.is_busy(), "FF_DL escape on classic CAN must be ignored");
+
+  // Escape FF_DL для сообщения, которое помещается в 12 бит
+  uint8_t frame[64] = {0x10, 0x00, 0x00, 0x00, 0x00, 0x64};
+  iso_tp.on_frame(make_fd_frame(0x7E8, frame, sizeof(frame)));
+  TEST_ASSERT_TRUE_MESSAGE(iso_tp.is_busy(), "Escaped FF_DL <= 4095 must be ignored");
+
+  TEST_ASSERT_EQUAL_size_t_MESSAGE(0, mock_can.transmitted_frames.size(), "No FC for ignored FF");
+  iso_tp.abort();
+}
+
+extern "C" void run_link_config_tests() {
+  RUN_TEST(test_iso_tp_link_optimized_dlc);
+  RUN_TEST(test_iso_tp_link_pad_byte);
+  RUN_TEST(test_iso_tp_link_fd_send);
+  RUN_TEST(test_iso_tp_link_fd_receive_escape);
+  RUN_TEST(test_iso_tp_link_invalid_tx_dl);
+  RUN_TEST(test_iso_tp_link_invalid_length_ignored);
+}
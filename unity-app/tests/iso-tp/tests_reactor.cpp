@@ -0,0 +1,432 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/task.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ НЕБЛОКИРУЮЩЕГО API ISO-TP (on_frame / poll / completion callback)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ОТПРАВКА:
+ * - FF отправляется в start_send(), CF - только после FC и вызова poll()
+ * - Таймаут ожидания FC фиксируется в poll() без ожидания в реальном времени
+ * - SF/FF, не принятый драйвером, завершает передачу ошибкой сразу
+ *
+ * ✅ ПРИЕМ:
+ * - Сборка сообщения из кадров, переданных напрямую в on_frame()
+ * - Таймаут CF (N_Cr)
+ *
+ * ✅ УПРАВЛЕНИЕ:
+ * - next_timeout() и abort()
+ *
+ * ✅ ПОТОКОВЫЙ ПРИЕМ:
+ * - Фрагменты передаются потребителю без копирования, длина до 4095 байт
+ * - Раскладка по scatter-буферам
+ *
+ * ✅ ПАРАЛЛЕЛЬНЫЕ СЕССИИ:
+ * - Одновременная сборка сообщений от разных ЭБУ
+ * - Лимит MAX_SESSIONS и запрет повторного rx_id
+ */
+
+namespace {
+
+struct StreamLog {
+  uint8_t data[IsoTp::MAX_SESSIONS * 1024];
+  size_t received  = 0;
+  size_t total_len = 0;
+  int chunks       = 0;
+};
+
+void on_stream(size_t offset, Span<const uint8_t> chunk, size_t total_len, void* ctx) {
+  auto* log = static_cast<StreamLog*>(ctx);
+  memcpy(log->data + offset, chunk.data(), chunk.size());
+  log->received  = offset + chunk.size();
+  log->total_len = total_len;
+  log->chunks++;
+}
+
+// Подает на вход сообщение длиной len в виде FF + CF
+void feed_multi_frame(IsoTp& iso_tp, uint32_t rx_id, const uint8_t* data, size_t len) {
+  iso_tp.on_frame(create_first_frame(rx_id, len, data));
+  uint8_t seq = 1;
+  for (size_t offset = 6; offset < len; offset += 7, seq++) {
+    const size_t chunk = (len - offset > 7) ? 7 : len - offset;
+    iso_tp.on_frame(create_consecutive_frame(rx_id, seq, data + offset, chunk));
+  }
+}
+
+}  // namespace
+
+// Тест 1: Многокадровая отправка продвигается только событиями
+void test_iso_tp_reactor_send_driven_by_events() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t test_data[20];
+  for (size_t i = 0; i < sizeof(test_data); i++) {
+    test_data[i] = static_cast<uint8_t>(i);
+  }
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.len   = sizeof(test_data);
+  msg.data  = test_data;
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  TEST_ASSERT_TRUE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_INT_MESSAGE(1, mock_can.transmitted_frames.size(), "Only FF before FC");
+
+  // Пока FC не пришел, poll() не должен отправлять CF
+  const uint32_t now = xTaskGetTickCount();
+  iso_tp.poll(now);
+  TEST_ASSERT_EQUAL_INT(1, mock_can.transmitted_frames.size());
+
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+  TEST_ASSERT_EQUAL_INT_MESSAGE(1, mock_can.transmitted_frames.size(), "CF are sent from poll()");
+  TEST_ASSERT_EQUAL_UINT32(0, iso_tp.next_timeout(now));
+
+  iso_tp.poll(now);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(3, mock_can.transmitted_frames.size(), "FF + 2 CF");
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_TRUE(log.last.is_send);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+  TEST_ASSERT_EQUAL_UINT32(IsoTp::NO_DEADLINE, iso_tp.next_timeout(now));
+}
+
+// Тест 2: Таймаут FC определяется переданным временем, а не ожиданием
+void test_iso_tp_reactor_send_fc_timeout() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t test_data[10] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.len   = sizeof(test_data);
+  msg.data  = test_data;
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+
+  const uint32_t now = xTaskGetTickCount();
+  TEST_ASSERT_NOT_EQUAL(IsoTp::NO_DEADLINE, iso_tp.next_timeout(now));
+
+  iso_tp.poll(now + 10);
+  TEST_ASSERT_EQUAL_INT(0, log.calls);
+
+  iso_tp.poll(now + 1000);
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TIMEOUT_FC), static_cast<int>(log.last.result));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+}
+
+// Тест 2a: Драйвер не принял SF/FF - ошибка сразу, без ожидания FC
+void test_iso_tp_reactor_send_tx_failed() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  mock_can.transmit_result = IPhyInterface::TwaiError::TRANSMIT_FAILED;
+  IsoTp iso_tp(mock_can);
+
+  uint8_t test_data[10] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.data  = test_data;
+
+  // SF
+  msg.len = 3;
+  CompletionLog sf_log;
+  TEST_ASSERT_FALSE(iso_tp.start_send(msg, on_complete, &sf_log));
+  TEST_ASSERT_EQUAL_INT(1, sf_log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TX_FAILED), static_cast<int>(sf_log.last.result));
+
+  // FF: сессия закрыта сразу, таймер FC не взведен
+  msg.len = sizeof(test_data);
+  CompletionLog ff_log;
+  TEST_ASSERT_FALSE(iso_tp.start_send(msg, on_complete, &ff_log));
+  TEST_ASSERT_EQUAL_INT(1, ff_log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TX_FAILED), static_cast<int>(ff_log.last.result));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_UINT32(IsoTp::NO_DEADLINE, iso_tp.next_timeout(xTaskGetTickCount()));
+}
+
+// Тест 3: Прием многокадрового сообщения через on_frame()
+void test_iso_tp_reactor_receive_multi_frame() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t expected[13] = {0x49, 0x02, 0x01, 0x57, 0x30, 0x4C, 0x30, 0x30, 0x30, 0x30, 0x34, 0x33, 0x4D};
+  uint8_t buffer[32]   = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.data  = buffer;
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &log));
+
+  // Кадр другого ЭБУ игнорируется
+  iso_tp.on_frame(create_single_frame(0x7E9, 2, expected));
+  TEST_ASSERT_TRUE(iso_tp.is_busy());
+
+  iso_tp.on_frame(create_first_frame(0x7E8, sizeof(expected), expected));
+  TEST_ASSERT_EQUAL_INT_MESSAGE(1, mock_can.transmitted_frames.size(), "FC must be sent after FF");
+  TEST_ASSERT_EQUAL_HEX8(0x30, mock_can.transmitted_frames[0].data[0]);
+
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 1, &expected[6], 7));
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_FALSE(log.last.is_send);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+  TEST_ASSERT_EQUAL_UINT32(sizeof(expected), log.last.len);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, buffer, sizeof(expected));
+}
+
+// Тест 4: Таймаут CF (N_Cr) после FF
+void test_iso_tp_reactor_receive_cf_timeout() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[6]    = {1, 2, 3, 4, 5, 6};
+  uint8_t buffer[32] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.data  = buffer;
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &log));
+  iso_tp.on_frame(create_first_frame(0x7E8, 20, data));
+
+  iso_tp.poll(xTaskGetTickCount() + 1000);
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TIMEOUT_CF), static_cast<int>(log.last.result));
+}
+
+// Тест 5: Прерывание транзакции и запуск новой
+void test_iso_tp_reactor_abort() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t buffer[8] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.data  = buffer;
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &log));
+  TEST_ASSERT_FALSE_MESSAGE(iso_tp.start_receive(msg, sizeof(buffer)), "Engine is busy");
+
+  iso_tp.abort();
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::ABORTED), static_cast<int>(log.last.result));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+}
+
+// Тест 6: Две многокадровые сборки от разных ЭБУ чередуются
+void test_iso_tp_reactor_concurrent_receive() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t engine_data[10]    = {0x49, 0x02, 0x01, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37};
+  uint8_t gearbox_data[9]    = {0x49, 0x02, 0x01, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46};
+  uint8_t engine_buffer[16]  = {0};
+  uint8_t gearbox_buffer[16] = {0};
+
+  IsoTp::Message engine;
+  engine.tx_id = 0x7E0;
+  engine.rx_id = 0x7E8;
+  engine.data  = engine_buffer;
+
+  IsoTp::Message gearbox;
+  gearbox.tx_id = 0x7E1;
+  gearbox.rx_id = 0x7E9;
+  gearbox.data  = gearbox_buffer;
+
+  CompletionLog engine_log;
+  CompletionLog gearbox_log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(engine, sizeof(engine_buffer), on_complete, &engine_log));
+  TEST_ASSERT_TRUE(iso_tp.start_receive(gearbox, sizeof(gearbox_buffer), on_complete, &gearbox_log));
+  TEST_ASSERT_TRUE(iso_tp.is_busy(0x7E0, 0x7E8));
+  TEST_ASSERT_TRUE(iso_tp.is_busy(0x7E1, 0x7E9));
+
+  iso_tp.on_frame(create_first_frame(0x7E8, sizeof(engine_data), engine_data));
+  iso_tp.on_frame(create_first_frame(0x7E9, sizeof(gearbox_data), gearbox_data));
+
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "FC for each ECU");
+  TEST_ASSERT_EQUAL_HEX32(0x7E0, mock_can.transmitted_frames[0].id);
+  TEST_ASSERT_EQUAL_HEX32(0x7E1, mock_can.transmitted_frames[1].id);
+
+  iso_tp.on_frame(create_consecutive_frame(0x7E9, 1, &gearbox_data[6], 3));
+  TEST_ASSERT_EQUAL_INT(1, gearbox_log.calls);
+  TEST_ASSERT_EQUAL_INT(0, engine_log.calls);
+  TEST_ASSERT_TRUE(iso_tp.is_busy(0x7E0, 0x7E8));
+
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 1, &engine_data[6], 4));
+  TEST_ASSERT_EQUAL_INT(1, engine_log.calls);
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(engine_data, engine_buffer, sizeof(engine_data));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(gearbox_data, gearbox_buffer, sizeof(gearbox_data));
+}
+
+// Тест 7: Таймаут одной сессии не влияет на другую
+void test_iso_tp_reactor_independent_timers() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[6]     = {1, 2, 3, 4, 5, 6};
+  uint8_t buffer1[32] = {0};
+  uint8_t buffer2[32] = {0};
+
+  IsoTp::Message msg1;
+  msg1.tx_id = 0x261;
+  msg1.rx_id = 0x661;
+  msg1.data  = buffer1;
+
+  IsoTp::Message msg2;
+  msg2.tx_id = 0x793;
+  msg2.rx_id = 0x7A3;
+  msg2.data  = buffer2;
+
+  CompletionLog log1;
+  CompletionLog log2;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg1, sizeof(buffer1), on_complete, &log1));
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg2, sizeof(buffer2), on_complete, &log2));
+
+  // Первая сессия ждет CF (500 мс), вторая - ответ (2000 мс)
+  iso_tp.on_frame(create_first_frame(0x661, 20, data));
+
+  iso_tp.poll(xTaskGetTickCount() + 1000);
+  TEST_ASSERT_EQUAL_INT(1, log1.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TIMEOUT_CF), static_cast<int>(log1.last.result));
+  TEST_ASSERT_EQUAL_INT(0, log2.calls);
+  TEST_ASSERT_TRUE(iso_tp.is_busy(0x793, 0x7A3));
+
+  iso_tp.poll(xTaskGetTickCount() + 3000);
+  TEST_ASSERT_EQUAL_INT(1, log2.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TIMEOUT_SESSION), static_cast<int>(log2.last.result));
+}
+
+// Тест 8: Ограничение числа сессий и уникальность rx_id
+void test_iso_tp_reactor_session_limit() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t buffer[8] = {0};
+  IsoTp::Message msg;
+  msg.data = buffer;
+
+  for (size_t i = 0; i < IsoTp::MAX_SESSIONS; i++) {
+    msg.tx_id = 0x7E0 + i;
+    msg.rx_id = 0x7E8 + i;
+    TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+  }
+
+  msg.tx_id = 0x7E0 + IsoTp::MAX_SESSIONS;
+  msg.rx_id = 0x7E8 + IsoTp::MAX_SESSIONS;
+  TEST_ASSERT_FALSE_MESSAGE(iso_tp.start_receive(msg, sizeof(buffer)), "Session table is full");
+
+  iso_tp.abort(0x7E0, 0x7E8);
+  TEST_ASSERT_FALSE(iso_tp.is_busy(0x7E0, 0x7E8));
+
+  msg.tx_id = 0x7DF;
+  msg.rx_id = 0x7E9;
+  TEST_ASSERT_FALSE_MESSAGE(iso_tp.start_receive(msg, sizeof(buffer)), "rx_id already in use");
+
+  msg.rx_id = 0x7E8;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+}
+
+// Тест 9: Потоковый прием максимального сообщения без буфера движка
+void test_iso_tp_reactor_stream_max_length() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  static uint8_t expected[4095];
+  for (size_t i = 0; i < sizeof(expected); i++) {
+    expected[i] = static_cast<uint8_t>(i * 7);
+  }
+
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+
+  static StreamLog stream;
+  stream = StreamLog();
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive_stream(msg, on_stream, &stream, on_complete, &log));
+
+  feed_multi_frame(iso_tp, 0x7E8, expected, sizeof(expected));
+
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+  TEST_ASSERT_EQUAL_UINT32(sizeof(expected), log.last.len);
+  TEST_ASSERT_EQUAL_UINT32(sizeof(expected), stream.received);
+  TEST_ASSERT_EQUAL_UINT32(sizeof(expected), stream.total_len);
+  TEST_ASSERT_EQUAL_INT(1 + (sizeof(expected) - 6 + 6) / 7, stream.chunks);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, stream.data, sizeof(expected));
+}
+
+// Тест 10: Раскладка сообщения по двум несмежным буферам
+void test_iso_tp_reactor_scatter_buffer() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t expected[20];
+  for (size_t i = 0; i < sizeof(expected); i++) {
+    expected[i] = static_cast<uint8_t>(0xA0 + i);
+  }
+
+  uint8_t header[3]              = {0};
+  uint8_t payload[17]            = {0};
+  const Span<uint8_t> segments[] = {Span<uint8_t>(header), Span<uint8_t>(payload)};
+  IIsoTp::ScatterBuffer scatter;
+  scatter.segments = Span<const Span<uint8_t>>(segments);
+
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive_stream(msg, IIsoTp::ScatterBuffer::consume, &scatter, on_complete, &log));
+  feed_multi_frame(iso_tp, 0x7E8, expected, sizeof(expected));
+
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, header, sizeof(header));
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(&expected[3], payload, sizeof(payload));
+}
+
+// Функция запуска всех тестов неблокирующего API
+extern "C" void run_iso_tp_reactor_tests() {
+  RUN_TEST(test_iso_tp_reactor_send_driven_by_events);
+  RUN_TEST(test_iso_tp_reactor_send_fc_timeout);
+  RUN_TEST(test_iso_tp_reactor_send_tx_failed);
+  RUN_TEST(test_iso_tp_reactor_receive_multi_frame);
+  RUN_TEST(test_iso_tp_reactor_receive_cf_timeout);
+  RUN_TEST(test_iso_tp_reactor_abort);
+  RUN_TEST(test_iso_tp_reactor_concurrent_receive);
+  RUN_TEST(test_iso_tp_reactor_independent_timers);
+  RUN_TEST(test_iso_tp_reactor_session_limit);
+  RUN_TEST(test_iso_tp_reactor_stream_max_length);
+  RUN_TEST(test_iso_tp_reactor_scatter_buffer);
+}
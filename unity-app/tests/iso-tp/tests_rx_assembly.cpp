@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/task.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "twai_subscriber_iso_tp.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ФИЛЬТРА RX ID И СБОРКИ CF В ПРЕРЫВАНИИ
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ФИЛЬТР RX ID:
+ * - Кадры вне фильтра id/mask и другого формата ID отбрасываются
+ * - Чужой трафик шины не занимает буфер задачи
+ *
+ * ✅ СБОРКА CF:
+ * - Многокадровый ответ длиннее буфера собирается с одним пробуждением задачи
+ * - Конец блока BS будит задачу для отправки FC
+ * - Пропуск CF завершает прием с WRONG_SN, дубликаты учитываются
+ */
+
+namespace {
+
+size_t queued_frames(MockTwaiInterface& mock_can) {
+  return mock_can.subscribers[0]->onTwaiMessage()->Size();
+}
+
+// Уведомления задачи-читателя (тест и есть эта задача), не снятые Receive()
+uint32_t pending_wakeups() {
+  return ulTaskNotifyValueClearIndexed(xTaskGetCurrentTaskHandle(), TwaiRxRing::kNotifyIndex, 0);
+}
+
+// FF и первый FC: после этого CF собираются в прерывании
+void receive_first_frame(MockTwaiInterface& mock_can, IsoTp& iso_tp, const uint8_t* data, uint16_t len) {
+  mock_can.add_receive_frame(create_first_frame(0x7E8, len, data));
+  iso_tp.process(0);
+  // Пробуждение от FF (и оставшиеся от прошлых тестов) не относятся к сборке CF
+  ulTaskNotifyValueClearIndexed(xTaskGetCurrentTaskHandle(), TwaiRxRing::kNotifyIndex, UINT32_MAX);
+}
+
+}  // namespace
+
+// Тест 1: Фильтр id/mask отбрасывает чужие кадры
+void test_rx_assembly_filter() {
+  TwaiSubscriberIsoTp subscriber;
+  TEST_ASSERT_TRUE(subscriber.AddRxFilter(0x7E8, 0x7F8, false));
+
+  TwaiFrame frame   = {};
+  frame.data_length = 8;
+
+  frame.id = 0x7EF;
+  TEST_ASSERT_TRUE(subscriber.isInterested(frame));
+  frame.id = 0x7E0;
+  TEST_ASSERT_FALSE(subscriber.isInterested(frame));
+  frame.id = 0x123;
+  TEST_ASSERT_FALSE(subscriber.isInterested(frame));
+  frame.id          = 0x7E8;
+  frame.is_extended = true;
+  TEST_ASSERT_FALSE_MESSAGE(subscriber.isInterested(frame), "29-bit ID does not match 11-bit filter");
+
+  for (size_t i = 1; i < TwaiSubscriberIsoTp::kMaxRxFilters; i++) {
+    TEST_ASSERT_TRUE(subscriber.AddRxFilter(0x18DAF100 + i, 0x1FFFFFFF, true));
+  }
+  TEST_ASSERT_FALSE(subscriber.AddRxFilter(0x700, 0x700, false));
+  TEST_ASSERT_FALSE(subscriber.isInterested(frame));
+  frame.id = 0x18DAF101;
+  TEST_ASSERT_TRUE(subscriber.isInterested(frame));
+
+  // Чужой трафик не вытесняет ответ из очереди
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+  TEST_ASSERT_TRUE(iso_tp.add_rx_filter(0x7E8, 0x7F8));
+
+  const uint8_t noise[8] = {0};
+  for (uint32_t id = 0x100; id < 0x120; id++) {
+    mock_can.add_receive_frame(create_single_frame(id, 7, noise));
+  }
+  TEST_ASSERT_EQUAL_size_t(0, queued_frames(mock_can));
+
+  const uint8_t response[3] = {0x41, 0x0D, 0x3C};
+  mock_can.add_receive_frame(create_single_frame(0x7E8, sizeof(response), response));
+
+  uint8_t buffer[8]  = {0};
+  IsoTp::Message msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.receive(msg, sizeof(buffer)));
+  TEST_ASSERT_EQUAL_size_t(sizeof(response), msg.len);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(response, buffer, sizeof(response));
+}
+
+// Тест 2: 20 CF при буфере на 16 кадров - одно пробуждение на все сообщение
+void test_rx_assembly_single_wakeup() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[146];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(i * 3);
+  }
+
+  uint8_t buffer[160] = {0};
+  IsoTp::Message msg  = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+  receive_first_frame(mock_can, iso_tp, data, sizeof(data));
+  TEST_ASSERT_EQUAL_INT(1, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_HEX8(0x30, mock_can.transmitted_frames[0].data[0]);
+
+  // 6 + 20 * 7 = 146, SN проходит через 0
+  for (uint8_t sn = 1; sn <= 20; sn++) {
+    mock_can.add_receive_frame(create_consecutive_frame(0x7E8, sn, &data[6 + (sn - 1) * 7], 7));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(sn < 20 ? 0 : 1, pending_wakeups(), "Only the last CF wakes the task");
+  }
+  TEST_ASSERT_EQUAL_size_t(0, queued_frames(mock_can));
+
+  iso_tp.process(0);
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_INT(1, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buffer, sizeof(data));
+
+  const TransferStatsEntry* stats = iso_tp.transfer_stats().find(0x7E0, 0x7E8);
+  TEST_ASSERT_NOT_NULL(stats);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->received_ok);
+}
+
+// Тест 3: Конец блока BS будит задачу для отправки FC
+void test_rx_assembly_block_size() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  FlowControlParams params;
+  params.blocksize = 4;
+  TEST_ASSERT_TRUE(iso_tp.configure_flow_control(0x7E8, params, false));
+
+  uint8_t data[62];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(0xA0 + i);
+  }
+
+  uint8_t buffer[64] = {0};
+  IsoTp::Message msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+  receive_first_frame(mock_can, iso_tp, data, sizeof(data));
+  TEST_ASSERT_EQUAL_HEX8(0x04, mock_can.transmitted_frames[0].data[1]);
+
+  // 6 + 8 * 7 = 62: два блока по 4 CF
+  for (uint8_t sn = 1; sn <= 4; sn++) {
+    mock_can.add_receive_frame(create_consecutive_frame(0x7E8, sn, &data[6 + (sn - 1) * 7], 7));
+    TEST_ASSERT_EQUAL_UINT32(sn < 4 ? 0 : 1, pending_wakeups());
+  }
+  iso_tp.process(0);
+  TEST_ASSERT_EQUAL_UINT32(0, pending_wakeups());
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "FC after the first block");
+  TEST_ASSERT_EQUAL_HEX8(0x30, mock_can.transmitted_frames[1].data[0]);
+
+  for (uint8_t sn = 5; sn <= 8; sn++) {
+    mock_can.add_receive_frame(create_consecutive_frame(0x7E8, sn, &data[6 + (sn - 1) * 7], 7));
+  }
+  iso_tp.process(0);
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "No FC after the last CF");
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(data, buffer, sizeof(data));
+}
+
+// Тест 4: Пропуск CF в прерывании завершает прием с WRONG_SN
+void test_rx_assembly_wrong_sn() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[34] = {0};
+  uint8_t buffer[64];
+
+  struct Result {
+    bool done = false;
+    IsoTp::Result result;
+  } result;
+  auto on_complete = [](const IsoTp::Completion& completion, void* ctx) {
+    auto* r   = static_cast<Result*>(ctx);
+    r->done   = true;
+    r->result = completion.result;
+  };
+
+  IsoTp::Message msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &result));
+  receive_first_frame(mock_can, iso_tp, data, sizeof(data));
+
+  mock_can.add_receive_frame(create_consecutive_frame(0x7E8, 1, data, 7));
+  mock_can.add_receive_frame(create_consecutive_frame(0x7E8, 1, data, 7));  // Дубликат
+  mock_can.add_receive_frame(create_consecutive_frame(0x7E8, 3, data, 7));  // Пропущен SN 2
+  TEST_ASSERT_EQUAL_UINT32(1, pending_wakeups());
+  TEST_ASSERT_EQUAL_size_t(0, queued_frames(mock_can));
+
+  iso_tp.process(0);
+  TEST_ASSERT_TRUE(result.done);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::WRONG_SN), static_cast<int>(result.result));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+
+  const TransferStatsEntry* stats = iso_tp.transfer_stats().find(0x7E0, 0x7E8);
+  TEST_ASSERT_NOT_NULL(stats);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->duplicates);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->wrong_sn);
+}
+
+extern "C" void run_rx_assembly_tests() {
+  RUN_TEST(test_rx_assembly_filter);
+  RUN_TEST(test_rx_assembly_single_wakeup);
+  RUN_TEST(test_rx_assembly_block_size);
+  RUN_TEST(test_rx_assembly_wrong_sn);
+}
@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "twai_subscriber_iso_tp.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ МЕТОК ВРЕМЕНИ ПРИЕМА КАДРОВ
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ КАДРЫ:
+ * - Кадр получает метку в момент приема, готовая метка сохраняется до подписчика
+ *
+ * ✅ СООБЩЕНИЯ ISO-TP:
+ * - receive() и Completion сообщают время приема первого кадра (SF/FF)
+ *
+ * ✅ ТАЙМАУТЫ И СТАТИСТИКА:
+ * - N_Cr отсчитывается от приема FF, а не от его обработки задачей
+ * - Задержка ответа не включает время ожидания кадра в очереди
+ */
+
+namespace {
+
+const uint32_t kTimeoutCfMs = 500;  // N_Cr движка ISO-TP
+
+uint32_t now_us() {
+  return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+}  // namespace
+
+// Тест 1: Метка ставится при приеме и доходит до подписчика без изменений
+void test_rx_timestamp_frame_stamped() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  TwaiSubscriberIsoTp subscriber;
+  mock_can.RegisterSubscriber(subscriber);
+
+  const uint8_t data[3] = {0x41, 0x0D, 0x3C};
+  const uint32_t before = now_us();
+  mock_can.add_receive_frame(create_single_frame(0x7E8, sizeof(data), data));
+  const uint32_t after = now_us();
+
+  TwaiFrame frame = {};
+  TEST_ASSERT_TRUE(subscriber.Receive(frame, 0));
+  TEST_ASSERT_NOT_EQUAL_UINT32(0, frame.timestamp_us);
+  TEST_ASSERT_UINT32_WITHIN(after - before, before + (after - before) / 2, frame.timestamp_us);
+
+  TwaiFrame stamped    = create_single_frame(0x7E8, sizeof(data), data);
+  stamped.timestamp_us = 123456;
+  mock_can.add_receive_frame(stamped);
+  TEST_ASSERT_TRUE(subscriber.Receive(frame, 0));
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(123456, frame.timestamp_us, "Hardware timestamp is kept");
+}
+
+// Тест 2: Сообщение датируется первым кадром, а не последним CF
+void test_rx_timestamp_message_first_frame() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  // SF через блокирующий receive()
+  const uint8_t response[3] = {0x41, 0x0D, 0x3C};
+  TwaiFrame sf              = create_single_frame(0x7E8, sizeof(response), response);
+  sf.timestamp_us           = now_us() - 3000;
+  mock_can.add_receive_frame(sf);
+
+  uint8_t buffer[32] = {0};
+  IsoTp::Message msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.receive(msg, sizeof(buffer)));
+  TEST_ASSERT_EQUAL_UINT32(sf.timestamp_us, msg.timestamp_us);
+
+  // FF + CF: метка FF, хотя CF приняты позже
+  uint8_t data[20];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  CompletionLog log;
+  msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &log));
+
+  TwaiFrame ff    = create_first_frame(0x7E8, sizeof(data), data);
+  ff.timestamp_us = now_us() - 2000;
+  iso_tp.on_frame(ff);
+  TwaiFrame cf1    = create_consecutive_frame(0x7E8, 1, data + 6, 7);
+  cf1.timestamp_us = now_us() - 1000;
+  iso_tp.on_frame(cf1);
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 2, data + 13, 7));
+
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+  TEST_ASSERT_EQUAL_UINT32(ff.timestamp_us, log.last.timestamp_us);
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(data, buffer, sizeof(data));
+}
+
+// Тест 3: N_Cr отсчитывается от момента приема FF
+void test_rx_timestamp_cf_timeout_from_capture() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[6]    = {1, 2, 3, 4, 5, 6};
+  uint8_t buffer[32] = {0};
+
+  // FF обработан сразу: до N_Cr еще далеко
+  CompletionLog fresh;
+  IsoTp::Message msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &fresh));
+  iso_tp.on_frame(create_first_frame(0x7E8, 20, data));
+  iso_tp.poll(xTaskGetTickCount() + 100);
+  TEST_ASSERT_EQUAL_INT(0, fresh.calls);
+  iso_tp.abort(0x7E0, 0x7E8);
+
+  // FF пролежал в очереди 450 мс: на ожидание CF осталось 50 мс
+  CompletionLog delayed;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &delayed));
+  TwaiFrame ff    = create_first_frame(0x7E8, 20, data);
+  ff.timestamp_us = now_us() - (kTimeoutCfMs - 50) * 1000;
+  iso_tp.on_frame(ff);
+  TEST_ASSERT_EQUAL_INT(0, delayed.calls);
+
+  iso_tp.poll(xTaskGetTickCount() + 100);
+  TEST_ASSERT_EQUAL_INT(1, delayed.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TIMEOUT_CF), static_cast<int>(delayed.last.result));
+}
+
+// Тест 4: Задержка ответа измеряется до приема кадра, а не до его обработки
+void test_rx_timestamp_response_latency() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t buffer[8]  = {0};
+  IsoTp::Message msg = make_message(buffer, 0);
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer), on_complete, &log));
+
+  // Ответ принят через ~2 мс, задача обрабатывает его еще через 30 мс
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  const uint8_t response[3] = {0x41, 0x0D, 0x3C};
+  TwaiFrame sf              = create_single_frame(0x7E8, sizeof(response), response);
+  sf.timestamp_us           = now_us();
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  iso_tp.on_frame(sf);
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+
+  const TransferStatsEntry* stats = iso_tp.transfer_stats().find(0x7E0, 0x7E8);
+  TEST_ASSERT_NOT_NULL(stats);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->response.samples);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(2000, stats->response.max_us);
+  TEST_ASSERT_LESS_THAN_UINT32_MESSAGE(20000, stats->response.max_us, "Queueing delay is not response latency");
+}
+
+extern "C" void run_rx_timestamp_tests() {
+  RUN_TEST(test_rx_timestamp_frame_stamped);
+  RUN_TEST(test_rx_timestamp_message_first_frame);
+  RUN_TEST(test_rx_timestamp_cf_timeout_from_capture);
+  RUN_TEST(test_rx_timestamp_response_latency);
+}
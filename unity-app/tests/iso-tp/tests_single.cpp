@@ -94,22 +94,22 @@ void test_iso_tp_send_empty_frame() {
 
 // Тест 4: Обработка ошибки передачи
 void test_iso_tp_send_transmit_error() {
-  // Считаем что ошибки не может быть
-  // MockTwaiInterface mock_can;
-  // mock_can.reset();
-  // mock_can.transmit_result = IPhyInterface::TwaiError::TRANSMIT_FAILED;
-  // IsoTp iso_tp(mock_can);
-
-  // uint8_t test_data[] = {0x01, 0x02, 0x03};
-  // IsoTp::Message msg;
-  // msg.tx_id = 0x123;
-  // msg.rx_id = 0x456;
-  // msg.len   = sizeof(test_data);
-  // msg.data  = test_data;
-
-  // bool result = iso_tp.send(msg);
-
-  // TEST_ASSERT_FALSE_MESSAGE(result, "Send should fail when transmit fails");
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  mock_can.transmit_result = IPhyInterface::TwaiError::TRANSMIT_FAILED;
+  IsoTp iso_tp(mock_can);
+
+  uint8_t test_data[] = {0x01, 0x02, 0x03};
+  IsoTp::Message msg;
+  msg.tx_id = 0x123;
+  msg.rx_id = 0x456;
+  msg.len   = sizeof(test_data);
+  msg.data  = test_data;
+
+  bool result = iso_tp.send(msg);
+
+  TEST_ASSERT_FALSE_MESSAGE(result, "Send should fail when transmit fails");
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
 }
 
 // Тест 5: Отправка с различными CAN ID
@@ -201,7 +201,7 @@ void test_iso_tp_receive_single_frame_max() {
   TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(expected_data, msg.data, 7, "Received data should match");
 }
 
-// Тест 9: Приём пустого кадра
+// Тест 9: Пустой SF (SF_DL = 0) игнорируется по ISO 15765-2
 void test_iso_tp_receive_empty_frame() {
   MockTwaiInterface mock_can;
   mock_can.reset();
@@ -219,8 +219,8 @@ void test_iso_tp_receive_empty_frame() {
 
   bool result = iso_tp.receive(msg, sizeof(receive_buffer));
 
-  TEST_ASSERT_TRUE_MESSAGE(result, "Receive should succeed");
-  TEST_ASSERT_EQUAL_UINT16_MESSAGE(0, msg.len, "Received length should be 0");
+  TEST_ASSERT_FALSE_MESSAGE(result, "SF with SF_DL 0 must be ignored");
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
 }
 
 // Тест 10: Проверка корректности PCI байтов при различных размерах
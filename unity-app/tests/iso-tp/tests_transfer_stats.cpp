@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/task.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "transfer_stats.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ СТАТИСТИКИ ПЕРЕДАЧ ISO-TP
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ГИСТОГРАММА:
+ * - Распределение по корзинам, среднее и максимум
+ *
+ * ✅ СЧЕТЧИКИ ПО ПАРЕ АДРЕСОВ:
+ * - Успешные прием/отправка, задержка ответа, FF -> последний CF, ожидание FC
+ * - Дубликаты CF, пропуск CF, усечение ответа, таймауты по фазам, OVFLW
+ * - Пары адресов учитываются раздельно, сброс статистики
+ *
+ * ✅ ВЫВОД:
+ * - Вся статистика пары в одной строке
+ */
+
+// Тест 1: Гистограмма с фиксированными корзинами
+void test_transfer_stats_histogram() {
+  LatencyHistogram histogram;
+  histogram.add(500);     // <= 1 мс
+  histogram.add(1000);    // <= 1 мс
+  histogram.add(15000);   // <= 20 мс
+  histogram.add(250000);  // > 100 мс
+
+  TEST_ASSERT_EQUAL_UINT32(4, histogram.samples);
+  TEST_ASSERT_EQUAL_UINT32(2, histogram.counts[0]);
+  TEST_ASSERT_EQUAL_UINT32(1, histogram.counts[4]);
+  TEST_ASSERT_EQUAL_UINT32(1, histogram.counts[LatencyHistogram::BUCKETS - 1]);
+  TEST_ASSERT_EQUAL_UINT32(250000, histogram.max_us);
+  TEST_ASSERT_EQUAL_UINT32(66625, histogram.average_us());
+}
+
+// Тест 2: Успешный многокадровый прием и отправка
+void test_transfer_stats_success_paths() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[20] = {0};
+  uint8_t buffer[32];
+  IsoTp::Message rx_msg = make_message(buffer, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(rx_msg, sizeof(buffer)));
+  iso_tp.on_frame(create_first_frame(0x7E8, 20, data));
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 1, data, 7));
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 1, data, 7));  // Дубликат
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 2, data, 7));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+
+  IsoTp::Message tx_msg = make_message(data, sizeof(data));
+  TEST_ASSERT_TRUE(iso_tp.start_send(tx_msg));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+  iso_tp.poll(0);
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+
+  const TransferStatsEntry* stats = iso_tp.transfer_stats().find(0x7E0, 0x7E8);
+  TEST_ASSERT_NOT_NULL(stats);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->received_ok);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->sent_ok);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->duplicates);
+  TEST_ASSERT_EQUAL_UINT32(1, stats->response.samples);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(2, stats->transfer.samples, "FF -> last CF for RX and TX");
+  TEST_ASSERT_EQUAL_UINT32(1, stats->fc_wait.samples);
+  TEST_ASSERT_EQUAL_UINT32(0, stats->wrong_sn);
+}
+
+// Тест 3: Ошибки по фазам учитываются для своей пары адресов
+void test_transfer_stats_errors_per_pair() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[20] = {0};
+  uint8_t small[4];
+
+  // Пропуск CF на 7E8
+  IsoTp::Message engine = make_message(small, 0);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(engine, sizeof(small)));
+  iso_tp.on_frame(create_first_frame(0x7E8, 13, data));
+  iso_tp.on_frame(create_consecutive_frame(0x7E8, 3, data, 7));
+
+  // Усечение ответа и таймаут ответа на 7E9
+  IsoTp::Message gearbox = make_message(small, 0, 0x7E1, 0x7E9);
+  TEST_ASSERT_TRUE(iso_tp.start_receive(gearbox, sizeof(small)));
+  iso_tp.on_frame(create_single_frame(0x7E9, 7, data));
+  TEST_ASSERT_TRUE(iso_tp.start_receive(gearbox, sizeof(small)));
+  iso_tp.poll(xTaskGetTickCount() + 3000);
+
+  // OVFLW и таймаут FC при отправке на 7E9
+  IsoTp::Message request = make_message(data, sizeof(data), 0x7E1, 0x7E9);
+  TEST_ASSERT_TRUE(iso_tp.start_send(request));
+  iso_tp.on_frame(create_flow_control_frame(0x7E9, 2, 0, 0));
+  TEST_ASSERT_TRUE(iso_tp.start_send(request));
+  iso_tp.poll(xTaskGetTickCount() + 1000);
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+
+  const TransferStatsEntry* engine_stats  = iso_tp.transfer_stats().find(0x7E0, 0x7E8);
+  const TransferStatsEntry* gearbox_stats = iso_tp.transfer_stats().find(0x7E1, 0x7E9);
+  TEST_ASSERT_NOT_NULL(engine_stats);
+  TEST_ASSERT_NOT_NULL(gearbox_stats);
+
+  TEST_ASSERT_EQUAL_UINT32(1, engine_stats->wrong_sn);
+  TEST_ASSERT_EQUAL_UINT32(1, engine_stats->truncations);
+  TEST_ASSERT_EQUAL_UINT32(0, engine_stats->timeout_session);
+
+  TEST_ASSERT_EQUAL_UINT32(1, gearbox_stats->received_ok);
+  TEST_ASSERT_EQUAL_UINT32(1, gearbox_stats->truncations);
+  TEST_ASSERT_EQUAL_UINT32(1, gearbox_stats->timeout_session);
+  TEST_ASSERT_EQUAL_UINT32(1, gearbox_stats->overflow);
+  TEST_ASSERT_EQUAL_UINT32(1, gearbox_stats->timeout_fc);
+  TEST_ASSERT_EQUAL_UINT32(0, gearbox_stats->wrong_sn);
+
+  iso_tp.reset_transfer_stats();
+  TEST_ASSERT_NULL(iso_tp.transfer_stats().find(0x7E0, 0x7E8));
+}
+
+// Тест 4: Статистика пары в одну строку
+void test_transfer_stats_format_one_line() {
+  TransferStatsEntry entry;
+  entry.tx_id       = 0x7E0;
+  entry.rx_id       = 0x7E8;
+  entry.received_ok = 12;
+  entry.timeout_cf  = 2;
+  entry.response.add(8000);
+  entry.response.add(12000);
+
+  char line[384];
+  const int len = TransferStats::format(entry, line, sizeof(line));
+  TEST_ASSERT_GREATER_THAN(0, len);
+  TEST_ASSERT_LESS_THAN(static_cast<int>(sizeof(line)), len);
+  TEST_ASSERT_NULL(strchr(line, '\n'));
+  TEST_ASSERT_NOT_NULL(strstr(line, "7E0/7E8"));
+  TEST_ASSERT_NOT_NULL(strstr(line, "rx=12"));
+  TEST_ASSERT_NOT_NULL(strstr(line, "cf=2"));
+  TEST_ASSERT_NOT_NULL(strstr(line, "resp[n=2 avg=10000us max=12000us 0/0/0/1/1/0/0/0]"));
+
+  // Короткий буфер обрезается без выхода за границу
+  char short_line[16];
+  TransferStats::format(entry, short_line, sizeof(short_line));
+  TEST_ASSERT_EQUAL_size_t(15, strlen(short_line));
+}
+
+extern "C" void run_transfer_stats_tests() {
+  RUN_TEST(test_transfer_stats_histogram);
+  RUN_TEST(test_transfer_stats_success_paths);
+  RUN_TEST(test_transfer_stats_errors_per_pair);
+  RUN_TEST(test_transfer_stats_format_one_line);
+}
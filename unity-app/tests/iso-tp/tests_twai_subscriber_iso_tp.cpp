@@ -13,13 +13,14 @@
  * ПОКРЫТИЕ ТЕСТАМИ:
  *
  * ✅ ФУНКЦИОНАЛЬНОСТЬ:
- * - isInterested всегда возвращает true
- * - onTwaiMessage помещает сообщение в очередь
- * - Receive читает из очереди
- * - Обработка ошибок (неинициализированная очередь, переполнение, таймаут)
+ * - isInterested без фильтров rx ID возвращает true для любого кадра
+ * - onTwaiMessage возвращает буфер кадров, Receive читает из него
+ * - Пробуждение без кадра
+ * - Обработка ошибок (переполнение с подсчетом потерь, таймаут)
+ * - Читатель задается при создании, уведомление приходит в отдельный индекс
  */
 
-// Тест 1: Проверка, что isInterested всегда возвращает true
+// Тест 1: Проверка, что isInterested без фильтров возвращает true
 void test_twai_subscriber_iso_tp_is_interested() {
   TwaiSubscriberIsoTp subscriber;
 
@@ -42,7 +43,7 @@ void test_twai_subscriber_iso_tp_is_interested() {
   TEST_ASSERT_TRUE_MESSAGE(subscriber.isInterested(frame3), "isInterested должен возвращать true для RTR фрейма");
 }
 
-// Тест 2: Проверка, что onTwaiMessage возвращает очередь
+// Тест 2: Проверка, что onTwaiMessage возвращает буфер кадров
 void test_twai_subscriber_iso_tp_on_twai_message() {
   TwaiSubscriberIsoTp subscriber;
 
@@ -55,69 +56,95 @@ void test_twai_subscriber_iso_tp_on_twai_message() {
   send_frame.data[2]     = 0x03;
   send_frame.data[3]     = 0x04;
 
-  // Получаем очередь от подписчика
-  QueueHandle_t queue = subscriber.onTwaiMessage();
-  TEST_ASSERT_NOT_NULL_MESSAGE(queue, "onTwaiMessage должен вернуть валидную очередь");
+  // Получаем буфер от подписчика
+  TwaiRxRing* ring = subscriber.onTwaiMessage();
+  TEST_ASSERT_NOT_NULL_MESSAGE(ring, "onTwaiMessage должен вернуть валидный буфер");
 
-  // Помещаем фрейм в очередь
-  bool result = (xQueueSend(queue, &send_frame, 0) == pdTRUE);
-  TEST_ASSERT_TRUE_MESSAGE(result, "Фрейм должен быть успешно помещен в очередь");
+  // Помещаем фрейм в буфер, как прерывание драйвера
+  bool need_yield = false;
+  bool result     = ring->PushFromISR(send_frame, need_yield);
+  TEST_ASSERT_TRUE_MESSAGE(result, "Фрейм должен быть успешно помещен в буфер");
 
   // Получаем фрейм
   TwaiFrame receive_frame = {};
   result                  = subscriber.Receive(receive_frame, 0);
 
   // Проверяем, что фрейм получен корректно
-  TEST_ASSERT_TRUE_MESSAGE(result, "Receive должен успешно получить фрейм из очереди");
+  TEST_ASSERT_TRUE_MESSAGE(result, "Receive должен успешно получить фрейм из буфера");
   TEST_ASSERT_EQUAL_UINT32_MESSAGE(send_frame.id, receive_frame.id, "ID фрейма должен совпадать");
   TEST_ASSERT_EQUAL_UINT8_MESSAGE(send_frame.data_length, receive_frame.data_length, "Длина данных должна совпадать");
   TEST_ASSERT_EQUAL_UINT8_ARRAY_MESSAGE(
       send_frame.data, receive_frame.data, send_frame.data_length, "Данные должны совпадать");
 }
 
-// Тест 3: Проверка таймаута при чтении из пустой очереди
+// Тест 3: Проверка таймаута при чтении из пустого буфера и пробуждения без кадра
 void test_twai_subscriber_iso_tp_receive_timeout() {
   TwaiSubscriberIsoTp subscriber;
 
-  // Пытаемся получить фрейм из пустой очереди с нулевым таймаутом
+  // Пытаемся получить фрейм из пустого буфера с нулевым таймаутом
   TwaiFrame frame = {};
   bool result     = subscriber.Receive(frame, 0);
 
   // Проверяем, что получен таймаут
   TEST_ASSERT_FALSE_MESSAGE(result, "Receive должен вернуть false при таймауте");
+
+  // Пробуждение без кадра не выдает кадр и не остается в буфере
+  subscriber.Wake();
+  TEST_ASSERT_FALSE(subscriber.Receive(frame, 10));
+  TEST_ASSERT_TRUE(subscriber.onTwaiMessage()->Empty());
 }
 
-// Тест 4: Проверка переполнения очереди
+// Тест 4: Проверка переполнения буфера
 void test_twai_subscriber_iso_tp_queue_overflow() {
-  // Создаем подписчика с очередью минимального размера
-  TwaiSubscriberIsoTp subscriber(1);
-
-  // Создаем тестовые фреймы
-  TwaiFrame frame1 = {};
-  frame1.id        = 0x123;
-
-  TwaiFrame frame2 = {};
-  frame2.id        = 0x456;
-
-  // Получаем очередь от подписчика
-  QueueHandle_t queue = subscriber.onTwaiMessage();
-  TEST_ASSERT_NOT_NULL_MESSAGE(queue, "onTwaiMessage должен вернуть валидную очередь");
-
-  // Отправляем первый фрейм
-  bool result1 = (xQueueSend(queue, &frame1, 0) == pdTRUE);
-  TEST_ASSERT_TRUE_MESSAGE(result1, "Первый фрейм должен быть успешно помещен в очередь");
+  TwaiSubscriberIsoTp subscriber;
 
-  // Отправляем второй фрейм, который должен вызвать переполнение
-  bool result2 = (xQueueSend(queue, &frame2, 0) == pdTRUE);
-  TEST_ASSERT_FALSE_MESSAGE(result2, "Второй фрейм должен вызвать переполнение очереди");
+  // Получаем буфер от подписчика
+  TwaiRxRing* ring = subscriber.onTwaiMessage();
+  TEST_ASSERT_NOT_NULL_MESSAGE(ring, "onTwaiMessage должен вернуть валидный буфер");
 
-  // Получаем фрейм из очереди
+  // Заполняем буфер целиком
+  bool need_yield = false;
+  TwaiFrame frame = {};
+  for (size_t i = 0; i < TwaiRxRing::kCapacity; i++) {
+    frame.id = 0x100 + i;
+    TEST_ASSERT_TRUE_MESSAGE(ring->PushFromISR(frame, need_yield), "Фрейм должен быть помещен в буфер");
+  }
+
+  // Следующий фрейм отбрасывается и учитывается, принятые раньше сохраняются
+  frame.id = 0x456;
+  TEST_ASSERT_FALSE_MESSAGE(ring->PushFromISR(frame, need_yield), "Фрейм должен вызвать переполнение буфера");
+  TEST_ASSERT_EQUAL_UINT32(1, ring->GetDropCount());
+  TEST_ASSERT_EQUAL_size_t(TwaiRxRing::kCapacity, ring->Size());
+
+  // Получаем фрейм из буфера
   TwaiFrame receive_frame = {};
   bool receive_result     = subscriber.Receive(receive_frame, 0);
 
   // Проверяем, что получен первый фрейм
-  TEST_ASSERT_TRUE_MESSAGE(receive_result, "Receive должен успешно получить фрейм из очереди");
-  TEST_ASSERT_EQUAL_UINT32_MESSAGE(frame1.id, receive_frame.id, "ID фрейма должен совпадать с первым фреймом");
+  TEST_ASSERT_TRUE_MESSAGE(receive_result, "Receive должен успешно получить фрейм из буфера");
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0x100, receive_frame.id, "ID фрейма должен совпадать с первым фреймом");
+}
+
+// Тест 5: Уведомление получает заданная задача в индексе kNotifyIndex
+void test_twai_subscriber_iso_tp_consumer_notify_index() {
+  MockTask* const task = xTaskGetCurrentTaskHandle();
+  ulTaskNotifyValueClearIndexed(task, TwaiRxRing::kNotifyIndex, UINT32_MAX);
+  const uint32_t index0_before = ulTaskNotifyValueClear(task, 0);
+
+  // Без читателя кадры только опрашиваются: Receive() не назначает читателя сам
+  TwaiSubscriberIsoTp polled;
+  TwaiFrame frame = {};
+  TEST_ASSERT_FALSE(polled.Receive(frame, 0));
+  bool need_yield = false;
+  TEST_ASSERT_TRUE(polled.onTwaiMessage()->PushFromISR(frame, need_yield));
+  TEST_ASSERT_FALSE(need_yield);
+  TEST_ASSERT_EQUAL_UINT32(0, ulTaskNotifyValueClearIndexed(task, TwaiRxRing::kNotifyIndex, 0));
+
+  TwaiSubscriberIsoTp subscriber(task);
+  TEST_ASSERT_TRUE(subscriber.onTwaiMessage()->PushFromISR(frame, need_yield));
+  TEST_ASSERT_TRUE(need_yield);
+  TEST_ASSERT_EQUAL_UINT32(1, ulTaskNotifyValueClearIndexed(task, TwaiRxRing::kNotifyIndex, UINT32_MAX));
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(index0_before, ulTaskNotifyValueClear(task, 0), "Index 0 is left to other code");
 }
 
 // Функция запуска всех тестов
@@ -127,4 +154,5 @@ extern "C" void run_twai_subscriber_iso_tp_tests() {
   RUN_TEST(test_twai_subscriber_iso_tp_on_twai_message);
   RUN_TEST(test_twai_subscriber_iso_tp_receive_timeout);
   RUN_TEST(test_twai_subscriber_iso_tp_queue_overflow);
+  RUN_TEST(test_twai_subscriber_iso_tp_consumer_notify_index);
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "freertos/task.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ПАКЕТНОЙ ПЕРЕДАЧИ КАДРОВ (TransmitBatch)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ИНТЕРФЕЙС:
+ * - Реализация по умолчанию передает кадры по одному через Transmit()
+ * - Ошибка очереди: queued сообщает, сколько первых кадров принято
+ *
+ * ✅ ОТПРАВКА CF:
+ * - При STmin = 0 свободная часть окна передачи уходит одной пачкой
+ * - Пачка не выходит за границу блока BS, при STmin > 0 CF идут по одному
+ */
+
+namespace {
+
+// Данные сообщения: номер байта
+void fill_data(uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+}
+
+// Порядковые номера CF в переданных кадрах начиная с first
+void assert_cf_sequence(const MockTwaiInterface& mock_can, size_t first) {
+  for (size_t i = first; i < mock_can.transmitted_frames.size(); i++) {
+    const uint8_t pci = mock_can.transmitted_frames[i].data[0];
+    TEST_ASSERT_EQUAL_HEX8(0x20, pci & 0xF0);
+    TEST_ASSERT_EQUAL_UINT8((i - first + 1) & 0x0F, pci & 0x0F);
+  }
+}
+
+}  // namespace
+
+// Тест 1: Реализация по умолчанию и ошибка очереди
+void test_tx_batch_interface() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+
+  const TwaiFrame frames[3] = {make_frame(0x100, {1}), make_frame(0x101, {2}), make_frame(0x102, {3})};
+  size_t queued             = 0;
+
+  // Базовая реализация: три вызова Transmit(), пачка не регистрируется
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK,
+                    mock_can.IPhyInterface::TransmitBatch(Span<const TwaiFrame>(frames), 0, queued));
+  TEST_ASSERT_EQUAL_size_t(3, queued);
+  TEST_ASSERT_EQUAL_size_t(3, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_size_t(0, mock_can.transmitted_batches.size());
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT_EQUAL_HEX32(frames[i].id, mock_can.transmitted_frames[i].id);
+  }
+
+  // Мок записывает пачку целиком
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK, mock_can.TransmitBatch(Span<const TwaiFrame>(frames), 0, queued));
+  TEST_ASSERT_EQUAL_size_t(3, queued);
+  TEST_ASSERT_EQUAL_size_t(1, mock_can.transmitted_batches.size());
+  TEST_ASSERT_EQUAL_size_t(3, mock_can.transmitted_batches[0]);
+
+  mock_can.transmit_result = IPhyInterface::TwaiError::TIMEOUT;
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::TIMEOUT,
+                    mock_can.TransmitBatch(Span<const TwaiFrame>(frames), 0, queued));
+  TEST_ASSERT_EQUAL_size_t(0, queued);
+}
+
+// Тест 2: Окно передачи заполняется пачками
+void test_tx_batch_iso_tp_fills_window() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  mock_can.auto_tx_done = false;
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[50];
+  fill_data(data, sizeof(data));
+  IsoTp::Message msg = make_message(data, sizeof(data));  // FF + 7 CF
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  mock_can.complete_tx();
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+
+  const uint32_t now = xTaskGetTickCount();
+  iso_tp.poll(now);
+  TEST_ASSERT_EQUAL_size_t(1, mock_can.transmitted_batches.size());
+  TEST_ASSERT_EQUAL_size_t_MESSAGE(3, mock_can.transmitted_batches[0], "Whole TX window in one batch");
+
+  // Пока кадры в полете, новых пачек нет
+  iso_tp.poll(now);
+  TEST_ASSERT_EQUAL_size_t(1, mock_can.transmitted_batches.size());
+
+  mock_can.complete_tx(2);
+  iso_tp.poll(now);
+  TEST_ASSERT_EQUAL_size_t(2, mock_can.transmitted_batches.size());
+  TEST_ASSERT_EQUAL_size_t_MESSAGE(2, mock_can.transmitted_batches[1], "Only the freed part of the window");
+
+  mock_can.complete_tx();
+  iso_tp.poll(now);
+  TEST_ASSERT_EQUAL_size_t(3, mock_can.transmitted_batches.size());
+  TEST_ASSERT_EQUAL_size_t_MESSAGE(2, mock_can.transmitted_batches[2], "Last CF of the message");
+
+  TEST_ASSERT_EQUAL_size_t(8, mock_can.transmitted_frames.size());
+  assert_cf_sequence(mock_can, 1);
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+}
+
+// Тест 3: Граница блока BS и STmin ограничивают пачку
+void test_tx_batch_iso_tp_block_and_stmin() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[50];
+  fill_data(data, sizeof(data));
+  IsoTp::Message msg = make_message(data, sizeof(data));
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+
+  // BS = 2: пачка из двух CF, затем ожидание FC
+  const uint32_t now = xTaskGetTickCount();
+  while (log.calls == 0 && mock_can.transmitted_batches.size() < 10) {
+    iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 2, 0));
+    iso_tp.poll(now);
+  }
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+  TEST_ASSERT_EQUAL_size_t(4, mock_can.transmitted_batches.size());
+  const size_t expected_blocks[4] = {2, 2, 2, 1};
+  for (size_t i = 0; i < 4; i++) {
+    TEST_ASSERT_EQUAL_size_t(expected_blocks[i], mock_can.transmitted_batches[i]);
+  }
+  assert_cf_sequence(mock_can, 1);
+
+  // STmin = 1 мс: CF по одному, следующий по дедлайну паузы
+  mock_can.transmitted_frames.clear();
+  mock_can.transmitted_batches.clear();
+  log = CompletionLog();
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 1));
+
+  const uint32_t start = xTaskGetTickCount();
+  while (log.calls == 0 && xTaskGetTickCount() - start < 1000) {
+    iso_tp.process(1);
+  }
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+  TEST_ASSERT_EQUAL_size_t(7, mock_can.transmitted_batches.size());
+  for (size_t i = 0; i < mock_can.transmitted_batches.size(); i++) {
+    TEST_ASSERT_EQUAL_size_t(1, mock_can.transmitted_batches[i]);
+  }
+  TEST_ASSERT_EQUAL_size_t(8, mock_can.transmitted_frames.size());
+  assert_cf_sequence(mock_can, 1);
+}
+
+extern "C" void run_tx_batch_tests() {
+  RUN_TEST(test_tx_batch_interface);
+  RUN_TEST(test_tx_batch_iso_tp_fills_window);
+  RUN_TEST(test_tx_batch_iso_tp_block_and_stmin);
+}
@@ -0,0 +1,144 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <thread>
+
+#include "freertos/task.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "tx_pacer.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ТЕМПА ОТПРАВКИ CF (STmin в микросекундах, окно передачи)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ STmin:
+ * - 100us - 900us выдерживаются по микросекундным часам без занятого ожидания
+ *
+ * ✅ ОКНО ПЕРЕДАЧИ:
+ * - При STmin = 0 в драйвере не больше TX_WINDOW кадров, следующий CF - по TX done
+ * - Пока окно занято, next_timeout() не требует холостых пробуждений
+ * - Отсутствие TX done завершает передачу с TIMEOUT_TX (N_As)
+ *
+ * ✅ TxPacer:
+ * - Таймер взводится на ближайший дедлайн
+ */
+
+// Тест 1: STmin 500us выдерживается без округления до миллисекунды
+void test_iso_tp_pacing_stmin_microseconds() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  uint8_t test_data[27] = {0};
+  IsoTp::Message msg    = make_message(test_data, sizeof(test_data));  // FF + 3 CF
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0xF5));
+
+  iso_tp.poll(xTaskGetTickCount());
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "First CF right after FC");
+
+  iso_tp.poll(xTaskGetTickCount());
+  TEST_ASSERT_EQUAL_INT_MESSAGE(2, mock_can.transmitted_frames.size(), "Second CF waits STmin");
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(1, iso_tp.next_timeout(xTaskGetTickCount()));
+
+  for (size_t expected = 3; expected <= 4; expected++) {
+    std::this_thread::sleep_for(std::chrono::microseconds(600));
+    iso_tp.poll(xTaskGetTickCount());
+    TEST_ASSERT_EQUAL_INT(expected, mock_can.transmitted_frames.size());
+  }
+
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+}
+
+// Тест 2: При STmin = 0 CF отправляются по мере завершения передачи
+void test_iso_tp_pacing_tx_window_backpressure() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  mock_can.auto_tx_done = false;
+  IsoTp iso_tp(mock_can);
+
+  uint8_t test_data[48] = {0};
+  IsoTp::Message msg    = make_message(test_data, sizeof(test_data));  // FF + 6 CF
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+
+  const uint32_t now = xTaskGetTickCount();
+  iso_tp.poll(now);
+  // FF еще не подтвержден и занимает одно место в окне
+  TEST_ASSERT_EQUAL_INT_MESSAGE(3, mock_can.transmitted_frames.size(), "FF + 2 CF in TX window");
+  TEST_ASSERT_NOT_EQUAL_MESSAGE(0, iso_tp.next_timeout(now), "No busy loop while window is full");
+
+  mock_can.complete_tx(1);
+  iso_tp.poll(now);
+  TEST_ASSERT_EQUAL_INT(4, mock_can.transmitted_frames.size());
+
+  while (log.calls == 0 && !mock_can.pending_tx_done.empty()) {
+    mock_can.complete_tx();
+    iso_tp.poll(now);
+  }
+  TEST_ASSERT_EQUAL_INT(7, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+}
+
+// Тест 3: Кадры не покидают контроллер - TIMEOUT_TX
+void test_iso_tp_pacing_tx_timeout() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  mock_can.auto_tx_done = false;
+  IsoTp iso_tp(mock_can);
+
+  uint8_t test_data[48] = {0};
+  IsoTp::Message msg    = make_message(test_data, sizeof(test_data));
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+
+  const uint32_t now = xTaskGetTickCount();
+  iso_tp.poll(now);
+  iso_tp.poll(now + 500);
+  TEST_ASSERT_EQUAL_INT(0, log.calls);
+
+  iso_tp.poll(now + 1500);
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TIMEOUT_TX), static_cast<int>(log.last.result));
+  TEST_ASSERT_FALSE(iso_tp.is_busy());
+}
+
+// Тест 4: TxPacer держит таймер на ближайшем дедлайне
+void test_tx_pacer_schedule_earliest() {
+  int wakeups = 0;
+  TxPacer pacer([](void* ctx) { (*static_cast<int*>(ctx))++; }, &wakeups);
+
+  TEST_ASSERT_FALSE(pacer.is_armed());
+  const uint32_t now = TxPacer::now_us();
+  pacer.schedule(now + 5000);
+  TEST_ASSERT_TRUE(pacer.is_armed());
+
+  pacer.schedule(now + 9000);  // Позже уже взведенного - без изменений
+  pacer.schedule(now + 1000);
+  TEST_ASSERT_TRUE(pacer.is_armed());
+
+  pacer.cancel();
+  TEST_ASSERT_FALSE(pacer.is_armed());
+  TEST_ASSERT_EQUAL_INT(0, wakeups);
+}
+
+extern "C" void run_tx_pacing_tests() {
+  RUN_TEST(test_iso_tp_pacing_stmin_microseconds);
+  RUN_TEST(test_iso_tp_pacing_tx_window_backpressure);
+  RUN_TEST(test_iso_tp_pacing_tx_timeout);
+  RUN_TEST(test_tx_pacer_schedule_earliest);
+}
@@ -0,0 +1,279 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "heap_watermark.h"
+#include "iso_tp.h"
+#include "obd2.h"
+#include "twai_tx_queue.h"
+#include "unity.h"
+
+#if defined(__SANITIZE_ADDRESS__)
+// Интерфейс аллокатора санитайзера (sanitizer/allocator_interface.h есть не у всех компиляторов)
+extern "C" int __sanitizer_install_malloc_and_free_hooks(void (*malloc_hook)(const volatile void*, size_t),
+                                                         void (*free_hook)(const volatile void*));
+#endif
+
+// ============================================================================
+// ТЕСТЫ РАБОТЫ БЕЗ КУЧИ В УСТАНОВИВШЕМСЯ РЕЖИМЕ
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ HEAPWATERMARK:
+ * - До Arm() отчет пустой, выделения и снижение минимума нарушают установившийся режим
+ * - Счетчики с переполнением
+ * - Хуки по задаче: общий минимум не нарушает режим; известное выделение сдвигает точку отсчета
+ *
+ * ✅ БЕЗ ВЫДЕЛЕНИЙ (хуки аллокатора AddressSanitizer):
+ * - Очередь передачи создается в памяти объекта, постановка и извлечение без кучи
+ * - Опрос PID через OBD2 и ISO-TP после первого запроса не обращается к куче
+ */
+
+namespace {
+
+std::atomic_uint32_t g_allocations{0};
+std::atomic_uint32_t g_frees{0};
+
+#if defined(__SANITIZE_ADDRESS__)
+void count_alloc(const volatile void* /*ptr*/, size_t /*size*/) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void count_free(const volatile void* /*ptr*/) {
+  g_frees.fetch_add(1, std::memory_order_relaxed);
+}
+#endif
+
+// Хуки ставятся один раз на весь процесс; false если аллокатор их не поддерживает
+bool install_heap_hooks() {
+#if defined(__SANITIZE_ADDRESS__)
+  static const bool installed = __sanitizer_install_malloc_and_free_hooks(count_alloc, count_free) != 0;
+  return installed;
+#else
+  return false;
+#endif
+}
+
+HeapWatermark::Snapshot take_snapshot() {
+  HeapWatermark::Snapshot snapshot;
+  snapshot.allocations = g_allocations.load(std::memory_order_relaxed);
+  snapshot.frees       = g_frees.load(std::memory_order_relaxed);
+  return snapshot;
+}
+
+// ЭБУ на фиксированных массивах: отвечает на каждый запрос сервиса 01 одиночным кадром
+class EcuLoopback final : public IPhyInterface {
+ public:
+  void InstallStart() override {}
+
+  TwaiError Transmit(const TwaiFrame& message, Time_ms /*timeout_ms*/) override {
+    if (subscriber_ == nullptr) {
+      return TwaiError::OK;
+    }
+    subscriber_->onTwaiTxDone(message, true);
+    requests_++;
+
+    if (message.id != 0x7DF || message.data[1] != 0x01) {
+      return TwaiError::OK;
+    }
+    TwaiFrame response   = {};
+    response.id          = 0x7E8;
+    response.data_length = 8;
+    response.data[0]     = 0x06;
+    response.data[1]     = 0x41;
+    response.data[2]     = message.data[2];
+    memset(&response.data[3], 0xFF, 4);  // Все PID поддерживаются, значения максимальные
+    response.timestamp_us = static_cast<uint32_t>(esp_timer_get_time());
+
+    // Как DispatchMessage драйвера
+    if (subscriber_->isInterested(response)) {
+      bool need_yield = false;
+      if (!subscriber_->onTwaiFrameFromISR(response, need_yield)) {
+        TwaiRxRing* ring = subscriber_->onTwaiMessage();
+        if (ring != nullptr) {
+          ring->PushFromISR(response, need_yield);
+        }
+      }
+    }
+    return TwaiError::OK;
+  }
+
+  void RegisterSubscriber(ITwaiSubscriber& subscriber) override {
+    subscriber_ = &subscriber;
+  }
+
+  void UnRegisterSubscriber(ITwaiSubscriber& subscriber) override {
+    if (subscriber_ == &subscriber) {
+      subscriber_ = nullptr;
+    }
+  }
+
+  uint32_t requests() const {
+    return requests_;
+  }
+
+ private:
+  ITwaiSubscriber* subscriber_ = nullptr;
+  uint32_t requests_           = 0;
+};
+
+}  // namespace
+
+// Тест 1: Отчет HeapWatermark
+void test_heap_watermark_report() {
+  HeapWatermark watermark;
+  HeapWatermark::Snapshot snapshot;
+  snapshot.allocations    = 100;
+  snapshot.frees          = 90;
+  snapshot.free_bytes     = 50000;
+  snapshot.min_free_bytes = 40000;
+
+  // До Arm() нарушений нет
+  TEST_ASSERT_FALSE(watermark.IsArmed());
+  TEST_ASSERT_TRUE(watermark.Check(snapshot).steady);
+
+  watermark.Arm(snapshot);
+  TEST_ASSERT_TRUE(watermark.IsArmed());
+  HeapWatermark::Report report = watermark.Check(snapshot);
+  TEST_ASSERT_TRUE(report.steady);
+  TEST_ASSERT_EQUAL_UINT32(0, report.allocations);
+  TEST_ASSERT_EQUAL_INT32(0, report.free_delta);
+
+  // Освобождение памяти, выделенной до Arm(), допустимо
+  snapshot.frees      = 91;
+  snapshot.free_bytes = 50100;
+  report              = watermark.Check(snapshot);
+  TEST_ASSERT_TRUE(report.steady);
+  TEST_ASSERT_EQUAL_UINT32(1, report.frees);
+  TEST_ASSERT_EQUAL_INT32(100, report.free_delta);
+
+  // Выделение и снижение минимума
+  snapshot.allocations = 101;
+  snapshot.free_bytes  = 49900;
+  report               = watermark.Check(snapshot);
+  TEST_ASSERT_FALSE(report.steady);
+  TEST_ASSERT_EQUAL_UINT32(1, report.allocations);
+  TEST_ASSERT_EQUAL_INT32(-100, report.free_delta);
+
+  snapshot.allocations    = 100;
+  snapshot.min_free_bytes = 39999;
+  report                  = watermark.Check(snapshot);
+  TEST_ASSERT_FALSE(report.steady);
+  TEST_ASSERT_EQUAL_size_t(39999, report.min_free_bytes);
+}
+
+// Тест 2: Счетчики с переполнением
+void test_heap_watermark_counter_wrap() {
+  HeapWatermark watermark;
+  HeapWatermark::Snapshot snapshot;
+  snapshot.allocations = UINT32_MAX - 1;
+  snapshot.frees       = UINT32_MAX;
+  watermark.Arm(snapshot);
+
+  snapshot.allocations               = 1;
+  snapshot.frees                     = 2;
+  const HeapWatermark::Report report = watermark.Check(snapshot);
+  TEST_ASSERT_EQUAL_UINT32(3, report.allocations);
+  TEST_ASSERT_EQUAL_UINT32(3, report.frees);
+  TEST_ASSERT_FALSE(report.steady);
+}
+
+// Тест 2a: Выделения считает хук контролируемой задачи, известное выделение принимается
+void test_heap_watermark_task_hooks_and_accept() {
+  HeapWatermark::Snapshot snapshot;
+  snapshot.free_bytes     = 50000;
+  snapshot.min_free_bytes = 40000;
+
+  // Минимум снизили другие задачи: по хукам задача кучу не трогала
+  HeapWatermark hooked;
+  hooked.Arm(snapshot, true);
+  snapshot.min_free_bytes = 30000;
+  TEST_ASSERT_TRUE(hooked.Check(snapshot).steady);
+  snapshot.allocations = 1;
+  TEST_ASSERT_FALSE(hooked.Check(snapshot).steady);
+
+  // Без хуков запись в NVS снижает минимум; после Accept() режим снова установившийся
+  HeapWatermark watermark;
+  snapshot                = HeapWatermark::Snapshot();
+  snapshot.free_bytes     = 50000;
+  snapshot.min_free_bytes = 40000;
+  watermark.Arm(snapshot);
+  snapshot.free_bytes     = 49000;
+  snapshot.min_free_bytes = 38000;
+  TEST_ASSERT_FALSE(watermark.Check(snapshot).steady);
+  watermark.Accept(snapshot);
+  const HeapWatermark::Report report = watermark.Check(snapshot);
+  TEST_ASSERT_TRUE(report.steady);
+  TEST_ASSERT_EQUAL_INT32(0, report.free_delta);
+  snapshot.min_free_bytes = 37999;
+  TEST_ASSERT_FALSE(watermark.Check(snapshot).steady);
+}
+
+// Тест 3: Очередь передачи без кучи
+void test_heap_watermark_tx_queue_static() {
+  if (!install_heap_hooks()) {
+    TEST_IGNORE_MESSAGE("Allocator hooks require AddressSanitizer");
+  }
+
+  HeapWatermark watermark;
+  TwaiTxQueue queue;
+  watermark.Arm(take_snapshot());
+
+  TEST_ASSERT_TRUE(queue.Create());
+  TwaiFrame frame   = {};
+  frame.data_length = 8;
+  for (uint32_t i = 0; i < 100; i++) {
+    frame.id          = 0x7E0 + (i % 8);
+    frame.tx_priority = static_cast<TxPriority>(i % TwaiTxQueue::kClasses);
+    TEST_ASSERT_TRUE(queue.Send(frame, 0));
+    TEST_ASSERT_TRUE(queue.Receive(frame));
+  }
+
+  const HeapWatermark::Report report = watermark.Check(take_snapshot());
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, report.allocations, "TX queue storage lives in the object");
+  TEST_ASSERT_TRUE(report.steady);
+}
+
+// Тест 4: Опрос PID без кучи после первого запроса
+void test_heap_watermark_obd_polling_steady_state() {
+  if (!install_heap_hooks()) {
+    TEST_IGNORE_MESSAGE("Allocator hooks require AddressSanitizer");
+  }
+
+  EcuLoopback ecu;
+  IsoTp iso_tp(ecu);
+  OBD2 obd2(iso_tp);
+  iso_tp.add_rx_filter(0x7E8, 0x7F8);
+
+  // Первый запрос читает маску поддерживаемых PID
+  TEST_ASSERT_TRUE(obd2.rpm().has_value());
+
+  HeapWatermark watermark;
+  watermark.Arm(take_snapshot());
+  const uint32_t requests = ecu.requests();
+
+  float rpm = 0.0f;
+  for (int i = 0; i < 50; i++) {
+    const std::optional<float> value = obd2.rpm();
+    if (value.has_value()) {
+      rpm = value.value();
+    }
+  }
+
+  const HeapWatermark::Report report = watermark.Check(take_snapshot());
+  TEST_ASSERT_EQUAL_UINT32(requests + 50, ecu.requests());
+  TEST_ASSERT_EQUAL_FLOAT(0xFFFF / 4.0f, rpm);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, report.allocations, "Steady-state polling must not touch the heap");
+  TEST_ASSERT_TRUE(report.steady);
+}
+
+extern "C" void run_heap_watermark_tests() {
+  RUN_TEST(test_heap_watermark_report);
+  RUN_TEST(test_heap_watermark_counter_wrap);
+  RUN_TEST(test_heap_watermark_task_hooks_and_accept);
+  RUN_TEST(test_heap_watermark_tx_queue_static);
+  RUN_TEST(test_heap_watermark_obd_polling_steady_state);
+}
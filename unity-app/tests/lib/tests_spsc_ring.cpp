@@ -0,0 +1,222 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "spsc_ring.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ КОЛЬЦЕВОГО БУФЕРА SPSC
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ОДИН ПОТОК:
+ * - Порядок FIFO, многократный переход индексов через границу буфера
+ * - Переполнение: новый элемент отбрасывается и учитывается, старые сохраняются
+ * - Признак перехода из пустого в непустой только для первого элемента
+ *
+ * ✅ ДВА ПОТОКА:
+ * - Писатель и читатель без блокировок: порядок сохраняется, потери учтены
+ * - Читатель, ожидающий уведомления, не засыпает при непустом буфере
+ */
+
+namespace {
+
+struct Item {
+  uint32_t seq;
+  uint32_t check;
+};
+
+Item make_item(uint32_t seq) {
+  return Item{seq, seq * 2654435761u};
+}
+
+const uint32_t kStressItems = 1000000;
+
+}  // namespace
+
+// Тест 1: Порядок FIFO и переход индексов через границу
+void test_spsc_ring_fifo() {
+  SpscRing<uint32_t, 8> ring;
+  TEST_ASSERT_EQUAL_size_t(8, ring.capacity());
+  TEST_ASSERT_TRUE(ring.empty());
+
+  uint32_t value = 0;
+  TEST_ASSERT_FALSE(ring.pop(value));
+
+  uint32_t next_push = 0;
+  uint32_t next_pop  = 0;
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < 5; i++) {
+      TEST_ASSERT_TRUE(ring.push(next_push++));
+    }
+    TEST_ASSERT_EQUAL_size_t(5, ring.size());
+    for (int i = 0; i < 5; i++) {
+      TEST_ASSERT_TRUE(ring.pop(value));
+      TEST_ASSERT_EQUAL_UINT32(next_pop++, value);
+    }
+  }
+  TEST_ASSERT_TRUE(ring.empty());
+  TEST_ASSERT_EQUAL_UINT32(0, ring.dropped());
+}
+
+// Тест 2: Переполнение не трогает накопленные элементы
+void test_spsc_ring_overflow() {
+  SpscRing<uint32_t, 4> ring;
+  for (uint32_t i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(ring.push(i));
+  }
+  TEST_ASSERT_FALSE(ring.push(100));
+  TEST_ASSERT_FALSE(ring.push(101));
+  TEST_ASSERT_EQUAL_UINT32(2, ring.dropped());
+  TEST_ASSERT_EQUAL_size_t(4, ring.size());
+
+  uint32_t value = 0;
+  for (uint32_t i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(ring.pop(value));
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(i, value, "Old items are kept on overflow");
+  }
+  TEST_ASSERT_FALSE(ring.pop(value));
+
+  // Место освободилось: запись снова проходит
+  TEST_ASSERT_TRUE(ring.push(5));
+  TEST_ASSERT_EQUAL_UINT32(2, ring.dropped());
+}
+
+// Тест 3: Признак перехода из пустого в непустой
+void test_spsc_ring_empty_transition() {
+  SpscRing<uint32_t, 4> ring;
+  bool was_empty = false;
+  uint32_t value = 0;
+
+  TEST_ASSERT_TRUE(ring.push(1, was_empty));
+  TEST_ASSERT_TRUE_MESSAGE(was_empty, "First item wakes the reader");
+  TEST_ASSERT_TRUE(ring.push(2, was_empty));
+  TEST_ASSERT_FALSE_MESSAGE(was_empty, "Reader is already awake");
+
+  TEST_ASSERT_TRUE(ring.pop(value));
+  TEST_ASSERT_TRUE(ring.push(3, was_empty));
+  TEST_ASSERT_FALSE(was_empty);
+
+  TEST_ASSERT_TRUE(ring.pop(value));
+  TEST_ASSERT_TRUE(ring.pop(value));
+  TEST_ASSERT_TRUE(ring.push(4, was_empty));
+  TEST_ASSERT_TRUE_MESSAGE(was_empty, "Drained ring wakes the reader again");
+
+  TEST_ASSERT_TRUE(ring.push(5, was_empty));
+  TEST_ASSERT_TRUE(ring.push(6, was_empty));
+  TEST_ASSERT_TRUE(ring.push(7, was_empty));
+  TEST_ASSERT_FALSE(ring.push(8, was_empty));
+  TEST_ASSERT_FALSE(was_empty);
+}
+
+// Тест 4: Писатель и читатель в разных потоках, читатель не отстает
+void test_spsc_ring_stress_ordered() {
+  static SpscRing<Item, 64> ring;
+  std::atomic_bool done{false};
+
+  std::thread producer([&done]() {
+    for (uint32_t seq = 0; seq < kStressItems; seq++) {
+      // Ждем место: без потерь каждый элемент должен дойти до читателя
+      while (!ring.push(make_item(seq))) {
+        std::this_thread::yield();
+      }
+    }
+    done.store(true);
+  });
+
+  uint32_t expected = 0;
+  uint32_t errors   = 0;
+  Item item;
+  while (expected < kStressItems) {
+    if (!ring.pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (item.seq != expected || item.check != make_item(expected).check) {
+      errors++;
+    }
+    expected++;
+  }
+  producer.join();
+
+  TEST_ASSERT_TRUE(done.load());
+  TEST_ASSERT_EQUAL_UINT32(0, errors);
+  TEST_ASSERT_EQUAL_UINT32(kStressItems, expected);
+  TEST_ASSERT_TRUE(ring.empty());
+}
+
+// Тест 5: Потери при медленном читателе и уведомления по переходу из пустого
+void test_spsc_ring_stress_drops_and_wakeups() {
+  static SpscRing<Item, 16> ring;
+  std::atomic_uint32_t notifications{0};
+  std::atomic_uint32_t pushed{0};
+  std::atomic_bool done{false};
+
+  std::thread producer([&]() {
+    for (uint32_t seq = 0; seq < kStressItems; seq++) {
+      bool was_empty = false;
+      if (ring.push(make_item(seq), was_empty)) {
+        pushed.fetch_add(1, std::memory_order_relaxed);
+        if (was_empty) {
+          notifications.fetch_add(1, std::memory_order_release);
+        }
+      }
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t received     = 0;
+  uint32_t last_seq     = 0;
+  uint32_t order_errors = 0;
+  uint32_t lost_wakeups = 0;
+  uint32_t seen         = 0;
+  Item item;
+  while (true) {
+    if (ring.pop(item)) {
+      if (received > 0 && item.seq <= last_seq) {
+        order_errors++;
+      }
+      if (item.check != make_item(item.seq).check) {
+        order_errors++;
+      }
+      last_seq = item.seq;
+      received++;
+      continue;
+    }
+    if (done.load(std::memory_order_acquire) && ring.empty()) {
+      break;
+    }
+
+    // Буфер пуст: ждем уведомления, как задача в ulTaskNotifyTake()
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (notifications.load(std::memory_order_acquire) == seen && !done.load(std::memory_order_acquire)) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        lost_wakeups += ring.empty() ? 0 : 1;
+        break;
+      }
+      std::this_thread::yield();
+    }
+    seen = notifications.load(std::memory_order_acquire);
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, order_errors);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, lost_wakeups, "Reader slept with items in the ring");
+  TEST_ASSERT_EQUAL_UINT32(pushed.load(), received);
+  TEST_ASSERT_EQUAL_UINT32(kStressItems, received + ring.dropped());
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(received, notifications.load());
+}
+
+extern "C" void run_spsc_ring_tests() {
+  RUN_TEST(test_spsc_ring_fifo);
+  RUN_TEST(test_spsc_ring_overflow);
+  RUN_TEST(test_spsc_ring_empty_transition);
+  RUN_TEST(test_spsc_ring_stress_ordered);
+  RUN_TEST(test_spsc_ring_stress_drops_and_wakeups);
+}
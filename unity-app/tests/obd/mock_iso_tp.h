@@ -122,10 +122,10 @@ static const uint8_t SUPPORTED_PIDS_121_140 = 192;  // 0xC0 - bit encoded
 
 // Структура для хранения сообщения с использованием std::array вместо динамической памяти
 struct MockMessage {
-  uint32_t tx_id              = 0;
-  uint32_t rx_id              = 0;
-  size_t len                  = 0;
-  std::array<uint8_t, 8> data = {0};  // Максимальный размер для OBD2 сообщений
+  uint32_t tx_id               = 0;
+  uint32_t rx_id               = 0;
+  size_t len                   = 0;
+  std::array<uint8_t, 64> data = {0};  // Достаточно для многокадровых ответов Service 09
 
   // Конструктор по умолчанию
   MockMessage() = default;
@@ -166,6 +166,7 @@ class MockIsoTp : public IIsoTp {
     send_called       = true;
     last_sent_message = message;
     sent_messages.push_back(message);
+    sent_copies.push_back(MockMessage(message));
     return send_result;
   }
 
@@ -190,9 +191,59 @@ class MockIsoTp : public IIsoTp {
     return false;  // Нет сообщений для получения
   }
 
+  // Отдает сообщение фрагментами так же, как IsoTp: SF целиком, иначе FF (6 байт) и CF по 7 байт
+  bool receive_stream(Message& message, StreamConsumer consumer, void* ctx) override {
+    receive_called = true;
+    if (receive_messages.empty()) {
+      return false;
+    }
+
+    const MockMessage mock_msg = receive_messages.front();
+    receive_messages.pop();
+    message.tx_id = mock_msg.tx_id;
+    message.rx_id = mock_msg.rx_id;
+    message.len   = mock_msg.len;
+
+    const size_t total = std::min(mock_msg.len, mock_msg.data.size());
+    size_t offset      = 0;
+    while (offset < total) {
+      const size_t chunk = (total <= 7) ? total : ((offset == 0) ? 6 : std::min<size_t>(7, total - offset));
+      consumer(offset, Span<const uint8_t>(mock_msg.data.data() + offset, chunk), mock_msg.len, ctx);
+      offset += chunk;
+    }
+    return receive_result;
+  }
+
+  // Отправляет запрос и раздает ответы из functional_responses по rx_id
+  size_t send_functional(Message& message, Span<FunctionalResponse> responses, uint32_t window_ms) override {
+    send_called       = true;
+    last_sent_message = message;
+    last_window_ms    = window_ms;
+    sent_messages.push_back(message);
+
+    size_t received = 0;
+    for (FunctionalResponse& response : responses) {
+      response.len      = 0;
+      response.received = false;
+      for (const MockMessage& mock_msg : functional_responses) {
+        if (mock_msg.rx_id == response.rx_id) {
+          const size_t copy_len = std::min(mock_msg.len, response.size);
+          std::copy(mock_msg.data.begin(), mock_msg.data.begin() + copy_len, response.data);
+          response.len      = mock_msg.len;
+          response.received = true;
+          received++;
+          break;
+        }
+      }
+    }
+    return received;
+  }
+
   // Методы для управления состоянием мока
   void reset() {
     sent_messages.clear();
+    sent_copies.clear();
+    functional_responses.clear();
     while (!receive_messages.empty()) {
       receive_messages.pop();
     }
@@ -216,8 +267,11 @@ class MockIsoTp : public IIsoTp {
 
   // Публичные поля для проверки в тестах
   std::vector<Message> sent_messages;
+  std::vector<MockMessage> sent_copies;  // Копии отправленных данных (буфер запроса живет только в вызове)
   std::queue<MockMessage> receive_messages;
+  std::vector<MockMessage> functional_responses;
   Message last_sent_message;
+  uint32_t last_window_ms = 0;
   bool send_called    = false;
   bool receive_called = false;
   bool send_result    = true;
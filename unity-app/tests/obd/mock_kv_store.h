@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "kv_store_interface.h"
+
+// Хранилище записей в памяти вместо NVS
+class MockKeyValueStore : public IKeyValueStore {
+ public:
+  bool read(const char* key, Span<uint8_t> buffer, size_t& len) override {
+    read_count++;
+    const auto it = records.find(key);
+    if ((it == records.end()) || (it->second.size() > buffer.size())) {
+      return false;
+    }
+    std::copy(it->second.begin(), it->second.end(), buffer.data());
+    len = it->second.size();
+    return true;
+  }
+
+  bool write(const char* key, Span<const uint8_t> data) override {
+    write_count++;
+    if (!write_result) {
+      return false;
+    }
+    records[key].assign(data.begin(), data.end());
+    return true;
+  }
+
+  std::map<std::string, std::vector<uint8_t>> records;
+  size_t read_count  = 0;
+  size_t write_count = 0;
+  bool write_result  = true;
+};
@@ -0,0 +1,169 @@
+#include <cstdio>
+#include <cstring>
+
+#include "mock_iso_tp.h"
+#include "mock_kv_store.h"
+#include "obd2.h"
+#include "obd2_capability_store.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ХРАНЕНИЯ ВОЗМОЖНОСТЕЙ АВТОМОБИЛЯ (NVS)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ФОРМАТ ЗАПИСИ:
+ * - Сохранение и загрузка по VIN, порядок байт не зависит от платформы
+ * - Поврежденная, усеченная и чужая по версии запись отклоняются
+ *
+ * ✅ КЛЮЧ ПО VIN:
+ * - Другой VIN не находит запись, совпадение хэша не подменяет VIN
+ *
+ * ✅ КЭШ ПОДДЕРЖКИ PID:
+ * - Восстановленные маски используются без обмена по шине
+ * - Без маски 1-20 обновление кэша сохраняет прежние маски
+ */
+
+static MockIsoTp g_mock_iso_tp;
+
+namespace {
+
+const char* const kVin      = "W0L000043MB541326";
+const char* const kOtherVin = "WVWZZZ1JZXW000001";
+
+ObdCapabilities make_capabilities(const char* vin) {
+  ObdCapabilities caps;
+  memcpy(caps.vin.data(), vin, ObdCapabilities::kVinLength);
+  caps.supported_pids = {0xBE1FA813, 0x80018001, 0x7ED00000, 0, 0, 0, 0};
+  caps.ecu_count      = 2;
+  caps.ecu_ids[0]     = 0x7E8;
+  caps.ecu_ids[1]     = 0x7E9;
+  return caps;
+}
+
+}  // namespace
+
+// Тест 1: Сохранение и загрузка по VIN
+void test_obd2_capability_store_round_trip() {
+  MockKeyValueStore kv;
+  Obd2CapabilityStore store(kv);
+  TEST_ASSERT_TRUE(store.save(make_capabilities(kVin)));
+  TEST_ASSERT_EQUAL_size_t(1, kv.records.size());
+
+  // Ключ NVS не длиннее 15 символов, запись - little-endian
+  const std::string& key = kv.records.begin()->first;
+  TEST_ASSERT_TRUE(key.size() <= 15);
+  const std::vector<uint8_t>& record = kv.records.begin()->second;
+  TEST_ASSERT_EQUAL_size_t(Obd2CapabilityStore::kFixedSize + 4, record.size());
+  TEST_ASSERT_EQUAL_HEX8(Obd2CapabilityStore::kFormatVersion, record[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x13, record[18]);
+  TEST_ASSERT_EQUAL_HEX8(0xBE, record[21]);
+
+  ObdCapabilities caps;
+  TEST_ASSERT_TRUE(store.load(kVin, caps));
+  TEST_ASSERT_EQUAL_STRING(kVin, caps.vin.data());
+  TEST_ASSERT_EQUAL_HEX32(0xBE1FA813, caps.supported_pids[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x7ED00000, caps.supported_pids[2]);
+  TEST_ASSERT_EQUAL_UINT8(2, caps.ecu_count);
+  TEST_ASSERT_EQUAL_HEX16(0x7E9, caps.ecu_ids[1]);
+
+  // Другой VIN - другой ключ
+  TEST_ASSERT_FALSE(store.load(kOtherVin, caps));
+  TEST_ASSERT_TRUE(store.save(make_capabilities(kOtherVin)));
+  TEST_ASSERT_EQUAL_size_t(2, kv.records.size());
+  TEST_ASSERT_FALSE(store.load("SHORTVIN", caps));
+}
+
+// Тест 2: Поврежденные записи и совпадение ключей
+void test_obd2_capability_store_rejects_bad_records() {
+  MockKeyValueStore kv;
+  Obd2CapabilityStore store(kv);
+  TEST_ASSERT_TRUE(store.save(make_capabilities(kVin)));
+  std::vector<uint8_t>& record = kv.records.begin()->second;
+  const std::vector<uint8_t> good = record;
+  ObdCapabilities caps;
+
+  // Другая версия формата
+  record[0] = Obd2CapabilityStore::kFormatVersion + 1;
+  TEST_ASSERT_FALSE(store.load(kVin, caps));
+
+  // Усеченная запись и неверное число ЭБУ
+  record = good;
+  record.pop_back();
+  TEST_ASSERT_FALSE(store.load(kVin, caps));
+  record                                      = good;
+  record[Obd2CapabilityStore::kFixedSize - 1] = OBD2::kMaxEcus + 1;
+  TEST_ASSERT_FALSE(store.load(kVin, caps));
+
+  // Запись другого VIN под тем же ключом (совпадение хэша)
+  record = good;
+  char other_key[Obd2CapabilityStore::kKeySize];
+  Obd2CapabilityStore::makeKey(kOtherVin, other_key);
+  kv.records[other_key] = good;
+  TEST_ASSERT_FALSE(store.load(kOtherVin, caps));
+  TEST_ASSERT_TRUE(store.load(kVin, caps));
+
+  // Ошибка записи и неверный VIN при сохранении
+  kv.write_result = false;
+  TEST_ASSERT_FALSE(store.save(make_capabilities(kVin)));
+  kv.write_result = true;
+  ObdCapabilities no_vin;
+  TEST_ASSERT_FALSE(store.save(no_vin));
+}
+
+// Тест 3: Восстановленный кэш поддержки не требует обмена по шине
+void test_obd2_capability_store_restore_cache() {
+  g_mock_iso_tp.reset();
+  g_mock_iso_tp.set_receive_result(true);
+  OBD2 obd2(g_mock_iso_tp);
+
+  MockKeyValueStore kv;
+  Obd2CapabilityStore store(kv);
+  TEST_ASSERT_TRUE(store.save(make_capabilities(kVin)));
+  ObdCapabilities caps;
+  TEST_ASSERT_TRUE(store.load(kVin, caps));
+  obd2.restoreSupportedPids(caps.supported_pids);
+
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(ENGINE_RPM));
+  TEST_ASSERT_FALSE(obd2.IsPidSupported(0x22));
+  TEST_ASSERT_EQUAL_size_t(0, g_mock_iso_tp.sent_copies.size());
+
+  g_mock_iso_tp.add_receive_message(create_obd_response_2_bytes(0x7E8, SERVICE_01, ENGINE_RPM, 0x1A, 0xF8));
+  TEST_ASSERT_EQUAL_FLOAT(1726.0f, obd2.rpm().value());
+  TEST_ASSERT_EQUAL_size_t(1, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(obd2.supportedPidMasks() == caps.supported_pids);
+}
+
+// Тест 4: Обновление кэша без ответа ЭБУ сохраняет прежние маски
+void test_obd2_capability_store_refresh_keeps_masks() {
+  g_mock_iso_tp.reset();
+  g_mock_iso_tp.set_receive_result(true);
+  OBD2 obd2(g_mock_iso_tp);
+  obd2.restoreSupportedPids(make_capabilities(kVin).supported_pids);
+
+  TEST_ASSERT_FALSE(obd2.refreshSupportedPids());
+  TEST_ASSERT_EQUAL_HEX32(0xBE1FA813, obd2.supportedPidMasks()[0]);
+
+  // Маски 1-20 и 21-40; в 21-40 бит следующей группы снят - 41-60 не запрашивается
+  g_mock_iso_tp.add_receive_message(
+      create_obd_response_4_bytes(0x7E8, SERVICE_01, SUPPORTED_PIDS_1_20, 0x80, 0x00, 0x00, 0x01));
+  g_mock_iso_tp.add_receive_message(
+      create_obd_response_4_bytes(0x7E8, SERVICE_01, SUPPORTED_PIDS_21_40, 0x40, 0x00, 0x00, 0x00));
+  g_mock_iso_tp.sent_copies.clear();
+  TEST_ASSERT_TRUE(obd2.refreshSupportedPids());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+
+  const OBD2::SupportedPidMasks masks = obd2.supportedPidMasks();
+  TEST_ASSERT_EQUAL_HEX32(0x80000001, masks[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x40000000, masks[1]);
+  TEST_ASSERT_EQUAL_HEX32(0, masks[2]);
+}
+
+extern "C" void run_obd2_capability_store_tests() {
+  RUN_TEST(test_obd2_capability_store_round_trip);
+  RUN_TEST(test_obd2_capability_store_rejects_bad_records);
+  RUN_TEST(test_obd2_capability_store_restore_cache);
+  RUN_TEST(test_obd2_capability_store_refresh_keeps_masks);
+}
@@ -0,0 +1,167 @@
+#include <cstdio>
+#include <cstring>
+
+#include "mock_iso_tp.h"
+#include "obd2.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ГРУППОВОГО ЗАПРОСА PID SERVICE 01
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ЗАПРОС:
+ * - До шести PID в одном запросе, неподдерживаемые PID не включаются
+ * - Маски поддержки запрашиваются пачкой без проверки кэша
+ * - Смешивание масок с данными и PID переменной длины отклоняются
+ *
+ * ✅ ОТВЕТ:
+ * - Разбор по длине данных каждого PID, порядок PID в ответе произвольный
+ * - Типизированные значения совпадают с одиночными геттерами
+ * - Неожиданный PID обрывает разбор, отрицательный ответ - ошибка
+ */
+
+static MockIsoTp g_mock_iso_tp;
+
+namespace {
+
+MockMessage create_multi_pid_response(std::initializer_list<uint8_t> payload) {
+  MockMessage mock_msg;
+  mock_msg.tx_id   = 0x7DF;
+  mock_msg.rx_id   = 0x7E8;
+  mock_msg.len     = payload.size() + 1;
+  mock_msg.data[0] = 0x41;
+  size_t i         = 1;
+  for (uint8_t byte : payload) {
+    mock_msg.data[i++] = byte;
+  }
+  return mock_msg;
+}
+
+// Маска 1-20 без PID 0x0D (скорость); остальные диапазоны не поддерживаются
+void setup_supported_pids_without_speed() {
+  g_mock_iso_tp.reset();
+  g_mock_iso_tp.add_receive_message(
+      create_obd_response_4_bytes(0x7E8, SERVICE_01, SUPPORTED_PIDS_1_20, 0xFF, 0xF7, 0xFF, 0xFE));
+}
+
+}  // namespace
+
+// Тест 1: Шесть PID одним запросом
+void test_obd2_multi_pid_six_pids() {
+  setup_mock_for_all_pids(g_mock_iso_tp);
+  // 0C: 0x1AF8 / 4 = 1726, 0D: 60, 05: 90 - 40, 11: 51 * 100 / 255, 04: 102 * 100 / 255, 0F: 65 - 40
+  g_mock_iso_tp.add_receive_message(create_multi_pid_response(
+      {0x0C, 0x1A, 0xF8, 0x0D, 60, 0x05, 90, 0x11, 51, 0x04, 102, 0x0F, 65}));
+
+  OBD2 obd2(g_mock_iso_tp);
+  const uint8_t pids[] = {0x0C, 0x0D, 0x05, 0x11, 0x04, 0x0F};
+  OBD2::PidResults results;
+  TEST_ASSERT_EQUAL_size_t(6, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+
+  // Последний запрос - групповой: SID и шесть PID
+  const MockMessage& request = g_mock_iso_tp.sent_copies.back();
+  TEST_ASSERT_EQUAL_size_t(7, request.len);
+  TEST_ASSERT_EQUAL_HEX8(0x01, request.data[0]);
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(pids, &request.data[1], sizeof(pids));
+
+  TEST_ASSERT_EQUAL_size_t(6, results.size());
+  TEST_ASSERT_EQUAL_FLOAT(1726.0f, results.rpm().value());
+  TEST_ASSERT_EQUAL_UINT8(60, results.kph().value());
+  TEST_ASSERT_EQUAL_INT16(50, results.engineCoolantTemp().value());
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, results.throttle().value());
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 40.0f, results.engineLoad().value());
+  TEST_ASSERT_EQUAL_INT16(25, results.intakeAirTemp().value());
+
+  const Span<const uint8_t> rpm_data = results.data(0x0C);
+  TEST_ASSERT_EQUAL_size_t(2, rpm_data.size());
+  TEST_ASSERT_EQUAL_HEX8(0xF8, rpm_data[1]);
+
+  // Тот же ответ через одиночный геттер дает то же значение
+  g_mock_iso_tp.add_receive_message(create_obd_response_2_bytes(0x7E8, SERVICE_01, 0x0C, 0x1A, 0xF8));
+  TEST_ASSERT_EQUAL_FLOAT(results.rpm().value(), obd2.rpm().value());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.back().len);
+}
+
+// Тест 2: Неподдерживаемый PID не запрашивается, порядок ответа произвольный
+void test_obd2_multi_pid_unsupported_and_order() {
+  setup_supported_pids_without_speed();
+  g_mock_iso_tp.add_receive_message(create_multi_pid_response({0x05, 90, 0x0C, 0x0B, 0xB8}));
+
+  OBD2 obd2(g_mock_iso_tp);
+  const uint8_t pids[] = {0x0C, 0x0D, 0x05};
+  OBD2::PidResults results;
+  TEST_ASSERT_EQUAL_size_t(2, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+
+  const MockMessage& request = g_mock_iso_tp.sent_copies.back();
+  TEST_ASSERT_EQUAL_size_t(3, request.len);
+  TEST_ASSERT_EQUAL_HEX8(0x0C, request.data[1]);
+  TEST_ASSERT_EQUAL_HEX8(0x05, request.data[2]);
+
+  TEST_ASSERT_EQUAL_FLOAT(750.0f, results.rpm().value());
+  TEST_ASSERT_EQUAL_INT16(50, results.engineCoolantTemp().value());
+  TEST_ASSERT_FALSE(results.has(0x0D));
+  TEST_ASSERT_FALSE(results.kph().has_value());
+  TEST_ASSERT_TRUE(results.data(0x0D).empty());
+}
+
+// Тест 3: Маски поддержки пачкой
+void test_obd2_multi_pid_support_masks() {
+  g_mock_iso_tp.reset();
+  g_mock_iso_tp.add_receive_message(create_multi_pid_response(
+      {0x00, 0xBE, 0x1F, 0xA8, 0x13, 0x20, 0x80, 0x00, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00}));
+
+  OBD2 obd2(g_mock_iso_tp);
+  const uint8_t pids[] = {0x00, 0x20, 0x40};
+  OBD2::PidResults results;
+  TEST_ASSERT_EQUAL_size_t(3, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+  TEST_ASSERT_EQUAL_INT_MESSAGE(1, g_mock_iso_tp.sent_copies.size(), "Masks need no support check");
+
+  const Span<const uint8_t> mask = results.data(0x20);
+  TEST_ASSERT_EQUAL_size_t(4, mask.size());
+  TEST_ASSERT_EQUAL_HEX8(0x80, mask[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x01, mask[3]);
+  TEST_ASSERT_EQUAL_HEX8(0x13, results.data(0x00)[3]);
+}
+
+// Тест 4: Отклоняемые запросы и ответы
+void test_obd2_multi_pid_rejected() {
+  setup_mock_for_all_pids(g_mock_iso_tp);
+  OBD2 obd2(g_mock_iso_tp);
+  OBD2::PidResults results;
+
+  // Маска вместе с данными и PID переменной длины - запрос не отправляется
+  const uint8_t mixed[] = {0x0C, 0x20};
+  TEST_ASSERT_EQUAL_size_t(0, obd2.readPids(Span<const uint8_t>(mixed, sizeof(mixed)), results));
+  const uint8_t fuel_trim[] = {0x0C, 0x06};
+  TEST_ASSERT_EQUAL_size_t(0, obd2.readPids(Span<const uint8_t>(fuel_trim, sizeof(fuel_trim)), results));
+  TEST_ASSERT_EQUAL_size_t(0, g_mock_iso_tp.sent_copies.size());
+
+  // Неожиданный PID: остаются PID до него
+  const uint8_t pids[] = {0x0C, 0x0D, 0x05, 0x04, 0x0F, 0x11, 0x10};
+  g_mock_iso_tp.add_receive_message(create_multi_pid_response({0x0D, 88, 0x42, 0x30, 0x05, 90}));
+  TEST_ASSERT_EQUAL_size_t(1, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+  TEST_ASSERT_EQUAL_size_t(7, g_mock_iso_tp.sent_copies.back().len);  // Только первые шесть PID
+  TEST_ASSERT_EQUAL_UINT8(88, results.kph().value());
+  TEST_ASSERT_FALSE(results.has(0x05));
+
+  // Ответ короче заявленной длины PID
+  g_mock_iso_tp.add_receive_message(create_multi_pid_response({0x0D, 70, 0x0C, 0x10}));
+  TEST_ASSERT_EQUAL_size_t(1, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+  TEST_ASSERT_FALSE(results.rpm().has_value());
+
+  // Отрицательный ответ
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x12));
+  TEST_ASSERT_EQUAL_size_t(0, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+  TEST_ASSERT_EQUAL_size_t(0, results.size());
+  TEST_ASSERT_FALSE(results.kph().has_value());
+}
+
+extern "C" void run_obd2_multi_pid_tests() {
+  RUN_TEST(test_obd2_multi_pid_six_pids);
+  RUN_TEST(test_obd2_multi_pid_unsupported_and_order);
+  RUN_TEST(test_obd2_multi_pid_support_masks);
+  RUN_TEST(test_obd2_multi_pid_rejected);
+}
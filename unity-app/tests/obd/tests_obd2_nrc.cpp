@@ -0,0 +1,171 @@
+#include <cstdio>
+
+#include "freertos/task.h"
+#include "mock_iso_tp.h"
+#include "obd2.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ОБРАБОТКИ ОТРИЦАТЕЛЬНЫХ ОТВЕТОВ (NRC)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ 0x78 RESPONSE PENDING:
+ * - Ответ ждем дальше без повторной отправки запроса
+ *
+ * ✅ 0x21 BUSY:
+ * - Повтор с экспоненциальной паузой, число запросов ограничено
+ *
+ * ✅ ПОСТОЯННЫЕ И ВРЕМЕННЫЕ ОШИБКИ:
+ * - Постоянный NRC: отказ сразу, PID больше не запрашивается
+ * - Временный NRC: отказ сразу, PID запрашивается снова
+ * - NRC на чужой сервис не принимается за ответ
+ *
+ * ✅ ГРУППОВОЙ ЗАПРОС:
+ * - 0x78 и 0x21 обрабатываются как в одиночном запросе
+ * - Постоянный NRC исключает PID, только если он в запросе один
+ */
+
+static MockIsoTp g_mock_iso_tp;
+
+namespace {
+
+// Мок с поддержкой всех PID; кэш поддержки заполнен до начала теста
+void setup_supported(OBD2& obd2) {
+  setup_mock_for_all_pids(g_mock_iso_tp);
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(ENGINE_RPM));
+  g_mock_iso_tp.sent_copies.clear();
+}
+
+MockMessage rpm_response() {
+  return create_obd_response_2_bytes(0x7E8, SERVICE_01, ENGINE_RPM, 0x1A, 0xF8);
+}
+
+}  // namespace
+
+// Тест 1: 0x78 - ждем ответ без повторного запроса
+void test_obd2_nrc_response_pending() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_supported(obd2);
+
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x78));
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x78));
+  g_mock_iso_tp.add_receive_message(rpm_response());
+
+  const uint32_t start_ms = xTaskGetTickCount();
+  TEST_ASSERT_EQUAL_FLOAT(1726.0f, obd2.rpm().value());
+  TEST_ASSERT_EQUAL_size_t(1, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE_MESSAGE(xTaskGetTickCount() - start_ms < 50, "Pending response must not add delays");
+}
+
+// Тест 2: 0x21 - повтор с паузой 50 мс, затем 100 мс
+void test_obd2_nrc_busy_backoff() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_supported(obd2);
+
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x21));
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x21));
+  g_mock_iso_tp.add_receive_message(rpm_response());
+
+  const uint32_t start_ms = xTaskGetTickCount();
+  TEST_ASSERT_EQUAL_FLOAT(1726.0f, obd2.rpm().value());
+  const uint32_t elapsed_ms = xTaskGetTickCount() - start_ms;
+  TEST_ASSERT_EQUAL_size_t(3, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(elapsed_ms >= 150);
+  TEST_ASSERT_TRUE(elapsed_ms < 1000);
+
+  // Число повторов ограничено: после последнего 0x21 паузы нет
+  for (int i = 0; i < 3; i++) {
+    g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x21));
+  }
+  g_mock_iso_tp.sent_copies.clear();
+  TEST_ASSERT_FALSE(obd2.rpm().has_value());
+  TEST_ASSERT_EQUAL_size_t(3, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(ENGINE_RPM));
+}
+
+// Тест 3: Постоянный NRC исключает PID, временный - нет
+void test_obd2_nrc_permanent_and_temporary() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_supported(obd2);
+
+  // 0x22 ConditionsNotCorrect: отказ без повторов, PID остается поддерживаемым
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x22));
+  TEST_ASSERT_FALSE(obd2.rpm().has_value());
+  TEST_ASSERT_EQUAL_size_t(1, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(ENGINE_RPM));
+
+  // 0x31 RequestOutOfRange: отказ без повторов, PID больше не запрашивается
+  g_mock_iso_tp.sent_copies.clear();
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x31));
+  TEST_ASSERT_FALSE(obd2.rpm().has_value());
+  TEST_ASSERT_EQUAL_size_t(1, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_FALSE(obd2.IsPidSupported(ENGINE_RPM));
+
+  g_mock_iso_tp.add_receive_message(rpm_response());
+  TEST_ASSERT_FALSE(obd2.rpm().has_value());
+  TEST_ASSERT_EQUAL_size_t(1, g_mock_iso_tp.sent_copies.size());
+
+  // Остальные PID по-прежнему читаются
+  g_mock_iso_tp.add_receive_message(create_obd_response_1_byte(0x7E8, SERVICE_01, VEHICLE_SPEED, 60));
+  TEST_ASSERT_EQUAL_UINT8(60, obd2.kph().value());
+}
+
+// Тест 4: NRC на другой сервис - не ответ на запрос
+void test_obd2_nrc_other_service() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_supported(obd2);
+
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, OBD2::SERVICE_09, 0x31));
+  g_mock_iso_tp.add_receive_message(rpm_response());
+  TEST_ASSERT_EQUAL_FLOAT(1726.0f, obd2.rpm().value());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(ENGINE_RPM));
+}
+
+// Тест 5: NRC на групповой запрос
+void test_obd2_nrc_multi_pid() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_supported(obd2);
+
+  const uint8_t pids[] = {ENGINE_RPM, VEHICLE_SPEED};
+  MockMessage response = create_obd_response_2_bytes(0x7E8, SERVICE_01, ENGINE_RPM, 0x1A, 0xF8);
+  response.data[4]     = VEHICLE_SPEED;
+  response.data[5]     = 60;
+  response.len         = 6;
+
+  // 0x78, затем 0x21: ответ ждем без повтора, после 0x21 - один повтор запроса
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x78));
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x21));
+  g_mock_iso_tp.add_receive_message(response);
+  OBD2::PidResults results;
+  TEST_ASSERT_EQUAL_size_t(2, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_EQUAL_size_t(3, g_mock_iso_tp.sent_copies.back().len);
+  TEST_ASSERT_EQUAL_FLOAT(1726.0f, results.rpm().value());
+  TEST_ASSERT_EQUAL_UINT8(60, results.kph().value());
+
+  // Постоянный NRC на несколько PID: неизвестно, какой отклонен, оба остаются поддерживаемыми
+  g_mock_iso_tp.sent_copies.clear();
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x31));
+  TEST_ASSERT_EQUAL_size_t(0, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+  TEST_ASSERT_EQUAL_size_t(1, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(ENGINE_RPM));
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(VEHICLE_SPEED));
+
+  // Постоянный NRC на один PID исключает его
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, SERVICE_01, 0x31));
+  TEST_ASSERT_EQUAL_size_t(0, obd2.readPids(Span<const uint8_t>(pids, 1), results));
+  TEST_ASSERT_FALSE(obd2.IsPidSupported(ENGINE_RPM));
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(VEHICLE_SPEED));
+}
+
+extern "C" void run_obd2_nrc_tests() {
+  RUN_TEST(test_obd2_nrc_response_pending);
+  RUN_TEST(test_obd2_nrc_busy_backoff);
+  RUN_TEST(test_obd2_nrc_permanent_and_temporary);
+  RUN_TEST(test_obd2_nrc_other_service);
+  RUN_TEST(test_obd2_nrc_multi_pid);
+}
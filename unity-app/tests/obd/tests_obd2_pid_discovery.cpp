@@ -0,0 +1,197 @@
+#include <cstdio>
+
+#include "mock_iso_tp.h"
+#include "obd2.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ФОНОВОГО ОБНОВЛЕНИЯ МАСОК ПОДДЕРЖИВАЕМЫХ PID
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ГЕТТЕРЫ:
+ * - Устаревший кэш не вызывает запросов масок из геттера
+ *
+ * ✅ ШАГИ ОБНОВЛЕНИЯ:
+ * - Без необходимости шаг ничего не отправляет
+ * - Маски групп, известных по кэшу, одним групповым запросом
+ * - Новая группа, открытая маской, запрашивается следующим шагом
+ * - Без ответа на групповой запрос - по одной группе
+ * - Неполный групповой ответ: недостающие группы по одной, маски только по всей цепочке
+ * - Без маски 1-20 прежние маски остаются
+ */
+
+static MockIsoTp g_mock_iso_tp;
+
+namespace {
+
+// Маски 1-20 и 21-40 с битом следующей группы, 41-60 без него
+const OBD2::SupportedPidMasks kMasks = {0xBE1FA813, 0x80018001, 0x7ED00000, 0, 0, 0, 0};
+
+MockMessage create_masks_response(std::initializer_list<uint8_t> payload) {
+  MockMessage mock_msg;
+  mock_msg.tx_id   = 0x7DF;
+  mock_msg.rx_id   = 0x7E8;
+  mock_msg.len     = payload.size() + 1;
+  mock_msg.data[0] = 0x41;
+  size_t i         = 1;
+  for (uint8_t byte : payload) {
+    mock_msg.data[i++] = byte;
+  }
+  return mock_msg;
+}
+
+void setup_restored(OBD2& obd2) {
+  g_mock_iso_tp.reset();
+  g_mock_iso_tp.set_receive_result(true);
+  obd2.restoreSupportedPids(kMasks);
+}
+
+}  // namespace
+
+// Тест 1: Геттер не ждет обновления, шаг без необходимости ничего не отправляет
+void test_obd2_pid_discovery_getter_does_not_block() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_restored(obd2);
+
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(0, g_mock_iso_tp.sent_copies.size());
+
+  // Обновление запрошено: геттер отправляет только свой запрос
+  obd2.requestPidDiscovery();
+  g_mock_iso_tp.add_receive_message(create_obd_response_2_bytes(0x7E8, SERVICE_01, ENGINE_RPM, 0x1A, 0xF8));
+  TEST_ASSERT_EQUAL_FLOAT(1726.0f, obd2.rpm().value());
+  TEST_ASSERT_EQUAL_size_t(1, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies[0].len);
+}
+
+// Тест 2: Группы, известные по кэшу, одним запросом; новая группа - следующим шагом
+void test_obd2_pid_discovery_batched_ranges() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_restored(obd2);
+  obd2.requestPidDiscovery();
+
+  // 41-60 теперь открывает 61-80
+  g_mock_iso_tp.add_receive_message(create_masks_response({0x00, 0xBE, 0x1F, 0xA8, 0x13,
+                                                           0x20, 0x80, 0x01, 0x80, 0x01,
+                                                           0x40, 0x7E, 0xD0, 0x00, 0x01}));
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  const MockMessage& batch = g_mock_iso_tp.sent_copies.back();
+  TEST_ASSERT_EQUAL_size_t(4, batch.len);
+  const uint8_t expected_batch[] = {0x01, 0x00, 0x20, 0x40};
+  TEST_ASSERT_EQUAL_HEX8_ARRAY(expected_batch, batch.data.data(), sizeof(expected_batch));
+  TEST_ASSERT_EQUAL_HEX32(0x7ED00000, obd2.supportedPidMasks()[2]);  // Проход не завершен
+
+  g_mock_iso_tp.add_receive_message(create_masks_response({0x60, 0x00, 0x00, 0x00, 0x10}));
+  TEST_ASSERT_TRUE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.back().len);
+  TEST_ASSERT_EQUAL_HEX8(0x60, g_mock_iso_tp.sent_copies.back().data[1]);
+
+  const OBD2::SupportedPidMasks masks = obd2.supportedPidMasks();
+  TEST_ASSERT_EQUAL_HEX32(0x7ED00001, masks[2]);
+  TEST_ASSERT_EQUAL_HEX32(0x00000010, masks[3]);
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(0x7C));
+
+  // Проход завершен, срок кэша начат заново
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+}
+
+// Тест 3: ЭБУ без групповых запросов - по одной группе
+void test_obd2_pid_discovery_single_range_fallback() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_restored(obd2);
+  obd2.requestPidDiscovery();
+
+  // Групповой запрос без ответа
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(4, g_mock_iso_tp.sent_copies.back().len);
+
+  // 21-40 больше не открывает 41-60
+  g_mock_iso_tp.add_receive_message(create_masks_response({0x00, 0xBE, 0x1F, 0xA8, 0x13}));
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  g_mock_iso_tp.add_receive_message(create_masks_response({0x20, 0x80, 0x01, 0x80, 0x00}));
+  TEST_ASSERT_TRUE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(3, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.back().len);
+
+  const OBD2::SupportedPidMasks masks = obd2.supportedPidMasks();
+  TEST_ASSERT_EQUAL_HEX32(0x80018000, masks[1]);
+  TEST_ASSERT_EQUAL_HEX32(0, masks[2]);
+  TEST_ASSERT_FALSE(obd2.IsPidSupported(0x42));
+}
+
+// Тест 4: Без маски 1-20 прежние маски остаются
+void test_obd2_pid_discovery_keeps_masks_on_failure() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_restored(obd2);
+  obd2.requestPidDiscovery();
+
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());  // Групповой запрос
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());  // Одиночный 0x00
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(obd2.supportedPidMasks() == kMasks);
+
+  // Следующая попытка - по сроку кэша, не на каждом шаге
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+}
+
+// Тест 5: Групповой ответ без части групп - недостающие дочитываются по одной
+void test_obd2_pid_discovery_partial_batch_reply() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_restored(obd2);
+  obd2.requestPidDiscovery();
+
+  // Запрошены 0x00, 0x20, 0x40; в ответе нет 41-60, хотя 21-40 ее открывает
+  g_mock_iso_tp.add_receive_message(create_masks_response({0x00, 0xBE, 0x1F, 0xA8, 0x13,
+                                                           0x20, 0x80, 0x01, 0x80, 0x01}));
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(4, g_mock_iso_tp.sent_copies.back().len);
+  TEST_ASSERT_TRUE(obd2.supportedPidMasks() == kMasks);  // Усеченная цепочка не применяется
+
+  // Дочитывание начинается с недостающей группы
+  g_mock_iso_tp.add_receive_message(create_masks_response({0x40, 0x7E, 0xD0, 0x00, 0x00}));
+  TEST_ASSERT_TRUE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.back().len);
+  TEST_ASSERT_EQUAL_HEX8(0x40, g_mock_iso_tp.sent_copies.back().data[1]);
+
+  const OBD2::SupportedPidMasks masks = obd2.supportedPidMasks();
+  TEST_ASSERT_EQUAL_HEX32(0xBE1FA813, masks[0]);
+  TEST_ASSERT_EQUAL_HEX32(0x80018001, masks[1]);
+  TEST_ASSERT_EQUAL_HEX32(0x7ED00000, masks[2]);
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(0x42));
+}
+
+// Тест 6: Недостающая группа не получена и по одной - прежние маски остаются
+void test_obd2_pid_discovery_partial_batch_reply_keeps_masks() {
+  OBD2 obd2(g_mock_iso_tp);
+  setup_restored(obd2);
+  obd2.requestPidDiscovery();
+
+  // 21-40 без 0x0B и с битом 41-60, но маски 41-60 нет ни в групповом, ни в одиночном ответе
+  g_mock_iso_tp.add_receive_message(create_masks_response({0x00, 0xBE, 0x0F, 0xA8, 0x13,
+                                                           0x20, 0x80, 0x01, 0x80, 0x01}));
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+  TEST_ASSERT_TRUE(obd2.supportedPidMasks() == kMasks);
+  TEST_ASSERT_TRUE(obd2.IsPidSupported(0x42));
+
+  // Проход завершен, следующая попытка - по сроку кэша
+  TEST_ASSERT_FALSE(obd2.stepPidDiscovery());
+  TEST_ASSERT_EQUAL_size_t(2, g_mock_iso_tp.sent_copies.size());
+}
+
+extern "C" void run_obd2_pid_discovery_tests() {
+  RUN_TEST(test_obd2_pid_discovery_getter_does_not_block);
+  RUN_TEST(test_obd2_pid_discovery_batched_ranges);
+  RUN_TEST(test_obd2_pid_discovery_single_range_fallback);
+  RUN_TEST(test_obd2_pid_discovery_keeps_masks_on_failure);
+  RUN_TEST(test_obd2_pid_discovery_partial_batch_reply);
+  RUN_TEST(test_obd2_pid_discovery_partial_batch_reply_keeps_masks);
+}
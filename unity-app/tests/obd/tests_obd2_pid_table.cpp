@@ -0,0 +1,152 @@
+#include <cstdio>
+#include <cstring>
+
+#include "mock_iso_tp.h"
+#include "obd2.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ТАБЛИЦЫ ОПИСАНИЙ PID (kPidTable)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ОПИСАНИЯ:
+ * - Длина, единица и диапазон, выведенный из формулы
+ * - Несколько величин в одном PID, отсутствующие PID и величины
+ *
+ * ✅ ЧТЕНИЕ ПО НОМЕРУ:
+ * - readPidValue для PID без отдельного геттера, PID вне таблицы не запрашивается
+ * - Массивы: отсутствующие в таблице элементы равны нулю
+ * - PidResults::value для PID из группового ответа
+ */
+
+static MockIsoTp g_mock_iso_tp;
+
+namespace {
+
+MockMessage create_obd_response(uint8_t pid, std::initializer_list<uint8_t> data) {
+  MockMessage mock_msg;
+  mock_msg.tx_id   = 0x7DF;
+  mock_msg.rx_id   = 0x7E8;
+  mock_msg.len     = data.size() + 2;
+  mock_msg.data[0] = 0x41;
+  mock_msg.data[1] = pid;
+  size_t i         = 2;
+  for (uint8_t byte : data) {
+    mock_msg.data[i++] = byte;
+  }
+  return mock_msg;
+}
+
+}  // namespace
+
+// Тест 1: Описания PID
+void test_obd2_pid_table_descriptors() {
+  const PidDescriptor* rpm = OBD2::pidDescriptor(OBD2::ENGINE_RPM);
+  TEST_ASSERT_NOT_NULL(rpm);
+  TEST_ASSERT_EQUAL_HEX8(OBD2::SERVICE_01, rpm->service);
+  TEST_ASSERT_EQUAL_UINT8(2, rpm->length);
+  TEST_ASSERT_TRUE(rpm->unit == PidUnit::RPM);
+  TEST_ASSERT_TRUE(rpm->formula == PidFormula::LINEAR);
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, rpm->min);
+  TEST_ASSERT_EQUAL_FLOAT(16383.75f, rpm->max);
+
+  const PidDescriptor* coolant = OBD2::pidDescriptor(OBD2::ENGINE_COOLANT_TEMP);
+  TEST_ASSERT_EQUAL_FLOAT(-40.0f, coolant->min);
+  TEST_ASSERT_EQUAL_FLOAT(215.0f, coolant->max);
+
+  const PidDescriptor* status = OBD2::pidDescriptor(OBD2::MONITOR_STATUS_SINCE_DTC_CLEARED);
+  TEST_ASSERT_TRUE(status->formula == PidFormula::RAW);
+  TEST_ASSERT_EQUAL_UINT8(4, status->width);
+
+  // Кислородный датчик: напряжение и коррекция в одном PID
+  const PidDescriptor* trim = OBD2::pidDescriptor(OBD2::OXYGEN_SENSOR_3_A, 1);
+  TEST_ASSERT_NOT_NULL(trim);
+  TEST_ASSERT_EQUAL_UINT8(1, trim->byte);
+  TEST_ASSERT_TRUE(trim->unit == PidUnit::PERCENT);
+  TEST_ASSERT_NULL(OBD2::pidDescriptor(OBD2::OXYGEN_SENSOR_3_A, 2));
+
+  // Переменная длина, маска поддержки и PID вне таблицы
+  TEST_ASSERT_EQUAL_UINT8(0, OBD2::pidDescriptor(OBD2::SHORT_TERM_FUEL_TRIM_BANK_1)->length);
+  TEST_ASSERT_NULL(OBD2::pidDescriptor(OBD2::SUPPORTED_PIDS_21_40));
+  TEST_ASSERT_NULL(OBD2::pidDescriptor(0x66));
+}
+
+// Тест 2: Чтение по номеру PID без отдельного геттера
+void test_obd2_pid_table_read_by_id() {
+  setup_mock_for_all_pids(g_mock_iso_tp);
+  OBD2 obd2(g_mock_iso_tp);
+
+  // 24: соотношение 0x8000 * 2 / 65536 = 1.0, напряжение 0x4000 * 8 / 65536 = 2.0 В
+  g_mock_iso_tp.add_receive_message(create_obd_response(OBD2::OXYGEN_SENSOR_1_B, {0x80, 0x00, 0x40, 0x00}));
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, obd2.readPidValue(OBD2::OXYGEN_SENSOR_1_B).value());
+  g_mock_iso_tp.add_receive_message(create_obd_response(OBD2::OXYGEN_SENSOR_1_B, {0x80, 0x00, 0x40, 0x00}));
+  TEST_ASSERT_EQUAL_FLOAT(2.0f, obd2.readPidValue(OBD2::OXYGEN_SENSOR_1_B, 1).value());
+
+  // 34: ток 0x7F80 / 256 - 128 = -0.5 мА
+  g_mock_iso_tp.add_receive_message(create_obd_response(OBD2::OXYGEN_SENSOR_1_C, {0x80, 0x00, 0x7F, 0x80}));
+  TEST_ASSERT_EQUAL_FLOAT(-0.5f, obd2.readPidValue(OBD2::OXYGEN_SENSOR_1_C, 1).value());
+
+  // Значение совпадает с типизированным геттером
+  g_mock_iso_tp.add_receive_message(create_obd_response(OBD2::CATALYST_TEMP_BANK_1_SENSOR_1, {0x10, 0x00}));
+  TEST_ASSERT_EQUAL_FLOAT(369.6f, obd2.readPidValue(OBD2::CATALYST_TEMP_BANK_1_SENSOR_1).value());
+  g_mock_iso_tp.add_receive_message(create_obd_response(OBD2::CATALYST_TEMP_BANK_1_SENSOR_1, {0x10, 0x00}));
+  TEST_ASSERT_EQUAL_FLOAT(369.6f, obd2.catTempB1S1().value());
+
+  // PID и величины вне таблицы не запрашиваются
+  const size_t sent = g_mock_iso_tp.sent_copies.size();
+  TEST_ASSERT_FALSE(obd2.readPidValue(0x66).has_value());
+  TEST_ASSERT_FALSE(obd2.readPidValue(OBD2::ENGINE_RPM, 1).has_value());
+  TEST_ASSERT_EQUAL_size_t(sent, g_mock_iso_tp.sent_copies.size());
+}
+
+// Тест 3: Массивы по величинам таблицы
+void test_obd2_pid_table_arrays() {
+  setup_mock_for_all_pids(g_mock_iso_tp);
+  OBD2 obd2(g_mock_iso_tp);
+
+  g_mock_iso_tp.add_receive_message(
+      create_obd_response(OBD2::ENGINE_PERCENT_TORQUE_DATA, {125, 130, 200, 255, 0}));
+  const auto torque = obd2.enginePercentTorqueData();
+  TEST_ASSERT_TRUE(torque.has_value());
+  const int16_t expected_torque[] = {0, 5, 75, 130, -125};
+  TEST_ASSERT_EQUAL_INT16_ARRAY(expected_torque, torque->data(), 5);
+
+  // В таблице четыре величины SCR: пятый элемент массива - ноль
+  g_mock_iso_tp.add_receive_message(
+      create_obd_response(OBD2::SCR_INDUCE_SYSTEM, {0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04}));
+  const auto scr = obd2.scrInduceSystem();
+  TEST_ASSERT_TRUE(scr.has_value());
+  const uint16_t expected_scr[] = {1, 2, 3, 4, 0};
+  TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_scr, scr->data(), 5);
+}
+
+// Тест 4: Значения группового ответа по таблице
+void test_obd2_pid_table_batch_values() {
+  setup_mock_for_all_pids(g_mock_iso_tp);
+  OBD2 obd2(g_mock_iso_tp);
+
+  // 24 (4 байта), 42 (2 байта: 12.5 В), 5C (1 байт: 90 - 40)
+  MockMessage response = create_obd_response(OBD2::OXYGEN_SENSOR_1_B, {0x80, 0x00, 0x40, 0x00});
+  const uint8_t tail[] = {OBD2::CONTROL_MODULE_VOLTAGE, 0x30, 0xD4, OBD2::ENGINE_OIL_TEMP, 90};
+  memcpy(&response.data[response.len], tail, sizeof(tail));
+  response.len += sizeof(tail);
+  g_mock_iso_tp.add_receive_message(response);
+
+  const uint8_t pids[] = {OBD2::OXYGEN_SENSOR_1_B, OBD2::CONTROL_MODULE_VOLTAGE, OBD2::ENGINE_OIL_TEMP};
+  OBD2::PidResults results;
+  TEST_ASSERT_EQUAL_size_t(3, obd2.readPids(Span<const uint8_t>(pids, sizeof(pids)), results));
+  TEST_ASSERT_EQUAL_FLOAT(2.0f, results.value(OBD2::OXYGEN_SENSOR_1_B, 1).value());
+  TEST_ASSERT_EQUAL_FLOAT(12.5f, results.value(OBD2::CONTROL_MODULE_VOLTAGE).value());
+  TEST_ASSERT_EQUAL_FLOAT(50.0f, results.value(OBD2::ENGINE_OIL_TEMP).value());
+  TEST_ASSERT_FALSE(results.value(OBD2::ENGINE_RPM).has_value());
+}
+
+extern "C" void run_obd2_pid_table_tests() {
+  RUN_TEST(test_obd2_pid_table_descriptors);
+  RUN_TEST(test_obd2_pid_table_read_by_id);
+  RUN_TEST(test_obd2_pid_table_arrays);
+  RUN_TEST(test_obd2_pid_table_batch_values);
+}
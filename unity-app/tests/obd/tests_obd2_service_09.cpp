@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <cstring>
+
+#include "mock_iso_tp.h"
+#include "obd2.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ OBD2 SERVICE 09 (ПОТОКОВЫЙ РАЗБОР МНОГОКАДРОВЫХ ОТВЕТОВ)
+// ============================================================================
+
+/*
+ * Мок отдает ответ фрагментами как IsoTp (FF 6 байт, CF по 7 байт),
+ * поэтому значения и строки пересекают границы кадров.
+ */
+
+static MockIsoTp g_mock_iso_tp;
+
+static MockMessage create_service_09_response(uint8_t pid, const uint8_t* payload, size_t len) {
+  MockMessage mock_msg;
+  mock_msg.tx_id   = 0x7DF;
+  mock_msg.rx_id   = 0x7E8;
+  mock_msg.len     = len + 2;
+  mock_msg.data[0] = 0x49;
+  mock_msg.data[1] = pid;
+  memcpy(&mock_msg.data[2], payload, len);
+  return mock_msg;
+}
+
+// Тест 1: VIN из 20-байтного многокадрового ответа
+void test_obd2_service_09_vin() {
+  g_mock_iso_tp.reset();
+
+  const char* vin     = "W0L000043MB541326";
+  uint8_t payload[18] = {0x01};
+  memcpy(&payload[1], vin, 17);
+  g_mock_iso_tp.add_receive_message(create_service_09_response(0x02, payload, sizeof(payload)));
+
+  OBD2 obd2(g_mock_iso_tp);
+  char vin_buffer[18];
+  TEST_ASSERT_TRUE(obd2.getVIN(vin_buffer, sizeof(vin_buffer)));
+  TEST_ASSERT_EQUAL_STRING(vin, vin_buffer);
+}
+
+// Тест 2: Отрицательный ответ на запрос VIN
+void test_obd2_service_09_vin_negative_response() {
+  g_mock_iso_tp.reset();
+  g_mock_iso_tp.add_receive_message(create_obd_error_response(0x7E8, 0x09, 0x31));
+
+  OBD2 obd2(g_mock_iso_tp);
+  char vin_buffer[18];
+  TEST_ASSERT_FALSE(obd2.getVIN(vin_buffer, sizeof(vin_buffer)));
+  TEST_ASSERT_EQUAL_STRING("", vin_buffer);
+}
+
+// Тест 3: CVN, пересекающие границы кадров
+void test_obd2_service_09_cvn_across_frames() {
+  g_mock_iso_tp.reset();
+
+  const uint8_t payload[13] = {0x03, 0x11, 0x22, 0x33, 0x44, 0xAA, 0xBB, 0xCC, 0xDD, 0x01, 0x02, 0x03, 0x04};
+  g_mock_iso_tp.add_receive_message(create_service_09_response(0x06, payload, sizeof(payload)));
+
+  OBD2 obd2(g_mock_iso_tp);
+  uint32_t cvn[4] = {0};
+  size_t count    = 0;
+  TEST_ASSERT_TRUE(obd2.getCalibrationVerificationNumbers(cvn, 4, &count));
+  TEST_ASSERT_EQUAL_UINT32(3, count);
+  TEST_ASSERT_EQUAL_HEX32(0x11223344, cvn[0]);
+  TEST_ASSERT_EQUAL_HEX32(0xAABBCCDD, cvn[1]);
+  TEST_ASSERT_EQUAL_HEX32(0x01020304, cvn[2]);
+}
+
+// Тест 4: Ограничение количества значений размером буфера
+void test_obd2_service_09_perf_tracking_limited_by_buffer() {
+  g_mock_iso_tp.reset();
+
+  const uint8_t payload[9] = {0x04, 0x00, 0x01, 0x00, 0x02, 0x00, 0x03, 0x00, 0x04};
+  g_mock_iso_tp.add_receive_message(create_service_09_response(0x08, payload, sizeof(payload)));
+
+  OBD2 obd2(g_mock_iso_tp);
+  uint16_t values[3] = {0};
+  size_t count       = 0;
+  TEST_ASSERT_TRUE(obd2.getPerformanceTrackingSparkIgnition(values, 3, &count));
+  TEST_ASSERT_EQUAL_UINT32(3, count);
+  TEST_ASSERT_EQUAL_UINT16(1, values[0]);
+  TEST_ASSERT_EQUAL_UINT16(2, values[1]);
+  TEST_ASSERT_EQUAL_UINT16(3, values[2]);
+}
+
+// Тест 5: Имя ЭБУ с заполнением нулями
+void test_obd2_service_09_ecu_name() {
+  g_mock_iso_tp.reset();
+
+  uint8_t payload[21] = {0x01, 'E', 'C', 'M', '-', 'E', 'n', 'g', 'i', 'n', 'e'};
+  g_mock_iso_tp.add_receive_message(create_service_09_response(0x0A, payload, sizeof(payload)));
+
+  OBD2 obd2(g_mock_iso_tp);
+  char name[32];
+  TEST_ASSERT_TRUE(obd2.getEcuName(name, sizeof(name)));
+  TEST_ASSERT_EQUAL_STRING("ECM-Engine", name);
+}
+
+extern "C" void run_obd2_service_09_tests() {
+  RUN_TEST(test_obd2_service_09_vin);
+  RUN_TEST(test_obd2_service_09_vin_negative_response);
+  RUN_TEST(test_obd2_service_09_cvn_across_frames);
+  RUN_TEST(test_obd2_service_09_perf_tracking_limited_by_buffer);
+  RUN_TEST(test_obd2_service_09_ecu_name);
+}
@@ -13,6 +13,7 @@
  * ПОЛНОЕ ПОКРЫТИЕ ТЕСТАМИ PID ГРУППЫ 1-20:
  *
  * ✅ PID 00 - supportedPIDs_1_20() - поддерживаемые PID 1-20
+ * ✅ PID 00 - supportedPidsAllEcus() - поддерживаемые PID всех ЭБУ (запрос 0x7DF)
  * ✅ PID 01 - monitorStatus() - статус мониторинга с момента очистки DTC
  * ✅ PID 02 - freezeDTC() - замороженные DTC
  * ✅ PID 03 - fuelSystemStatus() - статус топливной системы
@@ -99,6 +100,29 @@ void test_pid_00_supported_pids_bit_check() {
   TEST_ASSERT_TRUE_MESSAGE(pid_13_supported, "PID 13 должен быть поддержан");
 }
 
+// Тест 2a: supportedPidsAllEcus - маски всех ЭБУ одним функциональным запросом
+void test_pid_00_supported_pids_all_ecus() {
+  g_mock_iso_tp.reset();
+  g_mock_iso_tp.functional_responses.push_back(
+      create_obd_response_4_bytes(0x7E8, SERVICE_01, SUPPORTED_PIDS_1_20, 0xBE, 0x1F, 0xA8, 0x13));
+  g_mock_iso_tp.functional_responses.push_back(create_obd_error_response(0x7E9, SERVICE_01, 0x12));
+  g_mock_iso_tp.functional_responses.push_back(
+      create_obd_response_4_bytes(0x7EB, SERVICE_01, SUPPORTED_PIDS_1_20, 0x80, 0x00, 0x00, 0x01));
+
+  OBD2 obd2(g_mock_iso_tp);
+  std::array<OBD2::EcuResponse, OBD2::kMaxEcus> ecus;
+  TEST_ASSERT_EQUAL_INT(2, obd2.supportedPidsAllEcus(SUPPORTED_PIDS_1_20, ecus));
+
+  TEST_ASSERT_EQUAL_INT_MESSAGE(1, g_mock_iso_tp.sent_messages.size(), "Один запрос на все ЭБУ");
+  TEST_ASSERT_EQUAL_HEX32(0x7DF, g_mock_iso_tp.last_sent_message.tx_id);
+
+  TEST_ASSERT_EQUAL_HEX16(0x7E8, ecus[0].rx_id);
+  TEST_ASSERT_EQUAL_HEX8(0xBE, ecus[0].data[0]);
+  TEST_ASSERT_EQUAL_HEX8(0x13, ecus[0].data[3]);
+  TEST_ASSERT_EQUAL_HEX16(0x7EB, ecus[1].rx_id);
+  TEST_ASSERT_EQUAL_HEX8(0x80, ecus[1].data[0]);
+}
+
 // ============================================================================
 // PID 01 - MONITOR STATUS ТЕСТЫ
 // ============================================================================
@@ -1017,6 +1041,7 @@ extern "C" void run_obd_pid_group_1_20_tests() {
   // PID 00 - supportedPIDs_1_20
   RUN_TEST(test_pid_00_supported_pids_1_20_valid_data);
   RUN_TEST(test_pid_00_supported_pids_bit_check);
+  RUN_TEST(test_pid_00_supported_pids_all_ecus);
 
   // PID 01 - monitorStatus
   RUN_TEST(test_pid_01_monitor_status_valid_data);
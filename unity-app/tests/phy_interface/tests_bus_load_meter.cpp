@@ -0,0 +1,167 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "bus_load_meter.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ИЗМЕРИТЕЛЯ ЗАГРУЗКИ ШИНЫ
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ДЛИНА КАДРА:
+ * - Худший случай стаффинга для стандартного и расширенного ID, RTR
+ *
+ * ✅ ОКНА:
+ * - Окна 100 мс, 1 с и 10 с учитывают только завершенные корзины
+ * - Загрузка в промилле от скорости шины, ограничена 1000
+ * - После паузы старые корзины не попадают в окно, переполнение времени
+ *
+ * ✅ ЧАСТОТА ПО ID:
+ * - Кадры в секунду по ID (стандартный и расширенный ID различаются)
+ * - Молчащий ID дает 0, ID сверх таблицы учитываются как неотслеживаемые
+ */
+
+namespace {
+
+const uint32_t kBitrate = 500000;
+
+TwaiFrame make_frame(uint32_t id, uint8_t len, bool is_extended = false) {
+  TwaiFrame frame   = {};
+  frame.id          = id;
+  frame.is_extended = is_extended;
+  frame.data_length = len;
+  return frame;
+}
+
+}  // namespace
+
+// Тест 1: Длина кадра на шине
+void test_bus_load_frame_bits() {
+  TEST_ASSERT_EQUAL_UINT32(135, BusLoadMeter::FrameBits(make_frame(0x7E0, 8)));
+  TEST_ASSERT_EQUAL_UINT32(160, BusLoadMeter::FrameBits(make_frame(0x18DAF110, 8, true)));
+  TEST_ASSERT_EQUAL_UINT32(55, BusLoadMeter::FrameBits(make_frame(0x100, 0)));
+
+  TwaiFrame rtr = make_frame(0x100, 8);
+  rtr.is_rtr    = true;
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(55, BusLoadMeter::FrameBits(rtr), "RTR carries no data field");
+}
+
+// Тест 2: Окна усреднения
+void test_bus_load_windows() {
+  BusLoadMeter meter(kBitrate);
+  const uint32_t start = 5000000;
+
+  // 10 с по 10 кадров каждые 100 мс, в последнюю секунду по 20
+  for (uint32_t bucket = 0; bucket < 100; bucket++) {
+    const uint32_t frames = (bucket >= 90) ? 20 : 10;
+    for (uint32_t i = 0; i < frames; i++) {
+      meter.OnFrame(make_frame(0x7E8, 8), start + bucket * BusLoadMeter::kBucketUs + i * 1000);
+    }
+  }
+
+  // Текущая корзина (еще заполняется) в окна не входит
+  const uint32_t now = start + 100 * BusLoadMeter::kBucketUs + 10;
+  meter.OnFrame(make_frame(0x7E8, 8), now);
+
+  const BusLoadMeter::Load last_100ms = meter.GetLoad(BusLoadMeter::Window::WINDOW_100MS, now);
+  TEST_ASSERT_EQUAL_UINT32(20, last_100ms.frames);
+  TEST_ASSERT_EQUAL_UINT32(20 * 135, last_100ms.bits);
+  TEST_ASSERT_EQUAL_UINT32(200, last_100ms.frames_per_s);
+  TEST_ASSERT_EQUAL_UINT16(20 * 135 * 1000 / (kBitrate / 10), last_100ms.permille);
+
+  const BusLoadMeter::Load last_1s = meter.GetLoad(BusLoadMeter::Window::WINDOW_1S, now);
+  TEST_ASSERT_EQUAL_UINT32(200, last_1s.frames);
+  TEST_ASSERT_EQUAL_UINT32(200, last_1s.frames_per_s);
+  TEST_ASSERT_EQUAL_UINT16(54, last_1s.permille);  // 27000 бит из 500000
+
+  const BusLoadMeter::Load last_10s = meter.GetLoad(BusLoadMeter::Window::WINDOW_10S, now);
+  TEST_ASSERT_EQUAL_UINT32(900 + 200, last_10s.frames);
+  TEST_ASSERT_EQUAL_UINT32(110, last_10s.frames_per_s);
+
+  // Через 1.5 с тишины окно 1 с пусто, из окна 10 с ушли корзины 0-14
+  const uint32_t later = now + 15 * BusLoadMeter::kBucketUs;
+  TEST_ASSERT_EQUAL_UINT32(0, meter.GetLoad(BusLoadMeter::Window::WINDOW_1S, later).frames);
+  TEST_ASSERT_EQUAL_UINT32(1 + 200 + 10 * (90 - 15), meter.GetLoad(BusLoadMeter::Window::WINDOW_10S, later).frames);
+
+  // После паузы дольше 10 с все корзины устарели
+  const uint32_t idle = now + 200 * BusLoadMeter::kBucketUs;
+  meter.OnFrame(make_frame(0x7E8, 8), idle);
+  TEST_ASSERT_EQUAL_UINT32(0, meter.GetLoad(BusLoadMeter::Window::WINDOW_10S, idle).frames);
+  TEST_ASSERT_EQUAL_UINT32(1, meter.GetLoad(BusLoadMeter::Window::WINDOW_100MS, idle + BusLoadMeter::kBucketUs).frames);
+}
+
+// Тест 3: Насыщение и переполнение времени
+void test_bus_load_saturation_and_wrap() {
+  BusLoadMeter meter(kBitrate);
+  const uint32_t start = UINT32_MAX - 50000;
+
+  // 500 кадров за 100 мс не помещаются на шину 500 кбит/с
+  for (uint32_t i = 0; i < 500; i++) {
+    meter.OnFrame(make_frame(0x7E8, 8), start + i * 100);
+  }
+  const uint32_t now                 = start + BusLoadMeter::kBucketUs;  // После переполнения
+  const BusLoadMeter::Load saturated = meter.GetLoad(BusLoadMeter::Window::WINDOW_100MS, now);
+  TEST_ASSERT_EQUAL_UINT32(500, saturated.frames);
+  TEST_ASSERT_EQUAL_UINT16(1000, saturated.permille);
+
+  // Время чтения чуть раньше последнего кадра не сдвигает окно
+  TEST_ASSERT_EQUAL_UINT32(0, meter.GetLoad(BusLoadMeter::Window::WINDOW_100MS, start - 10).frames);
+
+  BusLoadMeter empty(kBitrate);
+  TEST_ASSERT_EQUAL_UINT32(0, empty.GetLoad(BusLoadMeter::Window::WINDOW_10S, 12345).frames);
+  TEST_ASSERT_EQUAL_UINT32(0, empty.FrameRate(0x7E8, false, 12345));
+}
+
+// Тест 4: Частота кадров по ID
+void test_bus_load_frame_rate() {
+  BusLoadMeter meter(kBitrate);
+  const uint32_t start = 1000000;
+
+  // Первая секунда: 0x100 - 10 кадров, расширенный 0x100 - 3, 0x200 - 5
+  for (uint32_t i = 0; i < 10; i++) {
+    meter.OnFrame(make_frame(0x100, 8), start + i * 50000);
+  }
+  for (uint32_t i = 0; i < 3; i++) {
+    meter.OnFrame(make_frame(0x100, 8, true), start + i * 50000);
+  }
+  for (uint32_t i = 0; i < 5; i++) {
+    meter.OnFrame(make_frame(0x200, 8), start + i * 50000);
+  }
+
+  // Секунда еще идет: завершенной секунды нет
+  TEST_ASSERT_EQUAL_UINT32(0, meter.FrameRate(0x100, false, start + 600000));
+
+  // Вторая секунда: только 0x100, 4 кадра
+  const uint32_t second = start + 1000000;
+  for (uint32_t i = 0; i < 4; i++) {
+    meter.OnFrame(make_frame(0x100, 8), second + i * 100000);
+  }
+  TEST_ASSERT_EQUAL_UINT32(10, meter.FrameRate(0x100, false, second + 500000));
+  TEST_ASSERT_EQUAL_UINT32(3, meter.FrameRate(0x100, true, second + 500000));
+  TEST_ASSERT_EQUAL_UINT32(5, meter.FrameRate(0x200, false, second + 500000));
+  TEST_ASSERT_EQUAL_UINT32(0, meter.FrameRate(0x300, false, second + 500000));
+
+  const uint32_t third = second + 1000000;
+  TEST_ASSERT_EQUAL_UINT32(4, meter.FrameRate(0x100, false, third + 10));
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, meter.FrameRate(0x200, false, third + 10), "Silent ID");
+  TEST_ASSERT_EQUAL_UINT32(0, meter.FrameRate(0x100, false, third + 1000000));
+
+  // ID сверх таблицы учитываются в загрузке, но не по отдельности
+  BusLoadMeter full(kBitrate);
+  for (uint32_t id = 0; id < BusLoadMeter::kIdSlots + 16; id++) {
+    full.OnFrame(make_frame(id, 8), start);
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(16, full.UntrackedFrames());
+  const BusLoadMeter::Load load = full.GetLoad(BusLoadMeter::Window::WINDOW_100MS, start + BusLoadMeter::kBucketUs);
+  TEST_ASSERT_EQUAL_UINT32(BusLoadMeter::kIdSlots + 16, load.frames);
+}
+
+extern "C" void run_bus_load_meter_tests() {
+  RUN_TEST(test_bus_load_frame_bits);
+  RUN_TEST(test_bus_load_windows);
+  RUN_TEST(test_bus_load_saturation_and_wrap);
+  RUN_TEST(test_bus_load_frame_rate);
+}
@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "can_acceptance_filter.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ СЛИЯНИЯ ФИЛЬТРОВ В АППАРАТНЫЙ ФИЛЬТР TWAI
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ РЕЖИМЫ:
+ * - Без фильтров, смешение форматов ID, переполнение входа - прием всего
+ * - Один фильтр переносится без изменений
+ * - Три 11-битных фильтра - двойной фильтр с минимальным покрытием
+ * - 29-битные ID: двойной фильтр только по битам 28..13, выбор с меньшим покрытием
+ *
+ * ✅ КОРРЕКТНОСТЬ:
+ * - Любой ID, нужный подписчикам, проходит аппаратный фильтр (перебор 11-битных ID)
+ * - Сравнение фильтров для перепрограммирования
+ */
+
+namespace {
+
+CanIdFilter make_filter(uint32_t id, uint32_t mask, bool is_extended = false) {
+  CanIdFilter filter;
+  filter.id          = id;
+  filter.mask        = mask;
+  filter.is_extended = is_extended;
+  return filter;
+}
+
+TwaiFrame make_frame(uint32_t id, bool is_extended = false) {
+  TwaiFrame frame   = {};
+  frame.id          = id;
+  frame.is_extended = is_extended;
+  frame.data_length = 8;
+  return frame;
+}
+
+bool any_matches(const CanIdFilter* filters, size_t count, const TwaiFrame& frame) {
+  for (size_t i = 0; i < count; i++) {
+    if (filters[i].Matches(frame)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// Тест 1: Случаи, когда аппаратный фильтр не сужает прием
+void test_can_acceptance_filter_accept_all() {
+  TEST_ASSERT_TRUE(CanAcceptanceFilter::Merge(Span<const CanIdFilter>()).mode ==
+                   CanAcceptanceFilter::Mode::ACCEPT_ALL);
+
+  const CanIdFilter mixed[] = {make_filter(0x7E8, 0x7F8), make_filter(0x18DAF110, 0x1FFFFFFF, true)};
+  TEST_ASSERT_TRUE(CanAcceptanceFilter::Merge(Span<const CanIdFilter>(mixed)).mode ==
+                   CanAcceptanceFilter::Mode::ACCEPT_ALL);
+
+  CanIdFilter many[CanAcceptanceFilter::kMaxInputFilters + 1];
+  for (size_t i = 0; i < CanAcceptanceFilter::kMaxInputFilters + 1; i++) {
+    many[i] = make_filter(0x700 + i, 0x7FF);
+  }
+  const CanAcceptanceFilter overflow = CanAcceptanceFilter::Merge(Span<const CanIdFilter>(many));
+  TEST_ASSERT_TRUE(overflow.mode == CanAcceptanceFilter::Mode::ACCEPT_ALL);
+  TEST_ASSERT_TRUE(overflow.Accepts(make_frame(0x123)));
+  TEST_ASSERT_TRUE(overflow.Accepts(make_frame(0x18DAF110, true)));
+
+  // Фильтры, покрывающие все ID, тоже ничего не отсекают
+  const CanIdFilter wide[] = {make_filter(0x000, 0x400), make_filter(0x400, 0x400)};
+  TEST_ASSERT_TRUE(CanAcceptanceFilter::Merge(Span<const CanIdFilter>(wide)).mode ==
+                   CanAcceptanceFilter::Mode::ACCEPT_ALL);
+}
+
+// Тест 2: Один фильтр переносится в одиночный режим
+void test_can_acceptance_filter_single() {
+  const CanIdFilter obd[]          = {make_filter(0x7EF, 0x7F8)};
+  const CanAcceptanceFilter merged = CanAcceptanceFilter::Merge(Span<const CanIdFilter>(obd));
+
+  TEST_ASSERT_TRUE(merged.mode == CanAcceptanceFilter::Mode::SINGLE);
+  TEST_ASSERT_FALSE(merged.is_extended);
+  TEST_ASSERT_EQUAL_HEX32(0x7E8, merged.filters[0].id);
+  TEST_ASSERT_EQUAL_HEX32(0x7F8, merged.filters[0].mask);
+  TEST_ASSERT_EQUAL_UINT32(8, merged.Coverage());
+  TEST_ASSERT_TRUE(merged.Accepts(make_frame(0x7EC)));
+  TEST_ASSERT_FALSE(merged.Accepts(make_frame(0x7E0)));
+  TEST_ASSERT_FALSE_MESSAGE(merged.Accepts(make_frame(0x7E8, true)), "11-bit filter rejects 29-bit frames");
+}
+
+// Тест 3: Три 11-битных фильтра сводятся к двойному
+void test_can_acceptance_filter_dual_standard() {
+  // Ответы ЭБУ, функциональный запрос другого тестера и отдельный датчик
+  const CanIdFilter filters[]      = {make_filter(0x7E8, 0x7F8), make_filter(0x7DF, 0x7FF), make_filter(0x100, 0x7FF)};
+  const CanAcceptanceFilter merged = CanAcceptanceFilter::Merge(Span<const CanIdFilter>(filters));
+
+  TEST_ASSERT_TRUE(merged.mode == CanAcceptanceFilter::Mode::DUAL);
+  TEST_ASSERT_EQUAL_UINT32_MESSAGE(33, merged.Coverage(), "7E8/7DF merged into 32 IDs, 0x100 kept exact");
+  for (uint32_t id = 0; id < 0x800; id++) {
+    if (any_matches(filters, 3, make_frame(id))) {
+      TEST_ASSERT_TRUE(merged.Accepts(make_frame(id)));
+    }
+  }
+  TEST_ASSERT_FALSE(merged.Accepts(make_frame(0x123)));
+  TEST_ASSERT_FALSE(merged.Accepts(make_frame(0x101)));
+}
+
+// Тест 4: 29-битные ID - двойной фильтр грубее одиночного
+void test_can_acceptance_filter_extended() {
+  // Соседние ID: одиночный фильтр точнее двойного (у него не сравниваются биты 12..0)
+  const CanIdFilter near[]         = {make_filter(0x18DAF110, 0x1FFFFFFF, true),
+                                      make_filter(0x18DAF118, 0x1FFFFFFF, true)};
+  const CanAcceptanceFilter single = CanAcceptanceFilter::Merge(Span<const CanIdFilter>(near));
+  TEST_ASSERT_TRUE(single.mode == CanAcceptanceFilter::Mode::SINGLE);
+  TEST_ASSERT_TRUE(single.is_extended);
+  TEST_ASSERT_EQUAL_UINT32(2, single.Coverage());
+  TEST_ASSERT_FALSE(single.Accepts(make_frame(0x18DAF110)));
+
+  // Далекие ID: двойной фильтр по старшим 16 битам пропускает меньше
+  const CanIdFilter far[]        = {make_filter(0x18DAF110, 0x1FFFFFFF, true),
+                                    make_filter(0x0CF004EF, 0x1FFFFFFF, true)};
+  const CanAcceptanceFilter dual = CanAcceptanceFilter::Merge(Span<const CanIdFilter>(far));
+  TEST_ASSERT_TRUE(dual.mode == CanAcceptanceFilter::Mode::DUAL);
+  TEST_ASSERT_EQUAL_HEX32(CanAcceptanceFilter::kDualExtendedMask, dual.filters[0].mask);
+  TEST_ASSERT_EQUAL_UINT32(2 * 8192, dual.Coverage());
+  TEST_ASSERT_TRUE(dual.Accepts(make_frame(0x18DAF110, true)));
+  TEST_ASSERT_TRUE(dual.Accepts(make_frame(0x0CF004EF, true)));
+  TEST_ASSERT_TRUE_MESSAGE(dual.Accepts(make_frame(0x18DAF1F1, true)), "Bits 12..0 are not compared");
+  TEST_ASSERT_FALSE(dual.Accepts(make_frame(0x18DB33F1, true)));
+}
+
+// Тест 5: Случайные наборы фильтров - нужные ID всегда проходят
+void test_can_acceptance_filter_covers_union() {
+  uint32_t seed = 0x12345678;
+  auto next     = [&seed]() {
+    seed = seed * 1664525u + 1013904223u;
+    return seed >> 8;
+  };
+
+  for (int round = 0; round < 50; round++) {
+    CanIdFilter filters[6];
+    const size_t count = 1 + next() % 6;
+    for (size_t i = 0; i < count; i++) {
+      // Маски с несколькими свободными младшими битами, как у реальных подписок
+      filters[i] = make_filter(next() & 0x7FF, 0x7FF & ~((1u << (next() % 4)) - 1));
+    }
+    const CanAcceptanceFilter merged = CanAcceptanceFilter::Merge(Span<const CanIdFilter>(filters, count));
+
+    uint32_t needed = 0;
+    for (uint32_t id = 0; id < 0x800; id++) {
+      if (any_matches(filters, count, make_frame(id))) {
+        needed++;
+        TEST_ASSERT_TRUE(merged.Accepts(make_frame(id)));
+      }
+    }
+    const bool accept_all = merged.mode == CanAcceptanceFilter::Mode::ACCEPT_ALL;
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(needed, accept_all ? 0x800 : merged.Coverage());
+  }
+}
+
+// Тест 6: Сравнение фильтров для решения о перепрограммировании
+void test_can_acceptance_filter_compare() {
+  const CanIdFilter a[] = {make_filter(0x7E8, 0x7F8)};
+  const CanIdFilter b[] = {make_filter(0x7EF, 0x7F8)};
+  const CanIdFilter c[] = {make_filter(0x7E8, 0x7FF)};
+
+  TEST_ASSERT_TRUE(CanAcceptanceFilter::Merge(Span<const CanIdFilter>(a)) ==
+                   CanAcceptanceFilter::Merge(Span<const CanIdFilter>(b)));
+  TEST_ASSERT_TRUE(CanAcceptanceFilter::Merge(Span<const CanIdFilter>(a)) !=
+                   CanAcceptanceFilter::Merge(Span<const CanIdFilter>(c)));
+  TEST_ASSERT_TRUE(CanAcceptanceFilter() == CanAcceptanceFilter::Merge(Span<const CanIdFilter>()));
+}
+
+extern "C" void run_can_acceptance_filter_tests() {
+  RUN_TEST(test_can_acceptance_filter_accept_all);
+  RUN_TEST(test_can_acceptance_filter_single);
+  RUN_TEST(test_can_acceptance_filter_dual_standard);
+  RUN_TEST(test_can_acceptance_filter_extended);
+  RUN_TEST(test_can_acceptance_filter_covers_union);
+  RUN_TEST(test_can_acceptance_filter_compare);
+}
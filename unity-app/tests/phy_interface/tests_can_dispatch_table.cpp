@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "can_dispatch_table.h"
+#include "twai_subscriber_iso_tp.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ТАБЛИЦЫ МАРШРУТИЗАЦИИ ПО CAN ID
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ 11-БИТНЫЕ ID:
+ * - Фильтры id/mask нескольких маршрутов, маршрут без фильтров получает все кадры
+ *
+ * ✅ 29-БИТНЫЕ ID:
+ * - Одинаковые фильтры разных маршрутов объединяются, лимит фильтров
+ * - Формат ID фильтра и кадра должен совпадать
+ *
+ * ✅ ПОСТРОЕНИЕ:
+ * - Очистка таблицы, номер маршрута вне таблицы
+ * - Таблица по фильтрам подписчика совпадает с его isInterested
+ */
+
+namespace {
+
+TwaiFrame make_frame(uint32_t id, bool is_extended) {
+  TwaiFrame frame   = {};
+  frame.id          = id;
+  frame.is_extended = is_extended;
+  frame.data_length = 8;
+  return frame;
+}
+
+CanIdFilter make_filter(uint32_t id, uint32_t mask, bool is_extended) {
+  CanIdFilter filter;
+  filter.id          = id;
+  filter.mask        = mask;
+  filter.is_extended = is_extended;
+  return filter;
+}
+
+// Таблица 11-битных ID занимает 2 КБ: статическая, как в драйвере
+CanDispatchTable table;
+
+}  // namespace
+
+// Тест 1: Маршруты 11-битных ID
+void test_can_dispatch_table_standard() {
+  table.Clear();
+
+  const CanIdFilter obd[]        = {make_filter(0x7E8, 0x7F8, false)};
+  const CanIdFilter functional[] = {make_filter(0x7DF, 0x7FF, false), make_filter(0x7E8, 0x7FF, false)};
+  TEST_ASSERT_TRUE(table.AddRoute(0, Span<const CanIdFilter>(obd)));
+  TEST_ASSERT_TRUE(table.AddRoute(1, Span<const CanIdFilter>(functional)));
+  TEST_ASSERT_TRUE(table.AddRoute(3, Span<const CanIdFilter>()));  // Сниффер: все кадры
+
+  TEST_ASSERT_EQUAL_HEX8(0x0B, table.Lookup(make_frame(0x7E8, false)));
+  TEST_ASSERT_EQUAL_HEX8(0x09, table.Lookup(make_frame(0x7EF, false)));
+  TEST_ASSERT_EQUAL_HEX8(0x0A, table.Lookup(make_frame(0x7DF, false)));
+  TEST_ASSERT_EQUAL_HEX8(0x08, table.Lookup(make_frame(0x123, false)));
+  TEST_ASSERT_EQUAL_HEX8_MESSAGE(0x08, table.Lookup(make_frame(0x7E8, true)), "11-bit filter ignores 29-bit frame");
+}
+
+// Тест 2: Маршруты 29-битных ID
+void test_can_dispatch_table_extended() {
+  table.Clear();
+
+  const CanIdFilter engine[]  = {make_filter(0x18DAF110, 0x1FFFFFFF, true)};
+  const CanIdFilter all_uds[] = {make_filter(0x18DAF100, 0x1FFFFF00, true), make_filter(0x18DAF110, 0x1FFFFFFF, true)};
+  TEST_ASSERT_TRUE(table.AddRoute(0, Span<const CanIdFilter>(engine)));
+  TEST_ASSERT_TRUE(table.AddRoute(1, Span<const CanIdFilter>(all_uds)));
+
+  TEST_ASSERT_EQUAL_HEX8(0x03, table.Lookup(make_frame(0x18DAF110, true)));
+  TEST_ASSERT_EQUAL_HEX8(0x02, table.Lookup(make_frame(0x18DAF133, true)));
+  TEST_ASSERT_EQUAL_HEX8(0x00, table.Lookup(make_frame(0x18DB33F1, true)));
+  TEST_ASSERT_EQUAL_HEX8_MESSAGE(0x00, table.Lookup(make_frame(0x110, false)), "29-bit filter ignores 11-bit frame");
+
+  // Два уникальных фильтра заняты, остальные до лимита
+  CanIdFilter many[CanDispatchTable::kMaxExtendedFilters - 2];
+  for (size_t i = 0; i < CanDispatchTable::kMaxExtendedFilters - 2; i++) {
+    many[i] = make_filter(0x18DA0000 + i, 0x1FFFFFFF, true);
+  }
+  TEST_ASSERT_TRUE(table.AddRoute(2, Span<const CanIdFilter>(many)));
+
+  const CanIdFilter extra[] = {make_filter(0x18DAFFFF, 0x1FFFFFFF, true), make_filter(0x700, 0x700, false)};
+  TEST_ASSERT_FALSE_MESSAGE(table.AddRoute(4, Span<const CanIdFilter>(extra)), "29-bit filters exhausted");
+  TEST_ASSERT_EQUAL_HEX8_MESSAGE(0x10, table.Lookup(make_frame(0x701, false)), "11-bit filter still added");
+  TEST_ASSERT_EQUAL_HEX8(0x04, table.Lookup(make_frame(0x18DA0005, true)));
+}
+
+// Тест 3: Очистка и номер маршрута вне таблицы
+void test_can_dispatch_table_clear() {
+  table.Clear();
+  TEST_ASSERT_TRUE(table.AddRoute(0, Span<const CanIdFilter>()));
+  TEST_ASSERT_FALSE(table.AddRoute(CanDispatchTable::kMaxRoutes, Span<const CanIdFilter>()));
+  TEST_ASSERT_EQUAL_HEX8(0x01, table.Lookup(make_frame(0x555, false)));
+
+  table.Clear();
+  TEST_ASSERT_EQUAL_HEX8(0x00, table.Lookup(make_frame(0x555, false)));
+  TEST_ASSERT_EQUAL_HEX8(0x00, table.Lookup(make_frame(0x18DAF110, true)));
+}
+
+// Тест 4: Таблица по фильтрам подписчика ISO-TP совпадает с isInterested
+void test_can_dispatch_table_subscriber_filters() {
+  TwaiSubscriberIsoTp subscriber;
+  TEST_ASSERT_EQUAL_size_t(0, subscriber.rxFilters().size());
+  TEST_ASSERT_TRUE(subscriber.AddRxFilter(0x7E8, 0x7F8, false));
+  TEST_ASSERT_TRUE(subscriber.AddRxFilter(0x18DAF100, 0x1FFFFF00, true));
+  TEST_ASSERT_EQUAL_size_t(2, subscriber.rxFilters().size());
+
+  table.Clear();
+  TEST_ASSERT_TRUE(table.AddRoute(0, subscriber.rxFilters()));
+
+  for (uint32_t id = 0; id < 0x800; id++) {
+    const TwaiFrame frame = make_frame(id, false);
+    TEST_ASSERT_EQUAL(subscriber.isInterested(frame), table.Lookup(frame) == 0x01);
+  }
+  const uint32_t extended_ids[] = {0x18DAF100, 0x18DAF1FF, 0x18DAF200, 0x18DB33F1, 0x7E8};
+  for (uint32_t id : extended_ids) {
+    const TwaiFrame frame = make_frame(id, true);
+    TEST_ASSERT_EQUAL(subscriber.isInterested(frame), table.Lookup(frame) == 0x01);
+  }
+}
+
+extern "C" void run_can_dispatch_table_tests() {
+  RUN_TEST(test_can_dispatch_table_standard);
+  RUN_TEST(test_can_dispatch_table_extended);
+  RUN_TEST(test_can_dispatch_table_clear);
+  RUN_TEST(test_can_dispatch_table_subscriber_filters);
+}
@@ -0,0 +1,189 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "can_signal.h"
+#include "can_sniffer.h"
+#include "mock_twai_interface.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ПАССИВНОГО ПРИЕМА СИГНАЛОВ (CanSignal, CanSniffer)
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ИЗВЛЕЧЕНИЕ СИГНАЛА:
+ * - Intel и Motorola, в том числе через границу байта
+ * - Знаковые сигналы, масштаб и смещение
+ * - Сигнал за пределами DLC и некорректная длина отклоняются
+ *
+ * ✅ ПОДПИСЧИК:
+ * - Фильтр на каждый ID таблицы, при переполнении - прием всех кадров
+ * - Кадр декодируется в прерывании, Poll() передает только обновленные сигналы
+ */
+
+namespace {
+
+CanSignal make_signal(uint32_t id, uint8_t start_bit, uint8_t length, CanSignal::ByteOrder order) {
+  CanSignal signal;
+  signal.id         = id;
+  signal.start_bit  = start_bit;
+  signal.length     = length;
+  signal.byte_order = order;
+  return signal;
+}
+
+struct Published {
+  uint8_t tag;
+  float value;
+};
+
+void collect(const CanSignal& signal, float value, void* ctx) {
+  static_cast<std::vector<Published>*>(ctx)->push_back({signal.tag, value});
+}
+
+}  // namespace
+
+// Тест 1: Intel и Motorola
+void test_can_signal_byte_order() {
+  const TwaiFrame frame = make_frame(0x316, {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC, 0xDE, 0xF0});
+  uint32_t raw          = 0;
+
+  // Intel: 16 бит с бита 8 - байты 1 (младший) и 2
+  TEST_ASSERT_TRUE(make_signal(0x316, 8, 16, CanSignal::ByteOrder::INTEL).ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_HEX32(0x5634, raw);
+
+  // Intel внутри байта: биты 4-7 байта 0
+  TEST_ASSERT_TRUE(make_signal(0x316, 4, 4, CanSignal::ByteOrder::INTEL).ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_HEX32(0x1, raw);
+
+  // Motorola: старший бит 7 байта 1 (бит 15), 16 бит - байты 1 (старший) и 2
+  TEST_ASSERT_TRUE(make_signal(0x316, 15, 16, CanSignal::ByteOrder::MOTOROLA).ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_HEX32(0x3456, raw);
+
+  // Motorola через границу байта: биты 3-0 байта 0 и 7-4 байта 1
+  TEST_ASSERT_TRUE(make_signal(0x316, 3, 8, CanSignal::ByteOrder::MOTOROLA).ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_HEX32(0x23, raw);
+
+  // Полные 32 бита
+  TEST_ASSERT_TRUE(make_signal(0x316, 0, 32, CanSignal::ByteOrder::INTEL).ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_HEX32(0x78563412, raw);
+  TEST_ASSERT_TRUE(make_signal(0x316, 7, 32, CanSignal::ByteOrder::MOTOROLA).ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_HEX32(0x12345678, raw);
+}
+
+// Тест 2: Знак, масштаб, смещение и границы
+void test_can_signal_scaling_and_bounds() {
+  const TwaiFrame frame = make_frame(0x100, {0xF6, 0xFF, 0x7B});
+  uint32_t raw          = 0;
+
+  CanSignal temp = make_signal(0x100, 16, 8, CanSignal::ByteOrder::INTEL);
+  temp.offset    = -40.0f;
+  TEST_ASSERT_TRUE(temp.ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_FLOAT(83.0f, temp.ToPhysical(raw));  // 0x7B - 40
+
+  CanSignal torque = make_signal(0x100, 0, 16, CanSignal::ByteOrder::INTEL);
+  torque.is_signed = true;
+  torque.scale     = 0.5f;
+  TEST_ASSERT_TRUE(torque.ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_HEX32(0xFFFFFFF6, raw);
+  TEST_ASSERT_EQUAL_FLOAT(-5.0f, torque.ToPhysical(raw));
+
+  CanSignal nibble = make_signal(0x100, 0, 4, CanSignal::ByteOrder::INTEL);
+  nibble.is_signed = true;
+  TEST_ASSERT_TRUE(nibble.ExtractRaw(frame, raw));
+  TEST_ASSERT_EQUAL_FLOAT(6.0f, nibble.ToPhysical(raw));
+
+  // За пределами DLC = 3 и некорректные длины
+  TEST_ASSERT_FALSE(make_signal(0x100, 24, 8, CanSignal::ByteOrder::INTEL).ExtractRaw(frame, raw));
+  TEST_ASSERT_FALSE(make_signal(0x100, 16, 16, CanSignal::ByteOrder::INTEL).ExtractRaw(frame, raw));
+  TEST_ASSERT_FALSE(make_signal(0x100, 16, 16, CanSignal::ByteOrder::MOTOROLA).ExtractRaw(frame, raw));
+  TEST_ASSERT_FALSE(make_signal(0x100, 0, 0, CanSignal::ByteOrder::INTEL).ExtractRaw(frame, raw));
+  TEST_ASSERT_FALSE(make_signal(0x100, 0, 33, CanSignal::ByteOrder::INTEL).ExtractRaw(frame, raw));
+}
+
+// Тест 3: Фильтры подписчика
+void test_can_sniffer_filters() {
+  CanSignal signals[4] = {make_signal(0x316, 16, 16, CanSignal::ByteOrder::INTEL),
+                          make_signal(0x316, 0, 8, CanSignal::ByteOrder::INTEL),
+                          make_signal(0x329, 8, 8, CanSignal::ByteOrder::INTEL),
+                          make_signal(0x18FEF100, 8, 16, CanSignal::ByteOrder::INTEL)};
+  signals[3].is_extended = true;
+
+  CanSniffer sniffer{Span<const CanSignal>(signals)};
+  const Span<const CanIdFilter> filters = sniffer.rxFilters();
+  TEST_ASSERT_EQUAL_size_t(3, filters.size());
+  TEST_ASSERT_EQUAL_HEX32(0x316, filters[0].id);
+  TEST_ASSERT_EQUAL_HEX32(0x7FF, filters[0].mask);
+  TEST_ASSERT_EQUAL_HEX32(0x329, filters[1].id);
+  TEST_ASSERT_TRUE(filters[2].is_extended);
+  TEST_ASSERT_EQUAL_HEX32(0x1FFFFFFF, filters[2].mask);
+
+  TEST_ASSERT_TRUE(sniffer.isInterested(make_frame(0x329, {0})));
+  TEST_ASSERT_FALSE(sniffer.isInterested(make_frame(0x330, {0})));
+  TEST_ASSERT_NULL(sniffer.onTwaiMessage());
+
+  // ID больше, чем фильтров: подписчик принимает все кадры
+  CanSignal many[CanSniffer::kMaxFilters + 1];
+  for (size_t i = 0; i < CanSniffer::kMaxFilters + 1; i++) {
+    many[i] = make_signal(0x200 + i, 0, 8, CanSignal::ByteOrder::INTEL);
+  }
+  CanSniffer wide{Span<const CanSignal>(many)};
+  TEST_ASSERT_TRUE(wide.rxFilters().empty());
+}
+
+// Тест 4: Декодирование в прерывании и Poll()
+void test_can_sniffer_poll() {
+  CanSignal signals[3] = {make_signal(0x316, 16, 16, CanSignal::ByteOrder::INTEL),
+                          make_signal(0x316, 7, 8, CanSignal::ByteOrder::MOTOROLA),
+                          make_signal(0x329, 8, 8, CanSignal::ByteOrder::INTEL)};
+  signals[0].scale  = 0.25f;
+  signals[0].tag    = 1;
+  signals[1].tag    = 2;
+  signals[2].offset = -40.0f;
+  signals[2].tag    = 3;
+
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  CanSniffer sniffer{Span<const CanSignal>(signals)};
+  mock_can.RegisterSubscriber(sniffer);
+
+  std::vector<Published> published;
+  TEST_ASSERT_EQUAL_size_t(0, sniffer.Poll(collect, &published));
+
+  // Обороты 3000 (0x2EE0 * 0.25) и второй сигнал того же кадра
+  mock_can.add_receive_frame(make_frame(0x316, {0x55, 0x00, 0xE0, 0x2E, 0, 0, 0, 0}));
+  TEST_ASSERT_EQUAL_size_t(2, sniffer.Poll(collect, &published));
+  TEST_ASSERT_EQUAL_UINT8(1, published[0].tag);
+  TEST_ASSERT_EQUAL_FLOAT(3000.0f, published[0].value);
+  TEST_ASSERT_EQUAL_UINT8(2, published[1].tag);
+  TEST_ASSERT_EQUAL_FLOAT(85.0f, published[1].value);
+
+  // Без новых кадров сигналы не повторяются; побеждает последнее значение
+  TEST_ASSERT_EQUAL_size_t(0, sniffer.Poll(collect, &published));
+  mock_can.add_receive_frame(make_frame(0x329, {0x00, 0x7B, 0, 0, 0, 0, 0, 0}));
+  mock_can.add_receive_frame(make_frame(0x329, {0x00, 0x82, 0, 0, 0, 0, 0, 0}));
+  published.clear();
+  TEST_ASSERT_EQUAL_size_t(1, sniffer.Poll(collect, &published));
+  TEST_ASSERT_EQUAL_UINT8(3, published[0].tag);
+  TEST_ASSERT_EQUAL_FLOAT(90.0f, published[0].value);
+  TEST_ASSERT_EQUAL_UINT32(2, sniffer.GetUpdateCount(2));
+  TEST_ASSERT_NOT_EQUAL(0, sniffer.GetTimestampUs(2));
+
+  // Короткий кадр не обновляет сигнал, выходящий за DLC
+  mock_can.add_receive_frame(make_frame(0x316, {0x01}));
+  published.clear();
+  TEST_ASSERT_EQUAL_size_t(1, sniffer.Poll(collect, &published));
+  TEST_ASSERT_EQUAL_UINT8(2, published[0].tag);
+  TEST_ASSERT_EQUAL_UINT32(1, sniffer.GetUpdateCount(0));
+}
+
+extern "C" void run_can_sniffer_tests() {
+  RUN_TEST(test_can_signal_byte_order);
+  RUN_TEST(test_can_signal_scaling_and_bounds);
+  RUN_TEST(test_can_sniffer_filters);
+  RUN_TEST(test_can_sniffer_poll);
+}
@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "twai_recovery.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ВОССТАНОВЛЕНИЯ ПОСЛЕ BUS-OFF
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ АВТОМАТ СОСТОЯНИЙ:
+ * - Повтор текущего состояния не порождает уведомления
+ * - Восстановление запускается только из bus-off, неудача возвращает в bus-off
+ * - Счетчики bus-off и завершенных восстановлений
+ *
+ * ✅ ЗАДЕРЖКА:
+ * - Задержка растет вдвое с каждой попыткой и ограничена kMaxBackoffUs
+ * - После kStableUs работы без bus-off серия начинается заново
+ *
+ * ✅ КАРАНТИН:
+ * - Прием кадров и карантин передачи для каждого состояния
+ *
+ * ✅ ISO-TP:
+ * - Bus-off завершает передачу CF и не блокирует следующие сообщения
+ */
+
+namespace {
+
+// Проход bus-off -> восстановление -> error-active
+void recover(TwaiRecovery& recovery, uint32_t now_us) {
+  TEST_ASSERT_TRUE(recovery.OnRecoveryStarted());
+  TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::ERROR_ACTIVE, now_us));
+}
+
+}  // namespace
+
+// Тест 1: Переходы состояний и счетчики
+void test_twai_recovery_state_machine() {
+  TwaiRecovery recovery;
+  TEST_ASSERT_EQUAL(TwaiBusState::ERROR_ACTIVE, recovery.State());
+
+  TEST_ASSERT_FALSE_MESSAGE(recovery.OnStateChange(TwaiBusState::ERROR_ACTIVE, 0), "Same state is not reported");
+  TEST_ASSERT_FALSE_MESSAGE(recovery.OnRecoveryStarted(), "Nothing to recover outside bus-off");
+  TEST_ASSERT_FALSE_MESSAGE(recovery.OnStateChange(TwaiBusState::RECOVERING, 0), "Only the driver starts recovery");
+
+  TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::ERROR_WARNING, 100));
+  TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::ERROR_PASSIVE, 200));
+  TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::BUS_OFF, 300));
+  TEST_ASSERT_FALSE(recovery.OnStateChange(TwaiBusState::BUS_OFF, 400));
+  TEST_ASSERT_EQUAL_UINT32(1, recovery.BusOffCount());
+  TEST_ASSERT_EQUAL_UINT32(0, recovery.RecoveryCount());
+
+  // Контроллер отклонил запуск: снова bus-off, следующая попытка позже
+  TEST_ASSERT_TRUE(recovery.OnRecoveryStarted());
+  TEST_ASSERT_EQUAL(TwaiBusState::RECOVERING, recovery.State());
+  TEST_ASSERT_FALSE_MESSAGE(recovery.OnRecoveryStarted(), "Recovery already running");
+  TEST_ASSERT_EQUAL_UINT32(TwaiRecovery::kInitialBackoffUs * 2, recovery.OnRecoveryFailed());
+  TEST_ASSERT_EQUAL(TwaiBusState::BUS_OFF, recovery.State());
+
+  recover(recovery, 500);
+  TEST_ASSERT_EQUAL(TwaiBusState::ERROR_ACTIVE, recovery.State());
+  TEST_ASSERT_EQUAL_UINT32(1, recovery.BusOffCount());
+  TEST_ASSERT_EQUAL_UINT32(1, recovery.RecoveryCount());
+
+  // Переходы без bus-off восстановлением не считаются
+  TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::ERROR_WARNING, 600));
+  TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::ERROR_ACTIVE, 700));
+  TEST_ASSERT_EQUAL_UINT32(1, recovery.RecoveryCount());
+}
+
+// Тест 2: Экспоненциальная задержка и ее сброс
+void test_twai_recovery_backoff() {
+  TwaiRecovery recovery;
+  TEST_ASSERT_EQUAL_UINT32(TwaiRecovery::kInitialBackoffUs, recovery.BackoffUs());
+
+  // Bus-off сразу после каждого восстановления: задержка растет до предела
+  uint32_t now_us   = 1000;
+  uint32_t expected = TwaiRecovery::kInitialBackoffUs;
+  for (int i = 0; i < 12; i++) {
+    TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::BUS_OFF, now_us));
+    TEST_ASSERT_EQUAL_UINT32(expected, recovery.BackoffUs());
+    now_us += recovery.BackoffUs();
+    recover(recovery, now_us);
+    now_us += 1000;
+    expected = (expected * 2 < TwaiRecovery::kMaxBackoffUs) ? expected * 2 : TwaiRecovery::kMaxBackoffUs;
+  }
+  TEST_ASSERT_EQUAL_UINT32(TwaiRecovery::kMaxBackoffUs, recovery.BackoffUs());
+
+  // Шина стабильна дольше kStableUs: первая попытка снова через kInitialBackoffUs
+  now_us += TwaiRecovery::kStableUs;
+  TEST_ASSERT_TRUE(recovery.OnStateChange(TwaiBusState::BUS_OFF, now_us));
+  TEST_ASSERT_EQUAL_UINT32(TwaiRecovery::kInitialBackoffUs, recovery.BackoffUs());
+
+  // Переполнение времени не мешает сбросу
+  TwaiRecovery wrapped;
+  TEST_ASSERT_TRUE(wrapped.OnStateChange(TwaiBusState::BUS_OFF, UINT32_MAX - 100));
+  recover(wrapped, UINT32_MAX - 50);
+  TEST_ASSERT_TRUE(wrapped.OnStateChange(TwaiBusState::BUS_OFF, 100));
+  TEST_ASSERT_EQUAL_UINT32(TwaiRecovery::kInitialBackoffUs * 2, wrapped.BackoffUs());
+  recover(wrapped, 200);
+  TEST_ASSERT_TRUE(wrapped.OnStateChange(TwaiBusState::BUS_OFF, 200 + TwaiRecovery::kStableUs));
+  TEST_ASSERT_EQUAL_UINT32(TwaiRecovery::kInitialBackoffUs, wrapped.BackoffUs());
+}
+
+// Тест 3: Прием кадров и карантин по состояниям
+void test_twai_recovery_quarantine() {
+  struct Expectation {
+    TwaiBusState state;
+    bool accepts;
+    bool quarantined;
+  };
+  const Expectation expectations[] = {
+      {TwaiBusState::ERROR_WARNING, true, false},
+      {TwaiBusState::ERROR_PASSIVE, true, true},
+      {TwaiBusState::BUS_OFF, false, true},
+      {TwaiBusState::RECOVERING, false, true},
+      {TwaiBusState::ERROR_PASSIVE, true, true},
+      {TwaiBusState::ERROR_ACTIVE, true, false},
+  };
+
+  TwaiRecovery recovery;
+  TEST_ASSERT_TRUE(recovery.AcceptsFrames());
+  TEST_ASSERT_FALSE(recovery.Quarantined());
+
+  for (const Expectation& expectation : expectations) {
+    if (expectation.state == TwaiBusState::RECOVERING) {
+      TEST_ASSERT_TRUE(recovery.OnRecoveryStarted());
+    } else {
+      TEST_ASSERT_TRUE(recovery.OnStateChange(expectation.state, 0));
+    }
+    TEST_ASSERT_EQUAL(expectation.state, recovery.State());
+    TEST_ASSERT_EQUAL(expectation.accepts, recovery.AcceptsFrames());
+    TEST_ASSERT_EQUAL(expectation.quarantined, recovery.Quarantined());
+  }
+
+  // Восстановление через error-passive тоже завершает bus-off
+  TEST_ASSERT_EQUAL_UINT32(1, recovery.RecoveryCount());
+}
+
+// Тест 4: Bus-off во время передачи CF
+void test_twai_recovery_iso_tp_bus_off() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  mock_can.auto_tx_done = false;
+  IsoTp iso_tp(mock_can);
+
+  uint8_t data[50] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.len   = sizeof(data);
+  msg.data  = data;
+
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  mock_can.complete_tx();
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+  iso_tp.poll(0);
+  const size_t sent = mock_can.transmitted_frames.size();
+  TEST_ASSERT_GREATER_THAN_size_t(1, sent);
+
+  // Очередь сброшена, завершений передачи не будет: сессия завершается без ожидания N_As
+  mock_can.bus_off();
+  iso_tp.poll(0);
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::TIMEOUT_TX), static_cast<int>(log.last.result));
+  TEST_ASSERT_EQUAL_size_t(sent, mock_can.transmitted_frames.size());
+
+  // Сброшенные кадры не занимают окно передачи следующего сообщения
+  log = CompletionLog();
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg, on_complete, &log));
+  mock_can.complete_tx();
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+  for (int i = 0; i < 10 && log.calls == 0; i++) {
+    iso_tp.poll(0);
+    mock_can.complete_tx();
+  }
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+}
+
+extern "C" void run_twai_recovery_tests() {
+  RUN_TEST(test_twai_recovery_state_machine);
+  RUN_TEST(test_twai_recovery_backoff);
+  RUN_TEST(test_twai_recovery_quarantine);
+  RUN_TEST(test_twai_recovery_iso_tp_bus_off);
+}
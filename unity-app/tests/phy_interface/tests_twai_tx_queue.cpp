@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "twai_tx_queue.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ОЧЕРЕДИ ПЕРЕДАЧИ С КЛАССАМИ ПРИОРИТЕТА
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ ПОРЯДОК:
+ * - FC, поставленный за полной очередью CF, передается следующим
+ * - Классы FLOW_CONTROL > REQUEST > BULK, внутри класса FIFO (задача и прерывание)
+ * - Кадр, не принятый контроллером, возвращается в начало своего класса
+ *
+ * ✅ ЕМКОСТЬ:
+ * - Переполнение BULK не мешает постановке FC и запросов
+ *
+ * ✅ ISO-TP:
+ * - FC, SF/FF и CF помечаются своими классами приоритета
+ */
+
+namespace {
+
+TwaiFrame make_frame(uint32_t id, TxPriority priority) {
+  TwaiFrame frame   = {};
+  frame.id          = id;
+  frame.data_length = 8;
+  frame.tx_priority = priority;
+  return frame;
+}
+
+}  // namespace
+
+// Тест 1: FC не ждет очередь CF
+void test_twai_tx_queue_fc_overtakes_bulk() {
+  TwaiTxQueue queue;
+  TEST_ASSERT_TRUE(queue.Create());
+
+  const size_t bulk_depth = TwaiTxQueue::kDepth[static_cast<size_t>(TxPriority::BULK)];
+  for (size_t i = 0; i < bulk_depth; i++) {
+    TEST_ASSERT_TRUE(queue.Send(make_frame(0x7E0 + 0x100 + i, TxPriority::BULK), 0));
+  }
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x7E0, TxPriority::FLOW_CONTROL), 0));
+
+  TwaiFrame frame = {};
+  TEST_ASSERT_TRUE(queue.Receive(frame));
+  TEST_ASSERT_EQUAL_HEX32_MESSAGE(0x7E0, frame.id, "FC is sent right after the frame in the controller");
+  for (size_t i = 0; i < bulk_depth; i++) {
+    TEST_ASSERT_TRUE(queue.Receive(frame));
+    TEST_ASSERT_EQUAL_HEX32(0x7E0 + 0x100 + i, frame.id);
+  }
+  TEST_ASSERT_FALSE(queue.Receive(frame));
+}
+
+// Тест 2: Порядок классов и FIFO внутри класса
+void test_twai_tx_queue_class_order() {
+  TwaiTxQueue queue;
+  TEST_ASSERT_TRUE(queue.Create());
+
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x301, TxPriority::BULK), 0));
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x201, TxPriority::REQUEST), 0));
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x302, TxPriority::BULK), 0));
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x101, TxPriority::FLOW_CONTROL), 0));
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x202, TxPriority::REQUEST), 0));
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x102, TxPriority::FLOW_CONTROL), 0));
+
+  const uint32_t expected[6] = {0x101, 0x102, 0x201, 0x202, 0x301, 0x302};
+  TwaiFrame frame            = {};
+  for (size_t i = 0; i < 6; i++) {
+    // Прерывание TxCallback выбирает кадры по тем же правилам
+    BaseType_t woken = pdFALSE;
+    const bool ok    = (i % 2 == 0) ? queue.Receive(frame) : queue.ReceiveFromISR(frame, &woken);
+    TEST_ASSERT_TRUE(ok);
+    TEST_ASSERT_EQUAL_HEX32(expected[i], frame.id);
+  }
+  TEST_ASSERT_FALSE(queue.Receive(frame));
+}
+
+// Тест 3: Возврат кадра в начало своего класса
+void test_twai_tx_queue_return() {
+  TwaiTxQueue queue;
+  TEST_ASSERT_TRUE(queue.Create());
+
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x301, TxPriority::BULK), 0));
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x302, TxPriority::BULK), 0));
+
+  TwaiFrame frame = {};
+  TEST_ASSERT_TRUE(queue.Receive(frame));
+  TEST_ASSERT_EQUAL_HEX32(0x301, frame.id);
+
+  // Контроллер не принял кадр, тем временем поставлен FC
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x101, TxPriority::FLOW_CONTROL), 0));
+  BaseType_t woken = pdFALSE;
+  queue.ReturnFromISR(frame, &woken);
+
+  const uint32_t expected[3] = {0x101, 0x301, 0x302};
+  for (size_t i = 0; i < 3; i++) {
+    TEST_ASSERT_TRUE(queue.Receive(frame));
+    TEST_ASSERT_EQUAL_HEX32(expected[i], frame.id);
+  }
+}
+
+// Тест 4: Полная очередь CF не блокирует FC и запросы
+void test_twai_tx_queue_bulk_full() {
+  TwaiTxQueue queue;
+  TEST_ASSERT_TRUE(queue.Create());
+
+  size_t bulk = 0;
+  while (queue.Send(make_frame(0x300, TxPriority::BULK), 0)) {
+    bulk++;
+  }
+  TEST_ASSERT_EQUAL_size_t(TwaiTxQueue::kDepth[static_cast<size_t>(TxPriority::BULK)], bulk);
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x100, TxPriority::FLOW_CONTROL), 0));
+  TEST_ASSERT_TRUE(queue.Send(make_frame(0x200, TxPriority::REQUEST), 0));
+
+  // Неизвестный класс обслуживается как REQUEST
+  TwaiFrame unknown   = make_frame(0x201, TxPriority::REQUEST);
+  unknown.tx_priority = static_cast<TxPriority>(7);
+  TEST_ASSERT_TRUE(queue.Send(unknown, 0));
+
+  TwaiFrame frame = {};
+  TEST_ASSERT_TRUE(queue.Receive(frame));
+  TEST_ASSERT_EQUAL_HEX32(0x100, frame.id);
+  TEST_ASSERT_TRUE(queue.Receive(frame));
+  TEST_ASSERT_EQUAL_HEX32(0x200, frame.id);
+  TEST_ASSERT_TRUE(queue.Receive(frame));
+  TEST_ASSERT_EQUAL_HEX32(0x201, frame.id);
+}
+
+// Тест 5: Классы кадров ISO-TP
+void test_twai_tx_queue_iso_tp_classes() {
+  MockTwaiInterface mock_can;
+  mock_can.reset();
+  IsoTp iso_tp(mock_can);
+
+  // Отправка: FF - REQUEST, CF - BULK
+  uint8_t data[20] = {0};
+  IsoTp::Message msg;
+  msg.tx_id = 0x7E0;
+  msg.rx_id = 0x7E8;
+  msg.len   = sizeof(data);
+  msg.data  = data;
+  TEST_ASSERT_TRUE(iso_tp.start_send(msg));
+  iso_tp.on_frame(create_flow_control_frame(0x7E8, 0, 0, 0));
+  iso_tp.poll(0);
+  TEST_ASSERT_EQUAL_size_t(3, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL(TxPriority::REQUEST, mock_can.transmitted_frames[0].tx_priority);
+  TEST_ASSERT_EQUAL(TxPriority::BULK, mock_can.transmitted_frames[1].tx_priority);
+  TEST_ASSERT_EQUAL(TxPriority::BULK, mock_can.transmitted_frames[2].tx_priority);
+
+  // Прием: FC - FLOW_CONTROL
+  uint8_t buffer[32] = {0};
+  msg.data           = buffer;
+  TEST_ASSERT_TRUE(iso_tp.start_receive(msg, sizeof(buffer)));
+  iso_tp.on_frame(create_first_frame(0x7E8, 20, data));
+  TEST_ASSERT_EQUAL_size_t(4, mock_can.transmitted_frames.size());
+  TEST_ASSERT_EQUAL_HEX8(0x30, mock_can.transmitted_frames[3].data[0]);
+  TEST_ASSERT_EQUAL(TxPriority::FLOW_CONTROL, mock_can.transmitted_frames[3].tx_priority);
+  iso_tp.abort();
+
+  // SF - REQUEST
+  msg.data = data;
+  msg.len  = 2;
+  TEST_ASSERT_TRUE(iso_tp.send(msg));
+  TEST_ASSERT_EQUAL(TxPriority::REQUEST, mock_can.transmitted_frames.back().tx_priority);
+}
+
+extern "C" void run_twai_tx_queue_tests() {
+  RUN_TEST(test_twai_tx_queue_fc_overtakes_bulk);
+  RUN_TEST(test_twai_tx_queue_class_order);
+  RUN_TEST(test_twai_tx_queue_return);
+  RUN_TEST(test_twai_tx_queue_bulk_full);
+  RUN_TEST(test_twai_tx_queue_iso_tp_classes);
+}
@@ -0,0 +1,203 @@
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "esp_twai_onchip.h"
+#include "iso_tp.h"
+#include "mock_twai_interface.h"
+#include "twai_driver.h"
+#include "unity.h"
+
+// ============================================================================
+// ТЕСТЫ ДРАЙВЕРА TWAI НА МОКЕ УЗЛА ESP-IDF
+// ============================================================================
+
+/*
+ * ПОКРЫТИЕ ТЕСТАМИ:
+ *
+ * ✅ КАРАНТИН ERROR-PASSIVE:
+ * - Transmit/TransmitBatch ставят кадры в очередь, пока в контроллере есть кадр
+ * - Кадры из очереди уходят по одному по завершению предыдущего
+ * - Передача ISO-TP (FF, FC от ЭБУ, пачка CF) завершается без TIMEOUT_TX
+ *
+ * ✅ ОТКАЗ В ПЕРЕДАЧЕ:
+ * - Bus-off и пассивный режим (listen-only) возвращают INVALID_STATE
+ *
+ * ✅ СМЕНА ФИЛЬТРА НА РАБОТАЮЩЕМ УЗЛЕ:
+ * - Кадр, снятый с передачи перезапуском, завершается onTwaiTxDone(frame, false)
+ * - Передача продолжается с кадров, оставшихся в очереди
+ */
+
+namespace {
+
+// Подписчик с фильтрами CAN ID, запоминающий завершения передачи
+class TxDoneSubscriber : public ITwaiSubscriber {
+ public:
+  explicit TxDoneSubscriber(Span<const CanIdFilter> filters) : filters_(filters) {}
+
+  TwaiRxRing* onTwaiMessage() override {
+    return nullptr;
+  }
+  bool isInterested(const TwaiFrame& /*frame*/) override {
+    return true;
+  }
+  Span<const CanIdFilter> rxFilters() override {
+    return filters_;
+  }
+  bool onTwaiTxDone(const TwaiFrame& frame, bool success) override {
+    done.push_back(frame.id);
+    failed += success ? 0 : 1;
+    return false;
+  }
+
+  std::vector<uint32_t> done;
+  int failed = 0;
+
+ private:
+  Span<const CanIdFilter> filters_;
+};
+
+// Установка драйвера и переход узла в error-passive
+twai_node_handle_t start_error_passive(TwaiDriver& driver) {
+  driver.InstallStart();
+  twai_node_handle_t node = mock_twai_last_node();
+  TEST_ASSERT_NOT_NULL(node);
+  mock_twai_state_change(node, TWAI_ERROR_PASSIVE);
+  TEST_ASSERT_EQUAL(TwaiBusState::ERROR_PASSIVE, driver.GetBusState());
+  return node;
+}
+
+}  // namespace
+
+// Тест 1: Кадры, отправленные в error-passive, ставятся в очередь и уходят по одному
+void test_twai_driver_error_passive_queues_frames() {
+  TwaiDriver driver(GPIO_NUM_0, GPIO_NUM_1, 500);
+  twai_node_handle_t node = start_error_passive(driver);
+
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK, driver.Transmit(make_frame(0x100, {0x01}), 0));
+  TEST_ASSERT_EQUAL_size_t(1, node->in_flight.size());
+
+  // Кадр в контроллере: следующие ждут в очереди, а не отклоняются
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK, driver.Transmit(make_frame(0x101, {0x02}), 0));
+  const TwaiFrame batch[] = {make_frame(0x102, {0x03}), make_frame(0x103, {0x04})};
+  size_t queued           = 0;
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK,
+                    driver.TransmitBatch(Span<const TwaiFrame>(batch, 2), 0, queued));
+  TEST_ASSERT_EQUAL_size_t(2, queued);
+  TEST_ASSERT_EQUAL_size_t(1, node->in_flight.size());
+
+  // Каждое завершение передачи запускает ровно один следующий кадр
+  for (uint32_t id = 0x101; id <= 0x103; id++) {
+    TEST_ASSERT_TRUE(mock_twai_tx_done(node));
+    TEST_ASSERT_EQUAL_size_t(1, node->in_flight.size());
+    TEST_ASSERT_EQUAL_HEX32(id, node->in_flight.front().header.id);
+  }
+  TEST_ASSERT_TRUE(mock_twai_tx_done(node));
+  TEST_ASSERT_EQUAL_size_t(0, node->in_flight.size());
+  TEST_ASSERT_EQUAL_size_t(4, node->transmitted.size());
+
+  // Очередь пуста: новый кадр сразу уходит в контроллер
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK, driver.Transmit(make_frame(0x104, {0x05}), 0));
+  TEST_ASSERT_EQUAL_size_t(1, node->in_flight.size());
+}
+
+// Тест 2: Многокадровая передача ISO-TP в error-passive
+void test_twai_driver_error_passive_iso_tp_send() {
+  TwaiDriver driver(GPIO_NUM_0, GPIO_NUM_1, 500);
+  IsoTp iso_tp(driver);
+  twai_node_handle_t node = start_error_passive(driver);
+
+  uint8_t data[40];
+  for (size_t i = 0; i < sizeof(data); i++) {
+    data[i] = static_cast<uint8_t>(i);
+  }
+  CompletionLog log;
+  TEST_ASSERT_TRUE(iso_tp.start_send(make_message(data, sizeof(data)), on_complete, &log));
+  TEST_ASSERT_EQUAL_size_t(1, node->in_flight.size());
+  TEST_ASSERT_TRUE(mock_twai_tx_done(node));
+
+  // FC от ЭБУ: все CF пачкой в очередь драйвера, в контроллере по одному
+  const uint8_t fc[] = {0x30, 0x00, 0x00};
+  mock_twai_rx(node, 0x7E8, fc, sizeof(fc));
+  for (int i = 0; i < 20 && log.calls == 0; i++) {
+    iso_tp.process(0);
+    TEST_ASSERT_LESS_OR_EQUAL_size_t(1, node->in_flight.size());
+    mock_twai_tx_done(node);
+  }
+
+  TEST_ASSERT_EQUAL_INT(1, log.calls);
+  TEST_ASSERT_EQUAL_INT(static_cast<int>(IsoTp::Result::OK), static_cast<int>(log.last.result));
+
+  // Сессия завершается постановкой последнего CF: он уходит из очереди драйвера следом
+  while (mock_twai_tx_done(node)) {
+    TEST_ASSERT_LESS_OR_EQUAL_size_t(1, node->in_flight.size());
+  }
+  TEST_ASSERT_EQUAL_size_t(1 + 5, node->transmitted.size());  // FF (6 байт) + 5 CF (34 байта)
+  TEST_ASSERT_EQUAL_HEX8(0x25, node->transmitted.back().data[0]);
+}
+
+// Тест 3: Bus-off и listen-only отклоняют передачу
+void test_twai_driver_rejects_when_not_sending() {
+  TwaiDriver driver(GPIO_NUM_0, GPIO_NUM_1, 500);
+  twai_node_handle_t node = start_error_passive(driver);
+
+  mock_twai_state_change(node, TWAI_ERROR_BUS_OFF);
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::INVALID_STATE, driver.Transmit(make_frame(0x100, {0x01}), 0));
+  TEST_ASSERT_EQUAL_size_t(0, node->transmitted.size());
+
+  TwaiDriver listener(GPIO_NUM_2, GPIO_NUM_3, 500, true);
+  listener.InstallStart();
+  size_t queued           = 0;
+  const TwaiFrame frame[] = {make_frame(0x100, {0x01})};
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::INVALID_STATE,
+                    listener.TransmitBatch(Span<const TwaiFrame>(frame, 1), 0, queued));
+  TEST_ASSERT_EQUAL_size_t(0, queued);
+}
+
+// Тест 4: Перезапуск узла для нового фильтра не теряет кадр в передаче молча
+void test_twai_driver_filter_restart_fails_in_flight_frame() {
+  const CanIdFilter ecu_filter[]    = {{0x7E8, 0x7FF, false}};
+  const CanIdFilter sensor_filter[] = {{0x3A0, 0x7FF, false}};
+  TxDoneSubscriber iso_tp(Span<const CanIdFilter>(ecu_filter, 1));
+  TxDoneSubscriber sensor(Span<const CanIdFilter>(sensor_filter, 1));
+
+  TwaiDriver driver(GPIO_NUM_0, GPIO_NUM_1, 500);
+  driver.RegisterSubscriber(iso_tp);
+  driver.InstallStart();
+  twai_node_handle_t node = mock_twai_last_node();
+  TEST_ASSERT_EQUAL_INT(1, node->filter_writes);
+
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK, driver.Transmit(make_frame(0x7E0, {0x02, 0x01, 0x0C}), 0));
+  TEST_ASSERT_EQUAL(IPhyInterface::TwaiError::OK, driver.Transmit(make_frame(0x7E0, {0x02, 0x01, 0x0D}), 0));
+  TEST_ASSERT_EQUAL_size_t(1, node->in_flight.size());
+
+  // Новый подписчик расширяет фильтр: узел перезапускается, первый кадр снят с передачи
+  driver.RegisterSubscriber(sensor);
+  TEST_ASSERT_EQUAL_INT(2, node->filter_writes);
+  TEST_ASSERT_TRUE(node->enabled);
+  TEST_ASSERT_EQUAL_size_t(1, iso_tp.done.size());
+  TEST_ASSERT_EQUAL_INT(1, iso_tp.failed);
+  TEST_ASSERT_EQUAL_HEX32(0x7E0, iso_tp.done[0]);
+
+  // Второй кадр ушел из очереди после включения узла
+  TEST_ASSERT_EQUAL_size_t(1, node->in_flight.size());
+  TEST_ASSERT_EQUAL_HEX8(0x0D, node->in_flight.front().data[2]);
+  TEST_ASSERT_TRUE(mock_twai_tx_done(node));
+  TEST_ASSERT_EQUAL_size_t(2, iso_tp.done.size());
+  TEST_ASSERT_EQUAL_INT(1, iso_tp.failed);
+
+  // Узел без кадра в передаче перезапускается без ложных завершений
+  driver.UnRegisterSubscriber(sensor);
+  TEST_ASSERT_EQUAL_INT(3, node->filter_writes);
+  TEST_ASSERT_EQUAL_size_t(2, iso_tp.done.size());
+
+  driver.UnRegisterSubscriber(iso_tp);
+}
+
+extern "C" void run_twai_driver_tests() {
+  RUN_TEST(test_twai_driver_error_passive_queues_frames);
+  RUN_TEST(test_twai_driver_error_passive_iso_tp_send);
+  RUN_TEST(test_twai_driver_rejects_when_not_sending);
+  RUN_TEST(test_twai_driver_filter_restart_fails_in_flight_frame);
+}